@@ -9,20 +9,58 @@ typedef NS_ENUM(NSUInteger, BAPromiseStatus) {
     BAPromiseStatusRejected,
 };
 
+/**
+ A thread-safe Promise-like implementation.
+
+ A promise settles once: resolving or rejecting a settled promise does nothing.
+ Blocks registered without a queue are called on the thread that settles the promise, or synchronously if it has
+ already settled. Blocks registered with a queue are always dispatched asynchronously on it.
+ Blocks are called in the order they were registered.
+ */
 @interface BAPromise<ObjectType : NSObject *> : NSObject
 
-@property BAPromiseStatus status;
+@property (readonly) BAPromiseStatus status;
 
 + (nonnull instancetype)resolved:(nullable ObjectType)value;
 
 + (nonnull instancetype)rejected:(nullable NSError *)error;
 
+/**
+ Resolves with the values of all promises, in the same order, once they are all resolved.
+ nil values are replaced by NSNull. Rejects with the first rejection.
+ */
++ (nonnull BAPromise<NSArray *> *)all:(nonnull NSArray<BAPromise *> *)promises;
+
+/**
+ Settles like the first of the promises to settle. Stays pending if the array is empty.
+ */
++ (nonnull BAPromise *)race:(nonnull NSArray<BAPromise *> *)promises;
+
 - (void)resolve:(nullable ObjectType)value;
 
 - (void)reject:(nullable NSError *)error;
 
 - (void)then:(void (^_Nonnull)(ObjectType _Nullable value))thenBlock;
 
+- (void)then:(void (^_Nonnull)(ObjectType _Nullable value))thenBlock queue:(nullable dispatch_queue_t)queue;
+
 - (void)catch:(void (^_Nonnull)(NSError *_Nullable))catchBlock;
 
+- (void)catch:(void (^_Nonnull)(NSError *_Nullable))catchBlock queue:(nullable dispatch_queue_t)queue;
+
+/**
+ Returns a promise resolved with the transformed value. Rejections are forwarded as is.
+ */
+- (nonnull BAPromise *)map:(id _Nullable (^_Nonnull)(ObjectType _Nullable value))mapBlock;
+
+/**
+ Returns a promise rejected with the transformed error. Values are forwarded as is.
+ */
+- (nonnull BAPromise<ObjectType> *)mapError:(NSError *_Nullable (^_Nonnull)(NSError *_Nullable error))mapBlock;
+
+/**
+ Returns a promise that settles like the one returned by the block. Rejections are forwarded as is.
+ */
+- (nonnull BAPromise *)flatMap:(BAPromise *_Nonnull (^_Nonnull)(ObjectType _Nullable value))flatMapBlock;
+
 @end
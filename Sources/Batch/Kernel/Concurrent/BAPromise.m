@@ -3,27 +3,71 @@
 
 #import <Batch/BAPromise.h>
 
+#import <stdatomic.h>
+
+// Value of the callbacks word once the promise has settled. Nodes are objects: their address is never 1.
+#define SETTLED_MARKER ((uintptr_t)1)
+
+typedef void (^BAPromiseCallbackBlock)(BAPromiseStatus status, id _Nullable value);
+
+/**
+ A registered block, as a node of the promise's callbacks list
+ */
+@interface BAPromiseCallback : NSObject {
+  @public
+    BAPromiseCallbackBlock _block;
+    dispatch_queue_t _queue;
+    // Nodes are owned by the list, through the +1 they got when pushed
+    __unsafe_unretained BAPromiseCallback *_next;
+}
+@end
+
+@implementation BAPromiseCallback
+
+- (void)invokeWithStatus:(BAPromiseStatus)status value:(id)value {
+    BAPromiseCallbackBlock block = _block;
+    if (_queue != nil) {
+        dispatch_async(_queue, ^{
+          block(status, value);
+        });
+    } else {
+        block(status, value);
+    }
+}
+
+@end
+
 /**
- A simple Promise-like implementation that is not thread-safe.
- then can't mutate the value
+ The promise's state is a single atomic word: either the head of a list of pending callbacks (0 if empty), or
+ SETTLED_MARKER. Registering a callback pushes it with a CAS, settling swaps the whole list out for the marker and
+ runs it. No lock is ever held while user code runs.
+ A separate flag elects the thread allowed to settle, so that the value is written before the marker publishes it.
  */
 @implementation BAPromise {
-    BAPromiseStatus _status;
+    _Atomic(uintptr_t) _callbacks;
+    atomic_flag _settleClaimed;
+    BAPromiseStatus _settledStatus;
     NSObject *_resolvedValue; // NSError* if rejected
-    NSMutableArray *_thenQueue;
-    void (^_catchBlock)(NSError *);
 }
 
 - (instancetype)init {
     self = [super init];
     if (self) {
-        _status = BAPromiseStatusPending;
+        atomic_init(&_callbacks, 0);
+        atomic_flag_clear(&_settleClaimed);
+        _settledStatus = BAPromiseStatusPending;
         _resolvedValue = nil;
-        _thenQueue = [NSMutableArray new];
     }
     return self;
 }
 
+- (void)dealloc {
+    uintptr_t head = atomic_load_explicit(&_callbacks, memory_order_acquire);
+    if (head != SETTLED_MARKER) {
+        [self releaseCallbacks:head];
+    }
+}
+
 + (nonnull instancetype)resolved:(nullable NSObject *)value {
     BAPromise *promise = [BAPromise new];
     [promise resolve:value];
@@ -36,59 +80,193 @@
     return promise;
 }
 
-- (void)resolve:(nullable NSObject *)value {
-    @synchronized(_thenQueue) {
-        if (_status != BAPromiseStatusPending) {
-            return;
-        }
+- (BAPromiseStatus)status {
+    if (atomic_load_explicit(&_callbacks, memory_order_acquire) != SETTLED_MARKER) {
+        return BAPromiseStatusPending;
+    }
+    return _settledStatus;
+}
 
-        _status = BAPromiseStatusResolved;
-        _resolvedValue = value;
+#pragma mark Settling
 
-        void (^thenBlock)(NSObject *);
-        while ([_thenQueue count] > 0) {
-            thenBlock = [_thenQueue objectAtIndex:0];
-            [_thenQueue removeObjectAtIndex:0];
-            if (thenBlock) {
-                thenBlock(value);
-            }
-        }
-    }
+- (void)resolve:(nullable NSObject *)value {
+    [self settleWithStatus:BAPromiseStatusResolved value:value];
 }
 
 - (void)reject:(nullable NSError *)error {
-    if (_status != BAPromiseStatusPending) {
+    [self settleWithStatus:BAPromiseStatusRejected value:error];
+}
+
+- (void)settleWithStatus:(BAPromiseStatus)status value:(nullable NSObject *)value {
+    if (atomic_flag_test_and_set_explicit(&_settleClaimed, memory_order_acq_rel)) {
         return;
     }
 
-    _status = BAPromiseStatusRejected;
-    _resolvedValue = error;
+    _settledStatus = status;
+    _resolvedValue = value;
 
-    if (_catchBlock) {
-        _catchBlock(error);
+    uintptr_t head = atomic_exchange_explicit(&_callbacks, SETTLED_MARKER, memory_order_acq_rel);
+
+    // The list is LIFO: reverse it to call the blocks in the order they were registered
+    BAPromiseCallback *previous = nil;
+    BAPromiseCallback *current = (__bridge BAPromiseCallback *)(void *)head;
+    while (current != nil) {
+        BAPromiseCallback *next = current->_next;
+        current->_next = previous;
+        previous = current;
+        current = next;
+    }
+
+    current = previous;
+    while (current != nil) {
+        BAPromiseCallback *callback = (__bridge_transfer BAPromiseCallback *)(__bridge void *)current;
+        current = callback->_next;
+        [callback invokeWithStatus:status value:value];
     }
 }
 
-- (void)then:(void (^_Nonnull)(NSObject *_Nullable))thenBlock {
-    @synchronized(_thenQueue) {
-        if (_status == BAPromiseStatusResolved) {
-            thenBlock(_resolvedValue);
-        } else if (_status == BAPromiseStatusPending) {
-            [_thenQueue addObject:thenBlock];
+#pragma mark Callbacks
+
+- (void)addCallback:(BAPromiseCallbackBlock)block queue:(nullable dispatch_queue_t)queue {
+    BAPromiseCallback *callback = [BAPromiseCallback new];
+    callback->_block = block;
+    callback->_queue = queue;
+
+    uintptr_t node = (uintptr_t)(__bridge_retained void *)callback;
+    uintptr_t head = atomic_load_explicit(&_callbacks, memory_order_acquire);
+    while (head != SETTLED_MARKER) {
+        callback->_next = (__bridge BAPromiseCallback *)(void *)head;
+        if (atomic_compare_exchange_weak_explicit(&_callbacks, &head, node, memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            return;
         }
     }
+
+    // Already settled: the list won't be run again, call the block right away
+    callback = (__bridge_transfer BAPromiseCallback *)(void *)node;
+    [callback invokeWithStatus:_settledStatus value:_resolvedValue];
+}
+
+- (void)releaseCallbacks:(uintptr_t)head {
+    BAPromiseCallback *current = (__bridge BAPromiseCallback *)(void *)head;
+    while (current != nil) {
+        BAPromiseCallback *callback = (__bridge_transfer BAPromiseCallback *)(__bridge void *)current;
+        current = callback->_next;
+    }
+}
+
+- (void)then:(void (^_Nonnull)(NSObject *_Nullable))thenBlock {
+    [self then:thenBlock queue:nil];
+}
+
+- (void)then:(void (^_Nonnull)(NSObject *_Nullable))thenBlock queue:(nullable dispatch_queue_t)queue {
+    BAPromiseCallbackBlock callback = ^(BAPromiseStatus status, id value) {
+      if (status == BAPromiseStatusResolved) {
+          thenBlock(value);
+      }
+    };
+    [self addCallback:callback queue:queue];
 }
 
 - (void)catch:(void (^_Nonnull)(NSError *_Nullable))catchBlock {
-    if (_status == BAPromiseStatusRejected) {
-        if ([_resolvedValue isKindOfClass:[NSError class]]) {
-            catchBlock((NSError *)_resolvedValue);
-        } else {
-            catchBlock(nil);
+    [self catch:catchBlock queue:nil];
+}
+
+- (void)catch:(void (^_Nonnull)(NSError *_Nullable))catchBlock queue:(nullable dispatch_queue_t)queue {
+    BAPromiseCallbackBlock callback = ^(BAPromiseStatus status, id value) {
+      if (status == BAPromiseStatusRejected) {
+          catchBlock([value isKindOfClass:[NSError class]] ? (NSError *)value : nil);
+      }
+    };
+    [self addCallback:callback queue:queue];
+}
+
+#pragma mark Combinators
+
+- (nonnull BAPromise *)map:(id _Nullable (^_Nonnull)(NSObject *_Nullable value))mapBlock {
+    BAPromise *mapped = [BAPromise new];
+    [self then:^(NSObject *_Nullable value) {
+      [mapped resolve:mapBlock(value)];
+    }];
+    [self catch:^(NSError *_Nullable error) {
+      [mapped reject:error];
+    }];
+    return mapped;
+}
+
+- (nonnull BAPromise *)mapError:(NSError *_Nullable (^_Nonnull)(NSError *_Nullable error))mapBlock {
+    BAPromise *mapped = [BAPromise new];
+    [self then:^(NSObject *_Nullable value) {
+      [mapped resolve:value];
+    }];
+    [self catch:^(NSError *_Nullable error) {
+      [mapped reject:mapBlock(error)];
+    }];
+    return mapped;
+}
+
+- (nonnull BAPromise *)flatMap:(BAPromise *_Nonnull (^_Nonnull)(NSObject *_Nullable value))flatMapBlock {
+    BAPromise *mapped = [BAPromise new];
+    [self then:^(NSObject *_Nullable value) {
+      BAPromise *next = flatMapBlock(value);
+      [next then:^(NSObject *_Nullable nextValue) {
+        [mapped resolve:nextValue];
+      }];
+      [next catch:^(NSError *_Nullable error) {
+        [mapped reject:error];
+      }];
+    }];
+    [self catch:^(NSError *_Nullable error) {
+      [mapped reject:error];
+    }];
+    return mapped;
+}
+
++ (nonnull BAPromise<NSArray *> *)all:(nonnull NSArray<BAPromise *> *)promises {
+    BAPromise *all = [BAPromise new];
+    NSUInteger count = [promises count];
+    if (count == 0) {
+        [all resolve:@[]];
+        return all;
+    }
+
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [values addObject:[NSNull null]];
+    }
+
+    __block NSUInteger remaining = count;
+    [promises enumerateObjectsUsingBlock:^(BAPromise *promise, NSUInteger idx, BOOL *stop) {
+      [promise then:^(NSObject *_Nullable value) {
+        BOOL done;
+        @synchronized(values) {
+            if (value != nil) {
+                values[idx] = value;
+            }
+            done = --remaining == 0;
         }
-    } else if (_status == BAPromiseStatusPending) {
-        _catchBlock = catchBlock;
+        if (done) {
+            [all resolve:[values copy]];
+        }
+      }];
+      [promise catch:^(NSError *_Nullable error) {
+        [all reject:error];
+      }];
+    }];
+    return all;
+}
+
++ (nonnull BAPromise *)race:(nonnull NSArray<BAPromise *> *)promises {
+    BAPromise *race = [BAPromise new];
+    for (BAPromise *promise in promises) {
+        [promise then:^(NSObject *_Nullable value) {
+          [race resolve:value];
+        }];
+        [promise catch:^(NSError *_Nullable error) {
+          [race reject:error];
+        }];
     }
+    return race;
 }
 
 @end
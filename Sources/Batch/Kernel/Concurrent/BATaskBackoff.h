@@ -0,0 +1,48 @@
+//
+//  BATaskBackoff.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Retries a task defined by a block with an exponential backoff.
+
+ Each retry is scheduled after the current delay, which then doubles until it reaches the maximum delay.
+ Scheduling is thread-safe, and uses the shared timer wheel.
+ */
+@interface BATaskBackoff : NSObject
+
++ (instancetype)backoffWithInitialDelay:(NSTimeInterval)initialDelay
+                               maxDelay:(NSTimeInterval)maxDelay
+                                  queue:(dispatch_queue_t)queue
+                                   task:(dispatch_block_t)taskBlock;
+
+/**
+ Delay of the next retry
+ */
+@property (readonly) NSTimeInterval currentDelay;
+
+/**
+ Whether a retry is pending
+ */
+@property (readonly, getter=isScheduled) BOOL scheduled;
+
+/**
+ Schedule a retry after the current delay, replacing the pending one if any, and increase the delay
+ */
+- (void)scheduleRetry;
+
+/**
+ Cancel the pending retry, keeping the current delay
+ */
+- (void)cancel;
+
+/**
+ Cancel the pending retry, and go back to the initial delay
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,61 @@
+//
+//  BATaskBackoff.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BATaskBackoff.h>
+#import <Batch/BATimerWheel.h>
+
+@implementation BATaskBackoff {
+    NSTimeInterval _initialDelay;
+    NSTimeInterval _maxDelay;
+    BATimerWheelTimeout *_timeout;
+}
+
++ (instancetype)backoffWithInitialDelay:(NSTimeInterval)initialDelay
+                               maxDelay:(NSTimeInterval)maxDelay
+                                  queue:(dispatch_queue_t)queue
+                                   task:(dispatch_block_t)taskBlock {
+    BATaskBackoff *backoff = [BATaskBackoff new];
+
+    backoff->_initialDelay = initialDelay;
+    backoff->_maxDelay = MAX(initialDelay, maxDelay);
+    backoff->_currentDelay = initialDelay;
+    backoff->_timeout = [[BATimerWheelTimeout alloc] initWithWheel:[BATimerWheel sharedWheel]
+                                                             queue:queue
+                                                              task:taskBlock];
+
+    return backoff;
+}
+
+- (NSTimeInterval)currentDelay {
+    @synchronized(self) {
+        return _currentDelay;
+    }
+}
+
+- (BOOL)isScheduled {
+    return [_timeout isScheduled];
+}
+
+- (void)scheduleRetry {
+    @synchronized(self) {
+        [_timeout scheduleAfter:_currentDelay];
+        _currentDelay = MIN(_maxDelay, _currentDelay * 2);
+    }
+}
+
+- (void)cancel {
+    [_timeout cancel];
+}
+
+- (void)reset {
+    @synchronized(self) {
+        [_timeout cancel];
+        _currentDelay = _initialDelay;
+    }
+}
+
+@end
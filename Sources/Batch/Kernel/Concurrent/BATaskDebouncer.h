@@ -10,7 +10,8 @@
 /**
  Allows deboucing of a task defined by a block.
 
- Warning: Calling "shedule" in between threads isn't supported.
+ The task runs once the delay has elapsed without any new call to "schedule".
+ Scheduling is thread-safe, and reschedules the task on the shared timer wheel without creating a timer.
  */
 @interface BATaskDebouncer : NSObject
 
@@ -20,4 +21,6 @@
 
 - (void)schedule;
 
+- (void)cancel;
+
 @end
@@ -0,0 +1,28 @@
+//
+//  BATaskThrottler.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Allows throttling of a task defined by a block.
+
+ The task runs at most once per interval: calls to "schedule" made while a run is pending are merged into it, and a run
+ requested too soon after the previous one is delayed until the interval has elapsed.
+ Scheduling is thread-safe, and uses the shared timer wheel. Cancelling skips the pending run, even if it has already
+ been dispatched to the queue.
+ */
+@interface BATaskThrottler : NSObject
+
++ (instancetype)throttlerWithInterval:(NSTimeInterval)interval
+                                queue:(dispatch_queue_t)queue
+                                 task:(dispatch_block_t)taskBlock;
+
+- (void)schedule;
+
+- (void)cancel;
+
+@end
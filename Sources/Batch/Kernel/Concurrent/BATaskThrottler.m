@@ -0,0 +1,77 @@
+//
+//  BATaskThrottler.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BATaskThrottler.h>
+#import <Batch/BATimerWheel.h>
+#import <Batch/BAUptimeProvider.h>
+
+#import <stdatomic.h>
+
+@implementation BATaskThrottler {
+    NSTimeInterval _interval;
+    BATimerWheelTimeout *_timeout;
+    /// Uptime of the last run, 0 if the task never ran
+    _Atomic(uint64_t) _lastRunUptime;
+    /// Whether a run has been requested and hasn't started yet. Runs dispatched right away aren't tracked by the
+    /// timeout, so this is what merges calls made before they start, and what lets cancel skip them.
+    _Atomic(bool) _pending;
+}
+
++ (instancetype)throttlerWithInterval:(NSTimeInterval)interval
+                                queue:(dispatch_queue_t)queue
+                                 task:(dispatch_block_t)taskBlock {
+    BATaskThrottler *throttler = [BATaskThrottler new];
+
+    throttler->_interval = interval;
+    atomic_init(&throttler->_lastRunUptime, 0);
+    atomic_init(&throttler->_pending, false);
+
+    __weak BATaskThrottler *weakThrottler = throttler;
+    dispatch_block_t throttledTask = ^{
+      if ([weakThrottler taskWillRun]) {
+          taskBlock();
+      }
+    };
+    throttler->_timeout = [[BATimerWheelTimeout alloc] initWithWheel:[BATimerWheel sharedWheel]
+                                                               queue:queue
+                                                                task:throttledTask];
+
+    return throttler;
+}
+
+- (void)schedule {
+    bool notPending = false;
+    if (!atomic_compare_exchange_strong(&_pending, &notPending, true)) {
+        return;
+    }
+
+    NSTimeInterval delay = 0;
+    uint64_t lastRunUptime = atomic_load_explicit(&_lastRunUptime, memory_order_relaxed);
+    if (lastRunUptime != 0) {
+        delay = MAX(0, _interval - [BAUptimeProvider secondsSinceUptimeNanoseconds:lastRunUptime]);
+    }
+    [_timeout scheduleAfter:delay];
+}
+
+- (void)cancel {
+    atomic_store(&_pending, false);
+    [_timeout cancel];
+}
+
+/// Returns false if the run has been cancelled, or already started by a run scheduled before a cancel
+- (BOOL)taskWillRun {
+    if (!atomic_load(&_pending)) {
+        return false;
+    }
+    // Record the run before clearing the pending flag: calls made from then on schedule the next run an interval
+    // after this one
+    atomic_store(&_lastRunUptime, [BAUptimeProvider uptimeNanoseconds]);
+    bool pending = true;
+    return atomic_compare_exchange_strong(&_pending, &pending, false);
+}
+
+@end
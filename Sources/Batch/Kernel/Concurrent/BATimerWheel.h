@@ -0,0 +1,75 @@
+//
+//  BATimerWheel.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class BATimerWheel;
+
+/**
+ A task scheduled on a timer wheel.
+
+ Scheduling a timeout that is already pending moves it to its new deadline: a timeout fires at most once per deadline.
+ All methods are thread-safe, and O(1).
+ */
+@interface BATimerWheelTimeout : NSObject
+
+- (nonnull instancetype)init NS_UNAVAILABLE;
+
+/**
+ Make a timeout, initially not scheduled.
+ The task is dispatched asynchronously on the queue when the timeout fires.
+ */
+- (nonnull instancetype)initWithWheel:(nonnull BATimerWheel *)wheel
+                                queue:(nonnull dispatch_queue_t)queue
+                                 task:(nonnull dispatch_block_t)taskBlock NS_DESIGNATED_INITIALIZER;
+
+/**
+ Schedule the task to run after the delay, replacing the pending deadline if any.
+ A delay of zero or less cancels the pending deadline, and dispatches the task right away.
+ */
+- (void)scheduleAfter:(NSTimeInterval)delay NS_SWIFT_NAME(schedule(after:));
+
+- (void)cancel;
+
+@property (readonly, getter=isScheduled) BOOL scheduled;
+
+@end
+
+/**
+ A hashed timer wheel, shared by the SDK's debouncers and schedulers.
+
+ Timeouts are hashed by deadline into a fixed ring of slots. A single one-shot timer source, on a background queue, is
+ armed for the earliest pending deadline: it fires the timeouts of the slots the clock went through, and doesn't wake
+ up while nothing is due. Timeouts further away than a revolution stay in their slot until their deadline is reached.
+ Deadlines are rounded up to the next tick, and use the monotonic clock. Tasks without a delay are dispatched right
+ away.
+ */
+@interface BATimerWheel : NSObject
+
++ (nonnull BATimerWheel *)sharedWheel;
+
+- (nonnull instancetype)init NS_UNAVAILABLE;
+
+- (nonnull instancetype)initWithTickInterval:(NSTimeInterval)tickInterval NS_DESIGNATED_INITIALIZER;
+
+/**
+ Run a task once after a delay, like dispatch_after, without creating a timer.
+ The returned timeout can be used to cancel or postpone the task.
+ */
+- (nonnull BATimerWheelTimeout *)dispatchAfter:(NSTimeInterval)delay
+                                         queue:(nonnull dispatch_queue_t)queue
+                                          task:(nonnull dispatch_block_t)taskBlock
+    NS_SWIFT_NAME(dispatch(after:queue:task:));
+
+@property (readonly) NSTimeInterval tickInterval;
+
+/**
+ Number of pending timeouts
+ */
+@property (readonly) NSUInteger pendingCount;
+
+@end
@@ -0,0 +1,294 @@
+//
+//  BATimerWheel.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BATimerWheel.h>
+#import <Batch/BAUptimeProvider.h>
+
+#import <os/lock.h>
+
+/// Number of slots of the wheel: a revolution of the shared wheel lasts 51.2 seconds
+#define SLOT_COUNT 512
+
+/// Resolution of the shared wheel (in seconds)
+#define DEFAULT_TICK_INTERVAL 0.1
+
+@interface BATimerWheelTimeout () {
+  @public
+    dispatch_queue_t _queue;
+    dispatch_block_t _taskBlock;
+
+    // Guarded by the wheel's lock
+    uint64_t _deadlineTick;
+    NSUInteger _slot;
+    BOOL _scheduled;
+    // Slots own their timeouts through the next pointers
+    BATimerWheelTimeout *_next;
+    __unsafe_unretained BATimerWheelTimeout *_previous;
+
+    // Only used by the tick, to fire expired timeouts once the lock is released
+    BATimerWheelTimeout *_nextExpired;
+}
+@end
+
+@interface BATimerWheel ()
+
+- (void)scheduleTimeout:(BATimerWheelTimeout *)timeout after:(NSTimeInterval)delay;
+
+- (void)cancelTimeout:(BATimerWheelTimeout *)timeout;
+
+- (BOOL)isTimeoutScheduled:(BATimerWheelTimeout *)timeout;
+
+@end
+
+@implementation BATimerWheelTimeout {
+    BATimerWheel *_wheel;
+}
+
+- (instancetype)initWithWheel:(BATimerWheel *)wheel queue:(dispatch_queue_t)queue task:(dispatch_block_t)taskBlock {
+    self = [super init];
+    if (self) {
+        _wheel = wheel;
+        _queue = queue;
+        _taskBlock = taskBlock;
+    }
+    return self;
+}
+
+- (void)scheduleAfter:(NSTimeInterval)delay {
+    [_wheel scheduleTimeout:self after:delay];
+}
+
+- (void)cancel {
+    [_wheel cancelTimeout:self];
+}
+
+- (BOOL)isScheduled {
+    return [_wheel isTimeoutScheduled:self];
+}
+
+@end
+
+@implementation BATimerWheel {
+    dispatch_queue_t _queue;
+    dispatch_source_t _tickSource;
+    uint64_t _tickNanoseconds;
+    uint64_t _startUptime;
+    os_unfair_lock _lock;
+
+    // Everything below is guarded by the lock
+    BATimerWheelTimeout *_slots[SLOT_COUNT];
+    uint64_t _lastProcessedTick;
+    NSUInteger _pendingCount;
+    // Tick the source is armed for, or UINT64_MAX when it is disarmed
+    uint64_t _armedTick;
+}
+
++ (BATimerWheel *)sharedWheel {
+    static BATimerWheel *wheel = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      wheel = [[BATimerWheel alloc] initWithTickInterval:DEFAULT_TICK_INTERVAL];
+    });
+    return wheel;
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval {
+    self = [super init];
+    if (self) {
+        _tickInterval = tickInterval;
+        _tickNanoseconds = MAX((uint64_t)(tickInterval * NSEC_PER_SEC), 1);
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _startUptime = [BAUptimeProvider uptimeNanoseconds];
+        _lastProcessedTick = 0;
+        _pendingCount = 0;
+        _armedTick = UINT64_MAX;
+
+        _queue = dispatch_queue_create("com.batch.ios.timerwheel", NULL);
+        _tickSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+        __weak BATimerWheel *weakSelf = self;
+        dispatch_source_set_event_handler(_tickSource, ^{
+          [weakSelf tick];
+        });
+        // The source stays disarmed until a timeout is scheduled
+        dispatch_source_set_timer(_tickSource, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_tickSource);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    dispatch_source_cancel(_tickSource);
+}
+
+- (NSUInteger)pendingCount {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger pendingCount = _pendingCount;
+    os_unfair_lock_unlock(&_lock);
+    return pendingCount;
+}
+
+- (BATimerWheelTimeout *)dispatchAfter:(NSTimeInterval)delay
+                                 queue:(dispatch_queue_t)queue
+                                  task:(dispatch_block_t)taskBlock {
+    BATimerWheelTimeout *timeout = [[BATimerWheelTimeout alloc] initWithWheel:self queue:queue task:taskBlock];
+    [timeout scheduleAfter:delay];
+    return timeout;
+}
+
+#pragma mark - Timeouts
+
+- (void)scheduleTimeout:(BATimerWheelTimeout *)timeout after:(NSTimeInterval)delay {
+    if (delay <= 0) {
+        // Nothing to wait for: don't delay the task until the next tick
+        [self cancelTimeout:timeout];
+        dispatch_async(timeout->_queue, timeout->_taskBlock);
+        return;
+    }
+
+    uint64_t now = [BAUptimeProvider uptimeNanoseconds] - _startUptime;
+    uint64_t delayNanoseconds = delay > 0 ? (uint64_t)(delay * NSEC_PER_SEC) : 0;
+    // Round up, so that timeouts never fire early
+    uint64_t deadlineTick = (now + delayNanoseconds + _tickNanoseconds - 1) / _tickNanoseconds;
+
+    os_unfair_lock_lock(&_lock);
+    if (timeout->_scheduled) {
+        [self unlinkTimeout:timeout];
+    }
+    if (_pendingCount == 0) {
+        // Nothing is pending: there are no slots to catch up with
+        _lastProcessedTick = now / _tickNanoseconds;
+    }
+    deadlineTick = MAX(deadlineTick, _lastProcessedTick + 1);
+    [self linkTimeout:timeout deadlineTick:deadlineTick];
+    if (deadlineTick < _armedTick) {
+        [self armTickSourceForTick:deadlineTick now:now];
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)cancelTimeout:(BATimerWheelTimeout *)timeout {
+    os_unfair_lock_lock(&_lock);
+    if (timeout->_scheduled) {
+        [self unlinkTimeout:timeout];
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (BOOL)isTimeoutScheduled:(BATimerWheelTimeout *)timeout {
+    os_unfair_lock_lock(&_lock);
+    BOOL scheduled = timeout->_scheduled;
+    os_unfair_lock_unlock(&_lock);
+    return scheduled;
+}
+
+- (void)linkTimeout:(BATimerWheelTimeout *)timeout deadlineTick:(uint64_t)deadlineTick {
+    NSUInteger slot = (NSUInteger)(deadlineTick % SLOT_COUNT);
+    timeout->_deadlineTick = deadlineTick;
+    timeout->_slot = slot;
+    timeout->_scheduled = YES;
+    timeout->_previous = nil;
+    timeout->_next = _slots[slot];
+    if (_slots[slot] != nil) {
+        _slots[slot]->_previous = timeout;
+    }
+    _slots[slot] = timeout;
+    _pendingCount++;
+}
+
+- (void)unlinkTimeout:(BATimerWheelTimeout *)timeout {
+    // The slot may hold the last reference to the timeout
+    BATimerWheelTimeout *retainedTimeout = timeout;
+    BATimerWheelTimeout *next = retainedTimeout->_next;
+    if (retainedTimeout->_previous != nil) {
+        retainedTimeout->_previous->_next = next;
+    } else {
+        _slots[retainedTimeout->_slot] = next;
+    }
+    if (next != nil) {
+        next->_previous = retainedTimeout->_previous;
+    }
+    retainedTimeout->_next = nil;
+    retainedTimeout->_previous = nil;
+    retainedTimeout->_scheduled = NO;
+    _pendingCount--;
+}
+
+#pragma mark - Ticking
+
+// Arms the source to fire once, when the tick is reached.
+// The leeway lets the system coalesce the wake up with others: deadlines are only precise to a tick anyway.
+- (void)armTickSourceForTick:(uint64_t)tick now:(uint64_t)now {
+    _armedTick = tick;
+    uint64_t fireTime = tick * _tickNanoseconds;
+    int64_t delay = fireTime > now ? (int64_t)(fireTime - now) : 0;
+    dispatch_source_set_timer(_tickSource, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER,
+                              _tickNanoseconds);
+}
+
+// Finds the earliest deadline of the pending timeouts, or UINT64_MAX if there are none.
+// Slots are visited in deadline order from the current tick: the first timeout due in the current revolution is the
+// earliest.
+- (uint64_t)earliestDeadlineTickAfter:(uint64_t)currentTick {
+    uint64_t earliestTick = UINT64_MAX;
+    for (uint64_t i = 1; i <= SLOT_COUNT && _pendingCount > 0; i++) {
+        BATimerWheelTimeout *timeout = _slots[(currentTick + i) % SLOT_COUNT];
+        while (timeout != nil) {
+            if (timeout->_deadlineTick <= currentTick + i) {
+                return timeout->_deadlineTick;
+            }
+            earliestTick = MIN(earliestTick, timeout->_deadlineTick);
+            timeout = timeout->_next;
+        }
+    }
+    return earliestTick;
+}
+
+- (void)tick {
+    uint64_t now = [BAUptimeProvider uptimeNanoseconds] - _startUptime;
+    uint64_t currentTick = now / _tickNanoseconds;
+
+    // Expired timeouts are fired, and maybe released, outside of the lock: releasing a task may run code that
+    // schedules another timeout
+    BATimerWheelTimeout *expired = nil;
+
+    os_unfair_lock_lock(&_lock);
+    // The source is one-shot: it needs to be armed again for the next deadline, if any
+    _armedTick = UINT64_MAX;
+    if (currentTick > _lastProcessedTick) {
+        // After a long pause, every slot has to be visited once, but not more
+        uint64_t elapsedTicks = MIN(currentTick - _lastProcessedTick, (uint64_t)SLOT_COUNT);
+        for (uint64_t i = 1; i <= elapsedTicks; i++) {
+            BATimerWheelTimeout *timeout = _slots[(_lastProcessedTick + i) % SLOT_COUNT];
+            while (timeout != nil) {
+                BATimerWheelTimeout *next = timeout->_next;
+                // Timeouts due in a later revolution stay in their slot
+                if (timeout->_deadlineTick <= currentTick) {
+                    [self unlinkTimeout:timeout];
+                    timeout->_nextExpired = expired;
+                    expired = timeout;
+                }
+                timeout = next;
+            }
+        }
+        _lastProcessedTick = currentTick;
+    }
+
+    uint64_t nextTick = [self earliestDeadlineTickAfter:currentTick];
+    if (nextTick != UINT64_MAX) {
+        [self armTickSourceForTick:MAX(nextTick, currentTick + 1) now:now];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    while (expired != nil) {
+        dispatch_async(expired->_queue, expired->_taskBlock);
+        BATimerWheelTimeout *next = expired->_nextExpired;
+        expired->_nextExpired = nil;
+        expired = next;
+    }
+}
+
+@end
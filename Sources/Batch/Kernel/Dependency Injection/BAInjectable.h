@@ -16,6 +16,13 @@ typedef _Nullable id (^BAInjectableInitializer)(void);
  */
 + (nonnull BAInjectable *)injectableWithInitializer:(nonnull BAInjectableInitializer)initializer;
 
+/**
+ Make an injectable using an initializer block, called once: the same instance is returned on each injection.
+ Unlike the block of injectableWithInitializer:, it can be cached by the registry.
+ */
++ (nonnull BAInjectable *)injectableWithSingletonInitializer:(nonnull BAInjectableInitializer)initializer
+    NS_SWIFT_NAME(singleton(initializer:));
+
 /**
 Make an injectable for an instance. The given instance will be returned directly.
 */
@@ -26,4 +33,9 @@ Make an injectable for an instance. The given instance will be returned directly
  */
 - (nullable id)resolveInstance;
 
+/**
+ Whether the resolved instance is always the same, in which case the registry caches it
+ */
+@property (readonly) BOOL cacheable;
+
 @end
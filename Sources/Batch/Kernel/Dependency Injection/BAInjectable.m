@@ -17,6 +17,10 @@
     return [[BABlockInitializerInjectable alloc] initWithInitializer:initializer];
 }
 
++ (nonnull BAInjectable *)injectableWithSingletonInitializer:(nonnull BAInjectableInitializer)initializer {
+    return [[BASingletonInjectable alloc] initWithInitializer:initializer];
+}
+
 + (nonnull BAInjectable *)injectableWithInstance:(nullable id)instance {
     return [[BAInstanceInjectable alloc] initWithInstance:instance];
 }
@@ -27,6 +31,10 @@
     return nil;
 }
 
+- (BOOL)cacheable {
+    return false;
+}
+
 #pragma mark Other
 
 - (NSString *)description {
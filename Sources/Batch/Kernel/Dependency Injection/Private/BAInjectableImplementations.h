@@ -26,3 +26,12 @@
 - (nonnull instancetype)initWithInitializer:(nonnull BAInjectableInitializer)initializer;
 
 @end
+
+/**
+ A BAInjectable that uses a block to create its value once
+ */
+@interface BASingletonInjectable : BAInjectable
+
+- (nonnull instancetype)initWithInitializer:(nonnull BAInjectableInitializer)initializer;
+
+@end
@@ -7,6 +7,8 @@
 
 #import <Batch/BAInjectableImplementations.h>
 
+#import <os/lock.h>
+
 /**
  BAInjectable class cluster
  */
@@ -27,6 +29,10 @@
     return _instance;
 }
 
+- (BOOL)cacheable {
+    return true;
+}
+
 - (NSString *)description {
     return [NSString stringWithFormat:@"BAInjectable - Instance: %@", _instance];
 }
@@ -54,3 +60,42 @@
 }
 
 @end
+
+@implementation BASingletonInjectable {
+    BAInjectableInitializer _initializer;
+    os_unfair_lock _lock;
+    BOOL _resolved;
+    id _instance;
+}
+
+- (nonnull instancetype)initWithInitializer:(nonnull BAInjectableInitializer)initializer {
+    self = [super init];
+    if (self) {
+        _initializer = initializer;
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (id)resolveInstance {
+    os_unfair_lock_lock(&_lock);
+    if (!_resolved) {
+        // The initializer may inject other dependencies, but never this one: it can run under the lock
+        _instance = _initializer();
+        _resolved = true;
+        _initializer = nil;
+    }
+    id instance = _instance;
+    os_unfair_lock_unlock(&_lock);
+    return instance;
+}
+
+- (BOOL)cacheable {
+    return true;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"BAInjectable - Singleton: %@", _resolved ? _instance : @"unresolved"];
+}
+
+@end
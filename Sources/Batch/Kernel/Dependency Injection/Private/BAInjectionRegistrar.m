@@ -6,17 +6,21 @@
 
 #import "BAInjectionRegistrar.h"
 #import <Batch/Batch-Swift.h>
+#import "BACSSDocumentCache.h"
 #import "BAEventDispatcherCenter.h"
 #import "BAInboxSQLiteDatasource.h"
 #import "BAInboxSQLiteHelper.h"
 #import "BAInjection.h"
 #import "BAInstallDataEditor.h"
+#import "BAMSGAssetPrefetcher.h"
+#import "BAMSGImagePipeline.h"
 #import "BALocalCampaignsFilePersistence.h"
 #import "BAMessagingAnalyticsDeduplicatingDelegate.h"
 #import "BAMessagingCenter.h"
 #import "BAMetricManager.h"
 #import "BAMetricRegistry.h"
 #import "BAPushSystemHelper.h"
+#import "BATGIFFrameCache.h"
 #import "BATrackerCenter.h"
 #import "BAUserSQLiteDatasource.h"
 
@@ -36,13 +40,8 @@
                         forProtocol:@protocol(BATEventTrackerProtocol)];
 
     // Register BAEventDispatcherCenter
-    [BAInjection registerInjectable:[BAInjectable injectableWithInitializer:^id() {
-                   static id singleInstance = nil;
-                   static dispatch_once_t once;
-                   dispatch_once(&once, ^{
-                     singleInstance = [BAEventDispatcherCenter new];
-                   });
-                   return singleInstance;
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [BAEventDispatcherCenter new];
                  }]
                            forClass:BAEventDispatcherCenter.class];
 
@@ -57,7 +56,7 @@
                         forProtocol:@protocol(BAPushSystemHelperProtocol)];
 
     // Register BAMessagingCenter
-    [BAInjection registerInjectable:[BAInjectable injectableWithInitializer:^id() {
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
                    return [BAMessagingCenter instance];
                  }]
                            forClass:BAMessagingCenter.class];
@@ -69,6 +68,30 @@
                  }]
                         forProtocol:@protocol(BAMessagingAnalyticsDelegate)];
 
+    // Register BAMSGImagePipeline
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [BAMSGImagePipeline sharedPipeline];
+                 }]
+                           forClass:BAMSGImagePipeline.class];
+
+    // Register BAMSGAssetPrefetcher
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [BAMSGAssetPrefetcher sharedPrefetcher];
+                 }]
+                           forClass:BAMSGAssetPrefetcher.class];
+
+    // Register BATGIFFrameCache
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [BATGIFFrameCache sharedCache];
+                 }]
+                           forClass:BATGIFFrameCache.class];
+
+    // Register BACSSDocumentCache
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [BACSSDocumentCache sharedCache];
+                 }]
+                           forClass:BACSSDocumentCache.class];
+
     // Register BAUserSQLiteDatasource
     [BAInjection registerInjectable:[BAInjectable injectableWithInstance:[BAUserSQLiteDatasource instance]]
                         forProtocol:@protocol(BAUserDatasourceProtocol)];
@@ -86,25 +109,20 @@
                            forClass:BATProfileEditor.class];
 
     // Register BAInboxSQLiteDatasource
-    [BAInjection registerInjectable:[BAInjectable injectableWithInitializer:^id() {
-                   static id singleInstance = nil;
-                   static dispatch_once_t once;
-                   dispatch_once(&once, ^{
-                     singleInstance = [[BAInboxSQLiteDatasource alloc] initWithFilename:@"ba_in.db"
-                                                                            forDBHelper:[BAInboxSQLiteHelper new]];
-                   });
-                   return singleInstance;
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
+                   return [[BAInboxSQLiteDatasource alloc] initWithFilename:@"ba_in.db"
+                                                                forDBHelper:[BAInboxSQLiteHelper new]];
                  }]
                         forProtocol:@protocol(BAInboxDatasourceProtocol)];
 
     // Register MetricManager
-    [BAInjection registerInjectable:[BAInjectable injectableWithInitializer:^id() {
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
                    return [BAMetricManager sharedInstance];
                  }]
                            forClass:BAMetricManager.class];
 
     // Register MetricRegistry
-    [BAInjection registerInjectable:[BAInjectable injectableWithInitializer:^id() {
+    [BAInjection registerInjectable:[BAInjectable injectableWithSingletonInitializer:^id() {
                    return [BAMetricRegistry instance];
                  }]
                            forClass:BAMetricRegistry.class];
@@ -8,6 +8,9 @@
 #import <Batch/BAInjectionRegistrar.h>
 #import <Batch/BAInjectionRegistry.h>
 
+#import <os/lock.h>
+#import <stdatomic.h>
+
 @interface BAInjectionRegistry () {
     NSMapTable<Class, BAInjectable *> *_classInjectables;
     NSMapTable<Protocol *, BAInjectable *> *_protocolInjectables;
@@ -16,6 +19,14 @@
 
     NSObject *_registrationLockToken;
     NSObject *_overlaysLockToken;
+
+    /// Instances of the cacheable injectables, by class or protocol. NSNull stands for nil instances.
+    /// Classes and protocols live as long as the process: they are keyed by identity, without retaining them.
+    NSMapTable *_resolvedInstances;
+    os_unfair_lock _resolvedInstancesLock;
+
+    /// Bumped whenever a registration or an overlay changes: instances resolved before are stale
+    _Atomic(uint64_t) _generation;
 }
 @end
 
@@ -40,6 +51,12 @@
         _overlaysTable = nil;
         _registrationLockToken = [NSObject new];
         _overlaysLockToken = [NSObject new];
+        _resolvedInstances = [[NSMapTable alloc]
+            initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality
+                  valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPersonality
+                      capacity:32];
+        _resolvedInstancesLock = OS_UNFAIR_LOCK_INIT;
+        atomic_init(&_generation, 0);
     }
     return self;
 }
@@ -52,6 +69,7 @@
         [newInjectables setObject:injectable forKey:classToRegister];
         _classInjectables = newInjectables;
     }
+    [self invalidateResolvedInstances];
 }
 
 - (void)registerInjectable:(nonnull BAInjectable *)injectable forProtocol:(nonnull Protocol *)protocol {
@@ -60,28 +78,74 @@
         [newInjectables setObject:injectable forKey:protocol];
         _protocolInjectables = newInjectables;
     }
+    [self invalidateResolvedInstances];
 }
 
 #pragma mark Injection
 
 - (nullable id)injectClass:(Class _Nonnull)classToInject {
+    id cachedInstance = [self cachedInstanceForKey:classToInject];
+    if (cachedInstance != nil) {
+        return cachedInstance != [NSNull null] ? cachedInstance : nil;
+    }
+
     [self registerInjectablesIfNeeded];
-    id instance = [[_classInjectables objectForKey:classToInject] resolveInstance];
-    if (_overlaysTable != nil) {
+    uint64_t generation = atomic_load_explicit(&_generation, memory_order_acquire);
+    BAInjectable *injectable = [_classInjectables objectForKey:classToInject];
+    id instance = [injectable resolveInstance];
+    if (_overlaysTable != nil && [self hasOverlayForKey:classToInject]) {
         return [self overlayedClass:classToInject originalInstance:instance];
     }
+    if (injectable.cacheable) {
+        [self cacheInstance:instance forKey:classToInject generation:generation];
+    }
     return instance;
 }
 
 - (nullable id)injectProtocol:(nonnull Protocol *)protocolToInject {
+    id cachedInstance = [self cachedInstanceForKey:protocolToInject];
+    if (cachedInstance != nil) {
+        return cachedInstance != [NSNull null] ? cachedInstance : nil;
+    }
+
     [self registerInjectablesIfNeeded];
-    id instance = [[_protocolInjectables objectForKey:protocolToInject] resolveInstance];
-    if (_overlaysTable != nil) {
+    uint64_t generation = atomic_load_explicit(&_generation, memory_order_acquire);
+    BAInjectable *injectable = [_protocolInjectables objectForKey:protocolToInject];
+    id instance = [injectable resolveInstance];
+    if (_overlaysTable != nil && [self hasOverlayForKey:protocolToInject]) {
         return [self overlayedProtocol:protocolToInject originalInstance:instance];
     }
+    if (injectable.cacheable) {
+        [self cacheInstance:instance forKey:protocolToInject generation:generation];
+    }
+    return instance;
+}
+
+#pragma mark Resolved instances cache
+
+- (nullable id)cachedInstanceForKey:(id)key {
+    os_unfair_lock_lock(&_resolvedInstancesLock);
+    id instance = [_resolvedInstances objectForKey:key];
+    os_unfair_lock_unlock(&_resolvedInstancesLock);
     return instance;
 }
 
+- (void)cacheInstance:(nullable id)instance forKey:(id)key generation:(uint64_t)generation {
+    os_unfair_lock_lock(&_resolvedInstancesLock);
+    // If anything changed while the instance was resolved, it may be stale: let the next injection resolve it again
+    if (atomic_load_explicit(&_generation, memory_order_acquire) == generation) {
+        [_resolvedInstances setObject:(instance != nil ? instance : [NSNull null]) forKey:key];
+    }
+    os_unfair_lock_unlock(&_resolvedInstancesLock);
+}
+
+- (void)invalidateResolvedInstances {
+    os_unfair_lock_lock(&_resolvedInstancesLock);
+    atomic_fetch_add_explicit(&_generation, 1, memory_order_release);
+    [_resolvedInstances removeAllObjects];
+    os_unfair_lock_unlock(&_resolvedInstancesLock);
+}
+
 #pragma mark Registration
 
 - (void)registerInjectablesIfNeeded {
@@ -137,6 +201,7 @@
             }
         }
     }
+    [self invalidateResolvedInstances];
 }
 
 #pragma mark -
@@ -151,6 +216,12 @@
     }
 }
 
+- (BOOL)hasOverlayForKey:(id)key {
+    @synchronized(_overlaysTable) {
+        return [_overlaysTable objectForKey:key] != nil;
+    }
+}
+
 - (id)overlayedProtocol:(Protocol *)protocolToInject originalInstance:(id)originalInstance {
     @synchronized(_overlaysTable) {
         BAOverlayedInjectable *overlay = [_overlaysTable objectForKey:protocolToInject];
@@ -176,6 +247,8 @@
     @synchronized(_overlaysTable) {
         [_overlaysTable setObject:overlay forKey:key];
     }
+    // Overlaid keys are never cached, but the key may have been cached before
+    [self invalidateResolvedInstances];
 }
 
 @end
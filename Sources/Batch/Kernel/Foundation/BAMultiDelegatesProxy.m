@@ -8,13 +8,42 @@
 
 #import <Batch/BAMultiDelegatesProxy.h>
 
+#import <os/lock.h>
+
+/**
+ How a selector is forwarded: which delegates respond to it, and its signature.
+ Delegates are referenced by their index in the pointer array, so that they stay weak.
+ */
+@interface BAMultiDelegatesDispatchEntry : NSObject {
+  @public
+    /// nil if no delegate responds to the selector
+    NSMethodSignature *_signature;
+    BOOL _returnsValue;
+    BOOL _mainDelegateResponds;
+    NSUInteger *_delegateIndexes;
+    NSUInteger _delegateIndexesCount;
+}
+@end
+
+@implementation BAMultiDelegatesDispatchEntry
+
+- (void)dealloc {
+    free(_delegateIndexes);
+}
+
+@end
+
 @interface BAMultiDelegatesProxy ()
 
 @property (nonatomic, strong) NSPointerArray *delegatesPointerArray;
 
 @end
 
-@implementation BAMultiDelegatesProxy
+@implementation BAMultiDelegatesProxy {
+    os_unfair_lock _dispatchCacheLock;
+    /// Dispatch entries keyed by selector, cleared when the delegates change
+    NSMapTable<id, BAMultiDelegatesDispatchEntry *> *_dispatchCache;
+}
 
 #pragma mark -
 #pragma mark Initialization
@@ -25,8 +54,12 @@
 }
 
 - (id)initWithMainDelegate:(id)mainDelegate other:(NSArray *)delegates {
-    [self setDelegates:delegates];
+    _dispatchCacheLock = OS_UNFAIR_LOCK_INIT;
+    _dispatchCache = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory |
+                                                        NSPointerFunctionsOpaquePersonality
+                                           valueOptions:NSPointerFunctionsStrongMemory];
     _mainDelegate = mainDelegate;
+    [self setDelegates:delegates];
 
     return self;
 }
@@ -38,34 +71,74 @@
 }
 
 #pragma mark -
-#pragma mark Message Forwarding
+#pragma mark Dispatch cache
+
+- (BAMultiDelegatesDispatchEntry *)dispatchEntryForSelector:(SEL)selector
+                                                   delegates:(NSPointerArray *__autoreleasing *)delegatesOut {
+    NSPointerArray *delegates;
+    os_unfair_lock_lock(&_dispatchCacheLock);
+    delegates = _delegatesPointerArray;
+    BAMultiDelegatesDispatchEntry *entry = [_dispatchCache objectForKey:(__bridge id)(void *)selector];
+    os_unfair_lock_unlock(&_dispatchCacheLock);
+
+    if (entry == nil) {
+        // Delegates may run code when asked whether they respond: build the entry outside of the lock
+        entry = [self makeDispatchEntryForSelector:selector delegates:delegates];
+
+        os_unfair_lock_lock(&_dispatchCacheLock);
+        // Don't cache an entry built for delegates that have been replaced meanwhile
+        if (delegates == _delegatesPointerArray) {
+            [_dispatchCache setObject:entry forKey:(__bridge id)(void *)selector];
+        }
+        os_unfair_lock_unlock(&_dispatchCacheLock);
+    }
 
-// First we are asked if we respond to a selector
-- (BOOL)respondsToSelector:(SEL)aSelector {
-    if ([self.mainDelegate respondsToSelector:aSelector]) {
-        return YES;
+    if (delegatesOut != NULL) {
+        *delegatesOut = delegates;
     }
+    return entry;
+}
 
-    for (id delegateObj in self.delegatesPointerArray.allObjects) {
-        if ([delegateObj respondsToSelector:aSelector]) {
-            return YES;
+- (BAMultiDelegatesDispatchEntry *)makeDispatchEntryForSelector:(SEL)selector delegates:(NSPointerArray *)delegates {
+    BAMultiDelegatesDispatchEntry *entry = [BAMultiDelegatesDispatchEntry new];
+
+    NSUInteger count = [delegates count];
+    if (count > 0) {
+        entry->_delegateIndexes = malloc(count * sizeof(NSUInteger));
+    }
+    for (NSUInteger i = 0; i < count; i++) {
+        id delegateObj = (__bridge id)[delegates pointerAtIndex:i];
+        if ([delegateObj respondsToSelector:selector]) {
+            entry->_delegateIndexes[entry->_delegateIndexesCount++] = i;
+            if (entry->_signature == nil) {
+                entry->_signature = [delegateObj methodSignatureForSelector:selector];
+            }
         }
     }
 
-    return NO;
+    // The main delegate's signature wins
+    entry->_mainDelegateResponds = [self.mainDelegate respondsToSelector:selector];
+    if (entry->_mainDelegateResponds) {
+        entry->_signature = [self.mainDelegate methodSignatureForSelector:selector];
+    }
+    entry->_returnsValue = entry->_signature != nil && entry->_signature.methodReturnLength > 0;
+
+    return entry;
+}
+
+#pragma mark -
+#pragma mark Message Forwarding
+
+// First we are asked if we respond to a selector
+- (BOOL)respondsToSelector:(SEL)aSelector {
+    return [self dispatchEntryForSelector:aSelector delegates:NULL]->_signature != nil;
 }
 
 // Then we are asked for the method signature for that selector
 - (NSMethodSignature *)methodSignatureForSelector:(SEL)selector {
-    // Check if the main delegate knows this selector before
-    if ([self.mainDelegate respondsToSelector:selector]) {
-        return [self.mainDelegate methodSignatureForSelector:selector];
-    }
-
-    for (id delegateObj in self.delegatesPointerArray.allObjects) {
-        if ([delegateObj respondsToSelector:selector]) {
-            return [delegateObj methodSignatureForSelector:selector];
-        }
+    NSMethodSignature *signature = [self dispatchEntryForSelector:selector delegates:NULL]->_signature;
+    if (signature != nil) {
+        return signature;
     }
 
     [[NSException exceptionWithName:NSInternalInconsistencyException
@@ -78,27 +151,27 @@
 
 // Once we answered, we forward the invocation
 - (void)forwardInvocation:(NSInvocation *)invocation {
-    // Check if method can return something.
-    BOOL methodReturnSomething = (![[NSString stringWithCString:invocation.methodSignature.methodReturnType
-                                                       encoding:NSUTF8StringEncoding] isEqualToString:@"v"]);
-
-    // Make another fake invocation with the same method signature and send the same messages to the other delegates
-    // (ignoring return values).
-    NSInvocation *targetInvocation = invocation;
-    if (methodReturnSomething) {
-        targetInvocation = [NSInvocation invocationWithMethodSignature:invocation.methodSignature];
-        [targetInvocation setSelector:invocation.selector];
-    }
-
-    for (id delegateObj in self.delegatesPointerArray.allObjects) {
-        if ([delegateObj respondsToSelector:invocation.selector]) {
-            [targetInvocation invokeWithTarget:delegateObj];
+    NSPointerArray *delegates;
+    BAMultiDelegatesDispatchEntry *entry = [self dispatchEntryForSelector:invocation.selector delegates:&delegates];
+
+    // Send the same message to the other delegates. The main delegate is invoked last: its return value is the one
+    // left in the invocation.
+    for (NSUInteger i = 0; i < entry->_delegateIndexesCount; i++) {
+        id delegateObj = (__bridge id)[delegates pointerAtIndex:entry->_delegateIndexes[i]];
+        // Weak delegates may be gone
+        if (delegateObj != nil) {
+            [invocation invokeWithTarget:delegateObj];
         }
     }
 
     // Send invocation to the main delegate and use it's return value.
-    if ([self.mainDelegate respondsToSelector:invocation.selector]) {
+    if (entry->_mainDelegateResponds) {
         [invocation invokeWithTarget:self.mainDelegate];
+    } else if (entry->_returnsValue && entry->_delegateIndexesCount > 0) {
+        // Return values of the other delegates are ignored
+        void *zeroValue = calloc(1, invocation.methodSignature.methodReturnLength);
+        [invocation setReturnValue:zeroValue];
+        free(zeroValue);
     }
 }
 
@@ -106,14 +179,22 @@
 #pragma mark Properties
 
 - (void)setDelegates:(NSArray *)newDelegates {
-    self.delegatesPointerArray = [NSPointerArray weakObjectsPointerArray];
-    [newDelegates enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
-      [self.delegatesPointerArray addPointer:(void *)obj];
-    }];
+    NSPointerArray *delegatesPointerArray = [NSPointerArray weakObjectsPointerArray];
+    for (id delegateObj in newDelegates) {
+        [delegatesPointerArray addPointer:(__bridge void *)delegateObj];
+    }
+
+    os_unfair_lock_lock(&_dispatchCacheLock);
+    _delegatesPointerArray = delegatesPointerArray;
+    [_dispatchCache removeAllObjects];
+    os_unfair_lock_unlock(&_dispatchCacheLock);
 }
 
 - (NSArray *)delegates {
-    return self.delegatesPointerArray.allObjects;
+    os_unfair_lock_lock(&_dispatchCacheLock);
+    NSPointerArray *delegatesPointerArray = _delegatesPointerArray;
+    os_unfair_lock_unlock(&_dispatchCacheLock);
+    return delegatesPointerArray.allObjects;
 }
 
 @end
@@ -7,8 +7,19 @@
 
 #import <Foundation/Foundation.h>
 
+/// Monotonic clock, to use for durations, throttles and timeouts.
+/// Its time is the time elapsed since boot, including the time spent in deep sleep: unlike the wall clock, it never
+/// jumps when the user or the network changes the date.
 @interface BAUptimeProvider : NSObject
 
+/// Time since boot, in seconds
 + (NSTimeInterval)uptime;
 
+/// Time since boot, in nanoseconds
++ (uint64_t)uptimeNanoseconds;
+
+/// Seconds elapsed since a previous value of uptimeNanoseconds
++ (NSTimeInterval)secondsSinceUptimeNanoseconds:(uint64_t)uptimeNanoseconds
+    NS_SWIFT_NAME(secondsSince(uptimeNanoseconds:));
+
 @end
@@ -7,33 +7,42 @@
 
 #import <Batch/BAUptimeProvider.h>
 
-#include <errno.h>
-#include <sys/sysctl.h>
-#include <time.h>
+#include <mach/mach_time.h>
 
 @implementation BAUptimeProvider
 
 // Gets the real uptime, including the time spent in deep sleep
 // [[NSProcessInfo processInfo] systemUptime] drifts, even
 // if the documentation doesn't say so.
-+ (NSTimeInterval)uptime {
-    struct timeval boottime;
-    int mib[2] = {CTL_KERN, KERN_BOOTTIME};
-    size_t size = sizeof(boottime);
-    time_t now;
-    time_t uptime = -1;
-
-    time(&now);
-
-    if (sysctl(mib, 2, &boottime, &size, NULL, 0) != -1 && boottime.tv_sec != 0) {
-        uptime = now - boottime.tv_sec;
+// mach_continuous_time is cheap, but its ticks need converting: the timebase is only read once.
++ (uint64_t)uptimeNanoseconds {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      if (mach_timebase_info(&timebase) != KERN_SUCCESS || timebase.denom == 0) {
+          timebase.numer = 1;
+          timebase.denom = 1;
+      }
+    });
+
+    uint64_t ticks = mach_continuous_time();
+    if (timebase.numer == timebase.denom) {
+        return ticks;
     }
+    // Split the multiplication so that it doesn't overflow after a few days of uptime
+    return (ticks / timebase.denom) * timebase.numer + (ticks % timebase.denom) * timebase.numer / timebase.denom;
+}
 
-    if (uptime == -1) {
-        return [[NSProcessInfo processInfo] systemUptime];
-    }
++ (NSTimeInterval)uptime {
+    return (NSTimeInterval)[self uptimeNanoseconds] / NSEC_PER_SEC;
+}
 
-    return uptime;
++ (NSTimeInterval)secondsSinceUptimeNanoseconds:(uint64_t)uptimeNanoseconds {
+    uint64_t now = [self uptimeNanoseconds];
+    if (now < uptimeNanoseconds) {
+        return 0;
+    }
+    return (NSTimeInterval)(now - uptimeNanoseconds) / NSEC_PER_SEC;
 }
 
 @end
@@ -8,19 +8,55 @@
 
 #import <Batch/BARandom.h>
 
+#import <os/lock.h>
+
+/// Size of the random bytes pool, refilled from the CSPRNG in one call when exhausted
+#define RANDOM_POOL_SIZE 256
+
+static const char alphanumericCharacters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+/// Number of alphanumeric characters
+#define ALPHANUMERIC_COUNT 62
+
+/// Random bytes at or above this value are rejected: keeping them would make the first characters more likely
+#define ALPHANUMERIC_REJECTION_THRESHOLD (256 - (256 % ALPHANUMERIC_COUNT))
+
+static os_unfair_lock randomPoolLock = OS_UNFAIR_LOCK_INIT;
+static uint8_t randomPool[RANDOM_POOL_SIZE];
+static NSUInteger randomPoolOffset = RANDOM_POOL_SIZE;
+
 @implementation BARandom
 
 // Generate a random [0-9][a-z][A-Z] string.
 + (NSString *)randomAlphanumericStringWithLength:(int)length {
-    static NSString *letters = @"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    if (length <= 0) {
+        return @"";
+    }
 
-    NSMutableString *randomString = [NSMutableString stringWithCapacity:length];
+    char *characters = malloc((size_t)length);
+    if (characters == NULL) {
+        return @"";
+    }
 
-    for (int i = 0; i < length; i++) {
-        [randomString appendFormat:@"%C", [letters characterAtIndex:arc4random() % [letters length]]];
+    os_unfair_lock_lock(&randomPoolLock);
+    int count = 0;
+    while (count < length) {
+        if (randomPoolOffset == RANDOM_POOL_SIZE) {
+            // arc4random is backed by the system's CSPRNG
+            arc4random_buf(randomPool, RANDOM_POOL_SIZE);
+            randomPoolOffset = 0;
+        }
+        uint8_t byte = randomPool[randomPoolOffset++];
+        if (byte < ALPHANUMERIC_REJECTION_THRESHOLD) {
+            characters[count++] = alphanumericCharacters[byte % ALPHANUMERIC_COUNT];
+        }
     }
+    os_unfair_lock_unlock(&randomPoolLock);
 
-    return randomString;
+    return [[NSString alloc] initWithBytesNoCopy:characters
+                                          length:(NSUInteger)length
+                                        encoding:NSASCIIStringEncoding
+                                    freeWhenDone:YES];
 }
 
 // Generate a random identifier using CFUUIDCreateString() method.
@@ -14,16 +14,29 @@
 
 // Generate the hexadeciaml value of the data.
 + (NSString *)hexStringValueForData:(NSData *)data {
-    NSMutableString *stringBuffer = [NSMutableString stringWithCapacity:([data length] * 2)];
+    static const char hexDigits[] = "0123456789abcdef";
 
-    const unsigned char *dataBuffer = [data bytes];
-    int i;
+    NSUInteger length = [data length];
+    if (length == 0) {
+        return @"";
+    }
 
-    for (i = 0; i < [data length]; ++i) {
-        [stringBuffer appendFormat:@"%02x", (unsigned int)dataBuffer[i]];
+    // Written in a single buffer, that the string takes ownership of
+    char *hexBuffer = malloc(length * 2);
+    if (hexBuffer == NULL) {
+        return @"";
+    }
+
+    const unsigned char *dataBuffer = [data bytes];
+    for (NSUInteger i = 0; i < length; ++i) {
+        hexBuffer[i * 2] = hexDigits[dataBuffer[i] >> 4];
+        hexBuffer[i * 2 + 1] = hexDigits[dataBuffer[i] & 0x0F];
     }
 
-    return [stringBuffer copy];
+    return [[NSString alloc] initWithBytesNoCopy:hexBuffer
+                                          length:length * 2
+                                        encoding:NSASCIIStringEncoding
+                                    freeWhenDone:YES];
 }
 
 @end
@@ -0,0 +1,46 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BALoggerProtocol.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Logger taking the log output off the caller's thread.
+///
+/// Logging only pushes an entry into a lock-free ring buffer. A background queue drains it: entries are forwarded to
+/// the wrapped logger, kept in memory, and appended to a log file if persistence is enabled. The log file is rotated
+/// once it reaches its maximum size, keeping one previous file.
+/// When logs are produced faster than they are drained, the buffer drops them. The number of dropped logs is then
+/// reported as a public warning to the wrapped logger, and kept in memory and in the log file.
+/// Logging allocates the entry pushed into the buffer, but never blocks nor waits for the output.
+@interface BAAsyncLogger : NSObject <BALoggerProtocol>
+
+/// Shared instance, forwarding to os_log and persisting in Batch's application support directory
++ (instancetype)sharedInstance;
+
+- (instancetype)initWithLogger:(id<BALoggerProtocol>)logger
+                    logFileURL:(nullable NSURL *)logFileURL
+                   maxFileSize:(NSUInteger)maxFileSize NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Whether logs are written to the log file. Disabled by default: the -BatchSDKPersistLogs launch argument enables it.
+@property (atomic) BOOL persistenceEnabled;
+
+/// Wait until the logs pushed so far have been drained
+- (void)flush;
+
+/// Get the recent logs, oldest first: the persisted ones if persistence is enabled, the in-memory ones otherwise.
+/// The completion is called on the main thread.
+- (void)exportLogs:(void (^)(NSString *logs))completion;
+
+/// Remove the in-memory and persisted logs
+- (void)clearLogs;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,291 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAAsyncLogger.h>
+#import <Batch/BADirectories.h>
+#import <Batch/BALogRingBuffer.h>
+#import <Batch/BALoggerUnified.h>
+
+#include <stdio.h>
+
+/// Entries waiting to be drained: enough for a burst of logs
+#define BUFFER_CAPACITY 1024
+
+/// Lines kept in memory
+#define MAX_HISTORY_LINES 500
+
+#define LOG_FILE_NAME @"logs/batch.log"
+#define MAX_LOG_FILE_SIZE (256 * 1024)
+
+@interface BAAsyncLogEntry : NSObject {
+  @public
+    NSDate *_date;
+    NSString *_message;
+    NSString *_subsystem;
+    BOOL _internal;
+    os_log_type_t _level;
+}
+@end
+
+@implementation BAAsyncLogEntry
+@end
+
+@implementation BAAsyncLogger {
+    id<BALoggerProtocol> _logger;
+    BALogRingBuffer<BAAsyncLogEntry *> *_buffer;
+
+    /// Serial queue draining the buffer, owning everything below
+    dispatch_queue_t _queue;
+    dispatch_source_t _drainSource;
+
+    NSMutableArray<NSString *> *_history;
+    NSDateFormatter *_dateFormatter;
+
+    NSURL *_logFileURL;
+    NSUInteger _maxFileSize;
+    FILE *_logFile;
+    NSUInteger _logFileSize;
+}
+
++ (instancetype)sharedInstance {
+    static BAAsyncLogger *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      NSURL *logFileURL =
+          [NSURL fileURLWithPathComponents:@[ [BADirectories pathForBatchAppSupportDirectory], LOG_FILE_NAME ]];
+      instance = [[BAAsyncLogger alloc] initWithLogger:[BALoggerUnified new]
+                                            logFileURL:logFileURL
+                                           maxFileSize:MAX_LOG_FILE_SIZE];
+    });
+    return instance;
+}
+
+- (instancetype)initWithLogger:(id<BALoggerProtocol>)logger
+                    logFileURL:(nullable NSURL *)logFileURL
+                   maxFileSize:(NSUInteger)maxFileSize {
+    self = [super init];
+    if (self) {
+        _logger = logger;
+        _buffer = [[BALogRingBuffer alloc] initWithCapacity:BUFFER_CAPACITY];
+        _history = [NSMutableArray array];
+        _logFileURL = logFileURL;
+        _maxFileSize = maxFileSize;
+
+        _dateFormatter = [NSDateFormatter new];
+        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        _dateFormatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"UTC"];
+        _dateFormatter.dateFormat = @"yyyy-MM-dd'T'HH:mm:ss.SSS'Z'";
+
+        _queue = dispatch_queue_create("com.batch.ios.logger",
+                                       dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                               QOS_CLASS_UTILITY, 0));
+        // Producers only signal the source: signals are coalesced until the queue drains the buffer
+        _drainSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_OR, 0, 0, _queue);
+        __weak BAAsyncLogger *weakSelf = self;
+        dispatch_source_set_event_handler(_drainSource, ^{
+          [weakSelf drain];
+        });
+        dispatch_resume(_drainSource);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    dispatch_source_cancel(_drainSource);
+    if (_logFile != NULL) {
+        fclose(_logFile);
+    }
+}
+
+#pragma mark - BALoggerProtocol
+
+- (void)logMessage:(NSString *)message
+         subsystem:(NSString *)subsystem
+          internal:(BOOL)internal
+             level:(os_log_type_t)level {
+    BAAsyncLogEntry *entry = [BAAsyncLogEntry new];
+    entry->_date = [NSDate date];
+    entry->_message = message;
+    entry->_subsystem = subsystem;
+    entry->_internal = internal;
+    entry->_level = level;
+
+    // A full buffer drops the entry: the drainer reports how many were to the wrapped logger and the history
+    [_buffer push:entry];
+    dispatch_source_merge_data(_drainSource, 1);
+}
+
+#pragma mark - Public methods
+
+- (void)flush {
+    dispatch_sync(_queue, ^{
+      [self drain];
+    });
+}
+
+- (void)exportLogs:(void (^)(NSString *logs))completion {
+    dispatch_async(_queue, ^{
+      [self drain];
+
+      NSString *logs = nil;
+      if (self.persistenceEnabled && self->_logFileURL != nil) {
+          logs = [self persistedLogs];
+      }
+      if (logs == nil) {
+          logs = [self->_history count] > 0 ? [self historyLogs] : @"";
+      }
+
+      dispatch_async(dispatch_get_main_queue(), ^{
+        completion(logs);
+      });
+    });
+}
+
+- (void)clearLogs {
+    dispatch_sync(_queue, ^{
+      [self drain];
+      [self->_history removeAllObjects];
+      [self closeLogFile];
+      if (self->_logFileURL != nil) {
+          [[NSFileManager defaultManager] removeItemAtURL:self->_logFileURL error:nil];
+          [[NSFileManager defaultManager] removeItemAtURL:[self rotatedLogFileURL] error:nil];
+      }
+    });
+}
+
+#pragma mark - Draining
+
+- (void)drain {
+    BOOL persist = self.persistenceEnabled && _logFileURL != nil;
+    NSMutableString *persistedLines = persist ? [NSMutableString string] : nil;
+
+    NSUInteger droppedCount = [_buffer drainDroppedCount];
+    if (droppedCount > 0) {
+        // Dropped entries may be public logs: report them where integrators look, not only in the log file
+        NSString *message = [NSString stringWithFormat:@"%lu logs dropped", (unsigned long)droppedCount];
+        [_logger logMessage:message subsystem:@"Logger - " internal:false level:OS_LOG_TYPE_ERROR];
+        NSString *line = [NSString stringWithFormat:@"%@ [Batch] warning Logger - %@",
+                                                    [_dateFormatter stringFromDate:[NSDate date]], message];
+        [self appendLine:line toPersistedLines:persistedLines];
+    }
+
+    BAAsyncLogEntry *entry;
+    while ((entry = [_buffer pop]) != nil) {
+        [_logger logMessage:entry->_message subsystem:entry->_subsystem internal:entry->_internal level:entry->_level];
+        [self appendLine:[self lineForEntry:entry] toPersistedLines:persistedLines];
+    }
+
+    if ([persistedLines length] > 0) {
+        [self writeToLogFile:persistedLines];
+    }
+}
+
+- (void)appendLine:(NSString *)line toPersistedLines:(nullable NSMutableString *)persistedLines {
+    [_history addObject:line];
+    // Trim in batches rather than on every line
+    if ([_history count] > MAX_HISTORY_LINES + MAX_HISTORY_LINES / 10) {
+        [_history removeObjectsInRange:NSMakeRange(0, [_history count] - MAX_HISTORY_LINES)];
+    }
+
+    [persistedLines appendString:line];
+    [persistedLines appendString:@"\n"];
+}
+
+- (NSString *)lineForEntry:(BAAsyncLogEntry *)entry {
+    NSString *level;
+    switch (entry->_level) {
+        case OS_LOG_TYPE_FAULT:
+            level = @"error";
+            break;
+        case OS_LOG_TYPE_ERROR:
+            level = @"warning";
+            break;
+        case OS_LOG_TYPE_DEBUG:
+            level = @"debug";
+            break;
+        default:
+            level = @"info";
+            break;
+    }
+
+    return [NSString stringWithFormat:@"%@ [%@] %@ %@%@", [_dateFormatter stringFromDate:entry->_date],
+                                      entry->_internal ? @"Batch-Internal" : @"Batch", level,
+                                      entry->_subsystem != nil ? entry->_subsystem : @"", entry->_message];
+}
+
+#pragma mark - Persistence
+
+- (NSURL *)rotatedLogFileURL {
+    return [_logFileURL URLByAppendingPathExtension:@"1"];
+}
+
+- (BOOL)openLogFileIfNeeded {
+    if (_logFile != NULL) {
+        return true;
+    }
+
+    [[NSFileManager defaultManager] createDirectoryAtURL:[_logFileURL URLByDeletingLastPathComponent]
+                             withIntermediateDirectories:YES
+                                              attributes:nil
+                                                   error:nil];
+    _logFile = fopen([_logFileURL fileSystemRepresentation], "a");
+    if (_logFile == NULL) {
+        return false;
+    }
+    fseek(_logFile, 0, SEEK_END);
+    long size = ftell(_logFile);
+    _logFileSize = size > 0 ? (NSUInteger)size : 0;
+    return true;
+}
+
+- (void)closeLogFile {
+    if (_logFile != NULL) {
+        fclose(_logFile);
+        _logFile = NULL;
+    }
+    _logFileSize = 0;
+}
+
+- (void)writeToLogFile:(NSString *)lines {
+    if (![self openLogFileIfNeeded]) {
+        return;
+    }
+
+    NSData *data = [lines dataUsingEncoding:NSUTF8StringEncoding];
+    fwrite([data bytes], 1, [data length], _logFile);
+    fflush(_logFile);
+    _logFileSize += [data length];
+
+    if (_logFileSize >= _maxFileSize) {
+        // Keep the current file as the previous one, and start a new one on the next write
+        [self closeLogFile];
+        NSURL *rotatedLogFileURL = [self rotatedLogFileURL];
+        [[NSFileManager defaultManager] removeItemAtURL:rotatedLogFileURL error:nil];
+        [[NSFileManager defaultManager] moveItemAtURL:_logFileURL toURL:rotatedLogFileURL error:nil];
+    }
+}
+
+- (NSString *)historyLogs {
+    return [[_history componentsJoinedByString:@"\n"] stringByAppendingString:@"\n"];
+}
+
+- (nullable NSString *)persistedLogs {
+    if (_logFile != NULL) {
+        fflush(_logFile);
+    }
+
+    NSMutableString *logs = nil;
+    for (NSURL *url in @[ [self rotatedLogFileURL], _logFileURL ]) {
+        NSString *content = [NSString stringWithContentsOfURL:url encoding:NSUTF8StringEncoding error:nil];
+        if (content != nil) {
+            logs = logs != nil ? logs : [NSMutableString string];
+            [logs appendString:content];
+        }
+    }
+    return logs;
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Bounded lock-free queue, for many producers and a single consumer.
+///
+/// Producers never block, and the buffer itself never allocates after its creation: when it is full, pushed objects
+/// are dropped and counted. Allocating the pushed objects is left to the caller.
+/// Slots are sequenced (Vyukov's bounded queue): a producer claims a slot with a compare-and-swap on the enqueue
+/// position, and publishes it by bumping the slot's sequence number.
+@interface BALogRingBuffer<ObjectType> : NSObject
+
+/// Create a buffer. The capacity is rounded up to the next power of two.
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSUInteger capacity;
+
+/// Push an object. Can be called from any thread.
+/// Returns false if the buffer was full, in which case the object is dropped.
+- (BOOL)push:(ObjectType)object;
+
+/// Pop the oldest object, or nil if the buffer is empty. Must only be called by the consumer.
+- (nullable ObjectType)pop;
+
+/// Number of objects dropped since the last call. Can be called from any thread.
+- (NSUInteger)drainDroppedCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,109 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BALogRingBuffer.h>
+
+#import <stdatomic.h>
+
+typedef struct {
+    /// Equals the slot's position when it is free to write, and its position + 1 once written
+    _Atomic(size_t) sequence;
+    void *object;
+} BALogRingSlot;
+
+@implementation BALogRingBuffer {
+    BALogRingSlot *_slots;
+    size_t _mask;
+
+    /// Claimed by producers
+    _Atomic(size_t) _enqueuePosition;
+
+    /// Only read and written by the consumer
+    size_t _dequeuePosition;
+
+    _Atomic(size_t) _droppedCount;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        size_t slotCount = 2;
+        while (slotCount < capacity) {
+            slotCount <<= 1;
+        }
+        _capacity = slotCount;
+        _mask = slotCount - 1;
+        _slots = calloc(slotCount, sizeof(BALogRingSlot));
+        for (size_t i = 0; i < slotCount; i++) {
+            atomic_init(&_slots[i].sequence, i);
+        }
+        atomic_init(&_enqueuePosition, 0);
+        atomic_init(&_droppedCount, 0);
+        _dequeuePosition = 0;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    // Release the objects that were never consumed
+    while ([self pop] != nil) {
+    }
+    free(_slots);
+}
+
+- (BOOL)push:(id)object {
+    if (object == nil) {
+        return false;
+    }
+
+    BALogRingSlot *slot;
+    size_t position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+    for (;;) {
+        slot = &_slots[position & _mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            // The slot is free: claim it, unless another producer did first
+            if (atomic_compare_exchange_weak_explicit(&_enqueuePosition, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The slot hasn't been consumed since the previous lap: the buffer is full
+            atomic_fetch_add_explicit(&_droppedCount, 1, memory_order_relaxed);
+            return false;
+        } else {
+            position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+        }
+    }
+
+    slot->object = (__bridge_retained void *)object;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return true;
+}
+
+- (nullable id)pop {
+    size_t position = _dequeuePosition;
+    BALogRingSlot *slot = &_slots[position & _mask];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence != position + 1) {
+        // Empty, or the producer that claimed the slot hasn't published it yet
+        return nil;
+    }
+
+    id object = (__bridge_transfer id)slot->object;
+    slot->object = NULL;
+    _dequeuePosition = position + 1;
+    // Free the slot for the next lap
+    atomic_store_explicit(&slot->sequence, position + _mask + 1, memory_order_release);
+    return object;
+}
+
+- (NSUInteger)drainDroppedCount {
+    return atomic_exchange_explicit(&_droppedCount, 0, memory_order_relaxed);
+}
+
+@end
@@ -35,6 +35,9 @@ typedef NSUInteger BALoggerLevel;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Whether internal logs are enabled. Backs BALogger.internalLogsEnabled, and is read by the BALog macros.
+FOUNDATION_EXPORT BOOL BALoggerInternalLogsEnabled;
+
 /*!
  @class BALogger
  @abstract Logger helper.
@@ -113,3 +116,40 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 NS_ASSUME_NONNULL_END
+
+#pragma mark -
+#pragma mark Internal log macros
+
+/*!
+ @abstract Internal log macros, to use in hot paths.
+ @discussion Unlike the BALogger methods, they check that internal logs are enabled before evaluating their arguments:
+ a disabled log costs a global read.
+ Building with BATCH_DISABLE_INTERNAL_LOGS=1 removes them from the binary. Their arguments are still type-checked,
+ so that a log doesn't break the build of the configuration it isn't enabled in.
+ */
+#if BATCH_DISABLE_INTERNAL_LOGS
+#define BALOG_INTERNAL_ENABLED 0
+#else
+#define BALOG_INTERNAL_ENABLED __builtin_expect(BALoggerInternalLogsEnabled, 0)
+#endif
+
+#define BALogDebug(domain, ...)                                                                                        \
+    do {                                                                                                               \
+        if (BALOG_INTERNAL_ENABLED) {                                                                                  \
+            [BALogger debugForDomain:domain message:__VA_ARGS__];                                                      \
+        }                                                                                                              \
+    } while (0)
+
+#define BALogWarning(domain, ...)                                                                                      \
+    do {                                                                                                               \
+        if (BALOG_INTERNAL_ENABLED) {                                                                                  \
+            [BALogger warningForDomain:domain message:__VA_ARGS__];                                                    \
+        }                                                                                                              \
+    } while (0)
+
+#define BALogError(domain, ...)                                                                                        \
+    do {                                                                                                               \
+        if (BALOG_INTERNAL_ENABLED) {                                                                                  \
+            [BALogger errorForDomain:domain message:__VA_ARGS__];                                                      \
+        }                                                                                                              \
+    } while (0)
@@ -6,8 +6,8 @@
 //  Copyright (c) 2014 Batch SDK. All rights reserved.
 //
 
+#import <Batch/BAAsyncLogger.h>
 #import <Batch/BALogger.h>
-#import <Batch/BALoggerUnified.h>
 #import <Batch/BANullHelper.h>
 #import <Batch/BAOSHelper.h>
 #import "Defined.h"
@@ -16,7 +16,9 @@
 
 NSString *const kBATLoggerEnableInternalArgument = @"-BatchSDKEnableInternalLogs";
 
-static BOOL BATLoggerInternalForceEnable = false;
+NSString *const kBATLoggerPersistLogsArgument = @"-BatchSDKPersistLogs";
+
+BOOL BALoggerInternalLogsEnabled = false;
 
 __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 
@@ -37,7 +39,7 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 
 // Log the message using an error tag.
 + (void)errorForDomain:(NSString *)name message:(NSString *)formatstring, ... {
-    if (BATLoggerInternalForceEnable) {
+    if (BALoggerInternalLogsEnabled) {
         va_list arglist;
         va_start(arglist, formatstring);
         NSString *statement = [[NSString alloc] initWithFormat:formatstring arguments:arglist];
@@ -49,7 +51,7 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 
 // Log the message using a warning tag.
 + (void)warningForDomain:(NSString *)name message:(NSString *)formatstring, ... {
-    if (BATLoggerInternalForceEnable) {
+    if (BALoggerInternalLogsEnabled) {
         va_list arglist;
         va_start(arglist, formatstring);
         NSString *statement = [[NSString alloc] initWithFormat:formatstring arguments:arglist];
@@ -61,7 +63,7 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 
 // Log the message using a debug tag.
 + (void)debugForDomain:(NSString *)name message:(NSString *)formatstring, ... {
-    if (BATLoggerInternalForceEnable) {
+    if (BALoggerInternalLogsEnabled) {
         va_list arglist;
         va_start(arglist, formatstring);
         NSString *statement = [[NSString alloc] initWithFormat:formatstring arguments:arglist];
@@ -78,7 +80,12 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
     // Check if there is a process argument to enable Batch Internal Logs
     NSArray *arguments = [[NSProcessInfo processInfo] arguments];
     if ([arguments containsObject:kBATLoggerEnableInternalArgument]) {
-        BATLoggerInternalForceEnable = true;
+        BALoggerInternalLogsEnabled = true;
+    }
+
+    // Keep the logs on disk, to export them from the debug view
+    if ([arguments containsObject:kBATLoggerPersistLogsArgument]) {
+        [BAAsyncLogger sharedInstance].persistenceEnabled = true;
     }
 }
 
@@ -103,11 +110,11 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 #pragma mark - Internal log control
 
 + (BOOL)internalLogsEnabled {
-    return BATLoggerInternalForceEnable;
+    return BALoggerInternalLogsEnabled;
 }
 
 + (void)setInternalLogsEnabled:(BOOL)internalLogsEnabled {
-    BATLoggerInternalForceEnable = internalLogsEnabled;
+    BALoggerInternalLogsEnabled = internalLogsEnabled;
 }
 
 #pragma mark -
@@ -117,17 +124,18 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
     static id<BALoggerProtocol> logger = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-      logger = [BALoggerUnified new];
+      // Output happens on a background queue, not on the thread that logs
+      logger = [BAAsyncLogger sharedInstance];
     });
     return logger;
 }
 
 + (void)enableInternalLogs __attribute__((deprecated("Use setEnableInternalLogs"))) {
-    BATLoggerInternalForceEnable = true;
+    BALoggerInternalLogsEnabled = true;
 }
 
 + (void)disableInternalLogs __attribute__((deprecated("Use setEnableInternalLogs"))) {
-    BATLoggerInternalForceEnable = false;
+    BALoggerInternalLogsEnabled = false;
 }
 
 + (void)setLoggerDelegateSource:(id<BALoggerDelegateSource>)delegateSource {
@@ -135,10 +143,11 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
 }
 
 + (void)setEnableInternalLogs:(BOOL)enableInternalLogs {
-    BATLoggerInternalForceEnable = enableInternalLogs;
+    BALoggerInternalLogsEnabled = enableInternalLogs;
 }
 
 // Private method that do the NSLog().
+// The message is formatted once by the caller: each sink only builds its prefixed version if it is enabled.
 + (void)logMessage:(NSString *)message domain:(NSString *)domain internal:(BOOL)internal level:(os_log_type_t)level {
     if ([BANullHelper isNull:message] == YES) {
         return;
@@ -147,14 +156,18 @@ __weak static id<BALoggerDelegateSource> BALoggerDelegateSource;
     if ([BANullHelper isStringEmpty:domain] == YES) {
         domain = @"";
     } else {
-        domain = [NSString stringWithFormat:@"%@ - ", domain];
+        domain = [domain stringByAppendingString:@" - "];
     }
 
     [[BALogger sharedLogger] logMessage:message subsystem:domain internal:internal level:level];
 
-    [BALoggerDelegateSource.loggerDelegate
-        logWithMessage:[NSString
-                           stringWithFormat:@"[%@] - %@%@", internal ? @"Batch-Internal" : @"Batch", domain, message]];
+    // Messages sent to nil still evaluate their arguments: only format the delegate's message if there is one
+    id<BatchLoggerDelegate> loggerDelegate = BALoggerDelegateSource.loggerDelegate;
+    if (loggerDelegate != nil) {
+        [loggerDelegate
+            logWithMessage:[NSString stringWithFormat:@"[%@] - %@%@", internal ? @"Batch-Internal" : @"Batch", domain,
+                                                      message]];
+    }
 }
 
 @end
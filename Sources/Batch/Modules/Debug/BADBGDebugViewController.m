@@ -3,6 +3,7 @@
 #import <Batch/BADBGCustomDataViewController.h>
 #import <Batch/BADBGIdentifiersViewController.h>
 #import <Batch/BADBGLocalCampaignsViewController.h>
+#import <Batch/BADBGLogsViewController.h>
 
 #define DEFAULT_CELL_NAME @"cell"
 
@@ -10,6 +11,7 @@ typedef NS_ENUM(NSUInteger, BADBGMenuAction) {
     BADBGMenuActionIdentifiers,
     BADBGMenuActionLocalCampaigns,
     BADBGMenuActionCustomData,
+    BADBGMenuActionLogs,
 };
 
 @interface BADBGMenuItem : NSObject
@@ -69,6 +71,8 @@ typedef NS_ENUM(NSUInteger, BADBGMenuAction) {
             [BADBGMenuSection sectionWithName:nil
                                         items:@[ [BADBGMenuItem itemWithName:@"In-App Campaigns"
                                                                       action:BADBGMenuActionLocalCampaigns] ]],
+            [BADBGMenuSection sectionWithName:nil
+                                        items:@[ [BADBGMenuItem itemWithName:@"Logs" action:BADBGMenuActionLogs] ]],
         ];
     }
     return self;
@@ -120,6 +124,9 @@ typedef NS_ENUM(NSUInteger, BADBGMenuAction) {
         case BADBGMenuActionCustomData:
             [self.navigationController pushViewController:[BADBGCustomDataViewController new] animated:YES];
             break;
+        case BADBGMenuActionLogs:
+            [self.navigationController pushViewController:[BADBGLogsViewController new] animated:YES];
+            break;
     }
 }
 
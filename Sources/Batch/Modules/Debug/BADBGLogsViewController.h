@@ -0,0 +1,5 @@
+#import <UIKit/UIKit.h>
+
+@interface BADBGLogsViewController : UIViewController
+
+@end
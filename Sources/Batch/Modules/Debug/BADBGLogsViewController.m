@@ -0,0 +1,70 @@
+#import <Batch/BADBGLogsViewController.h>
+
+#import <Batch/BAAsyncLogger.h>
+
+@implementation BADBGLogsViewController {
+    UITextView *_textView;
+    NSString *_logs;
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    self.navigationItem.title = @"Logs";
+    self.navigationItem.rightBarButtonItems = @[
+        [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemAction
+                                                      target:self
+                                                      action:@selector(share:)],
+        [[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemTrash
+                                                      target:self
+                                                      action:@selector(clear)],
+    ];
+
+    _textView = [[UITextView alloc] initWithFrame:self.view.bounds];
+    _textView.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleHeight;
+    _textView.editable = false;
+    _textView.font = [UIFont monospacedSystemFontOfSize:11 weight:UIFontWeightRegular];
+    _textView.text = @"Loading…";
+    [self.view addSubview:_textView];
+
+    [self loadLogs];
+}
+
+- (void)loadLogs {
+    __weak BADBGLogsViewController *weakSelf = self;
+    [[BAAsyncLogger sharedInstance] exportLogs:^(NSString *logs) {
+      [weakSelf displayLogs:logs];
+    }];
+}
+
+- (void)displayLogs:(NSString *)logs {
+    _logs = logs;
+    _textView.text = [logs length] > 0 ? logs : @"No logs";
+    if ([logs length] > 0) {
+        // Most recent logs are at the bottom
+        [_textView scrollRangeToVisible:NSMakeRange([logs length] - 1, 1)];
+    }
+}
+
+- (void)clear {
+    [[BAAsyncLogger sharedInstance] clearLogs];
+    [self displayLogs:@""];
+}
+
+- (void)share:(id)sender {
+    if ([_logs length] == 0) {
+        return;
+    }
+
+    NSString *logs = [@"Batch Debug: Logs\n\n" stringByAppendingString:_logs];
+    UIActivityViewController *activityVC = [[UIActivityViewController alloc] initWithActivityItems:@[ logs ]
+                                                                             applicationActivities:nil];
+
+    if ([sender isKindOfClass:[UIBarButtonItem class]]) {
+        [activityVC.popoverPresentationController setBarButtonItem:sender];
+    }
+
+    [self.navigationController presentViewController:activityVC animated:YES completion:nil];
+}
+
+@end
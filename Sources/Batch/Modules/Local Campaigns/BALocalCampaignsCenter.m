@@ -116,8 +116,7 @@
                                                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
 
 #if TARGET_OS_VISION
-    [BALogger debugForDomain:LOGGER_DOMAIN
-                     message:@"Not registering Local Campaigns refresh: unsupported on visionOS."];
+    BALogDebug(LOGGER_DOMAIN, @"Not registering Local Campaigns refresh: unsupported on visionOS.");
     return;
 #else
     // New session is used to load the campaign cache, scheduling server refreshs
@@ -143,11 +142,11 @@
 
 - (void)emitSignal:(id<BALocalCampaignSignalProtocol>)signal {
 #if TARGET_OS_VISION
-    [BALogger debugForDomain:LOGGER_DOMAIN message:@"Not handling Local Campaigns signal: unsupported on visionOS."];
+    BALogDebug(LOGGER_DOMAIN, @"Not handling Local Campaigns signal: unsupported on visionOS.");
     return;
 #else
     if ([[BAOptOut instance] isOptedOut]) {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Batch is opted-out from, not bubbling local campaigns signal"];
+        BALogDebug(LOGGER_DOMAIN, @"Batch is opted-out from, not bubbling local campaigns signal");
         return;
     }
 
@@ -156,8 +155,7 @@
     }
 
     if (!_isReady) {
-        [BALogger debugForDomain:LOGGER_DOMAIN
-                         message:@"Local Campaign module isn't ready, enqueueing signal: %@", signal];
+        BALogDebug(LOGGER_DOMAIN, @"Local Campaign module isn't ready, enqueueing signal: %@", signal);
         [self enqueueSignal:signal];
         return;
     }
@@ -182,7 +180,7 @@
 
     dispatch_async(_dispatchSignalQueue, ^{
       if (self->_isWaitingJITSync) {
-          [BALogger debugForDomain:LOGGER_DOMAIN message:@"JIT sync in progress, enqueueing signal: %@", signal];
+          BALogDebug(LOGGER_DOMAIN, @"JIT sync in progress, enqueueing signal: %@", signal);
           [self enqueueSignal:signal];
       } else {
           [self electCampaignForSignal:signal];
@@ -223,8 +221,7 @@
                 [self->_campaignManager syncedJITCampaignState:firstElectedCampaign];
             if (syncedCampaignState == BATSyncedJITCampaignStateEligible) {
                 // Last succeed JIT sync for this campaign is NOT older than 30 sec, considering eligibility up to date.
-                [BALogger debugForDomain:LOGGER_DOMAIN
-                                 message:@"Skipping JIT sync since this campaign has been already synced recently."];
+                BALogDebug(LOGGER_DOMAIN, @"Skipping JIT sync since this campaign has been already synced recently.");
                 [self displayInAppMessage:firstElectedCampaign];
 
             } else if (syncedCampaignState == BATSyncedJITCampaignStateRequiresSync &&
@@ -245,9 +242,9 @@
                                                            message:@"Elected campaign has been synchronized with JIT."];
                                                 [self displayInAppMessage:electedCampaign];
                                             } else if (offlineCampaignFallback != nil) {
-                                                [BALogger debugForDomain:LOGGER_DOMAIN
-                                                                 message:@"JIT respond with no eligible campaigns or "
-                                                                         @"with error. Fallback on offline campaign."];
+                                                BALogDebug(LOGGER_DOMAIN,
+                                                           @"JIT respond with no eligible campaigns or "
+                                                           @"with error. Fallback on offline campaign.");
                                                 [self displayInAppMessage:offlineCampaignFallback];
 
                                             } else {
@@ -263,19 +260,19 @@
                 BALocalCampaign *firstEligibleCampaignNotRequiringJITSync =
                     [self->_campaignManager firstCampaignNotRequiringJITSync:eligibleCampaigns];
                 if (firstEligibleCampaignNotRequiringJITSync != nil) {
-                    [BALogger debugForDomain:LOGGER_DOMAIN
-                                     message:@"JIT not available or campaign already in cached and not eligible, "
-                                             @"fallback on offline campaign."];
+                    BALogDebug(LOGGER_DOMAIN,
+                               @"JIT not available or campaign already in cached and not eligible, "
+                               @"fallback on offline campaign.");
                     [self displayInAppMessage:firstEligibleCampaignNotRequiringJITSync];
                 }
             }
         } else {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"Elected campaign not requiring a sync, display it."];
+            BALogDebug(LOGGER_DOMAIN, @"Elected campaign not requiring a sync, display it.");
             [self displayInAppMessage:firstElectedCampaign];
         }
 
     } else {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"No eligible campaigns found."];
+        BALogDebug(LOGGER_DOMAIN, @"No eligible campaigns found.");
     }
 }
 
@@ -285,7 +282,7 @@
         [campaign generateOccurrenceIdentifier];
         [campaign.output performForCampaign:campaign];
     } else {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"No output for this campaign. This should not be happening."];
+        BALogDebug(LOGGER_DOMAIN, @"No output for this campaign. This should not be happening.");
     }
 }
 
@@ -308,7 +305,7 @@
  */
 - (void)didPerformCampaignOutputWithIdentifier:(nonnull NSString *)identifier eventData:(nullable NSObject *)eventData {
     if (identifier == nil) {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Can't track local campaign view for a nil identifier"];
+        BALogDebug(LOGGER_DOMAIN, @"Can't track local campaign view for a nil identifier");
     }
 
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
@@ -326,9 +323,9 @@
                                       @"last" : @(floor([ev.lastOccurrence timeIntervalSince1970] * 1000))
                                   }];
       } else {
-          [BALogger debugForDomain:LOGGER_DOMAIN
-                           message:@"An unknown error occurred while tracking a local campaign view. Not sending the "
-                                   @"view to the server."];
+          BALogDebug(LOGGER_DOMAIN,
+                     @"An unknown error occurred while tracking a local campaign view. Not sending the "
+                     @"view to the server.");
       }
     });
 }
@@ -343,15 +340,14 @@
     // This check should be made before calling this method, but we need to ensure it
     // so that we don't end up in an infinite loop
     if (_isReady && !_isWaitingJITSync) {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Cannot enqueue a signal when the SDK is ready."];
+        BALogDebug(LOGGER_DOMAIN, @"Cannot enqueue a signal when the SDK is ready.");
         return;
     }
     @synchronized(_signalQueue) {
         if (_isReady && !_isWaitingJITSync) {
             // We became ready while waiting for the lock
             // This means that the events have probably been dequeued in the meantime
-            [BALogger debugForDomain:LOGGER_DOMAIN
-                             message:@"SDK ready state changed while enqueueing signal: replaying immediatly."];
+            BALogDebug(LOGGER_DOMAIN, @"SDK ready state changed while enqueueing signal: replaying immediatly.");
             [self emitSignal:signal];
         } else {
             [_signalQueue addObject:signal];
@@ -370,8 +366,7 @@
         [_signalQueue removeAllObjects];
 
         if (enqueuedSignals.count > 0) {
-            [BALogger debugForDomain:LOGGER_DOMAIN
-                             message:@"Replaying %ld local campaign signals", enqueuedSignals.count];
+            BALogDebug(LOGGER_DOMAIN, @"Replaying %ld local campaign signals", enqueuedSignals.count);
         }
 
         for (id<BALocalCampaignSignalProtocol> signal in enqueuedSignals) {
@@ -419,16 +414,15 @@
       BALocalCampaignsVersion version;
       NSDictionary *rawCampaigns = [self->_campaignPersister loadCampaignsWithError:&err];
       if (rawCampaigns == nil) {
-          [BALogger debugForDomain:LOGGER_DOMAIN
-                           message:@"Could not load local campaigns from disk. Reason: %@",
-                                   err ? err.localizedDescription : @"Unknown error"];
+          BALogDebug(LOGGER_DOMAIN, @"Could not load local campaigns from disk. Reason: %@",
+                     err ? err.localizedDescription : @"Unknown error");
       } else {
           // Ensure cache is not too old
           NSNumber *campaignsCacheTimestamp = [rawCampaigns objectForKey:@"cache_date"];
           if (campaignsCacheTimestamp != nil) {
               if ([campaignsCacheTimestamp doubleValue] + CACHE_EXPIRATION_DELAY <=
                   [[self->_dateProvider currentDate] timeIntervalSince1970]) {
-                  [BALogger debugForDomain:LOGGER_DOMAIN message:@"Local campaigns cache is too old, deleting it."];
+                  BALogDebug(LOGGER_DOMAIN, @"Local campaigns cache is too old, deleting it.");
                   [self->_campaignPersister deleteCampaigns];
                   return;
               }
@@ -443,8 +437,7 @@
                                message:@"Could not parse local campaigns loaded from disk: %@",
                                        err ? err.localizedDescription : @"Unknown error"];
           } else {
-              [BALogger debugForDomain:LOGGER_DOMAIN
-                               message:@"Loaded %lu campaigns from disk", (unsigned long)campaigns.count];
+              BALogDebug(LOGGER_DOMAIN, @"Loaded %lu campaigns from disk", (unsigned long)campaigns.count);
           }
 
           BALocalCampaignsVersion cachedVersion = [BALocalCampaignsParser parseVersion:rawCampaigns
@@ -461,7 +454,7 @@
                                message:@"Could not parse local campaigns loaded from disk: %@",
                                        err ? err.localizedDescription : @"Unknown error"];
           } else {
-              [BALogger debugForDomain:LOGGER_DOMAIN message:@"Version %d from disk", version];
+              BALogDebug(LOGGER_DOMAIN, @"Version %d from disk", version);
           }
       }
 
@@ -487,7 +480,7 @@
     // Disable signal queue while we are synchronizing local campaigns
     _isReady = false;
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-      [BALogger debugForDomain:LOGGER_DOMAIN message:@"Refreshing local campaigns"];
+      BALogDebug(LOGGER_DOMAIN, @"Refreshing local campaigns");
 
       NSDictionary<NSString *, BALocalCampaignCountedEvent *> *views =
           [self->_campaignManager viewCountsForLoadedCampaigns];
@@ -542,7 +535,7 @@
                                  err ? err.localizedDescription : @"Unknown error"];
         versionPayload = nil;
     } else {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Version %lu from the WS", version];
+        BALogDebug(LOGGER_DOMAIN, @"Version %lu from the WS", version);
     }
 
     if (version != BALocalCampaignsVersionUnknown) {
@@ -556,7 +549,7 @@
                                      err ? err.localizedDescription : @"Unknown error"];
             persistPayload = nil;
         } else {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"Loaded %ld campaigns from the WS", campaigns.count];
+            BALogDebug(LOGGER_DOMAIN, @"Loaded %ld campaigns from the WS", campaigns.count);
         }
     }
 
@@ -17,8 +17,10 @@
 
 #import <Batch/BALocalCampaignCountedEvent.h>
 
+#import <Batch/BAInjection.h>
 #import <Batch/BALocalCampaignsCenter.h>
 #import <Batch/BALocalCampaignsJITService.h>
+#import <Batch/BAMSGAssetPrefetcher.h>
 #import <Batch/BAParameter.h>
 #import <Batch/BAStandardQueryWebserviceIdentifiersProvider.h>
 #import <Batch/BAWebserviceClientExecutor.h>
@@ -126,6 +128,9 @@
         }
 
         [self updateWatchedEventNames];
+
+        // Warm the image cache so that messages don't wait on the network when triggered
+        [[BAInjection injectClass:BAMSGAssetPrefetcher.class] prefetchAssetsForCampaigns:_campaignList];
     }
 }
 
@@ -176,9 +181,8 @@
 
             [eligibleCampaigns addObject:campaign];
         }
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Found %lu eligible campaigns for signal %@",
-                                 (unsigned long)[eligibleCampaigns count], [signal description]];
+        BALogDebug(LOG_DOMAIN, @"Found %lu eligible campaigns for signal %@", (unsigned long)[eligibleCampaigns count],
+                   [signal description]);
 
         return [eligibleCampaigns sortedArrayUsingComparator:^NSComparisonResult(id obj1, id obj2) {
           NSInteger first = ((BALocalCampaign *)obj1).priority;
@@ -329,7 +333,7 @@
     }
 
     if (_cappings.session != nil && _viewTracker.sessionViewsCount >= _cappings.session.intValue) {
-        [BALogger debugForDomain:LOG_DOMAIN message:@"Session capping has been reached"];
+        BALogDebug(LOG_DOMAIN, @"Session capping has been reached");
         return true;
     }
 
@@ -341,13 +345,13 @@
                     [[_dateProvider currentDate] timeIntervalSince1970] - timeBasedCapping.duration.doubleValue;
                 NSNumber *count = [_viewTracker numberOfViewEventsSince:timestamp];
                 if (count == nil) {
-                    [BALogger debugForDomain:LOG_DOMAIN
-                                     message:@"Cannot retrived the number of view events. Campaigns will be prevented "
-                                             @"from displaying."];
+                    BALogDebug(LOG_DOMAIN,
+                               @"Cannot retrived the number of view events. Campaigns will be prevented "
+                               @"from displaying.");
                     return true;
                 }
                 if (count.intValue >= timeBasedCapping.views.intValue) {
-                    [BALogger debugForDomain:LOG_DOMAIN message:@"Time-based cappings have been reached"];
+                    BALogDebug(LOG_DOMAIN, @"Time-based cappings have been reached");
                     return true;
                 }
             }
@@ -380,22 +384,19 @@
     for (BALocalCampaign *campaign in campaignsToClean) {
         // Exclude campaigns that are over
         if (campaign.endDate != nil && [currentDate isAfter:campaign.endDate]) {
-            [BALogger debugForDomain:LOG_DOMAIN
-                             message:@"Ignoring campaign %@ since it is past its end_date", campaign.campaignID];
+            BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is past its end_date", campaign.campaignID);
             continue;
         }
 
         // Exclude campaigns that are over the view capping
         if ([self isCampaignOverCapping:campaign ignoreMinInterval:YES]) {
-            [BALogger debugForDomain:LOG_DOMAIN
-                             message:@"Ignoring campaign %@ since it is over capping", campaign.campaignID];
+            BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is over capping", campaign.campaignID);
             continue;
         }
 
         // Exclude campaigns that have a max api level too low
         if (campaign.maximumAPILevel > 0 && messagingAPILevel > campaign.maximumAPILevel) {
-            [BALogger debugForDomain:LOG_DOMAIN
-                             message:@"Ignoring campaign %@ since we are over its max API level", campaign.campaignID];
+            BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since we are over its max API level", campaign.campaignID);
             continue;
         }
 
@@ -439,7 +440,7 @@
         (campaign.minimumDisplayInterval > 0 &&
          [[_dateProvider currentDate] timeIntervalSince1970] <=
              ([eventData.lastOccurrence timeIntervalSince1970] + campaign.minimumDisplayInterval))) {
-        [BALogger debugForDomain:LOG_DOMAIN message:@"Not displaying campaign: min interval has not been reached"];
+        BALogDebug(LOG_DOMAIN, @"Not displaying campaign: min interval has not been reached");
         return true;
     }
 
@@ -462,43 +463,37 @@
  */
 - (BOOL)isCampaignDisplayable:(BALocalCampaign *)campaign {
     if ([self isCampaignOverCapping:campaign ignoreMinInterval:NO]) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ since it is over capping/minimum display interval",
-                                 campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is over capping/minimum display interval",
+                   campaign.campaignID);
         return false;
     }
 
     NSInteger messagingAPILevel = BAMessagingAPILevel;
 
     if (campaign.minimumAPILevel > 0 && campaign.minimumAPILevel > messagingAPILevel) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ since it is over max API level", campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is over max API level", campaign.campaignID);
         return false;
     }
 
     if (campaign.maximumAPILevel > 0 && messagingAPILevel > campaign.maximumAPILevel) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ since we are over its max API level", campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since we are over its max API level", campaign.campaignID);
         return false;
     }
 
     BATZAwareDate *currentDate = [BATZAwareDate dateWithDate:[_dateProvider currentDate] relativeToUserTZ:NO];
 
     if (campaign.startDate != nil && [currentDate isBefore:campaign.startDate]) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ since it is past it has not begun yet", campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is past it has not begun yet", campaign.campaignID);
         return false;
     }
 
     if (campaign.endDate != nil && [currentDate isAfter:campaign.endDate]) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ since it is past its end_date", campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ since it is past its end_date", campaign.campaignID);
         return false;
     }
 
     if ([self isCampaignDateInQuietHours:campaign]) {
-        [BALogger debugForDomain:LOG_DOMAIN
-                         message:@"Ignoring campaign %@ because of quiet days and hours", campaign.campaignID];
+        BALogDebug(LOG_DOMAIN, @"Ignoring campaign %@ because of quiet days and hours", campaign.campaignID);
 
         return false;
     }
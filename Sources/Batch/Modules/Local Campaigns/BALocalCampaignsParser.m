@@ -81,12 +81,10 @@
         }
     }
 
-    [BALogger debugForDomain:@"Local Campaigns"
-                     message:@"Successfully parsed %lu campaigns", (unsigned long)[parsedCampaigns count]];
+    BALogDebug(@"Local Campaigns", @"Successfully parsed %lu campaigns", (unsigned long)[parsedCampaigns count]);
 
     if (persist != nil) {
-        [BALogger debugForDomain:@"Local Campaigns"
-                         message:@"Persisting %lu campaigns", (unsigned long)[persistCampaigns count]];
+        BALogDebug(@"Local Campaigns", @"Persisting %lu campaigns", (unsigned long)[persistCampaigns count]);
         *persist = @{@"campaigns" : persistCampaigns};
     }
     return parsedCampaigns;
@@ -234,16 +232,15 @@
 
     for (NSDictionary *jsonTrigger in rawJson) {
         if (![jsonTrigger isKindOfClass:[NSDictionary class]]) {
-            [BALogger debugForDomain:@"Local Campaigns" message:@"Trigger is not a NSDictionary, skipping"];
+            BALogDebug(@"Local Campaigns", @"Trigger is not a NSDictionary, skipping");
             continue;
         }
 
         NSError *err = nil;
         id<BALocalCampaignTriggerProtocol> parsedTrigger = [self parseTrigger:jsonTrigger error:&err];
         if (parsedTrigger == nil) {
-            [BALogger debugForDomain:@"Local Campaigns"
-                             message:@"Could not parse trigger, skipping. Reason: %@",
-                                     err ? err.localizedDescription : @"Unknown error"];
+            BALogDebug(@"Local Campaigns", @"Could not parse trigger, skipping. Reason: %@",
+                       err ? err.localizedDescription : @"Unknown error");
             continue;
         }
         [triggers addObject:parsedTrigger];
@@ -10,6 +10,11 @@
 #import <Batch/BALocalCampaign.h>
 #import <Batch/BALocalCampaignOutputProtocol.h>
 
+@class BatchInAppMessage;
+
 @interface BALocalCampaignLandingOutput : NSObject <BALocalCampaignOutputProtocol>
 
+/// Message displayed by this output
+@property (readonly, nonnull) BatchInAppMessage *message;
+
 @end
@@ -11,9 +11,7 @@
 #import <Batch/BAThreading.h>
 #import <Batch/BatchMessagingPrivate.h>
 
-@implementation BALocalCampaignLandingOutput {
-    BatchInAppMessage *_message;
-}
+@implementation BALocalCampaignLandingOutput
 
 - (nullable instancetype)initWithPayload:(nonnull NSDictionary *)payload
                             isCEPMessage:(BOOL)isCEPMessage
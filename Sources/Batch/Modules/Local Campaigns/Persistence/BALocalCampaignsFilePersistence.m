@@ -24,8 +24,7 @@
         NSURL *filePath = [self filePath];
         NSData *json = [BAJson serializeData:campaigns error:nil];
         if ([json writeToURL:filePath atomically:YES]) {
-            [BALogger debugForDomain:LOGGER_DOMAIN
-                             message:@"Successfully wrote local campaigns to file: %@", filePath.path];
+            BALogDebug(LOGGER_DOMAIN, @"Successfully wrote local campaigns to file: %@", filePath.path);
         } else {
             [BALogger errorForDomain:LOCAL_ERROR_DOMAIN
                              message:@"Failed to write local campaigns to file: %@", filePath];
@@ -22,7 +22,7 @@
         // Extract and validate startHour
         NSNumber *startHour = [json objectForKey:@"startHour" kindOfClass:[NSNumber class] allowNil:NO error:&err];
         if (err != nil) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"startHour is not a NSNumber"];
+            BALogDebug(LOGGER_DOMAIN, @"startHour is not a NSNumber");
             return nil;
         } else {
             _startHour = [startHour integerValue];
@@ -31,7 +31,7 @@
         // Extract and validate startMin
         NSNumber *startMin = [json objectForKey:@"startMin" kindOfClass:[NSNumber class] allowNil:NO error:&err];
         if (err != nil) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"startMin is not a NSNumber"];
+            BALogDebug(LOGGER_DOMAIN, @"startMin is not a NSNumber");
             return nil;
         } else {
             _startMin = [startMin integerValue];
@@ -40,7 +40,7 @@
         // Extract and validate endHour
         NSNumber *endHour = [json objectForKey:@"endHour" kindOfClass:[NSNumber class] allowNil:NO error:&err];
         if (err != nil) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"endHour is not a NSNumber"];
+            BALogDebug(LOGGER_DOMAIN, @"endHour is not a NSNumber");
             return nil;
         } else {
             _endHour = [endHour integerValue];
@@ -49,7 +49,7 @@
         // Extract and validate endMin
         NSNumber *endMin = [json objectForKey:@"endMin" kindOfClass:[NSNumber class] allowNil:NO error:&err];
         if (err != nil) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"endMin is not a NSNumber"];
+            BALogDebug(LOGGER_DOMAIN, @"endMin is not a NSNumber");
             return nil;
         } else {
             _endMin = [endMin integerValue];
@@ -58,19 +58,19 @@
         // Extract and validate quietDaysOfWeek
         NSArray *quietDays = [json objectForKey:@"quietDaysOfWeek" kindOfClass:[NSArray class] allowNil:YES error:&err];
         if (err != nil) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"quietDays is not a NSArray"];
+            BALogDebug(LOGGER_DOMAIN, @"quietDays is not a NSArray");
             return nil;
         } else {
             // Ensure all elements in the array are valid BALocalCampaignDayOfWeek values
             for (id day in quietDays) {
                 if (![day isKindOfClass:[NSNumber class]]) {
-                    [BALogger debugForDomain:LOGGER_DOMAIN message:@"day is not a NSNumber"];
+                    BALogDebug(LOGGER_DOMAIN, @"day is not a NSNumber");
 
                     return nil;
                 }
                 NSInteger dayValue = [day integerValue];
                 if (dayValue < BALocalCampaignDayOfWeekSunday || dayValue > BALocalCampaignDayOfWeekSaturday) {
-                    [BALogger debugForDomain:LOGGER_DOMAIN message:@"day value is unknown"];
+                    BALogDebug(LOGGER_DOMAIN, @"day value is unknown");
                     // Invalid day of week value
 
                     return nil;
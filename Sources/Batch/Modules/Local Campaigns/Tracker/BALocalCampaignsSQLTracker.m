@@ -126,7 +126,7 @@
 
 /// Migrate database from version 2 to 3
 - (void)migrateFromVersion2To3 {
-    [BALogger debugForDomain:LOGGER_DOMAIN message:@"Migrating local campaigns database from version 2 to 3"];
+    BALogDebug(LOGGER_DOMAIN, @"Migrating local campaigns database from version 2 to 3");
 
     // Create new event table with custom_user_id and version columns
     NSString *createNewEventTable =
@@ -177,7 +177,7 @@
         return;
     }
 
-    [BALogger debugForDomain:LOGGER_DOMAIN message:@"Successfully migrated local campaigns database to version 3"];
+    BALogDebug(LOGGER_DOMAIN, @"Successfully migrated local campaigns database to version 3");
 }
 
 /// Open the database
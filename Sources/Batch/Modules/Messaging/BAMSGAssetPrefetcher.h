@@ -0,0 +1,64 @@
+//
+//  BAMSGAssetPrefetcher.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BALocalCampaign.h>
+#import <Batch/BAMSGImagePipeline.h>
+#import <Batch/BatchMessagingModels.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Downloads the images of in-app campaigns into the image pipeline's cache once they are loaded, so that messages
+/// can be displayed without waiting on the network when they are triggered. The views of the highest priority CEP
+/// campaigns are measured too, so that their texts are already built when they are displayed.
+///
+/// Layouts are measured first, then images are fetched one at a time, highest priority campaigns first, until the byte
+/// budget of the current network is used. Prefetching waits while the device is in Low Power Mode or under thermal
+/// pressure, downloads also wait while the network is unreachable, and both resume when conditions change.
+@interface BAMSGAssetPrefetcher : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithPipeline:(BAMSGImagePipeline *)pipeline NS_DESIGNATED_INITIALIZER;
+
++ (BAMSGAssetPrefetcher *)sharedPrefetcher;
+
+@property (readonly) BAMSGImagePipeline *pipeline;
+
+/// Prefetch the images of the given campaigns, replacing any prefetch in progress
+- (void)prefetchAssetsForCampaigns:(NSArray<BALocalCampaign *> *)campaigns;
+
+/// Prefetch the given images, in order, replacing any prefetch in progress.
+/// The completion is called once the prefetch ends, is out of budget, or has been replaced.
+- (void)prefetchImageURLs:(NSArray<NSURL *> *)urls completion:(nullable dispatch_block_t)completion;
+
+/// Images displayed by a message, most important first
++ (NSArray<NSURL *> *)imageURLsForMessage:(BatchMessage *)message;
+
+/// Bytes that can be downloaded per prefetch on an unmetered network
+@property unsigned long long byteBudget;
+
+/// Bytes that can be downloaded per prefetch on a cellular network
+@property unsigned long long meteredByteBudget;
+
+/// Delay before starting to prefetch, so that campaign loads during app startup don't compete with the app
+@property NSTimeInterval startDelay;
+
+// Environment checks, overridable for testing purposes
+
+- (BOOL)isNetworkReachable;
+
+- (BOOL)isNetworkMetered;
+
+- (BOOL)isPowerConstrained;
+
+/// Resume a prefetch that was waiting for better conditions
+- (void)conditionsDidChange;
+
+@end
+
+NS_ASSUME_NONNULL_END
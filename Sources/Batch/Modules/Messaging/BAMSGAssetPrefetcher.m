@@ -0,0 +1,311 @@
+//
+//  BAMSGAssetPrefetcher.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMSGAssetPrefetcher.h>
+
+#import <Batch/BALocalCampaignLandingOutput.h>
+#import <Batch/BALogger.h>
+#import <Batch/BAMSGMessage.h>
+#import <Batch/BAMSGPayloadParser.h>
+#import <Batch/BAReachabilityHelper.h>
+#import <Batch/Batch-Swift.h>
+#import <Batch/BatchMessagingPrivate.h>
+
+#define LOGGER_DOMAIN @"BAMSGAssetPrefetcher"
+
+#define DEFAULT_BYTE_BUDGET (10 * 1024 * 1024)
+#define DEFAULT_METERED_BYTE_BUDGET (2 * 1024 * 1024)
+#define DEFAULT_START_DELAY 5
+#define PREFETCH_TIMEOUT 30
+
+/// Campaigns whose views are measured ahead of their display: the ones most likely to be displayed, so that their texts
+/// fit in the text layout cache
+#define MAX_PREPARED_LAYOUTS 4
+
+@implementation BAMSGAssetPrefetcher {
+    // Serial queue guarding the prefetch state
+    dispatch_queue_t _queue;
+
+    // Incremented every time a new prefetch replaces the current one
+    NSUInteger _generation;
+
+    NSMutableArray<NSURL *> *_pendingURLs;
+
+    NSMutableArray<InAppMessagePreparation *> *_pendingLayouts;
+
+    unsigned long long _downloadedBytes;
+
+    BOOL _started;
+
+    BOOL _downloading;
+
+    dispatch_block_t _completion;
+}
+
++ (BAMSGAssetPrefetcher *)sharedPrefetcher {
+    static BAMSGAssetPrefetcher *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      sharedInstance = [[BAMSGAssetPrefetcher alloc] initWithPipeline:[BAMSGImagePipeline sharedPipeline]];
+    });
+
+    return sharedInstance;
+}
+
+- (instancetype)initWithPipeline:(BAMSGImagePipeline *)pipeline {
+    self = [super init];
+    if (self) {
+        _pipeline = pipeline;
+        _queue = dispatch_queue_create("com.batch.ios.msg.assetprefetcher", DISPATCH_QUEUE_SERIAL);
+        _pendingURLs = [NSMutableArray new];
+        _pendingLayouts = [NSMutableArray new];
+        _byteBudget = DEFAULT_BYTE_BUDGET;
+        _meteredByteBudget = DEFAULT_METERED_BYTE_BUDGET;
+        _startDelay = DEFAULT_START_DELAY;
+
+        [BAReachabilityHelper addObserver:self selector:@selector(conditionsDidChange)];
+
+        NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+        [notificationCenter addObserver:self
+                               selector:@selector(conditionsDidChange)
+                                   name:NSProcessInfoPowerStateDidChangeNotification
+                                 object:nil];
+        [notificationCenter addObserver:self
+                               selector:@selector(conditionsDidChange)
+                                   name:NSProcessInfoThermalStateDidChangeNotification
+                                 object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [BAReachabilityHelper removeObserver:self];
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark Public API
+
+- (void)prefetchAssetsForCampaigns:(NSArray<BALocalCampaign *> *)campaigns {
+    NSArray<BALocalCampaign *> *campaignsCopy = [campaigns copy];
+
+    dispatch_async(_queue, ^{
+      // The highest priority campaigns are the most likely to be displayed
+      NSArray<BALocalCampaign *> *sortedCampaigns =
+          [campaignsCopy sortedArrayUsingComparator:^NSComparisonResult(BALocalCampaign *a, BALocalCampaign *b) {
+            if (a.priority == b.priority) {
+                return NSOrderedSame;
+            }
+            return a.priority > b.priority ? NSOrderedAscending : NSOrderedDescending;
+          }];
+
+      NSMutableArray<NSURL *> *urls = [NSMutableArray new];
+      NSMutableArray<InAppMessagePreparation *> *layouts = [NSMutableArray new];
+      for (BALocalCampaign *campaign in sortedCampaigns) {
+          if (![campaign.output isKindOfClass:[BALocalCampaignLandingOutput class]]) {
+              continue;
+          }
+
+          BatchInAppMessage *message = ((BALocalCampaignLandingOutput *)campaign.output).message;
+          NSArray<NSURL *> *messageURLs;
+          InAppMessagePreparation *preparation = [BAMSGAssetPrefetcher preparationForMessage:message];
+          if (preparation != nil) {
+              // CEP messages are decoded once, for both their images and their layout
+              messageURLs = preparation.imageURLs;
+              if (layouts.count < MAX_PREPARED_LAYOUTS) {
+                  [layouts addObject:preparation];
+              }
+          } else {
+              messageURLs = [BAMSGAssetPrefetcher imageURLsForMessage:message];
+          }
+
+          for (NSURL *url in messageURLs) {
+              if (![url isFileURL] && ![urls containsObject:url]) {
+                  [urls addObject:url];
+              }
+          }
+      }
+
+      [self startPrefetchingURLs:urls layouts:layouts completion:nil];
+    });
+}
+
+- (void)prefetchImageURLs:(NSArray<NSURL *> *)urls completion:(nullable dispatch_block_t)completion {
+    NSArray<NSURL *> *urlsCopy = [urls copy];
+    dispatch_async(_queue, ^{
+      [self startPrefetchingURLs:urlsCopy layouts:@[] completion:completion];
+    });
+}
+
++ (nullable InAppMessagePreparation *)preparationForMessage:(BatchMessage *)message {
+    if (![message isCEPMessage]) {
+        return nil;
+    }
+
+    BAMSGCEPMessage *cepMessage = [BAMSGPayloadParser messageForCEPRawMessage:message bailIfNotAlert:NO];
+    return cepMessage != nil ? [InAppViewControllerProvider preparationWithMessage:cepMessage] : nil;
+}
+
++ (NSArray<NSURL *> *)imageURLsForMessage:(BatchMessage *)message {
+    if ([message isCEPMessage]) {
+        InAppMessagePreparation *preparation = [self preparationForMessage:message];
+        return preparation != nil ? preparation.imageURLs : @[];
+    }
+
+    BAMSGMEPMessage *mepMessage = [BAMSGPayloadParser messageForMEPRawMessage:message bailIfNotAlert:NO];
+
+    NSString *imageURL = nil;
+    if ([mepMessage isKindOfClass:[BAMSGMessageInterstitial class]]) {
+        BAMSGMessageInterstitial *interstitial = (BAMSGMessageInterstitial *)mepMessage;
+        // Videos take precedence over the hero image
+        if (interstitial.videoURL == nil) {
+            imageURL = interstitial.heroImageURL;
+        }
+    } else if ([mepMessage isKindOfClass:[BAMSGMessageBaseBanner class]]) {
+        imageURL = ((BAMSGMessageBaseBanner *)mepMessage).imageURL;
+    } else if ([mepMessage isKindOfClass:[BAMSGMessageImage class]]) {
+        imageURL = ((BAMSGMessageImage *)mepMessage).imageURL;
+    }
+
+    NSURL *url = imageURL != nil ? [NSURL URLWithString:imageURL] : nil;
+    return url != nil ? @[ url ] : @[];
+}
+
+#pragma mark Environment
+
+- (BOOL)isNetworkReachable {
+    return [BAReachabilityHelper isInternetReachable];
+}
+
+- (BOOL)isNetworkMetered {
+    return [BAReachabilityHelper currentReachabilityStatus] == ReachableViaWWAN;
+}
+
+- (BOOL)isPowerConstrained {
+    NSProcessInfo *processInfo = [NSProcessInfo processInfo];
+    return processInfo.isLowPowerModeEnabled || processInfo.thermalState >= NSProcessInfoThermalStateSerious;
+}
+
+- (void)conditionsDidChange {
+    dispatch_async(_queue, ^{
+      [self prefetchNext];
+    });
+}
+
+#pragma mark Prefetching
+
+// Must be called on _queue
+- (void)startPrefetchingURLs:(NSArray<NSURL *> *)urls
+                     layouts:(NSArray<InAppMessagePreparation *> *)layouts
+                  completion:(nullable dispatch_block_t)completion {
+    // Let the previous caller know that its prefetch won't go any further
+    [self finish];
+
+    _generation++;
+    [_pendingURLs setArray:urls];
+    [_pendingLayouts setArray:layouts];
+    _downloadedBytes = 0;
+    _started = false;
+    _completion = completion;
+
+    if (urls.count == 0 && layouts.count == 0) {
+        [self finish];
+        return;
+    }
+
+    [BALogger debugForDomain:LOGGER_DOMAIN
+                     message:@"Scheduling the prefetch of %lu images and %lu layouts", (unsigned long)urls.count,
+                             (unsigned long)layouts.count];
+
+    NSUInteger generation = _generation;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_startDelay * NSEC_PER_SEC)), _queue, ^{
+      if (generation != self->_generation) {
+          return;
+      }
+      self->_started = true;
+      [self prefetchNext];
+    });
+}
+
+// Must be called on _queue
+- (void)prefetchNext {
+    if (!_started || _downloading) {
+        return;
+    }
+
+    if (_pendingURLs.count == 0 && _pendingLayouts.count == 0) {
+        [self finish];
+        return;
+    }
+
+    if ([self isPowerConstrained]) {
+        // conditionsDidChange will resume
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Waiting for better conditions to prefetch"];
+        return;
+    }
+
+    if (_pendingLayouts.count > 0) {
+        // Measuring doesn't need the network: do it first, one message at a time so that new prefetches aren't delayed
+        InAppMessagePreparation *preparation = _pendingLayouts.firstObject;
+        [_pendingLayouts removeObjectAtIndex:0];
+        [preparation prepareLayout];
+        dispatch_async(_queue, ^{
+          [self prefetchNext];
+        });
+        return;
+    }
+
+    if (_pendingURLs.count == 0) {
+        [self finish];
+        return;
+    }
+
+    if (![self isNetworkReachable]) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Waiting for the network to prefetch images"];
+        return;
+    }
+
+    unsigned long long budget = [self isNetworkMetered] ? _meteredByteBudget : _byteBudget;
+    if (_downloadedBytes >= budget) {
+        [BALogger debugForDomain:LOGGER_DOMAIN
+                         message:@"Prefetch budget exhausted, skipping %lu images", (unsigned long)_pendingURLs.count];
+        [_pendingURLs removeAllObjects];
+        [self finish];
+        return;
+    }
+
+    NSURL *url = _pendingURLs.firstObject;
+    [_pendingURLs removeObjectAtIndex:0];
+    _downloading = true;
+
+    NSUInteger generation = _generation;
+    [_pipeline prefetchImageForURL:url
+                           timeout:PREFETCH_TIMEOUT
+                 completionHandler:^(NSUInteger downloadedBytes, NSError *_Nullable error) {
+                   dispatch_async(self->_queue, ^{
+                     self->_downloading = false;
+                     if (error != nil) {
+                         [BALogger debugForDomain:LOGGER_DOMAIN
+                                          message:@"Could not prefetch '%@': %@", url, error.localizedDescription];
+                     }
+                     if (generation == self->_generation) {
+                         self->_downloadedBytes += downloadedBytes;
+                     }
+                     [self prefetchNext];
+                   });
+                 }];
+}
+
+// Must be called on _queue
+- (void)finish {
+    dispatch_block_t completion = _completion;
+    _completion = nil;
+    if (completion != nil) {
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), completion);
+    }
+}
+
+@end
@@ -0,0 +1,90 @@
+//
+//  BAMSGImageCache.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// An image downloaded by the messaging image pipeline, along with the HTTP validators needed to revalidate it
+@interface BAMSGCachedImage : NSObject <NSSecureCoding>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithURL:(NSURL *)url
+                       data:(NSData *)data
+                       etag:(nullable NSString *)etag
+               lastModified:(nullable NSString *)lastModified
+             expirationDate:(nullable NSDate *)expirationDate NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) NSString *url;
+
+@property (readonly) NSData *data;
+
+@property (readonly, nullable) NSString *etag;
+
+@property (readonly, nullable) NSString *lastModified;
+
+/// Date after which the image should be revalidated before being used. nil means that it always needs revalidation.
+@property (readonly, nullable) NSDate *expirationDate;
+
+/// Size in bytes this image takes in the memory tier, including its decoded bitmap
+@property (readonly) NSUInteger memoryCost;
+
+@property (readonly) BOOL isFresh;
+
+@property (readonly) BOOL hasValidators;
+
+/// Decoded image, only kept in memory, if it has been decoded at a large enough size.
+/// maxPixelSize has the same meaning as in BAMSGImageDecoder: 0 asks for the full size image.
+- (nullable UIImage *)decodedImageForMaxPixelSize:(CGFloat)maxPixelSize;
+
+/// Keep a decoded version of this image. Ignored if the image already has a larger decoded version.
+- (void)setDecodedImage:(UIImage *)image maxPixelSize:(CGFloat)maxPixelSize;
+
+/// Returns a copy of this image with a new expiration date, used when the server confirms that it did not change
+- (BAMSGCachedImage *)revalidatedCopyWithExpirationDate:(nullable NSDate *)expirationDate;
+
+@end
+
+/// Two-tier cache for in-app message images.
+/// The memory tier is bounded by the size of the cached data and decoded bitmaps, the disk tier by the size of its
+/// files: the least recently used files are evicted first.
+/// Thread safe.
+@interface BAMSGImageCache : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithDirectory:(NSString *)directory
+                  memoryCostLimit:(NSUInteger)memoryCostLimit
+                    diskSizeLimit:(unsigned long long)diskSizeLimit NS_DESIGNATED_INITIALIZER;
+
+/// Default on-disk location, in the app's cache directory
++ (NSString *)defaultDirectory;
+
+/// Look up an image in memory, then on disk. Disk hits are promoted to the memory tier.
+- (nullable BAMSGCachedImage *)cachedImageForURL:(NSURL *)url;
+
+- (void)storeImage:(BAMSGCachedImage *)image;
+
+- (void)removeImageForURL:(NSURL *)url;
+
+/// Account for a newly decoded bitmap in the memory tier's cost
+- (void)updateMemoryCostForImage:(BAMSGCachedImage *)image;
+
+- (void)removeAllImages;
+
+/// Evict the least recently used files until the disk tier fits in its size limit
+- (void)trimDiskCache;
+
+@property (readonly) NSString *directory;
+
+@property (readonly) unsigned long long diskSizeLimit;
+
+@end
+
+NS_ASSUME_NONNULL_END
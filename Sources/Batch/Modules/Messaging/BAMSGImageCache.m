@@ -0,0 +1,317 @@
+//
+//  BAMSGImageCache.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BADirectories.h>
+#import <Batch/BALogger.h>
+#import <Batch/BAMSGImageCache.h>
+#import <Batch/BASHA.h>
+#import <Batch/BAStringUtils.h>
+#import "Defined.h"
+
+#define LOGGER_DOMAIN @"BAMSGImageCache"
+
+#define CODING_KEY_URL @"url"
+#define CODING_KEY_DATA @"data"
+#define CODING_KEY_ETAG @"etag"
+#define CODING_KEY_LAST_MODIFIED @"last_modified"
+#define CODING_KEY_EXPIRATION_DATE @"expiration_date"
+
+@implementation BAMSGCachedImage {
+    UIImage *_decodedImage;
+
+    // Max pixel size _decodedImage was decoded with, 0 meaning full size
+    CGFloat _decodedMaxPixelSize;
+}
+
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (instancetype)initWithURL:(NSURL *)url
+                       data:(NSData *)data
+                       etag:(nullable NSString *)etag
+               lastModified:(nullable NSString *)lastModified
+             expirationDate:(nullable NSDate *)expirationDate {
+    return [self initWithURLString:url.absoluteString
+                              data:data
+                              etag:etag
+                      lastModified:lastModified
+                    expirationDate:expirationDate];
+}
+
+- (instancetype)initWithURLString:(NSString *)url
+                             data:(NSData *)data
+                             etag:(nullable NSString *)etag
+                     lastModified:(nullable NSString *)lastModified
+                   expirationDate:(nullable NSDate *)expirationDate {
+    self = [super init];
+    if (self) {
+        _url = url;
+        _data = data;
+        _etag = etag;
+        _lastModified = lastModified;
+        _expirationDate = expirationDate;
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithCoder:(NSCoder *)coder {
+    NSString *url = [coder decodeObjectOfClass:NSString.class forKey:CODING_KEY_URL];
+    NSData *data = [coder decodeObjectOfClass:NSData.class forKey:CODING_KEY_DATA];
+    if (url == nil || data == nil) {
+        return nil;
+    }
+    return [self initWithURLString:url
+                              data:data
+                              etag:[coder decodeObjectOfClass:NSString.class forKey:CODING_KEY_ETAG]
+                      lastModified:[coder decodeObjectOfClass:NSString.class forKey:CODING_KEY_LAST_MODIFIED]
+                    expirationDate:[coder decodeObjectOfClass:NSDate.class forKey:CODING_KEY_EXPIRATION_DATE]];
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [coder encodeObject:_url forKey:CODING_KEY_URL];
+    [coder encodeObject:_data forKey:CODING_KEY_DATA];
+    [coder encodeObject:_etag forKey:CODING_KEY_ETAG];
+    [coder encodeObject:_lastModified forKey:CODING_KEY_LAST_MODIFIED];
+    [coder encodeObject:_expirationDate forKey:CODING_KEY_EXPIRATION_DATE];
+}
+
+- (BOOL)isFresh {
+    return _expirationDate != nil && [_expirationDate timeIntervalSinceNow] > 0;
+}
+
+- (BOOL)hasValidators {
+    return _etag != nil || _lastModified != nil;
+}
+
+- (NSUInteger)memoryCost {
+    @synchronized(self) {
+        CGImageRef cgImage = _decodedImage.CGImage;
+        NSUInteger bitmapCost = cgImage != NULL ? CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage) : 0;
+        return _data.length + bitmapCost;
+    }
+}
+
+- (nullable UIImage *)decodedImageForMaxPixelSize:(CGFloat)maxPixelSize {
+    @synchronized(self) {
+        if (_decodedImage == nil) {
+            return nil;
+        }
+        if (_decodedMaxPixelSize == 0 || (maxPixelSize > 0 && maxPixelSize <= _decodedMaxPixelSize)) {
+            return _decodedImage;
+        }
+        return nil;
+    }
+}
+
+- (void)setDecodedImage:(UIImage *)image maxPixelSize:(CGFloat)maxPixelSize {
+    @synchronized(self) {
+        if (_decodedImage != nil &&
+            (_decodedMaxPixelSize == 0 || (maxPixelSize > 0 && maxPixelSize <= _decodedMaxPixelSize))) {
+            return;
+        }
+        _decodedImage = image;
+        _decodedMaxPixelSize = maxPixelSize;
+    }
+}
+
+- (BAMSGCachedImage *)revalidatedCopyWithExpirationDate:(nullable NSDate *)expirationDate {
+    BAMSGCachedImage *copy = [[BAMSGCachedImage alloc] initWithURLString:_url
+                                                                    data:_data
+                                                                    etag:_etag
+                                                            lastModified:_lastModified
+                                                          expirationDate:expirationDate];
+    @synchronized(self) {
+        if (_decodedImage != nil) {
+            [copy setDecodedImage:_decodedImage maxPixelSize:_decodedMaxPixelSize];
+        }
+    }
+    return copy;
+}
+
+@end
+
+@implementation BAMSGImageCache {
+    NSCache<NSString *, BAMSGCachedImage *> *_memoryCache;
+
+    // Serial queue guarding the disk tier
+    dispatch_queue_t _ioQueue;
+}
+
++ (NSString *)defaultDirectory {
+    return [[[BADirectories pathForCacheDirectory] stringByAppendingPathComponent:BABundleIdentifier]
+        stringByAppendingPathComponent:@"messaging_images"];
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory
+                  memoryCostLimit:(NSUInteger)memoryCostLimit
+                    diskSizeLimit:(unsigned long long)diskSizeLimit {
+    self = [super init];
+    if (self) {
+        _directory = directory;
+        _diskSizeLimit = diskSizeLimit;
+        _memoryCache = [NSCache new];
+        _memoryCache.totalCostLimit = memoryCostLimit;
+        _ioQueue = dispatch_queue_create("com.batch.ios.msg.imagecache", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (nullable BAMSGCachedImage *)cachedImageForURL:(NSURL *)url {
+    NSString *key = url.absoluteString;
+    if (key == nil) {
+        return nil;
+    }
+
+    BAMSGCachedImage *image = [_memoryCache objectForKey:key];
+    if (image != nil) {
+        return image;
+    }
+
+    __block BAMSGCachedImage *diskImage = nil;
+    dispatch_sync(_ioQueue, ^{
+      diskImage = [self readImageForKey:key];
+    });
+
+    if (diskImage != nil) {
+        [_memoryCache setObject:diskImage forKey:key cost:diskImage.memoryCost];
+    }
+    return diskImage;
+}
+
+- (void)storeImage:(BAMSGCachedImage *)image {
+    [_memoryCache setObject:image forKey:image.url cost:image.memoryCost];
+
+    dispatch_async(_ioQueue, ^{
+      [self writeImage:image];
+      [self trimDiskCacheOnQueue];
+    });
+}
+
+- (void)removeImageForURL:(NSURL *)url {
+    NSString *key = url.absoluteString;
+    if (key == nil) {
+        return;
+    }
+
+    [_memoryCache removeObjectForKey:key];
+    dispatch_sync(_ioQueue, ^{
+      [[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:key] error:nil];
+    });
+}
+
+- (void)updateMemoryCostForImage:(BAMSGCachedImage *)image {
+    // Re-adding the image is the only way to update its cost. Don't resurrect an image that has been evicted.
+    if ([_memoryCache objectForKey:image.url] == image) {
+        [_memoryCache setObject:image forKey:image.url cost:image.memoryCost];
+    }
+}
+
+- (void)removeAllImages {
+    [_memoryCache removeAllObjects];
+    dispatch_sync(_ioQueue, ^{
+      [[NSFileManager defaultManager] removeItemAtPath:self->_directory error:nil];
+    });
+}
+
+- (void)trimDiskCache {
+    dispatch_sync(_ioQueue, ^{
+      [self trimDiskCacheOnQueue];
+    });
+}
+
+#pragma mark Disk tier
+
+- (NSString *)pathForKey:(NSString *)key {
+    NSData *hash = [BASHA sha256HashOf:[key dataUsingEncoding:NSUTF8StringEncoding]];
+    return [_directory stringByAppendingPathComponent:[BAStringUtils hexStringValueForData:hash]];
+}
+
+- (nullable BAMSGCachedImage *)readImageForKey:(NSString *)key {
+    NSString *path = [self pathForKey:key];
+    NSData *archive = [NSData dataWithContentsOfFile:path];
+    if (archive == nil) {
+        return nil;
+    }
+
+    NSError *err = nil;
+    BAMSGCachedImage *image = [NSKeyedUnarchiver unarchivedObjectOfClass:BAMSGCachedImage.class
+                                                                fromData:archive
+                                                                   error:&err];
+    // Guard against corrupted files and (unlikely) hash collisions
+    if (image == nil || ![image.url isEqualToString:key]) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Discarding unreadable cached image: %@", err];
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+        return nil;
+    }
+
+    // Bump the modification date so that the LRU trimming considers this file as recently used
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate : [NSDate date]}
+                                     ofItemAtPath:path
+                                            error:nil];
+    return image;
+}
+
+- (void)writeImage:(BAMSGCachedImage *)image {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager fileExistsAtPath:_directory]) {
+        [fileManager createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+    }
+
+    NSError *err = nil;
+    NSData *archive = [NSKeyedArchiver archivedDataWithRootObject:image requiringSecureCoding:YES error:&err];
+    if (archive == nil) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Could not archive image: %@", err];
+        return;
+    }
+
+    if (![archive writeToFile:[self pathForKey:image.url] options:NSDataWritingAtomic error:&err]) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Could not write image to disk: %@", err];
+    }
+}
+
+- (void)trimDiskCacheOnQueue {
+    NSURL *directoryURL = [NSURL fileURLWithPath:_directory isDirectory:YES];
+    NSArray<NSURLResourceKey> *keys = @[ NSURLContentModificationDateKey, NSURLTotalFileAllocatedSizeKey ];
+    NSArray<NSURL *> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directoryURL
+                                                            includingPropertiesForKeys:keys
+                                                                               options:0
+                                                                                 error:nil];
+    if (files.count == 0) {
+        return;
+    }
+
+    unsigned long long totalSize = 0;
+    NSMutableDictionary<NSURL *, NSDictionary<NSURLResourceKey, id> *> *attributes = [NSMutableDictionary new];
+    for (NSURL *file in files) {
+        NSDictionary<NSURLResourceKey, id> *values = [file resourceValuesForKeys:keys error:nil];
+        if (values == nil) {
+            continue;
+        }
+        attributes[file] = values;
+        totalSize += [values[NSURLTotalFileAllocatedSizeKey] unsignedLongLongValue];
+    }
+
+    if (totalSize <= _diskSizeLimit) {
+        return;
+    }
+
+    NSArray<NSURL *> *sortedFiles = [attributes keysSortedByValueUsingComparator:^NSComparisonResult(id a, id b) {
+      return [a[NSURLContentModificationDateKey] compare:b[NSURLContentModificationDateKey]];
+    }];
+
+    for (NSURL *file in sortedFiles) {
+        if (totalSize <= _diskSizeLimit) {
+            break;
+        }
+        if ([[NSFileManager defaultManager] removeItemAtURL:file error:nil]) {
+            totalSize -= [attributes[file][NSURLTotalFileAllocatedSizeKey] unsignedLongLongValue];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,32 @@
+//
+//  BAMSGImageDecoder.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Decodes message images ahead of display.
+///
+/// UIImage decodes its bitmap lazily, on the main thread, the first time it is rendered. Images returned by this class
+/// have already been decoded, and are downsampled to the size they will be displayed at so that large images don't
+/// need a full resolution bitmap. Meant to be used from a background queue.
+@interface BAMSGImageDecoder : NSObject
+
+/// Decode an image, downsampling it so that its largest side is at most maxPixelSize pixels.
+/// A maxPixelSize of 0 decodes the image at its full size.
+/// Returns nil if the data is not a supported image.
++ (nullable UIImage *)decodedImageWithData:(NSData *)data maxPixelSize:(CGFloat)maxPixelSize;
+
+/// Largest side, in pixels, an image displayed in the given view can have.
+/// Falls back on the screen's size if the view hasn't been laid out yet, or if view is nil.
+/// Must be called on the main thread.
++ (CGFloat)maxPixelSizeForView:(nullable UIView *)view;
+
+@end
+
+NS_ASSUME_NONNULL_END
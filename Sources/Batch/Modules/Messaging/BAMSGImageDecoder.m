@@ -0,0 +1,72 @@
+//
+//  BAMSGImageDecoder.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMSGImageDecoder.h>
+#import <ImageIO/ImageIO.h>
+
+@implementation BAMSGImageDecoder
+
++ (nullable UIImage *)decodedImageWithData:(NSData *)data maxPixelSize:(CGFloat)maxPixelSize {
+    if (data.length == 0) {
+        return nil;
+    }
+
+    // Don't let ImageIO keep a decoded copy of the full size image around
+    NSDictionary *sourceOptions = @{(id)kCGImageSourceShouldCache : @NO};
+    CGImageSourceRef source =
+        CGImageSourceCreateWithData((__bridge CFDataRef)data, (__bridge CFDictionaryRef)sourceOptions);
+    if (source == NULL) {
+        return nil;
+    }
+
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, NULL));
+    CGFloat fullPixelSize = MAX([properties[(id)kCGImagePropertyPixelWidth] doubleValue],
+                                [properties[(id)kCGImagePropertyPixelHeight] doubleValue]);
+    if (fullPixelSize <= 0) {
+        CFRelease(source);
+        return nil;
+    }
+
+    if (maxPixelSize <= 0 || maxPixelSize > fullPixelSize) {
+        maxPixelSize = fullPixelSize;
+    }
+
+    NSDictionary *thumbnailOptions = @{
+        (id)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+        (id)kCGImageSourceCreateThumbnailWithTransform : @YES,
+        (id)kCGImageSourceThumbnailMaxPixelSize : @(maxPixelSize),
+        // Decode now, rather than on the main thread on first render
+        (id)kCGImageSourceShouldCacheImmediately : @YES,
+    };
+
+    CGImageRef cgImage = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)thumbnailOptions);
+    CFRelease(source);
+
+    if (cgImage == NULL) {
+        return nil;
+    }
+
+    // Keep the size in points of [UIImage imageWithData:], so that layouts relying on the image's size don't change
+    // (a downsampled image gets a scale below 1)
+    CGFloat scale = MAX(CGImageGetWidth(cgImage), CGImageGetHeight(cgImage)) / fullPixelSize;
+    UIImage *image = [UIImage imageWithCGImage:cgImage scale:scale orientation:UIImageOrientationUp];
+    CGImageRelease(cgImage);
+    return image;
+}
+
++ (CGFloat)maxPixelSizeForView:(nullable UIView *)view {
+    UIScreen *screen = view.window.screen ?: [UIScreen mainScreen];
+
+    CGSize size = view.bounds.size;
+    if (size.width <= 0 || size.height <= 0) {
+        size = screen.bounds.size;
+    }
+
+    return ceil(MAX(size.width, size.height) * screen.scale);
+}
+
+@end
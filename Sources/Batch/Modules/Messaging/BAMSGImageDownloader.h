@@ -10,6 +10,7 @@
 
 @interface BAMSGImageDownloader : NSObject
 
+/// Download an image, decoding static images at full size
 + (void)downloadImageForURL:(NSURL *_Nonnull)url
             downloadTimeout:(NSTimeInterval)timeout
           completionHandler:(void (^__nonnull)(NSData *_Nullable rawData,
@@ -17,4 +18,15 @@
                                                UIImage *_Nullable image,
                                                NSError *_Nullable error))completionHandler;
 
+/// Download an image, decoding static images off the main thread so that their largest side is at most maxPixelSize
+/// pixels. Use [BAMSGImageDecoder maxPixelSizeForView:] to get the size matching the view the image will be shown in.
+/// Local file images are read in the background, and their completion is called on the main thread.
++ (void)downloadImageForURL:(NSURL *_Nonnull)url
+            downloadTimeout:(NSTimeInterval)timeout
+               maxPixelSize:(CGFloat)maxPixelSize
+          completionHandler:(void (^__nonnull)(NSData *_Nullable rawData,
+                                               BOOL isGif,
+                                               UIImage *_Nullable image,
+                                               NSError *_Nullable error))completionHandler;
+
 @end
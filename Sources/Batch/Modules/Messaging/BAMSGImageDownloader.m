@@ -6,11 +6,10 @@
 //
 
 #import <Batch/BAInjection.h>
+#import <Batch/BAMSGImageDecoder.h>
 #import <Batch/BAMSGImageDownloader.h>
-#import <Batch/BAMetricRegistry.h>
+#import <Batch/BAMSGImagePipeline.h>
 #import <Batch/BATGIFFile.h>
-#import "BAObservation.h"
-#import "BATMessagingCloseErrorCause.h"
 
 @implementation BAMSGImageDownloader
 
@@ -19,8 +18,17 @@
           completionHandler:(void (^__nonnull)(NSData *_Nullable rawData,
                                                BOOL isGif,
                                                UIImage *_Nullable image,
-                                               NSError *_Nullable error))completionHandler;
-{
+                                               NSError *_Nullable error))completionHandler {
+    [self downloadImageForURL:url downloadTimeout:timeout maxPixelSize:0 completionHandler:completionHandler];
+}
+
++ (void)downloadImageForURL:(NSURL *_Nonnull)url
+            downloadTimeout:(NSTimeInterval)timeout
+               maxPixelSize:(CGFloat)maxPixelSize
+          completionHandler:(void (^__nonnull)(NSData *_Nullable rawData,
+                                               BOOL isGif,
+                                               UIImage *_Nullable image,
+                                               NSError *_Nullable error))completionHandler {
     if (!completionHandler) {
         return;
     }
@@ -32,134 +40,44 @@
             NSString *localImagePath = [NSString stringWithCString:filesystemRepresentation
                                                           encoding:NSUTF8StringEncoding];
 
-            NSData *imageData = [NSData dataWithContentsOfFile:localImagePath];
-
-            if (imageData == nil) {
-                completionHandler(
-                    nil, false, nil,
-                    [NSError
-                        errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                   code:-5
-                               userInfo:@{NSLocalizedDescriptionKey : @"Unable to create NSData from local file"}]);
-                return;
-            }
-
-            if ([BATGIFFile isPotentiallyAGif:imageData]) {
-                completionHandler(imageData, true, nil, nil);
-                return;
-            }
-
-            UIImage *image = [UIImage imageWithData:imageData];
-
-            if (image != nil) {
-                completionHandler(imageData, false, image, nil);
-            } else {
-                completionHandler(
-                    nil, false, nil,
-                    [NSError
-                        errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                   code:-6
-                               userInfo:@{NSLocalizedDescriptionKey : @"Unable to create UIImage from local file"}]);
-            }
+            // Reading and decoding the file can be slow: do it in the background, but keep calling back on the main
+            // thread as callers update their views right away
+            dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+              NSData *imageData = [NSData dataWithContentsOfFile:localImagePath];
+              BOOL isGif = false;
+              UIImage *image = nil;
+              NSError *error = nil;
+
+              if (imageData == nil) {
+                  error = [NSError
+                      errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
+                                 code:-5
+                             userInfo:@{NSLocalizedDescriptionKey : @"Unable to create NSData from local file"}];
+              } else if ([BATGIFFile isPotentiallyAGif:imageData]) {
+                  isGif = true;
+              } else {
+                  image = [BAMSGImageDecoder decodedImageWithData:imageData maxPixelSize:maxPixelSize];
+                  if (image == nil) {
+                      imageData = nil;
+                      error = [NSError
+                          errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
+                                     code:-6
+                                 userInfo:@{NSLocalizedDescriptionKey : @"Unable to create UIImage from local file"}];
+                  }
+              }
 
+              dispatch_async(dispatch_get_main_queue(), ^{
+                completionHandler(imageData, isGif, image, error);
+              });
+            });
             return;
         }
     }
 
-    BAObservation *downloadTime =
-        [[BAInjection injectClass:BAMetricRegistry.class] registerNewDownloadImageDurationMetric];
-    NSURLSessionConfiguration *config = [NSURLSessionConfiguration defaultSessionConfiguration];
-    config.timeoutIntervalForResource = timeout;
-    // Enforce TLS 1.2
-    config.TLSMinimumSupportedProtocolVersion = tls_protocol_version_TLSv12;
-
-    NSURLSession *session = [NSURLSession sessionWithConfiguration:config delegate:nil delegateQueue:nil];
-
-    NSURLSessionDataTask *task = [session
-          dataTaskWithURL:url
-        completionHandler:^(NSData *_Nullable data, NSURLResponse *_Nullable response, NSError *_Nullable error) {
-          if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
-              NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
-              if (httpResponse.statusCode < 200 || httpResponse.statusCode >= 300) {
-                  [downloadTime observeDuration];
-                  [[[BAInjection injectClass:BAMetricRegistry.class] downloadingImageErrorCount] increment];
-                  completionHandler(
-                      nil, false, nil,
-                      error
-                          ? error
-                          : [NSError
-                                errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                           code:-1
-                                       userInfo:@{
-                                           NSLocalizedDescriptionKey : [NSString
-                                               stringWithFormat:@"Server returned a non successful statuscode (%ld)",
-                                                                (long)httpResponse.statusCode],
-                                           kBATMessagingCloseErrorCauseKey : @(BATMessagingCloseErrorCauseServerFailure)
-                                       }]);
-                  return;
-              }
-
-              if (!data) {
-                  [downloadTime observeDuration];
-                  [[[BAInjection injectClass:BAMetricRegistry.class] downloadingImageErrorCount] increment];
-                  completionHandler(nil, false, nil,
-                                    error ? error
-                                          : [NSError errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                                                code:-2
-                                                            userInfo:@{
-                                                                NSLocalizedDescriptionKey : @"Response data is nil",
-                                                                kBATMessagingCloseErrorCauseKey :
-                                                                    @(BATMessagingCloseErrorCauseInvalidResponse)
-                                                            }]);
-                  return;
-              }
-
-              if ([BATGIFFile isPotentiallyAGif:data]) {
-                  NSArray<NSString *> *labels = [[NSArray alloc] initWithObjects:@"gif", nil];
-                  [[downloadTime labels:labels] observeDuration];
-                  completionHandler(data, true, nil, nil);
-                  return;
-              }
-
-              UIImage *image = [UIImage imageWithData:data];
-
-              if (!image) {
-                  [downloadTime observeDuration];
-                  [[[BAInjection injectClass:BAMetricRegistry.class] downloadingImageErrorCount] increment];
-                  completionHandler(
-                      nil, false, nil,
-                      error ? error
-                            : [NSError errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                                  code:-3
-                                              userInfo:@{
-                                                  NSLocalizedDescriptionKey : @"Unable to create UIImage from data",
-                                                  kBATMessagingCloseErrorCauseKey :
-                                                      @(BATMessagingCloseErrorCauseInvalidResponse)
-                                              }]);
-                  return;
-              }
-
-              NSArray<NSString *> *labels = [[NSArray alloc] initWithObjects:@"image", nil];
-              [[downloadTime labels:labels] observeDuration];
-              completionHandler(data, false, image, nil);
-          } else {
-              [downloadTime observeDuration];
-              [[[BAInjection injectClass:BAMetricRegistry.class] downloadingImageErrorCount] increment];
-              completionHandler(
-                  nil, false, nil,
-                  error ? error
-                        : [NSError
-                              errorWithDomain:@"com.batch.ios.BAMSGImageDownloaderError"
-                                         code:-4
-                                     userInfo:@{
-                                         NSLocalizedDescriptionKey : @"Response was not a NSHTTPURLResponse",
-                                         kBATMessagingCloseErrorCauseKey : @(BATMessagingCloseErrorCauseServerFailure)
-                                     }]);
-              return;
-          }
-        }];
-    [downloadTime startTimer];
-    [task resume];
+    [[BAInjection injectClass:BAMSGImagePipeline.class] loadImageForURL:url
+                                                                 timeout:timeout
+                                                            maxPixelSize:maxPixelSize
+                                                       completionHandler:completionHandler];
 }
 
 @end
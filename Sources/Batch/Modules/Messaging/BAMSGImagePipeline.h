@@ -0,0 +1,55 @@
+//
+//  BAMSGImagePipeline.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMSGImageCache.h>
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^BAMSGImagePipelineCompletionHandler)(NSData *_Nullable rawData,
+                                                    BOOL isGif,
+                                                    UIImage *_Nullable image,
+                                                    NSError *_Nullable error);
+
+/// downloadedBytes is 0 when the image was already in the cache, or has only been revalidated
+typedef void (^BAMSGImagePipelinePrefetchHandler)(NSUInteger downloadedBytes, NSError *_Nullable error);
+
+/// Shared loader for remote in-app message images.
+///
+/// Images are served from a two-tier cache (see BAMSGImageCache) when fresh, and revalidated using their
+/// ETag/Last-Modified validators when stale. Concurrent requests for the same URL are coalesced into a single
+/// network request: the timeout of the first request applies to all of them.
+///
+/// Completion handlers are called on a background queue.
+@interface BAMSGImagePipeline : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+                                       cache:(BAMSGImageCache *)cache NS_DESIGNATED_INITIALIZER;
+
++ (BAMSGImagePipeline *)sharedPipeline;
+
+/// Load an image. Static images are decoded off the main thread, downsampled so that their largest side is at most
+/// maxPixelSize pixels, or at full size if maxPixelSize is 0. See BAMSGImageDecoder.
+- (void)loadImageForURL:(NSURL *)url
+                timeout:(NSTimeInterval)timeout
+           maxPixelSize:(CGFloat)maxPixelSize
+      completionHandler:(BAMSGImagePipelineCompletionHandler)completionHandler;
+
+/// Download an image into the cache, if it isn't there already, so that it can be displayed without waiting on the
+/// network later. The image isn't decoded.
+- (void)prefetchImageForURL:(NSURL *)url
+                    timeout:(NSTimeInterval)timeout
+          completionHandler:(BAMSGImagePipelinePrefetchHandler)completionHandler;
+
+@property (readonly) BAMSGImageCache *cache;
+
+@end
+
+NS_ASSUME_NONNULL_END
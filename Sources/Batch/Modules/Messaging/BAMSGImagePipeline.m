@@ -0,0 +1,472 @@
+//
+//  BAMSGImagePipeline.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAInjection.h>
+#import <Batch/BALogger.h>
+#import <Batch/BAMSGImageDecoder.h>
+#import <Batch/BAMSGImagePipeline.h>
+#import <Batch/BAMetricRegistry.h>
+#import <Batch/BATGIFFile.h>
+#import "BAObservation.h"
+#import "BATMessagingCloseErrorCause.h"
+
+#define LOGGER_DOMAIN @"BAMSGImagePipeline"
+
+#define ERROR_DOMAIN @"com.batch.ios.BAMSGImageDownloaderError"
+
+// 20MB of images kept in memory, 50MB on disk
+#define MEMORY_COST_LIMIT (20 * 1024 * 1024)
+#define DISK_SIZE_LIMIT (50 * 1024 * 1024)
+
+// Freshness lifetime of images served without any caching directive
+#define DEFAULT_FRESHNESS_LIFETIME (60 * 60)
+
+/// A caller waiting for an image. Prefetch requests only have a prefetchHandler, and don't need the image decoded.
+@interface BAMSGImageLoadRequest : NSObject
+
+@property (readonly) CGFloat maxPixelSize;
+
+@property (readonly, nullable) BAMSGImagePipelineCompletionHandler completionHandler;
+
+@property (readonly, nullable) BAMSGImagePipelinePrefetchHandler prefetchHandler;
+
+@end
+
+@implementation BAMSGImageLoadRequest
+
+- (instancetype)initWithMaxPixelSize:(CGFloat)maxPixelSize
+                   completionHandler:(BAMSGImagePipelineCompletionHandler)completionHandler {
+    self = [super init];
+    if (self) {
+        _maxPixelSize = maxPixelSize;
+        _completionHandler = completionHandler;
+    }
+    return self;
+}
+
+- (instancetype)initWithPrefetchHandler:(BAMSGImagePipelinePrefetchHandler)prefetchHandler {
+    self = [super init];
+    if (self) {
+        _prefetchHandler = prefetchHandler;
+    }
+    return self;
+}
+
+- (void)failWithError:(NSError *)error {
+    if (_prefetchHandler != nil) {
+        _prefetchHandler(0, error);
+    } else {
+        _completionHandler(nil, false, nil, error);
+    }
+}
+
+@end
+
+@implementation BAMSGImagePipeline {
+    NSURLSession *_session;
+
+    // Serial queue on which the in flight requests are tracked and network responses are handled
+    dispatch_queue_t _queue;
+
+    // Requests waiting for a network request, by URL
+    NSMutableDictionary<NSString *, NSMutableArray<BAMSGImageLoadRequest *> *> *_inFlightRequests;
+}
+
++ (BAMSGImagePipeline *)sharedPipeline {
+    static BAMSGImagePipeline *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      NSURLSessionConfiguration *config = [NSURLSessionConfiguration defaultSessionConfiguration];
+      BAMSGImageCache *cache = [[BAMSGImageCache alloc] initWithDirectory:[BAMSGImageCache defaultDirectory]
+                                                          memoryCostLimit:MEMORY_COST_LIMIT
+                                                            diskSizeLimit:DISK_SIZE_LIMIT];
+      sharedInstance = [[BAMSGImagePipeline alloc] initWithSessionConfiguration:config cache:cache];
+    });
+
+    return sharedInstance;
+}
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+                                       cache:(BAMSGImageCache *)cache {
+    self = [super init];
+    if (self) {
+        _cache = cache;
+        _queue = dispatch_queue_create("com.batch.ios.msg.imagepipeline", DISPATCH_QUEUE_SERIAL);
+        _inFlightRequests = [NSMutableDictionary new];
+
+        NSURLSessionConfiguration *config = [configuration copy];
+        // We have our own cache, and do our own revalidation
+        config.URLCache = nil;
+        config.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        // Enforce TLS 1.2
+        config.TLSMinimumSupportedProtocolVersion = tls_protocol_version_TLSv12;
+
+        NSOperationQueue *delegateQueue = [NSOperationQueue new];
+        delegateQueue.underlyingQueue = _queue;
+        delegateQueue.maxConcurrentOperationCount = 1;
+        _session = [NSURLSession sessionWithConfiguration:config delegate:nil delegateQueue:delegateQueue];
+    }
+    return self;
+}
+
+- (void)loadImageForURL:(NSURL *)url
+                timeout:(NSTimeInterval)timeout
+           maxPixelSize:(CGFloat)maxPixelSize
+      completionHandler:(BAMSGImagePipelineCompletionHandler)completionHandler {
+    BAMSGImageLoadRequest *request = [[BAMSGImageLoadRequest alloc] initWithMaxPixelSize:maxPixelSize
+                                                                       completionHandler:completionHandler];
+    [self enqueueRequest:request forURL:url timeout:timeout];
+}
+
+- (void)prefetchImageForURL:(NSURL *)url
+                    timeout:(NSTimeInterval)timeout
+          completionHandler:(BAMSGImagePipelinePrefetchHandler)completionHandler {
+    BAMSGImageLoadRequest *request = [[BAMSGImageLoadRequest alloc] initWithPrefetchHandler:completionHandler];
+    [self enqueueRequest:request forURL:url timeout:timeout];
+}
+
+- (void)enqueueRequest:(BAMSGImageLoadRequest *)request forURL:(NSURL *)url timeout:(NSTimeInterval)timeout {
+    NSString *key = url.absoluteString;
+    if (key == nil) {
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+          [request failWithError:[NSError errorWithDomain:ERROR_DOMAIN
+                                                     code:-4
+                                                 userInfo:@{NSLocalizedDescriptionKey : @"Invalid image URL"}]];
+        });
+        return;
+    }
+
+    dispatch_async(_queue, ^{
+      NSMutableArray<BAMSGImageLoadRequest *> *waitingRequests = self->_inFlightRequests[key];
+      if (waitingRequests != nil) {
+          [waitingRequests addObject:request];
+          return;
+      }
+
+      BAMSGCachedImage *cachedImage = [self->_cache cachedImageForURL:url];
+      if (cachedImage.isFresh) {
+          [self deliverCachedImage:cachedImage downloadedBytes:0 toRequests:@[ request ]];
+          return;
+      }
+
+      self->_inFlightRequests[key] = [NSMutableArray arrayWithObject:request];
+      [self startRequestForURL:url timeout:timeout cachedImage:cachedImage];
+    });
+}
+
+#pragma mark Network
+
+// Must be called on _queue
+- (void)startRequestForURL:(NSURL *)url
+                   timeout:(NSTimeInterval)timeout
+               cachedImage:(nullable BAMSGCachedImage *)cachedImage {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    if (timeout > 0) {
+        request.timeoutInterval = timeout;
+    }
+    if (cachedImage.etag != nil) {
+        [request setValue:cachedImage.etag forHTTPHeaderField:@"If-None-Match"];
+    }
+    if (cachedImage.lastModified != nil) {
+        [request setValue:cachedImage.lastModified forHTTPHeaderField:@"If-Modified-Since"];
+    }
+
+    BAObservation *downloadTime =
+        [[BAInjection injectClass:BAMetricRegistry.class] registerNewDownloadImageDurationMetric];
+
+    // The request timeout only covers idle time: enforce an overall timeout, like timeoutIntervalForResource would.
+    // Both the timer and the completion handler run on _queue, so this flag doesn't need any further locking.
+    __block BOOL timedOut = false;
+
+    NSURLSessionDataTask *task = [_session
+        dataTaskWithRequest:request
+          completionHandler:^(NSData *_Nullable data, NSURLResponse *_Nullable response, NSError *_Nullable error) {
+            if (timedOut) {
+                error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+            }
+            [self handleResponse:response
+                            data:data
+                           error:error
+                          forURL:url
+                     cachedImage:cachedImage
+                    downloadTime:downloadTime];
+          }];
+
+    if (timeout > 0) {
+        __weak NSURLSessionDataTask *weakTask = task;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), _queue, ^{
+          NSURLSessionDataTask *strongTask = weakTask;
+          if (strongTask != nil && strongTask.state == NSURLSessionTaskStateRunning) {
+              timedOut = true;
+              [strongTask cancel];
+          }
+        });
+    }
+
+    // Prefetches shouldn't compete with images that are about to be displayed
+    if (![self requestsNeedDecoding:_inFlightRequests[url.absoluteString]]) {
+        task.priority = NSURLSessionTaskPriorityLow;
+    }
+
+    [downloadTime startTimer];
+    [task resume];
+}
+
+// Must be called on _queue
+- (void)handleResponse:(nullable NSURLResponse *)response
+                  data:(nullable NSData *)data
+                 error:(nullable NSError *)error
+                forURL:(NSURL *)url
+           cachedImage:(nullable BAMSGCachedImage *)cachedImage
+          downloadTime:(BAObservation *)downloadTime {
+    if (![response isKindOfClass:[NSHTTPURLResponse class]]) {
+        if (cachedImage != nil) {
+            // Serving a stale image is better than nothing if the server can't be reached
+            [BALogger debugForDomain:LOGGER_DOMAIN message:@"Could not revalidate image, using stale copy: %@", error];
+            [downloadTime observeDuration];
+            [self deliverCachedImage:cachedImage downloadedBytes:0 toRequests:[self takeRequestsForURL:url]];
+            return;
+        }
+        [self failRequestForURL:url
+                   downloadTime:downloadTime
+                          error:error ? error
+                                      : [NSError errorWithDomain:ERROR_DOMAIN
+                                                            code:-4
+                                                        userInfo:@{
+                                                            NSLocalizedDescriptionKey :
+                                                                @"Response was not a NSHTTPURLResponse",
+                                                            kBATMessagingCloseErrorCauseKey :
+                                                                @(BATMessagingCloseErrorCauseServerFailure)
+                                                        }]];
+        return;
+    }
+
+    NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
+
+    if (httpResponse.statusCode == 304 && cachedImage != nil) {
+        BAMSGCachedImage *revalidatedImage =
+            [cachedImage revalidatedCopyWithExpirationDate:[self expirationDateForResponse:httpResponse]];
+        [_cache storeImage:revalidatedImage];
+        [self observeDuration:downloadTime forImage:revalidatedImage];
+        [self deliverCachedImage:revalidatedImage downloadedBytes:0 toRequests:[self takeRequestsForURL:url]];
+        return;
+    }
+
+    if (httpResponse.statusCode < 200 || httpResponse.statusCode >= 300) {
+        NSString *description = [NSString
+            stringWithFormat:@"Server returned a non successful statuscode (%ld)", (long)httpResponse.statusCode];
+        [self failRequestForURL:url
+                   downloadTime:downloadTime
+                          error:error ? error
+                                      : [NSError errorWithDomain:ERROR_DOMAIN
+                                                            code:-1
+                                                        userInfo:@{
+                                                            NSLocalizedDescriptionKey : description,
+                                                            kBATMessagingCloseErrorCauseKey :
+                                                                @(BATMessagingCloseErrorCauseServerFailure)
+                                                        }]];
+        return;
+    }
+
+    if (!data) {
+        [self failRequestForURL:url
+                   downloadTime:downloadTime
+                          error:error ? error
+                                      : [NSError errorWithDomain:ERROR_DOMAIN
+                                                            code:-2
+                                                        userInfo:@{
+                                                            NSLocalizedDescriptionKey : @"Response data is nil",
+                                                            kBATMessagingCloseErrorCauseKey :
+                                                                @(BATMessagingCloseErrorCauseInvalidResponse)
+                                                        }]];
+        return;
+    }
+
+    NSString *etag = [httpResponse valueForHTTPHeaderField:@"ETag"];
+    NSString *lastModified = [httpResponse valueForHTTPHeaderField:@"Last-Modified"];
+    BAMSGCachedImage *image = [[BAMSGCachedImage alloc] initWithURL:url
+                                                               data:data
+                                                               etag:etag
+                                                       lastModified:lastModified
+                                                     expirationDate:[self expirationDateForResponse:httpResponse]];
+
+    NSArray<BAMSGImageLoadRequest *> *waitingRequests = _inFlightRequests[url.absoluteString];
+    if ([BATGIFFile isPotentiallyAGif:data] || ![self requestsNeedDecoding:waitingRequests]) {
+        [self storeDownloadedImage:image forURL:url response:httpResponse downloadTime:downloadTime];
+        return;
+    }
+
+    // Decode once for the largest size any waiting request needs, the others reuse it.
+    // Decoding is slow, so it runs off _queue: the session's callbacks and other requests shouldn't wait on it.
+    // The URL stays in flight meanwhile, so requests made until it's delivered join it rather than downloading again.
+    CGFloat maxPixelSize = [self largestMaxPixelSizeForRequests:waitingRequests];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      UIImage *decodedImage = [BAMSGImageDecoder decodedImageWithData:data maxPixelSize:maxPixelSize];
+      dispatch_async(self->_queue, ^{
+        if (decodedImage == nil) {
+            [self failRequestForURL:url
+                       downloadTime:downloadTime
+                              error:error ? error
+                                          : [NSError errorWithDomain:ERROR_DOMAIN
+                                                                code:-3
+                                                            userInfo:@{
+                                                                NSLocalizedDescriptionKey :
+                                                                    @"Unable to create UIImage from data",
+                                                                kBATMessagingCloseErrorCauseKey :
+                                                                    @(BATMessagingCloseErrorCauseInvalidResponse)
+                                                            }]];
+            return;
+        }
+        [image setDecodedImage:decodedImage maxPixelSize:maxPixelSize];
+        [self storeDownloadedImage:image forURL:url response:httpResponse downloadTime:downloadTime];
+      });
+    });
+}
+
+// Must be called on _queue
+- (void)storeDownloadedImage:(BAMSGCachedImage *)image
+                      forURL:(NSURL *)url
+                    response:(NSHTTPURLResponse *)response
+                downloadTime:(BAObservation *)downloadTime {
+    if ([self isResponseStorable:response]) {
+        [_cache storeImage:image];
+    } else {
+        [_cache removeImageForURL:url];
+    }
+
+    [self observeDuration:downloadTime forImage:image];
+    [self deliverCachedImage:image downloadedBytes:image.data.length toRequests:[self takeRequestsForURL:url]];
+}
+
+- (void)failRequestForURL:(NSURL *)url downloadTime:(BAObservation *)downloadTime error:(NSError *)error {
+    [downloadTime observeDuration];
+    [[[BAInjection injectClass:BAMetricRegistry.class] downloadingImageErrorCount] increment];
+
+    NSArray<BAMSGImageLoadRequest *> *requests = [self takeRequestsForURL:url];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      for (BAMSGImageLoadRequest *request in requests) {
+          [request failWithError:error];
+      }
+    });
+}
+
+- (void)observeDuration:(BAObservation *)downloadTime forImage:(BAMSGCachedImage *)image {
+    NSArray<NSString *> *labels = @[ [BATGIFFile isPotentiallyAGif:image.data] ? @"gif" : @"image" ];
+    [[downloadTime labels:labels] observeDuration];
+}
+
+#pragma mark Delivery
+
+// Must be called on _queue
+- (NSArray<BAMSGImageLoadRequest *> *)takeRequestsForURL:(NSURL *)url {
+    NSString *key = url.absoluteString;
+    NSArray<BAMSGImageLoadRequest *> *requests = _inFlightRequests[key] ?: @[];
+    [_inFlightRequests removeObjectForKey:key];
+    return requests;
+}
+
+- (BOOL)requestsNeedDecoding:(NSArray<BAMSGImageLoadRequest *> *)requests {
+    for (BAMSGImageLoadRequest *request in requests) {
+        if (request.prefetchHandler == nil) {
+            return true;
+        }
+    }
+    return false;
+}
+
+- (CGFloat)largestMaxPixelSizeForRequests:(NSArray<BAMSGImageLoadRequest *> *)requests {
+    CGFloat largest = -1;
+    for (BAMSGImageLoadRequest *request in requests) {
+        if (request.prefetchHandler != nil) {
+            continue;
+        }
+        if (request.maxPixelSize <= 0) {
+            // Full size
+            return 0;
+        }
+        largest = MAX(largest, request.maxPixelSize);
+    }
+    return MAX(largest, 0);
+}
+
+- (void)deliverCachedImage:(BAMSGCachedImage *)cachedImage
+           downloadedBytes:(NSUInteger)downloadedBytes
+                toRequests:(NSArray<BAMSGImageLoadRequest *> *)requests {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      NSData *data = cachedImage.data;
+      BOOL isGif = [BATGIFFile isPotentiallyAGif:data];
+
+      for (BAMSGImageLoadRequest *request in requests) {
+          if (request.prefetchHandler != nil) {
+              request.prefetchHandler(downloadedBytes, nil);
+              continue;
+          }
+
+          if (isGif) {
+              request.completionHandler(data, true, nil, nil);
+              continue;
+          }
+
+          // Images read back from the disk tier, or needed at a larger size, haven't been decoded yet
+          UIImage *image = [cachedImage decodedImageForMaxPixelSize:request.maxPixelSize];
+          if (image == nil) {
+              image = [BAMSGImageDecoder decodedImageWithData:data maxPixelSize:request.maxPixelSize];
+              if (image != nil) {
+                  [cachedImage setDecodedImage:image maxPixelSize:request.maxPixelSize];
+                  [self->_cache updateMemoryCostForImage:cachedImage];
+              }
+          }
+
+          if (image != nil) {
+              request.completionHandler(data, false, image, nil);
+          } else {
+              request.completionHandler(
+                  nil, false, nil,
+                  [NSError errorWithDomain:ERROR_DOMAIN
+                                      code:-3
+                                  userInfo:@{
+                                      NSLocalizedDescriptionKey : @"Unable to create UIImage from data",
+                                      kBATMessagingCloseErrorCauseKey : @(BATMessagingCloseErrorCauseInvalidResponse)
+                                  }]);
+          }
+      }
+    });
+}
+
+#pragma mark Caching directives
+
+- (BOOL)isResponseStorable:(NSHTTPURLResponse *)response {
+    NSString *cacheControl = [[response valueForHTTPHeaderField:@"Cache-Control"] lowercaseString];
+    return cacheControl == nil || [cacheControl rangeOfString:@"no-store"].location == NSNotFound;
+}
+
+- (nullable NSDate *)expirationDateForResponse:(NSHTTPURLResponse *)response {
+    NSString *cacheControl = [[response valueForHTTPHeaderField:@"Cache-Control"] lowercaseString];
+    if (cacheControl == nil) {
+        return [NSDate dateWithTimeIntervalSinceNow:DEFAULT_FRESHNESS_LIFETIME];
+    }
+
+    NSTimeInterval maxAge = -1;
+    for (NSString *rawDirective in [cacheControl componentsSeparatedByString:@","]) {
+        NSString *directive =
+            [rawDirective stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+        if ([directive isEqualToString:@"no-cache"]) {
+            // Must always be revalidated
+            return nil;
+        }
+        if ([directive hasPrefix:@"max-age="]) {
+            maxAge = [[directive substringFromIndex:@"max-age=".length] doubleValue];
+        }
+    }
+
+    if (maxAge < 0) {
+        return [NSDate dateWithTimeIntervalSinceNow:DEFAULT_FRESHNESS_LIFETIME];
+    }
+    return [NSDate dateWithTimeIntervalSinceNow:maxAge];
+}
+
+@end
@@ -23,6 +23,7 @@
 #import <Batch/Batch-Swift.h>
 #import <Batch/BatchPush.h>
 
+#import <Batch/BAMSGImageDecoder.h>
 #import <Batch/BAMSGImageDownloader.h>
 
 #import <Batch/BAActionsCenter.h>
@@ -33,7 +34,7 @@
 #import <Batch/BatchMessaging.h>
 #import <Batch/BatchMessagingPrivate.h>
 
-#import <Batch/BACSSBuiltinImportProvider.h>
+#import <Batch/BACSSDocumentCache.h>
 #import <Batch/BALocalCampaignsCenter.h>
 #import <Batch/BatchMessagingModels.h>
 
@@ -433,8 +434,10 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
 
         if (imageURL && !universalMessage.videoURL) {
             __weak BAMSGInterstitialViewController *weakVC = universalVC;
+            // The hero view isn't laid out yet: its image won't be larger than the screen
             [BAMSGImageDownloader downloadImageForURL:imageURL
                                       downloadTimeout:self.imageDownloadTimeout
+                                         maxPixelSize:[BAMSGImageDecoder maxPixelSizeForView:nil]
                                     completionHandler:^(NSData *_Nullable data, BOOL isGif, UIImage *_Nullable image,
                                                         NSError *_Nullable error) {
                                       if (isGif) {
@@ -806,6 +809,10 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
     return [BAInjection injectClass:BAEventDispatcherCenter.class];
 }
 
+- (BACSSDocumentCache *)cssDocumentCache {
+    return [BAInjection injectClass:BACSSDocumentCache.class];
+}
+
 /**
  Display a message on the most appropriate view controller Batch can find.
  Warning: this does NOT take into account the automatic mode switch
@@ -876,8 +883,7 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
                                                     shouldWaitForImage:(BOOL)waitForImage
                                                                  error:(NSError **)error {
     NSError *cssError = nil;
-    BACSSDocument *style = [[BACSSParser parserWithString:message.css
-                                        andImportProvider:[BACSSBuiltinImportProvider new]] parseWithError:&cssError];
+    BACSSDocument *style = [[self cssDocumentCache] documentForStylesheet:message.css error:&cssError];
     if (!style || cssError) {
         if (error) {
             *error = [NSError errorWithDomain:MESSAGING_ERROR_DOMAIN
@@ -954,8 +960,7 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
 
 - (BAMSGBannerViewController *)bannerViewControllerForMessage:(BAMSGMessageBanner *)message error:(NSError **)error {
     NSError *cssError = nil;
-    BACSSDocument *style = [[BACSSParser parserWithString:message.css
-                                        andImportProvider:[BACSSBuiltinImportProvider new]] parseWithError:&cssError];
+    BACSSDocument *style = [[self cssDocumentCache] documentForStylesheet:message.css error:&cssError];
     if (!style || cssError) {
         if (error) {
             *error = [NSError errorWithDomain:MESSAGING_ERROR_DOMAIN
@@ -979,8 +984,7 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
 
 - (BAMSGModalViewController *)modalViewControllerForMessage:(BAMSGMessageModal *)message error:(NSError **)error {
     NSError *cssError = nil;
-    BACSSDocument *style = [[BACSSParser parserWithString:message.css
-                                        andImportProvider:[BACSSBuiltinImportProvider new]] parseWithError:&cssError];
+    BACSSDocument *style = [[self cssDocumentCache] documentForStylesheet:message.css error:&cssError];
     if (!style || cssError) {
         if (error) {
             *error = [NSError errorWithDomain:MESSAGING_ERROR_DOMAIN
@@ -1004,8 +1008,7 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
 
 - (BAMSGImageViewController *)imageViewControllerForMessage:(BAMSGMessageImage *)message error:(NSError **)error {
     NSError *cssError = nil;
-    BACSSDocument *style = [[BACSSParser parserWithString:message.css
-                                        andImportProvider:[BACSSBuiltinImportProvider new]] parseWithError:&cssError];
+    BACSSDocument *style = [[self cssDocumentCache] documentForStylesheet:message.css error:&cssError];
     if (!style || cssError) {
         if (error) {
             *error = [NSError errorWithDomain:MESSAGING_ERROR_DOMAIN
@@ -1021,8 +1024,7 @@ NSString *const kBATMessagingMessageDidDisappear = @"batch.messaging.messageDidD
 
 - (BAMSGWebviewViewController *)webviewViewControllerForMessage:(BAMSGMessageWebView *)message error:(NSError **)error {
     NSError *cssError = nil;
-    BACSSDocument *style = [[BACSSParser parserWithString:message.css
-                                        andImportProvider:[BACSSBuiltinImportProvider new]] parseWithError:&cssError];
+    BACSSDocument *style = [[self cssDocumentCache] documentForStylesheet:message.css error:&cssError];
     if (!style || cssError) {
         if (error) {
             *error = [NSError errorWithDomain:MESSAGING_ERROR_DOMAIN
@@ -0,0 +1,63 @@
+//
+//  BATAttributedTextBuilder.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BATHtmlParser.h>
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Style of a whole text, which the transforms are applied on top of
+ */
+@interface BATAttributedTextStyle : NSObject <NSCopying>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithFont:(UIFont *)font NS_DESIGNATED_INITIALIZER;
+
+/**
+ Base font of the text
+ */
+@property (readonly) UIFont *font;
+
+/**
+ Custom fonts used for the bold and italic transforms. If fontOverride is nil, variants of the base font are used.
+ */
+@property (nullable) UIFont *fontOverride;
+
+@property (nullable) UIFont *boldFontOverride;
+
+@property (nullable) UIFont *italicFontOverride;
+
+@property (nullable) UIFont *boldItalicFontOverride;
+
+@property NSTextAlignment textAlignment;
+
+@property CGFloat lineSpacing;
+
+@property CGFloat lineHeightMultiple;
+
+@property CGFloat letterSpacing;
+
+@end
+
+/**
+ Builds the attributed strings of formatted texts, applying each transform's attributes in a single pass.
+ Built strings are cached per text, transforms and style.
+ */
+@interface BATAttributedTextBuilder : NSObject
+
++ (NSAttributedString *)attributedStringForText:(NSString *)text
+                                     transforms:(nullable NSArray<BATTextTransform *> *)transforms
+                                          style:(BATAttributedTextStyle *)style;
+
++ (void)removeAllCachedStrings;
+
+@end
+
+NS_ASSUME_NONNULL_END
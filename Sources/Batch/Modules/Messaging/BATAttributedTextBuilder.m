@@ -0,0 +1,259 @@
+//
+//  BATAttributedTextBuilder.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMSGStyle.h>
+#import <Batch/BATAttributedTextBuilder.h>
+
+// Built strings are small: keep enough for the texts of a few messages
+#define MAX_CACHED_STRINGS 64
+
+@implementation BATAttributedTextStyle
+
+- (instancetype)initWithFont:(UIFont *)font {
+    self = [super init];
+    if (self) {
+        _font = font;
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    BATAttributedTextStyle *copy = [[BATAttributedTextStyle alloc] initWithFont:_font];
+    copy.fontOverride = _fontOverride;
+    copy.boldFontOverride = _boldFontOverride;
+    copy.italicFontOverride = _italicFontOverride;
+    copy.boldItalicFontOverride = _boldItalicFontOverride;
+    copy.textAlignment = _textAlignment;
+    copy.lineSpacing = _lineSpacing;
+    copy.lineHeightMultiple = _lineHeightMultiple;
+    copy.letterSpacing = _letterSpacing;
+    return copy;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (self == object) {
+        return true;
+    }
+    if (![object isKindOfClass:[BATAttributedTextStyle class]]) {
+        return false;
+    }
+
+    BATAttributedTextStyle *other = object;
+    // Font overrides are global: comparing their identity is enough
+    return [_font isEqual:other.font] && _fontOverride == other.fontOverride &&
+           _boldFontOverride == other.boldFontOverride && _italicFontOverride == other.italicFontOverride &&
+           _boldItalicFontOverride == other.boldItalicFontOverride && _textAlignment == other.textAlignment &&
+           _lineSpacing == other.lineSpacing && _lineHeightMultiple == other.lineHeightMultiple &&
+           _letterSpacing == other.letterSpacing;
+}
+
+- (NSUInteger)hash {
+    return [_font hash] ^ (NSUInteger)_textAlignment ^ (NSUInteger)(_letterSpacing * 31) ^
+           (NSUInteger)(_lineHeightMultiple * 17) ^ (NSUInteger)(_lineSpacing * 7);
+}
+
+@end
+
+/**
+ Cache key: texts are compared by value, transforms by identity since they are shared by a message's views
+ */
+@interface BATAttributedTextKey : NSObject
+
+- (instancetype)initWithText:(NSString *)text
+                  transforms:(nullable NSArray<BATTextTransform *> *)transforms
+                       style:(BATAttributedTextStyle *)style;
+
+@end
+
+@implementation BATAttributedTextKey {
+    NSString *_text;
+    NSArray<BATTextTransform *> *_transforms;
+    BATAttributedTextStyle *_style;
+}
+
+- (instancetype)initWithText:(NSString *)text
+                  transforms:(nullable NSArray<BATTextTransform *> *)transforms
+                       style:(BATAttributedTextStyle *)style {
+    self = [super init];
+    if (self) {
+        _text = [text copy];
+        _transforms = [transforms copy];
+        _style = [style copy];
+    }
+    return self;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[BATAttributedTextKey class]]) {
+        return false;
+    }
+
+    BATAttributedTextKey *other = object;
+    BOOL sameTransforms = _transforms == other->_transforms || [_transforms isEqualToArray:other->_transforms];
+    return sameTransforms && [_text isEqualToString:other->_text] && [_style isEqual:other->_style];
+}
+
+- (NSUInteger)hash {
+    return [_text hash] ^ [_style hash] ^ _transforms.count;
+}
+
+@end
+
+@implementation BATAttributedTextBuilder
+
++ (NSCache<BATAttributedTextKey *, NSAttributedString *> *)cache {
+    static NSCache *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      cache = [NSCache new];
+      cache.countLimit = MAX_CACHED_STRINGS;
+    });
+    return cache;
+}
+
++ (NSAttributedString *)attributedStringForText:(NSString *)text
+                                     transforms:(nullable NSArray<BATTextTransform *> *)transforms
+                                          style:(BATAttributedTextStyle *)style {
+    BATAttributedTextKey *key = [[BATAttributedTextKey alloc] initWithText:text transforms:transforms style:style];
+    NSAttributedString *attributedString = [[self cache] objectForKey:key];
+    if (attributedString == nil) {
+        attributedString = [self buildAttributedStringForText:text transforms:transforms style:style];
+        [[self cache] setObject:attributedString forKey:key];
+    }
+    return attributedString;
+}
+
++ (void)removeAllCachedStrings {
+    [[self cache] removeAllObjects];
+}
+
+#pragma mark Building
+
++ (NSAttributedString *)buildAttributedStringForText:(NSString *)text
+                                          transforms:(nullable NSArray<BATTextTransform *> *)transforms
+                                               style:(BATAttributedTextStyle *)style {
+    NSMutableDictionary *baseAttributes = [NSMutableDictionary new];
+    baseAttributes[NSFontAttributeName] = style.font;
+
+    if (style.lineSpacing != 0 || style.lineHeightMultiple != 0) {
+        NSMutableParagraphStyle *paragraphStyle = [[NSMutableParagraphStyle alloc] init];
+        if (style.lineSpacing != 0) {
+            [paragraphStyle setLineSpacing:style.lineSpacing];
+        }
+        if (style.lineHeightMultiple != 0) {
+            [paragraphStyle setLineHeightMultiple:style.lineHeightMultiple];
+        }
+        [paragraphStyle setAlignment:style.textAlignment];
+        baseAttributes[NSParagraphStyleAttributeName] = paragraphStyle;
+    }
+
+    if (style.letterSpacing != 0) {
+        baseAttributes[NSKernAttributeName] = @(style.letterSpacing);
+    }
+
+    NSMutableAttributedString *attributedString = [[NSMutableAttributedString alloc] initWithString:text
+                                                                                         attributes:baseAttributes];
+
+    // Reversing the iterator is important, otherwise composed styles will not work: nested transforms end first,
+    // and must override the transforms they're in
+    NSUInteger textLength = [text length];
+    for (BATTextTransform *transform in transforms.reverseObjectEnumerator) {
+        if (NSMaxRange(transform.range) > textLength) {
+            continue;
+        }
+        NSDictionary *attributes = [self attributesForTransform:transform style:style];
+        if ([attributes count] > 0) {
+            [attributedString addAttributes:attributes range:transform.range];
+        }
+    }
+
+    return [attributedString copy];
+}
+
++ (NSDictionary *)attributesForTransform:(BATTextTransform *)transform style:(BATAttributedTextStyle *)style {
+    NSMutableDictionary *attributes = [NSMutableDictionary new];
+    BATTextModifiers modifiers = transform.modifiers;
+
+    if ((modifiers & BATTextModifierBold) || (modifiers & BATTextModifierItalic) ||
+        (modifiers & BATTextModifierSmallerFont) || (modifiers & BATTextModifierBiggerFont)) {
+        UIFontDescriptorSymbolicTraits uiFontTraits = 0;
+        if (modifiers & BATTextModifierBold) {
+            uiFontTraits |= UIFontDescriptorTraitBold;
+        }
+        if (modifiers & BATTextModifierItalic) {
+            uiFontTraits |= UIFontDescriptorTraitItalic;
+        }
+
+        CGFloat fontSize = style.font.pointSize;
+        if (modifiers & BATTextModifierSmallerFont) {
+            fontSize *= 0.75;
+        } else if (modifiers & BATTextModifierBiggerFont) {
+            fontSize *= 1.25;
+        }
+
+        attributes[NSFontAttributeName] = [self fontVariantForTraits:uiFontTraits size:fontSize style:style];
+    }
+
+    if (modifiers & BATTextModifierUnderline) {
+        attributes[NSUnderlineStyleAttributeName] = @(NSUnderlineStyleSingle);
+    }
+
+    if (modifiers & BATTextModifierStrikethrough) {
+        // Yes, Strikethrough reuses the underline styling enum
+        attributes[NSStrikethroughStyleAttributeName] = @(NSUnderlineStyleSingle);
+    }
+
+    if (modifiers & BATTextModifierSpan) {
+        attributes[NSForegroundColorAttributeName] = [BAMSGStyle colorFromValue:transform.attributes[@"color"]];
+        attributes[NSBackgroundColorAttributeName] =
+            [BAMSGStyle colorFromValue:transform.attributes[@"background-color"]];
+    }
+
+    return attributes;
+}
+
+/**
+ Get a variant of the base font for the added traits
+
+ With support for the custom fonts
+ */
++ (UIFont *)fontVariantForTraits:(UIFontDescriptorSymbolicTraits)traits
+                            size:(CGFloat)size
+                           style:(BATAttributedTextStyle *)style {
+    UIFont *baseFont = style.font;
+    if (!traits) {
+        return [baseFont fontWithSize:size];
+    }
+
+    if (style.fontOverride != nil) {
+        // We have a custom font, work with that
+        UIFont *customFont = nil;
+
+        if (traits & UIFontDescriptorTraitBold) {
+            if (traits & UIFontDescriptorTraitItalic) {
+                customFont = style.boldItalicFontOverride;
+            } else {
+                customFont = style.boldFontOverride;
+            }
+        } else if (traits & UIFontDescriptorTraitItalic) {
+            customFont = style.italicFontOverride;
+        }
+
+        if (customFont == nil) {
+            customFont = style.fontOverride;
+        }
+
+        return [customFont fontWithSize:size];
+    }
+
+    // System font
+    UIFontDescriptor *fontDescriptor = [baseFont.fontDescriptor fontDescriptorWithSymbolicTraits:traits];
+    UIFont *computedFont = [UIFont fontWithDescriptor:fontDescriptor size:size];
+    return computedFont != nil ? computedFont : baseFont;
+}
+
+@end
@@ -9,6 +9,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+#define BAT_HTML_PARSER_ERROR_DOMAIN @"BATHtmlParsingErrorDomain"
+
 typedef NSDictionary<NSString *, NSString *> BATTextTransformAttributes;
 typedef NSMutableDictionary<NSString *, NSString *> BATMutableTextTransformAttributes;
 
@@ -39,7 +41,13 @@ typedef NS_OPTIONS(NSUInteger, BATTextModifiers) {
 
 @end
 
-@interface BATHtmlParser : NSObject <NSXMLParserDelegate>
+/**
+ Parser for the small HTML subset supported in messages.
+
+ Markup must be well formed XML: tags have to be closed (including "<br/>"), and only XML's predefined entities,
+ numeric character references and "&nbsp;" are supported. Whitespace is collapsed like HTML does.
+ */
+@interface BATHtmlParser : NSObject
 
 /**
  Unstyled text
@@ -70,28 +70,49 @@
 
 @end
 
+// Matches XML's whitespace
+static inline BOOL BATHtmlIsWhitespace(unichar c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline BOOL BATHtmlIsNameCharacter(unichar c, BOOL first) {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || c > 0x7F) {
+        return true;
+    }
+    return !first && ((c >= '0' && c <= '9') || c == '-' || c == '.');
+}
+
 @implementation BATHtmlParser {
-    NSData *_htmlData;
-    NSMutableString *_taglessString;
+    NSString *_string;
+
+    // Tagless text being built. It can't be longer than the input: markup and entities are always longer than what
+    // they are replaced with.
+    unichar *_output;
+    NSUInteger _outputLength;
+    // Last character written in the current text run, to collapse whitespace
+    unichar _previousChar;
+
+    NSString *_taglessString;
     NSMutableArray<BATTextTransform *> *_transforms;
     NSMutableArray<BATTextTransform *> *_pendingTransforms;
+    // Names of the currently open elements, to check that they are properly closed
+    NSMutableArray<NSString *> *_openElements;
 }
 
 - (instancetype)initWithString:(NSString *)string {
     self = [super init];
     if (self) {
-        // We wrap the input string in tags if needed, so that we can parse it as valid XML
-        NSString *inputString = [NSString stringWithFormat:@"<html>%@</html>", [self replaceHtmlEntities:string]];
-        _htmlData = [inputString dataUsingEncoding:NSUTF8StringEncoding];
-        _taglessString = [[NSMutableString alloc] initWithCapacity:inputString.length];
+        _string = [string copy] ?: @"";
+        _taglessString = @"";
         _pendingTransforms = [NSMutableArray new];
         _transforms = [NSMutableArray new];
+        _openElements = [NSMutableArray new];
     }
     return self;
 }
 
 - (NSString *)text {
-    return [_taglessString copy];
+    return _taglessString;
 }
 
 - (NSArray<BATTextTransform *> *)transforms {
@@ -99,37 +120,394 @@
 }
 
 - (NSError *)parse {
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:_htmlData];
-    parser.delegate = self;
-    if ([parser parse]) {
+    [_transforms removeAllObjects];
+    [_pendingTransforms removeAllObjects];
+    [_openElements removeAllObjects];
+    _outputLength = 0;
+    _previousChar = '\0';
+
+    NSUInteger length = [_string length];
+    if (length == 0) {
+        _taglessString = @"";
         return nil;
+    }
+
+    // Read the string's storage directly if possible, only copy it otherwise
+    const unichar *chars = CFStringGetCharactersPtr((__bridge CFStringRef)_string);
+    unichar *copiedChars = NULL;
+    if (chars == NULL) {
+        copiedChars = malloc(length * sizeof(unichar));
+        if (copiedChars == NULL) {
+            return [self errorWithMessage:@"Could not allocate the parser's buffer" offset:0];
+        }
+        [_string getCharacters:copiedChars range:NSMakeRange(0, length)];
+        chars = copiedChars;
+    }
+
+    _output = malloc(length * sizeof(unichar));
+    if (_output == NULL) {
+        free(copiedChars);
+        return [self errorWithMessage:@"Could not allocate the parser's buffer" offset:0];
+    }
+
+    NSError *err = [self parseCharacters:chars length:length];
+    if (err == nil) {
+        _taglessString = [[NSString alloc] initWithCharacters:_output length:_outputLength];
+    } else {
+        _taglessString = @"";
+        [_transforms removeAllObjects];
+    }
+
+    free(_output);
+    _output = NULL;
+    free(copiedChars);
+    return err;
+}
+
+#pragma mark Scanning
+
+- (nullable NSError *)parseCharacters:(const unichar *)chars length:(NSUInteger)length {
+    NSUInteger i = 0;
+    while (i < length) {
+        unichar c = chars[i];
+
+        if (c == '<') {
+            // Markup ends the current text run
+            _previousChar = '\0';
+
+            NSError *err = nil;
+            if (i + 1 < length && chars[i + 1] == '/') {
+                err = [self parseEndTagInCharacters:chars length:length index:&i];
+            } else if ([self characters:chars length:length index:i hasPrefix:@"<!--"]) {
+                err = [self skipCommentInCharacters:chars length:length index:&i];
+            } else {
+                err = [self parseStartTagInCharacters:chars length:length index:&i];
+            }
+
+            if (err != nil) {
+                return err;
+            }
+        } else if (c == '&') {
+            unichar decoded[2];
+            NSUInteger decodedLength = 0;
+            NSError *err = [self decodeEntityInCharacters:chars
+                                                   length:length
+                                                    index:&i
+                                                   output:decoded
+                                             outputLength:&decodedLength];
+            if (err != nil) {
+                return err;
+            }
+            for (NSUInteger j = 0; j < decodedLength; j++) {
+                [self appendTextCharacter:decoded[j]];
+            }
+        } else {
+            // XML normalizes "\r\n" and "\r" to "\n"
+            if (c == '\r') {
+                if (i + 1 < length && chars[i + 1] == '\n') {
+                    i++;
+                    continue;
+                }
+                c = '\n';
+            }
+            [self appendTextCharacter:c];
+            i++;
+        }
+    }
+
+    if ([_openElements count] > 0) {
+        return [self errorWithMessage:[NSString stringWithFormat:@"Unclosed tag '%@'", [_openElements lastObject]]
+                               offset:length];
+    }
+
+    return nil;
+}
+
+- (void)appendTextCharacter:(unichar)c {
+    // HTML replaces \n with spaces
+    if (c == '\n') {
+        c = ' ';
+    }
+    if (_previousChar == ' ' && c == ' ') {
+        // HTML trims consecutive whitespaces
+        return;
+    }
+    _output[_outputLength++] = c;
+    _previousChar = c;
+}
+
+- (nullable NSError *)parseStartTagInCharacters:(const unichar *)chars
+                                         length:(NSUInteger)length
+                                          index:(NSUInteger *)index {
+    NSUInteger tagStart = *index;
+    NSUInteger i = tagStart + 1;
+
+    NSString *name = [self readNameInCharacters:chars length:length index:&i];
+    if (name == nil) {
+        return [self errorWithMessage:@"Invalid tag" offset:tagStart];
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *attributes = nil;
+    BOOL selfClosing = false;
+    while (true) {
+        BOOL skippedWhitespace = [self skipWhitespaceInCharacters:chars length:length index:&i];
+        if (i >= length) {
+            return [self errorWithMessage:@"Unterminated tag" offset:tagStart];
+        }
+
+        if (chars[i] == '>') {
+            i++;
+            break;
+        }
+        if (chars[i] == '/' && i + 1 < length && chars[i + 1] == '>') {
+            selfClosing = true;
+            i += 2;
+            break;
+        }
+
+        // Attributes must be separated from what precedes them
+        NSUInteger attributeStart = i;
+        NSString *attributeName = skippedWhitespace ? [self readNameInCharacters:chars length:length index:&i] : nil;
+        [self skipWhitespaceInCharacters:chars length:length index:&i];
+        if (attributeName == nil || i >= length || chars[i] != '=') {
+            return [self errorWithMessage:@"Invalid attribute" offset:attributeStart];
+        }
+        i++;
+        [self skipWhitespaceInCharacters:chars length:length index:&i];
+
+        NSString *attributeValue = [self readAttributeValueInCharacters:chars length:length index:&i];
+        if (attributeValue == nil || attributes[attributeName] != nil) {
+            return [self errorWithMessage:@"Invalid attribute" offset:attributeStart];
+        }
+
+        if (attributes == nil) {
+            attributes = [NSMutableDictionary new];
+        }
+        attributes[attributeName] = attributeValue;
+    }
+
+    *index = i;
+    [self didStartElement:name attributes:attributes];
+    if (selfClosing) {
+        [self didEndElement:name];
+    }
+    return nil;
+}
+
+- (nullable NSError *)parseEndTagInCharacters:(const unichar *)chars
+                                       length:(NSUInteger)length
+                                        index:(NSUInteger *)index {
+    NSUInteger tagStart = *index;
+    NSUInteger i = tagStart + 2;
+
+    NSString *name = [self readNameInCharacters:chars length:length index:&i];
+    [self skipWhitespaceInCharacters:chars length:length index:&i];
+    if (name == nil || i >= length || chars[i] != '>') {
+        return [self errorWithMessage:@"Invalid closing tag" offset:tagStart];
+    }
+
+    // Only the last opened tag can be closed
+    if (![name isEqualToString:[_openElements lastObject]]) {
+        return [self errorWithMessage:[NSString stringWithFormat:@"Unexpected closing tag '%@'", name]
+                               offset:tagStart];
+    }
+
+    *index = i + 1;
+    [self didEndElement:name];
+    return nil;
+}
+
+- (nullable NSError *)skipCommentInCharacters:(const unichar *)chars
+                                       length:(NSUInteger)length
+                                        index:(NSUInteger *)index {
+    for (NSUInteger i = *index + 4; i + 2 < length; i++) {
+        if (chars[i] == '-' && chars[i + 1] == '-' && chars[i + 2] == '>') {
+            *index = i + 3;
+            return nil;
+        }
+    }
+    return [self errorWithMessage:@"Unterminated comment" offset:*index];
+}
+
+/**
+ Decodes the entity starting at index, which can take up to two UTF-16 code units
+ */
+- (nullable NSError *)decodeEntityInCharacters:(const unichar *)chars
+                                        length:(NSUInteger)length
+                                         index:(NSUInteger *)index
+                                        output:(unichar *)output
+                                  outputLength:(NSUInteger *)outputLength {
+    NSUInteger entityStart = *index;
+    NSUInteger nameStart = entityStart + 1;
+    NSUInteger nameEnd = nameStart;
+    // Entity names we support are short: don't look for the ';' too far
+    while (nameEnd < length && nameEnd - nameStart < 10 && chars[nameEnd] != ';') {
+        nameEnd++;
+    }
+    if (nameEnd >= length || chars[nameEnd] != ';' || nameEnd == nameStart) {
+        return [self errorWithMessage:@"Invalid entity" offset:entityStart];
+    }
+
+    *index = nameEnd + 1;
+    *outputLength = 1;
+
+    NSString *name = [[NSString alloc] initWithCharacters:chars + nameStart length:nameEnd - nameStart];
+    if ([@"amp" isEqualToString:name]) {
+        output[0] = '&';
+    } else if ([@"lt" isEqualToString:name]) {
+        output[0] = '<';
+    } else if ([@"gt" isEqualToString:name]) {
+        output[0] = '>';
+    } else if ([@"quot" isEqualToString:name]) {
+        output[0] = '"';
+    } else if ([@"apos" isEqualToString:name]) {
+        output[0] = '\'';
+    } else if ([@"nbsp" isEqualToString:name]) {
+        output[0] = 0x00A0;
+    } else if ([name hasPrefix:@"#"]) {
+        UTF32Char codePoint = [self codePointFromCharacterReference:name];
+        if (codePoint == 0 || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return [self errorWithMessage:@"Invalid character reference" offset:entityStart];
+        }
+        if (CFStringGetSurrogatePairForLongCharacter(codePoint, output)) {
+            *outputLength = 2;
+        } else {
+            output[0] = (unichar)codePoint;
+        }
     } else {
-        return parser.parserError;
+        return [self errorWithMessage:[NSString stringWithFormat:@"Unknown entity '%@'", name] offset:entityStart];
+    }
+
+    return nil;
+}
+
+/**
+ Returns the code point of a "#123" or "#x7B" reference, or 0 if it's invalid
+ */
+- (UTF32Char)codePointFromCharacterReference:(NSString *)reference {
+    BOOL hexadecimal = [reference hasPrefix:@"#x"];
+    NSUInteger start = hexadecimal ? 2 : 1;
+    NSUInteger length = [reference length];
+    if (start >= length) {
+        return 0;
+    }
+
+    UTF32Char codePoint = 0;
+    for (NSUInteger i = start; i < length; i++) {
+        unichar c = [reference characterAtIndex:i];
+        UTF32Char digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (hexadecimal && c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (hexadecimal && c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return 0;
+        }
+        codePoint = codePoint * (hexadecimal ? 16 : 10) + digit;
+        if (codePoint > 0x10FFFF) {
+            return 0;
+        }
+    }
+    return codePoint;
+}
+
+- (nullable NSString *)readNameInCharacters:(const unichar *)chars length:(NSUInteger)length index:(NSUInteger *)index {
+    NSUInteger start = *index;
+    NSUInteger i = start;
+    while (i < length && BATHtmlIsNameCharacter(chars[i], i == start)) {
+        i++;
+    }
+    if (i == start) {
+        return nil;
+    }
+    *index = i;
+    return [[NSString alloc] initWithCharacters:chars + start length:i - start];
+}
+
+- (nullable NSString *)readAttributeValueInCharacters:(const unichar *)chars
+                                               length:(NSUInteger)length
+                                                index:(NSUInteger *)index {
+    NSUInteger i = *index;
+    if (i >= length || (chars[i] != '"' && chars[i] != '\'')) {
+        return nil;
+    }
+    unichar quote = chars[i];
+    i++;
+
+    NSMutableString *value = [NSMutableString new];
+    while (i < length && chars[i] != quote) {
+        unichar c = chars[i];
+        if (c == '<') {
+            return nil;
+        }
+        if (c == '&') {
+            unichar decoded[2];
+            NSUInteger decodedLength = 0;
+            if ([self decodeEntityInCharacters:chars
+                                        length:length
+                                         index:&i
+                                        output:decoded
+                                  outputLength:&decodedLength] != nil) {
+                return nil;
+            }
+            CFStringAppendCharacters((__bridge CFMutableStringRef)value, decoded, (CFIndex)decodedLength);
+            continue;
+        }
+        // XML normalizes whitespace in attribute values
+        if (BATHtmlIsWhitespace(c)) {
+            c = ' ';
+        }
+        CFStringAppendCharacters((__bridge CFMutableStringRef)value, &c, 1);
+        i++;
     }
-    // NSLog(@"finished");
+
+    if (i >= length) {
+        return nil;
+    }
+    *index = i + 1;
+    return value;
 }
 
-- (NSString *)replaceHtmlEntities:(NSString *)origString {
-    unichar nbsp = 0x00a0;
-    NSString *nbspString = [NSString stringWithCharacters:&nbsp length:1];
-    NSMutableString *workString = [NSMutableString stringWithString:origString];
+- (BOOL)skipWhitespaceInCharacters:(const unichar *)chars length:(NSUInteger)length index:(NSUInteger *)index {
+    NSUInteger start = *index;
+    while (*index < length && BATHtmlIsWhitespace(chars[*index])) {
+        (*index)++;
+    }
+    return *index > start;
+}
 
-    [workString replaceOccurrencesOfString:@"&nbsp;"
-                                withString:nbspString
-                                   options:NSLiteralSearch
-                                     range:NSMakeRange(0, [workString length])];
+- (BOOL)characters:(const unichar *)chars
+         length:(NSUInteger)length
+          index:(NSUInteger)index
+      hasPrefix:(NSString *)prefix {
+    NSUInteger prefixLength = [prefix length];
+    if (index + prefixLength > length) {
+        return false;
+    }
+    for (NSUInteger i = 0; i < prefixLength; i++) {
+        if (chars[index + i] != [prefix characterAtIndex:i]) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    return workString;
+- (NSError *)errorWithMessage:(NSString *)message offset:(NSUInteger)offset {
+    NSString *description = [NSString stringWithFormat:@"%@ at offset %lu", message, (unsigned long)offset];
+    return [NSError errorWithDomain:BAT_HTML_PARSER_ERROR_DOMAIN
+                               code:-1
+                           userInfo:@{NSLocalizedDescriptionKey : description}];
 }
 
-- (void)parser:(NSXMLParser *)parser
-    didStartElement:(NSString *)elementName
-       namespaceURI:(NSString *)namespaceURI
-      qualifiedName:(NSString *)qName
-         attributes:(NSDictionary<NSString *, NSString *> *)xmlAttributes {
-    // NSLog(@"< %@", elementName);
-    //  Opening a new tag created a new transform that inherits all past modifiers
-    //  Don't skip unknown modifiers so we can close them correctly, except br and html
+#pragma mark Elements
+
+- (void)didStartElement:(NSString *)elementName attributes:(nullable NSDictionary<NSString *, NSString *> *)attributes {
+    [_openElements addObject:elementName];
+
+    // Opening a new tag created a new transform that inherits all past modifiers
+    // Don't skip unknown modifiers so we can close them correctly, except br and html
     if ([@"html" isEqualToString:elementName] || [@"br" isEqualToString:elementName]) {
         return;
     }
@@ -142,67 +520,36 @@
 
     BATTextTransformAttributes *mergedAttributes = [BATTextTransformAttributes new];
 
-    if ([xmlAttributes count] > 0) {
-        mergedAttributes = [self mergeXmlAttributes:xmlAttributes
+    if ([attributes count] > 0) {
+        mergedAttributes = [self mergeXmlAttributes:attributes
                                        intoPrevious:previousTransform.attributes
                                         newModifier:newModifier];
     }
 
-    [_pendingTransforms addObject:[[BATTextTransform alloc] initWithLocation:_taglessString.length
+    [_pendingTransforms addObject:[[BATTextTransform alloc] initWithLocation:_outputLength
                                                                    modifiers:previousModifier | newModifier
                                                                   attributes:mergedAttributes]];
-
-    // NSLog(@"- %@ %@ %@", _taglessString, _pendingTransforms, _transforms);
 }
 
-- (void)parser:(NSXMLParser *)parser
-    didEndElement:(NSString *)elementName
-     namespaceURI:(NSString *)namespaceURI
-    qualifiedName:(NSString *)qName {
-    // NSLog(@"/ %@ >", elementName);
-    //  XML parser enforces that only the last opened tag can be closed, so we can "pop" it
+- (void)didEndElement:(NSString *)elementName {
+    // Only the last opened tag can be closed, so we can "pop" it
+    [_openElements removeLastObject];
+
+    if ([@"html" isEqualToString:elementName]) {
+        return;
+    }
 
     if ([@"br" isEqualToString:elementName]) {
-        [_taglessString appendString:@"\n"];
+        _output[_outputLength++] = '\n';
         return;
     }
 
     BATTextTransform *pendingTransform = [_pendingTransforms lastObject];
     [_pendingTransforms removeLastObject];
     if (pendingTransform.modifiers != BATTextModifierNone) {
-        [pendingTransform setEndLocation:_taglessString.length];
+        [pendingTransform setEndLocation:_outputLength];
         [_transforms addObject:pendingTransform];
     }
-
-    // NSLog(@"~ %@ %@ %@", _taglessString, _pendingTransforms, _transforms);
-}
-
-- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string {
-    NSUInteger len = [string length];
-    unichar inputBuffer[len + 1];
-    [string getCharacters:inputBuffer range:NSMakeRange(0, len)];
-
-    unichar outputBuffer[len];
-    NSUInteger outputPos = 0;
-    unichar previousChar = '\0';
-    unichar currentChar;
-    for (int i = 0; i < len; i++) {
-        currentChar = inputBuffer[i];
-        // HTML replaces \n with spaces
-        if (currentChar == '\n') {
-            currentChar = ' ';
-        }
-        if (previousChar == ' ' && currentChar == ' ') {
-            // HTML trims consecutive whitespaces
-            continue;
-        }
-        if (outputPos < len) {
-            outputBuffer[outputPos] = currentChar;
-            outputPos++;
-        }
-        previousChar = currentChar;
-    }
-    [_taglessString appendString:[NSString stringWithCharacters:outputBuffer length:MIN(len, outputPos)]];
 }
 
 - (BATTextModifiers)modifierForTag:(NSString *)tag {
@@ -9,9 +9,11 @@ struct InAppFontStyleBuilder {
         var rules: [String: String] = [:]
         fontStyle.fontSize.map { size in rules["font-size"] = size.formatted() }
 
-        let font = BAMSGStylableViewHelper.font(fromRules: rules, baseFont: fontStyle.fontOverride, baseBoldFont: fontStyle.fontBoldOverride)
+        let font = BAMSGStylableViewHelper.font(fromRules: rules, baseFont: fontStyle.fontOverride, baseBoldFont: fontStyle.fontBoldOverride) ?? labelFont
         let text = addDecoration(to: text, fontDecorationStyle: fontStyle)
-        return try fontStyle.buildAttributedString(with: text, font: font ?? labelFont)
+        return try InAppTextLayoutCache.sharedInstance.attributedString(text: text, font: font, fontStyle: fontStyle) {
+            try fontStyle.buildAttributedString(with: text, font: font)
+        }
     }
 
     static func addDecoration(to text: String, fontDecorationStyle: InAppFontDecorationStylizable) -> String {
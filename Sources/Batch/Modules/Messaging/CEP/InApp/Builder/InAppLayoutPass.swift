@@ -0,0 +1,188 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import UIKit
+
+/// The measured size of a component for an available width, and of its children for containers.
+struct InAppLayoutFrame: Equatable {
+    // MARK: - Properties
+
+    /// Size of the component's container, margins included.
+    let size: CGSize
+
+    /// Width the component's text wraps at, paddings excluded. `nil` for components without text.
+    let textWidth: CGFloat?
+
+    /// Frames of the children of a columns component, in display order.
+    let children: [InAppLayoutFrame]
+
+    static let zero = InAppLayoutFrame(size: .zero, textWidth: nil, children: [])
+
+    // MARK: - Initialization
+
+    init(size: CGSize, textWidth: CGFloat? = nil, children: [InAppLayoutFrame] = []) {
+        self.size = size
+        self.textWidth = textWidth
+        self.children = children
+    }
+}
+
+/// Measures the components of a message before their views are built.
+///
+/// Texts are the expensive part of a message's layout: building their attributed strings goes through the HTML parser
+/// and font lookups, and measuring them through TextKit. The pass only works on configurations, so it can run on a
+/// background thread when the message is loaded: the text caches it fills are then hit when the views are built.
+/// Once the views are built, the frames give labels their wrapping width and size up front, rather than having each
+/// of them discover their width in a second layout pass and measure their text on the main thread.
+enum InAppLayoutPass {
+    /// Content width messages are measured for before one has been displayed: the narrowest iPhone screen.
+    static let defaultContentWidth: CGFloat = 320
+
+    private static let lastContentWidthLock = NSLock()
+
+    private static var _lastContentWidth: CGFloat = 0
+
+    /// Content width of the last displayed message, which the next messages are likely to be displayed with.
+    static var lastContentWidth: CGFloat {
+        get {
+            lastContentWidthLock.lock()
+            defer { lastContentWidthLock.unlock() }
+            return _lastContentWidth
+        }
+        set {
+            lastContentWidthLock.lock()
+            defer { lastContentWidthLock.unlock() }
+            _lastContentWidth = newValue
+        }
+    }
+
+    // MARK: - Preparing
+
+    /// Measure a message's views ahead of its display, filling the text caches. Can be called from any thread.
+    /// - Parameter inAppMessage: The raw in-app message data.
+    /// - Returns: The frames of the message's views, for the width of the last displayed message.
+    @discardableResult
+    static func prepare(inAppMessage: InAppMessage) throws -> [InAppLayoutFrame] {
+        let width = lastContentWidth
+        return frames(for: try InAppMessageBuilder.viewBuilders(for: inAppMessage), width: width > 0 ? width : defaultContentWidth)
+    }
+
+    // MARK: - Measuring
+
+    /// Measure the views of a message.
+    /// - Parameters:
+    ///   - builders: The builders of the views, in display order.
+    ///   - width: The width of the message's content.
+    /// - Returns: A frame per builder.
+    static func frames(for builders: [InAppViewBuilder], width: CGFloat) -> [InAppLayoutFrame] {
+        return builders.map { $0.measure(width) }
+    }
+
+    /// Measure a text component: its height is the height of its text, wrapped at the content width.
+    static func measureText(
+        _ text: String,
+        fontStyle: InAppFontStylizable & InAppFontDecorationStylizable,
+        maxLines: Int,
+        placement: InAppContainerizable,
+        width: CGFloat
+    ) -> InAppLayoutFrame {
+        let textWidth = max(contentWidth(for: placement, width: width) - placement.paddings.left - placement.paddings.right, 0)
+        let labelFont = UIFont.systemFont(ofSize: UIFont.labelFontSize)
+        let attributedString = (try? InAppFontStyleBuilder.attributedString(text: text, fontStyle: fontStyle, labelFont: labelFont)) ?? NSAttributedString(string: text)
+        let textSize = InAppTextLayoutCache.sharedInstance.size(of: attributedString, width: textWidth, maxLines: maxLines)
+
+        let height =
+            switch placement.heightType {
+            case let .fixed(value): CGFloat(value)
+            default: textSize.height + placement.paddings.top + placement.paddings.bottom
+            }
+        return InAppLayoutFrame(size: containerSize(for: placement, width: width, height: height), textWidth: textWidth)
+    }
+
+    /// Measure a component without content of its own, sized by its placement only.
+    static func measureBox(placement: InAppContainerizable, width: CGFloat) -> InAppLayoutFrame {
+        let height: CGFloat =
+            switch placement.heightType {
+            case let .fixed(value): CGFloat(value)
+            default: 0
+            }
+        return InAppLayoutFrame(size: containerSize(for: placement, width: width, height: height))
+    }
+
+    /// Measure an image: automatic heights follow the aspect ratio of the image's estimated size.
+    static func measureImage(placement: InAppImageView.Configuration.Placement, width: CGFloat) -> InAppLayoutFrame {
+        guard placement.heightType == .auto, let estimateWidth = placement.estimateWidth, let estimateHeight = placement.estimateHeight,
+            estimateWidth > 0
+        else {
+            return measureBox(placement: placement, width: width)
+        }
+
+        let height = contentWidth(for: placement, width: width) / CGFloat(estimateWidth) * CGFloat(estimateHeight)
+        return InAppLayoutFrame(size: containerSize(for: placement, width: width, height: height))
+    }
+
+    /// Measure columns: each column gets its ratio of the width left once spacing is removed,
+    /// and the columns are as tall as their tallest child.
+    static func measureColumns(configuration: InAppColumnsView.Configuration, width: CGFloat) -> InAppLayoutFrame {
+        let placement = configuration.placement
+        let ratiosSum = CGFloat(configuration.ratios.reduce(0, +))
+        let spacing = CGFloat(configuration.style.spacing * max(configuration.builders.count - 1, 0))
+        let availableWidth = max(contentWidth(for: placement, width: width) - spacing, 0)
+
+        let children = configuration.builders.enumerated()
+            .map { index, builder -> InAppLayoutFrame in
+                guard let builder, ratiosSum > 0, index < configuration.ratios.count else { return .zero }
+                return builder.measure(availableWidth * CGFloat(configuration.ratios[index]) / ratiosSum)
+            }
+
+        let height = children.map(\.size.height).max() ?? 0
+        return InAppLayoutFrame(size: containerSize(for: placement, width: width, height: height), children: children)
+    }
+
+    /// Width of a container's content: its width type applied to the available width, margins excluded.
+    static func contentWidth(for placement: InAppContainerizable, width: CGFloat) -> CGFloat {
+        let margins = placement.margins.left + placement.margins.right
+        return switch placement.widthType {
+        case let .percent(value): max(width * CGFloat(value) / 100 - margins, 0)
+        case .auto, nil: max(width - margins, 0)
+        }
+    }
+
+    private static func containerSize(for placement: InAppContainerizable, width: CGFloat, height: CGFloat) -> CGSize {
+        return CGSize(width: width, height: ceil(height) + placement.margins.top + placement.margins.bottom)
+    }
+
+    // MARK: - Applying
+
+    /// Give the text views their wrapping width, as measured by the layout pass. Labels also take their size from the
+    /// pass' measures, so that Auto Layout doesn't measure their text again.
+    /// - Parameters:
+    ///   - frames: The frames of the views.
+    ///   - views: The views built from the measured builders, in the same order.
+    @MainActor
+    static func apply(_ frames: [InAppLayoutFrame], to views: [UIView]) {
+        for (frame, view) in zip(frames, views) {
+            apply(frame, to: view)
+        }
+    }
+
+    @MainActor
+    private static func apply(_ frame: InAppLayoutFrame, to view: UIView) {
+        switch view {
+        case let container as InAppContainer:
+            container.subviews.first.map { apply(frame, to: $0) }
+        case let label as InAppLabelView:
+            frame.textWidth.map { label.applyLayout(textWidth: $0) }
+        case let button as InAppButtonView:
+            frame.textWidth.map { button.titleLabel?.preferredMaxLayoutWidth = $0 }
+        case let columns as InAppColumnsView:
+            // Columns wrap each child in a percented view
+            apply(frame.children, to: columns.arrangedSubviews.compactMap(\.subviews.first))
+        default:
+            break
+        }
+    }
+}
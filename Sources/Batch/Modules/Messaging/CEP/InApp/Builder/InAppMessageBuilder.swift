@@ -76,6 +76,35 @@ struct InAppMessageBuilder {
         return contentViewBuilders
     }
 
+    /// Collects the URLs of the images displayed by a message, in display order.
+    /// URLs are resolved the same way as when building the image views.
+    /// - Parameter inAppMessage: The raw in-app message data.
+    /// - Returns: The image URLs, without duplicates.
+    static func imageURLs(for inAppMessage: InAppMessage) -> [URL] {
+        let urls = inAppMessage.urls ?? [:]
+        var imageURLs: [URL] = []
+
+        func collect(_ components: [InAppAnyTypedComponent?]) {
+            for component in components.compactMap({ $0?.component }) {
+                switch component {
+                case let image as InAppImage:
+                    guard let urlString = urls[image.id] else { continue }
+                    let url = URL(string: urlString) ?? URL(fileURLWithPath: urlString)
+                    if !imageURLs.contains(url) {
+                        imageURLs.append(url)
+                    }
+                case let columns as InAppColumns:
+                    collect(columns.children)
+                default:
+                    continue
+                }
+            }
+        }
+
+        collect(inAppMessage.root.children)
+        return imageURLs
+    }
+
     /// Creates the style configuration for the main view controller.
     /// This includes background color, corner radius, and border styles.
     /// - Parameter inAppMessage: The raw in-app message data.
@@ -171,8 +200,17 @@ extension InAppTypedComponent {
             guard let button = self as? InAppButton else { return nil }
 
             let configuration = try InAppMessageBuilder.button(text: texts[button.id], action: actions[button.id], button: button)
+            let measure = { (width: CGFloat) in
+                InAppLayoutPass.measureText(
+                    configuration.content.text,
+                    fontStyle: configuration.fontStyle,
+                    maxLines: configuration.style.maxLines,
+                    placement: configuration.placement,
+                    width: width
+                )
+            }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { onClosureTap, _ in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { onClosureTap, _ in
                 try InAppContainer(configuration: configuration.placement) {
                     InAppButtonView(configuration: configuration, onClosureTap: onClosureTap)
                 }
@@ -182,10 +220,11 @@ extension InAppTypedComponent {
             guard let divider = self as? InAppDivider else { return nil }
 
             let configuration = try InAppMessageBuilder.divider(divider: divider)
+            let measure = { (width: CGFloat) in InAppLayoutPass.measureBox(placement: configuration.placement, width: width) }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { _, _ in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { _, _ in
                 try InAppContainer(configuration: configuration.placement) {
-                    InAppDividerView(configuration: configuration)
+                    InAppViewReusePool.sharedInstance.dequeue(configuration: configuration, create: InAppDividerView.init(configuration:))
                 }
             }
         // Build a spacer
@@ -193,10 +232,11 @@ extension InAppTypedComponent {
             guard let spacer = self as? InAppSpacer else { return nil }
 
             let configuration = try InAppMessageBuilder.spacer(spacer: spacer, format: format)
+            let measure = { (width: CGFloat) in InAppLayoutPass.measureBox(placement: configuration.placement, width: width) }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { _, _ in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { _, _ in
                 try InAppContainer(configuration: configuration.placement) {
-                    InAppSpacerView(configuration: configuration)
+                    InAppViewReusePool.sharedInstance.dequeue(configuration: configuration, create: InAppSpacerView.init(configuration:))
                 }
             }
         // Build an image
@@ -205,8 +245,9 @@ extension InAppTypedComponent {
 
             let url = URL(string: urlString) ?? URL(fileURLWithPath: urlString)
             let configuration = try InAppMessageBuilder.image(url: url, action: actions[image.id], image: image, contentDescription: texts[image.id], format: format)
+            let measure = { (width: CGFloat) in InAppLayoutPass.measureImage(placement: configuration.placement, width: width) }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { onClosureTap, onError in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { onClosureTap, onError in
                 try InAppContainer(configuration: configuration.placement) {
                     InAppImageView(configuration: configuration, onClosureTap: onClosureTap, onError: onError)
                 }
@@ -216,10 +257,19 @@ extension InAppTypedComponent {
             guard let label = self as? InAppLabel else { return nil }
 
             let configuration = try InAppMessageBuilder.label(text: texts[label.id], label: label)
+            let measure = { (width: CGFloat) in
+                InAppLayoutPass.measureText(
+                    configuration.content.text,
+                    fontStyle: configuration.fontStyle,
+                    maxLines: configuration.style.maxLines,
+                    placement: configuration.placement,
+                    width: width
+                )
+            }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { _, _ in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { _, _ in
                 try InAppContainer(configuration: configuration.placement) {
-                    InAppLabelView(configuration: configuration)
+                    InAppViewReusePool.sharedInstance.dequeue(configuration: configuration, create: InAppLabelView.init(configuration:))
                 }
             }
         // Build a columns container
@@ -227,8 +277,9 @@ extension InAppTypedComponent {
             guard let columns = self as? InAppColumns else { return nil }
 
             let configuration = try InAppMessageBuilder.columns(urls: urls, texts: texts, actions: actions, columns: columns, format: format)
+            let measure = { (width: CGFloat) in InAppLayoutPass.measureColumns(configuration: configuration, width: width) }
 
-            return InAppViewBuilder(component: self, expandable: configuration.placement) { onClosureTap, onError in
+            return InAppViewBuilder(component: self, expandable: configuration.placement, measure: measure) { onClosureTap, onError in
                 try InAppContainer(configuration: configuration.placement) {
                     InAppColumnsView(configuration: configuration, onClosureTap: onClosureTap, onError: onError)
                 }
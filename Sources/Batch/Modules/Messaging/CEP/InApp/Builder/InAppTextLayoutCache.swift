@@ -0,0 +1,90 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import UIKit
+
+/// Caches the attributed strings of labels and buttons, and their measured sizes.
+/// Building a text goes through the HTML parser and font lookups: doing it once per text and font lets the layout
+/// pass warm the cache off the main thread, and the views reuse its results when they are displayed.
+/// `NSCache` being thread safe, the cache can be used from any thread.
+final class InAppTextLayoutCache {
+    /// Texts of a few messages
+    static let maxCachedStrings = 64
+
+    /// Sizes are cheap, but there is one per text and width
+    static let maxCachedSizes = 256
+
+    static let sharedInstance = InAppTextLayoutCache()
+
+    private let strings = NSCache<NSString, NSAttributedString>()
+
+    private let sizes = NSCache<NSString, NSValue>()
+
+    init() {
+        strings.countLimit = Self.maxCachedStrings
+        sizes.countLimit = Self.maxCachedSizes
+    }
+
+    /// Get the attributed string of a text, building it on the first call.
+    /// - Parameters:
+    ///   - text: The text, with its decorations already applied.
+    ///   - font: The resolved base font of the text.
+    ///   - fontStyle: The font style, used for the transforms' font variants.
+    ///   - build: Builds the attributed string on a cache miss.
+    /// - Returns: The cached attributed string.
+    func attributedString(text: String, font: UIFont, fontStyle: InAppFontStylizable, build: () throws -> NSAttributedString) rethrows -> NSAttributedString {
+        let key = Self.key(text: text, font: font, fontStyle: fontStyle) as NSString
+        if let cached = strings.object(forKey: key) {
+            return cached
+        }
+
+        let attributedString = try build()
+        strings.setObject(attributedString, forKey: key)
+        return attributedString
+    }
+
+    /// Measure an attributed string for a width.
+    /// - Parameters:
+    ///   - attributedString: The text to measure.
+    ///   - width: The width available to the text, paddings excluded.
+    ///   - maxLines: Maximum number of lines, 0 for no limit.
+    /// - Returns: The size of the text, rounded up to whole points.
+    func size(of attributedString: NSAttributedString, width: CGFloat, maxLines: Int) -> CGSize {
+        let key = "\(width)|\(maxLines)|\(attributedString.hash)|\(attributedString.string)" as NSString
+        if let cached = sizes.object(forKey: key) {
+            return cached.cgSizeValue
+        }
+
+        let bounds = attributedString.boundingRect(
+            with: CGSize(width: max(width, 0), height: .greatestFiniteMagnitude),
+            options: [.usesLineFragmentOrigin, .usesFontLeading],
+            context: nil
+        )
+        var size = CGSize(width: ceil(bounds.width), height: ceil(bounds.height))
+
+        if maxLines > 0, attributedString.length > 0,
+            let font = attributedString.attribute(.font, at: 0, effectiveRange: nil) as? UIFont
+        {
+            size.height = min(size.height, ceil(font.lineHeight * CGFloat(maxLines)))
+        }
+
+        sizes.setObject(NSValue(cgSize: size), forKey: key)
+        return size
+    }
+
+    func removeAll() {
+        strings.removeAllObjects()
+        sizes.removeAllObjects()
+    }
+
+    /// Texts are keyed by their content and resolved fonts: dynamic type changes the base font, and thus the key.
+    private static func key(text: String, font: UIFont, fontStyle: InAppFontStylizable) -> String {
+        let overrides = [fontStyle.fontOverride, fontStyle.fontBoldOverride, fontStyle.fontItalicOverride, fontStyle.fontBoldItalicOverride]
+            .map { $0?.fontName ?? "-" }
+            .joined(separator: ",")
+        return "\(font.fontName)|\(font.pointSize)|\(fontStyle.fontSize ?? -1)|\(overrides)|\(text)"
+    }
+}
@@ -17,6 +17,10 @@ struct InAppViewBuilder {
     /// Caches the expandability information for the view to be built.
     let expandable: InAppExpandableView
 
+    /// A closure measuring the view to be built for an available width, without building it.
+    /// It doesn't touch UIKit views: it can be called from any thread, to warm the text caches ahead of time.
+    let measure: (_ width: CGFloat) -> InAppLayoutFrame
+
     /// A closure that, when executed, builds and returns the fully configured `UIView`.
     /// It must be called on the main actor.
     /// - Parameters:
@@ -27,4 +31,21 @@ struct InAppViewBuilder {
             _ onClosureTap: @escaping InAppClosureDelegate.Closure,
             _ onError: @escaping InAppErrorDelegate.Closure
         ) throws -> UIView
+
+    // MARK: - Initialization
+
+    init(
+        component: InAppTypedComponent,
+        expandable: InAppExpandableView,
+        measure: @escaping (_ width: CGFloat) -> InAppLayoutFrame = { _ in .zero },
+        content: @escaping @MainActor (
+            _ onClosureTap: @escaping InAppClosureDelegate.Closure,
+            _ onError: @escaping InAppErrorDelegate.Closure
+        ) throws -> UIView
+    ) {
+        self.component = component
+        self.expandable = expandable
+        self.measure = measure
+        self.content = content
+    }
 }
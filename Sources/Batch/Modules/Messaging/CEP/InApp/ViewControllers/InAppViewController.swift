@@ -80,6 +80,23 @@ class InAppViewController: UIViewController, InAppViewCountdownClose, BatchMessa
         // Track the "dismissed" event and update the state.
         analyticManager.track(.dismissed)
         isDismissed = true
+
+        // The message won't be displayed again: its views can be used by the next ones
+        if isBeingTornDown {
+            InAppViewReusePool.sharedInstance.recycle(viewsIn: messageContentView)
+        }
+    }
+
+    /// Whether the controller disappears for good, rather than being covered by another controller presented over it.
+    private var isBeingTornDown: Bool {
+        if isBeingDismissed || isMovingFromParent {
+            return true
+        }
+        // Overlay windows are only hidden when the message they display is dismissed, or replaced by another one
+        if let window = view.window as? BAMSGOverlayWindow {
+            return window.isHidden
+        }
+        return false
     }
 
     /// Responds to device orientation or size changes.
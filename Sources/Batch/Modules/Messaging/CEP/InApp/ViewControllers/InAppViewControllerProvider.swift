@@ -28,6 +28,16 @@ public class InAppViewControllerProvider: NSObject {
         return try viewController(message: message)
     }
 
+    /// Decodes a message ahead of its display, so that its images can be downloaded and its views measured without
+    /// decoding it again. Can be called from any thread.
+    /// - Parameter message: The parsed message object.
+    /// - Returns: The decoded message, or `nil` if it cannot be deserialized.
+    public static func preparation(message: BAMSGCEPMessage) -> InAppMessagePreparation? {
+        guard let inAppMessage = try? inAppMessage(for: message) else { return nil }
+
+        return InAppMessagePreparation(inAppMessage: inAppMessage)
+    }
+
     /// Creates a view controller from a `BAMSGCEPMessage` object.
     /// This is the core logic that deserializes the message, builds the configuration, and selects the appropriate view controller subclass.
     /// - Parameter message: The parsed message object.
@@ -35,8 +45,7 @@ public class InAppViewControllerProvider: NSObject {
     /// - Throws: An error if JSON deserialization or message building fails.
     public static func viewController(message: BAMSGCEPMessage) throws -> UIViewController {
         // 1. Deserialize the raw JSON payload into the InAppMessage data model.
-        let jsonData = try JSONSerialization.data(withJSONObject: message.sourceMessage.messagePayload)
-        let inAppMessage = try JSONDecoder().decode(InAppMessage.self, from: jsonData)
+        let inAppMessage = try inAppMessage(for: message)
 
         // 2. Use the builder to create the complete view controller configuration.
         let configuration = try InAppMessageBuilder.configuration(for: inAppMessage, message: message)
@@ -57,4 +66,30 @@ public class InAppViewControllerProvider: NSObject {
             }
         }
     }
+
+    /// Deserializes the raw JSON payload of a message into the InAppMessage data model.
+    private static func inAppMessage(for message: BAMSGCEPMessage) throws -> InAppMessage {
+        let jsonData = try JSONSerialization.data(withJSONObject: message.sourceMessage.messagePayload)
+        return try JSONDecoder().decode(InAppMessage.self, from: jsonData)
+    }
+}
+
+/// An in-app message decoded ahead of its display.
+@objcMembers
+public final class InAppMessagePreparation: NSObject {
+    private let inAppMessage: InAppMessage
+
+    /// The images the message will display, most important first.
+    public let imageURLs: [URL]
+
+    init(inAppMessage: InAppMessage) {
+        self.inAppMessage = inAppMessage
+        imageURLs = InAppMessageBuilder.imageURLs(for: inAppMessage)
+    }
+
+    /// Measures the views of the message, so that building its texts doesn't happen on the main thread when it is
+    /// displayed. Can be called from any thread.
+    public func prepareLayout() {
+        _ = try? InAppLayoutPass.prepare(inAppMessage: inAppMessage)
+    }
 }
@@ -7,10 +7,10 @@
 import UIKit
 
 /// Represents an in-app divider view
-class InAppDividerView: UIView {
+class InAppDividerView: UIView, InAppReusableView {
     // MARK: -
 
-    let configuration: InAppDividerView.Configuration
+    private(set) var configuration: InAppDividerView.Configuration
 
     // MARK: -
 
@@ -40,6 +40,12 @@ class InAppDividerView: UIView {
     func configure() {
         configuration.apply(to: self)
     }
+
+    func reconfigure(configuration: Configuration) {
+        self.configuration = configuration
+        layer.cornerRadius = 0
+        configure()
+    }
 }
 
 extension InAppDividerView {
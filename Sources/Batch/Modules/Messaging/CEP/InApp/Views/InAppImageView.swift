@@ -305,7 +305,8 @@ extension InAppImageView {
     func load(url: URL) {
         BAMSGImageDownloader.downloadImage(
             for: url,
-            downloadTimeout: configuration.timeout
+            downloadTimeout: configuration.timeout,
+            maxPixelSize: BAMSGImageDecoder.maxPixelSize(for: self)
         ) { [weak self] data, isGif, image, error in
             guard let self else { return }
 
@@ -352,7 +353,7 @@ extension InAppImageView {
             BALogger.debug(domain: "Messaging", message: "Could not load gif file: \(error.code) \(error.localizedDescription)")
 
             // If GIF loading fails, attempt to display it as a static image.
-            let fallbackImage = UIImage(data: data)
+            let fallbackImage = BAMSGImageDecoder.decodedImage(with: data, maxPixelSize: 0)
             loadImage(loadedImage: fallbackImage)
         }
     }
@@ -7,10 +7,13 @@
 import UIKit
 
 /// Represents an in-app label view
-class InAppLabelView: UILabel {
+class InAppLabelView: UILabel, InAppReusableView {
     // MARK: -
 
-    let configuration: InAppLabelView.Configuration
+    private(set) var configuration: InAppLabelView.Configuration
+
+    /// Size of the text at the wrapping width given by the layout pass, paddings excluded.
+    private var measuredTextSize: CGSize?
 
     // MARK: -
 
@@ -33,23 +36,31 @@ class InAppLabelView: UILabel {
         configuration.apply(to: self)
     }
 
+    func reconfigure(configuration: InAppLabelView.Configuration) {
+        self.configuration = configuration
+        // The wrapping width of the previous text is meaningless for the new one
+        preferredMaxLayoutWidth = 0
+        measuredTextSize = nil
+        configure()
+        invalidateIntrinsicContentSize()
+    }
+
     override func drawText(in rect: CGRect) {
         super.drawText(in: rect.inset(by: configuration.placement.paddings))
     }
 
-    override var bounds: CGRect {
-        didSet {
-            // Substract the padding from the asked width, so that iOS correctly reflows the text if needed
-            let targetWidth = bounds.width - (configuration.placement.paddings.left + configuration.placement.paddings.right)
-            if preferredMaxLayoutWidth != targetWidth {
-                preferredMaxLayoutWidth = targetWidth
-                setNeedsUpdateConstraints()
-            }
-        }
+    /// Wrap the text at the width measured by the layout pass, paddings excluded, and size the label from the
+    /// measure cached by the pass rather than measuring the text again.
+    func applyLayout(textWidth: CGFloat) {
+        guard preferredMaxLayoutWidth != textWidth || measuredTextSize == nil else { return }
+
+        preferredMaxLayoutWidth = textWidth
+        measuredTextSize = attributedText.map { InAppTextLayoutCache.sharedInstance.size(of: $0, width: textWidth, maxLines: numberOfLines) }
+        invalidateIntrinsicContentSize()
     }
 
     override var intrinsicContentSize: CGSize {
-        var size = super.intrinsicContentSize
+        var size = measuredTextSize ?? super.intrinsicContentSize
 
         size.width = size.width + configuration.placement.paddings.left + configuration.placement.paddings.right
         size.height = size.height + configuration.placement.paddings.top + configuration.placement.paddings.bottom
@@ -15,6 +15,9 @@ public class InAppRootContainerView: UIStackView, InAppClosureDelegate {
     let onClosureTap: InAppClosureDelegate.Closure
     let onError: InAppErrorDelegate.Closure
 
+    /// The width the layout frames were last applied for.
+    private var layoutWidth: CGFloat = 0
+
     // MARK: - Initialization
 
     init(
@@ -44,6 +47,18 @@ public class InAppRootContainerView: UIStackView, InAppClosureDelegate {
         try configuration.apply(to: self, onClosureTap: onClosureTap, onError: onError)
         configuration.updateExpandables(to: self)
     }
+
+    // MARK: - Layout
+
+    override public var bounds: CGRect {
+        didSet {
+            // Give all the text views their wrapping width and size at once, before they are laid out,
+            // rather than having each of them find it out and ask for another layout pass.
+            guard bounds.width > 0, bounds.width != layoutWidth else { return }
+            layoutWidth = bounds.width
+            configuration.applyLayout(to: self, width: bounds.width)
+        }
+    }
 }
 
 // MARK: - Nested Configuration Structs
@@ -63,6 +78,13 @@ extension InAppRootContainerView {
             try builder.apply(on: container, onClosureTap: onClosureTap, onError: onError)
         }
 
+        /// Measures the views for the container's width, and applies the resulting frames.
+        @MainActor
+        func applyLayout(to container: InAppRootContainerView, width: CGFloat) {
+            InAppLayoutPass.lastContentWidth = width
+            InAppLayoutPass.apply(InAppLayoutPass.frames(for: builder.viewsBuilder, width: width), to: container.arrangedSubviews)
+        }
+
         /// Post-layout logic to handle expandable "fill" spacers.
         /// This method finds all expandable spacers and constrains their heights to be equal,
         /// which creates a "space-between" or "space-around" distribution effect.
@@ -7,10 +7,10 @@
 import UIKit
 
 /// Represents an in-app spacer view
-class InAppSpacerView: UIView {
+class InAppSpacerView: UIView, InAppReusableView {
     // MARK: -
 
-    let configuration: InAppSpacerView.Configuration
+    private(set) var configuration: InAppSpacerView.Configuration
 
     // MARK: -
 
@@ -24,6 +24,12 @@ class InAppSpacerView: UIView {
     required init?(coder _: NSCoder) {
         fatalError("init(coder:) has not been implemented")
     }
+
+    // MARK: -
+
+    func reconfigure(configuration: Configuration) {
+        self.configuration = configuration
+    }
 }
 
 extension InAppSpacerView {
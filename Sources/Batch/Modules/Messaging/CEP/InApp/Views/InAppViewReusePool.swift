@@ -0,0 +1,90 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import UIKit
+
+/// A view that can be reconfigured to display another component once its message has been dismissed.
+protocol InAppReusableView: UIView {
+    associatedtype Configuration
+
+    /// Display a new configuration, resetting everything the previous one set.
+    func reconfigure(configuration: Configuration)
+}
+
+/// Keeps the leaf views of dismissed messages, so that the next messages reuse them rather than creating new ones.
+///
+/// Only views that don't hold closures are pooled (labels, dividers and spacers): their configuration is all there is
+/// to them. Their containers aren't, as their constraints depend on the component they were built for.
+/// The pool is emptied on memory warnings.
+@MainActor
+final class InAppViewReusePool: NSObject {
+    // MARK: - Properties
+
+    /// Enough for the leaves of a message
+    static let maxViewsPerType = 8
+
+    static let sharedInstance = InAppViewReusePool()
+
+    private var views: [ObjectIdentifier: [UIView]] = [:]
+
+    // MARK: - Initialization
+
+    override init() {
+        super.init()
+
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(removeAll),
+            name: UIApplication.didReceiveMemoryWarningNotification,
+            object: nil
+        )
+    }
+
+    // MARK: - Reuse
+
+    /// Get a pooled view reconfigured for a component, or a new one if none is available.
+    /// - Parameters:
+    ///   - configuration: The configuration of the component to display.
+    ///   - create: Creates a view when the pool is empty.
+    /// - Returns: A view displaying the configuration, without a superview.
+    func dequeue<View: InAppReusableView>(configuration: View.Configuration, create: (View.Configuration) -> View) -> View {
+        guard let view = views[ObjectIdentifier(View.self)]?.popLast() as? View else {
+            return create(configuration)
+        }
+
+        view.reconfigure(configuration: configuration)
+        return view
+    }
+
+    /// Take back the reusable views of a dismissed message.
+    /// - Parameter root: The root view of the message. The message must not be displayed again.
+    func recycle(viewsIn root: UIView) {
+        for subview in root.subviews {
+            if subview is any InAppReusableView {
+                enqueue(subview)
+            } else {
+                recycle(viewsIn: subview)
+            }
+        }
+    }
+
+    @objc func removeAll() {
+        views.removeAll()
+    }
+
+    private func enqueue(_ view: UIView) {
+        let key = ObjectIdentifier(type(of: view))
+        guard views[key, default: []].count < Self.maxViewsPerType else { return }
+
+        // Constraints shared with the container go away with it, but the size constraints installed on the view
+        // itself stay: drop them too. Content size constraints are UIKit's own, and are kept.
+        view.removeFromSuperview()
+        NSLayoutConstraint.deactivate(
+            view.constraints.filter { type(of: $0) == NSLayoutConstraint.self && $0.firstItem === view && $0.secondItem == nil }
+        )
+        views[key, default: []].append(view)
+    }
+}
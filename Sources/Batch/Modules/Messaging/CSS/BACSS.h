@@ -15,8 +15,17 @@
 @property (assign) CGSize viewSize;
 @property (assign) BOOL darkMode;
 
+/*!
+ @abstract Checks if the environment matches a media query.
+ @discussion Results are cached until the environment changes.
+ */
 - (BOOL)environmentMatchesQuery:(NSString *)query;
 
+/*!
+ @abstract Key identifying the environment's traits: environments with the same key match the same media queries.
+ */
+- (NSString *)mediaQueryCacheKey;
+
 @end
 
 @interface BACSSDOMNode : NSObject
@@ -88,4 +97,10 @@ typedef NSDictionary<NSString *, NSString *> BACSSRules;
 
 - (BACSSRules *)flatRulesFromCSSDeclarations:(NSArray<BACSSDeclaration *> *)declarations;
 
+/*!
+ @abstract Compiles the rulesets for fast lookups. This is done automatically on the first lookup.
+ @discussion Once compiled, the document is considered complete: rulesets and media queries added later are ignored.
+ */
+- (void)compileIfNeeded;
+
 @end
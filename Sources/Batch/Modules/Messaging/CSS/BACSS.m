@@ -6,8 +6,11 @@
 //
 
 #import <Batch/BACSS.h>
+#import <Batch/BACSSSelectorIndex.h>
 #import <Batch/BALogger.h>
 
+#define MAX_CACHED_ENVIRONMENTS 16
+
 #define SCREEN_MEDIA_QUERY_REGEXP @"@media (ios|android|\\*) and \\((max|min)-(width|height):\\s*(\\d*)\\)"
 
 @implementation BACSSDOMNode
@@ -115,6 +118,19 @@
 
 @end
 
+@interface BACSSDocument () {
+    // Compiled rulesets, built on the first lookup
+    BACSSSelectorIndex *_rulesetsIndex;
+    NSArray<BACSSSelectorIndex *> *_mediaQueriesIndexes;
+    NSArray<NSString *> *_mediaQueriesRules; // Lowercased
+
+    // Indexes of the media queries matching an environment, keyed by the environment's mediaQueryCacheKey.
+    // Guarded by @synchronized(self)
+    NSMutableDictionary<NSString *, NSIndexSet *> *_matchingMediaQueries;
+}
+
+@end
+
 @implementation BACSSDocument
 
 - (instancetype)init {
@@ -141,45 +157,72 @@
 }
 
 - (NSArray<BACSSDeclaration *> *)rulesForNode:(BACSSDOMNode *)node withEnvironment:(BACSSEnvironment *)environment {
+    [self compileIfNeeded];
+
     NSMutableArray<BACSSDeclaration *> *declarations = [NSMutableArray new];
 
-    [declarations addObjectsFromArray:[self rulesForNode:node inRuleSets:self.rulesets]];
+    [declarations addObjectsFromArray:[_rulesetsIndex declarationsForNode:node]];
 
-    for (BACSSMediaQuery *query in self.mediaQueries) {
-        NSString *rule = [[query rule] lowercaseString];
-        if ([environment environmentMatchesQuery:rule]) {
-            [declarations addObjectsFromArray:[self rulesForNode:node inRuleSets:[query rulesets]]];
-        }
-    }
+    [[self mediaQueriesMatchingEnvironment:environment] enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+      [declarations addObjectsFromArray:[self->_mediaQueriesIndexes[idx] declarationsForNode:node]];
+    }];
 
     return declarations;
 }
 
-- (NSArray<BACSSDeclaration *> *)rulesForNode:(BACSSDOMNode *)node inRuleSets:(NSArray<BACSSRuleset *> *)rulesets {
-    NSMutableArray<BACSSDeclaration *> *declarations = [NSMutableArray new];
+/**
+ Resolve the media queries once per kind of environment: documents are shared between messages, which are likely to
+ be displayed in the same environment.
+ */
+- (NSIndexSet *)mediaQueriesMatchingEnvironment:(BACSSEnvironment *)environment {
+    NSString *environmentKey = [environment mediaQueryCacheKey];
+    @synchronized(self) {
+        NSIndexSet *matchingQueries = _matchingMediaQueries[environmentKey];
+        if (matchingQueries != nil) {
+            return matchingQueries;
+        }
 
-    for (BACSSRuleset *ruleset in rulesets) {
-        // Only extract the variables from *
-        // Everybody will get them though
-        // Basically it means that the * block is merged with
-        // every other in the scope (where the scope is whether we're in a media query or not)
-        if ([ruleset.selector isEqualToString:@"*"]) {
-            for (BACSSDeclaration *declaration in ruleset.declarations) {
-                if ([declaration isKindOfClass:[BACSSVariable class]]) {
-                    [declarations addObject:declaration];
-                }
+        NSMutableIndexSet *newMatchingQueries = [NSMutableIndexSet new];
+        NSUInteger mediaQueriesCount = [_mediaQueriesRules count];
+        for (NSUInteger i = 0; i < mediaQueriesCount; i++) {
+            if ([environment environmentMatchesQuery:_mediaQueriesRules[i]]) {
+                [newMatchingQueries addIndex:i];
             }
-            continue;
         }
 
-        if (![node matchesSelector:ruleset.selector]) {
-            continue;
+        // There only are a few environments in practice (orientations, dark mode), but don't let this grow unbounded
+        if (_matchingMediaQueries.count >= MAX_CACHED_ENVIRONMENTS) {
+            [_matchingMediaQueries removeAllObjects];
         }
-
-        [declarations addObjectsFromArray:ruleset.declarations];
+        _matchingMediaQueries[environmentKey] = newMatchingQueries;
+        return newMatchingQueries;
     }
+}
 
-    return declarations;
+/**
+ Compile the rulesets into selector indexes, so that looking up the rules of a node doesn't have to match every
+ selector.
+ The document is considered complete once it's been looked up: rulesets and media queries added later are ignored.
+ */
+- (void)compileIfNeeded {
+    @synchronized(self) {
+        if (_rulesetsIndex != nil) {
+            return;
+        }
+
+        NSUInteger mediaQueriesCount = [self.mediaQueries count];
+        NSMutableArray<BACSSSelectorIndex *> *mediaQueriesIndexes =
+            [[NSMutableArray alloc] initWithCapacity:mediaQueriesCount];
+        NSMutableArray<NSString *> *mediaQueriesRules = [[NSMutableArray alloc] initWithCapacity:mediaQueriesCount];
+        for (BACSSMediaQuery *query in self.mediaQueries) {
+            [mediaQueriesIndexes addObject:[[BACSSSelectorIndex alloc] initWithRulesets:query.rulesets]];
+            [mediaQueriesRules addObject:[query.rule lowercaseString] ?: @""];
+        }
+        _mediaQueriesIndexes = mediaQueriesIndexes;
+        _mediaQueriesRules = mediaQueriesRules;
+        _matchingMediaQueries = [NSMutableDictionary new];
+        _rulesetsIndex = [[BACSSSelectorIndex alloc] initWithRulesets:self.rulesets];
+    }
 }
 
 - (BACSSRules *)flatRulesFromCSSDeclarations:(NSArray<BACSSDeclaration *> *)declarations {
@@ -275,6 +318,13 @@
 
 @end
 
+@interface BACSSEnvironment () {
+    // Media query results, keyed by query. Guarded by @synchronized(self)
+    NSMutableDictionary<NSString *, NSNumber *> *_queryResults;
+}
+
+@end
+
 @implementation BACSSEnvironment : NSObject
 
 + (NSRegularExpression *)screenMediaQueryMatcher {
@@ -302,11 +352,62 @@
     if (self) {
         _viewSize = CGSizeZero;
         _darkMode = false;
+        _queryResults = [NSMutableDictionary new];
     }
     return self;
 }
 
+- (CGSize)viewSize {
+    @synchronized(self) {
+        return _viewSize;
+    }
+}
+
+- (void)setViewSize:(CGSize)viewSize {
+    @synchronized(self) {
+        _viewSize = viewSize;
+        [_queryResults removeAllObjects];
+    }
+}
+
+- (BOOL)darkMode {
+    @synchronized(self) {
+        return _darkMode;
+    }
+}
+
+- (void)setDarkMode:(BOOL)darkMode {
+    @synchronized(self) {
+        _darkMode = darkMode;
+        [_queryResults removeAllObjects];
+    }
+}
+
 - (BOOL)environmentMatchesQuery:(NSString *)query {
+    if (query == nil) {
+        return false;
+    }
+
+    @synchronized(self) {
+        NSNumber *cachedResult = _queryResults[query];
+        if (cachedResult != nil) {
+            return [cachedResult boolValue];
+        }
+
+        BOOL result = [self computeEnvironmentMatchesQuery:query];
+        _queryResults[query] = @(result);
+        return result;
+    }
+}
+
+- (NSString *)mediaQueryCacheKey {
+    @synchronized(self) {
+        NSString *appearance = _darkMode ? @"dark" : @"light";
+        return [NSString stringWithFormat:@"%fx%f-%@", _viewSize.width, _viewSize.height, appearance];
+    }
+}
+
+- (BOOL)computeEnvironmentMatchesQuery:(NSString *)query {
     // Fast paths:
     //  - @ios
     //  - @dark
@@ -0,0 +1,46 @@
+//
+//  BACSSDocumentCache.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSS.h>
+#import <Batch/BACSSImportProvider.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Process-wide cache of parsed stylesheets, keyed by the SHA-256 of their content.
+
+ Campaigns reuse the same theme CSS across messages: parsing it and compiling its rules once is enough.
+ Cached documents are shared, and must not be modified.
+ */
+@interface BACSSDocumentCache : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ @param importProvider Provider used to parse the stylesheets
+ @param totalCostLimit Maximum total length of the cached stylesheets, in characters
+ */
+- (instancetype)initWithImportProvider:(id<BACSSImportProvider>)importProvider
+                        totalCostLimit:(NSUInteger)totalCostLimit NS_DESIGNATED_INITIALIZER;
+
+/**
+ Shared cache, using the builtin imports
+ */
++ (BACSSDocumentCache *)sharedCache;
+
+/**
+ Get the parsed and compiled document for a stylesheet, parsing it if it isn't cached.
+ Stylesheets that fail to parse are not cached.
+ */
+- (nullable BACSSDocument *)documentForStylesheet:(nullable NSString *)stylesheet error:(NSError **)error;
+
+- (void)removeAllDocuments;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,84 @@
+//
+//  BACSSDocumentCache.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSSBuiltinImportProvider.h>
+#import <Batch/BACSSDocumentCache.h>
+#import <Batch/BACSSParser.h>
+#import <Batch/BALogger.h>
+#import <Batch/BASHA.h>
+#import <Batch/BAStringUtils.h>
+
+#define LOGGER_DOMAIN @"BACSSDocumentCache"
+
+// Themes are a few KB at most
+#define DEFAULT_TOTAL_COST_LIMIT (512 * 1024)
+
+@implementation BACSSDocumentCache {
+    id<BACSSImportProvider> _importProvider;
+
+    NSCache<NSString *, BACSSDocument *> *_documents;
+}
+
++ (BACSSDocumentCache *)sharedCache {
+    static BACSSDocumentCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      sharedInstance = [[BACSSDocumentCache alloc] initWithImportProvider:[BACSSBuiltinImportProvider new]
+                                                           totalCostLimit:DEFAULT_TOTAL_COST_LIMIT];
+    });
+
+    return sharedInstance;
+}
+
+- (instancetype)initWithImportProvider:(id<BACSSImportProvider>)importProvider
+                        totalCostLimit:(NSUInteger)totalCostLimit {
+    self = [super init];
+    if (self) {
+        _importProvider = importProvider;
+        _documents = [NSCache new];
+        _documents.totalCostLimit = totalCostLimit;
+    }
+    return self;
+}
+
+- (nullable BACSSDocument *)documentForStylesheet:(nullable NSString *)stylesheet error:(NSError **)error {
+    if (stylesheet == nil) {
+        stylesheet = @"";
+    }
+
+    NSData *hash = [BASHA sha256HashOf:[stylesheet dataUsingEncoding:NSUTF8StringEncoding]];
+    NSString *key = hash != nil ? [BAStringUtils hexStringValueForData:hash] : nil;
+
+    BACSSDocument *document = key != nil ? [_documents objectForKey:key] : nil;
+    if (document != nil) {
+        return document;
+    }
+
+    NSError *parseError = nil;
+    document = [[BACSSParser parserWithString:stylesheet andImportProvider:_importProvider] parseWithError:&parseError];
+    if (document == nil || parseError != nil) {
+        if (error != NULL) {
+            *error = parseError;
+        }
+        return nil;
+    }
+
+    // Compile the rules now, so that they are shared with the document
+    [document compileIfNeeded];
+
+    if (key != nil) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Caching parsed stylesheet %@", key];
+        [_documents setObject:document forKey:key cost:[stylesheet length]];
+    }
+    return document;
+}
+
+- (void)removeAllDocuments {
+    [_documents removeAllObjects];
+}
+
+@end
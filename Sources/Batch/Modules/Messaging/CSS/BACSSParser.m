@@ -8,13 +8,10 @@
 #import <Batch/BACSS.h>
 #import <Batch/BACSSParser.h>
 #import <Batch/BACSSToken.h>
+#import <Batch/BACSSTokenizer.h>
 
 #define DEBUG_CSS 0
 
-#define CSS_COMMENT_REGEXP @"\\/\\*.*?\\*\\/"
-#define CSS_IMPORT_REGEXP @"@import sdk\\(\"([^\"]*)\"\\);"
-#define BACSS_PARSER_ERROR_DOMAIN @"BACSSParsingErrorDomain"
-
 typedef NS_ENUM(NSUInteger, BACSSParserState) {
     BACSSParserStateRoot,       // Document root
     BACSSParserStateMediaQuery, // Media query
@@ -27,7 +24,7 @@ typedef NS_ENUM(NSUInteger, BACSSParserSubstate) {
     BACSSParserSubstatePropertyValue // We're parsing a property value "white"
 };
 
-@interface BACSSParser () {
+@interface BACSSParser () <BACSSTokenizerDelegate> {
     id<BACSSImportProvider> importProvider;
 
     BACSSParserState state;
@@ -41,8 +38,6 @@ typedef NS_ENUM(NSUInteger, BACSSParserSubstate) {
 
     NSString *currentToken;
 
-    NSRegularExpression *commentRegexp;
-
     bool shouldMergePreviousToken;
 }
 
@@ -64,65 +59,25 @@ typedef NS_ENUM(NSUInteger, BACSSParserSubstate) {
     if (self) {
         importProvider = importProviderImpl;
         self.rawStylesheet = cssString;
-        [self replaceImports];
-
-        NSError *error;
-        commentRegexp = [NSRegularExpression regularExpressionWithPattern:CSS_COMMENT_REGEXP
-                                                                  options:NSRegularExpressionDotMatchesLineSeparators
-                                                                    error:&error];
-
-        if (error) {
-            return nil;
-        }
     }
     return self;
 }
 
-- (void)replaceImports {
-    NSError *error;
-    NSRegularExpression *importRegexp =
-        [NSRegularExpression regularExpressionWithPattern:CSS_IMPORT_REGEXP
-                                                  options:NSRegularExpressionDotMatchesLineSeparators
-                                                    error:&error];
-    if (error || importRegexp == nil) {
-        [BALogger debugForDomain:BACSS_PARSER_ERROR_DOMAIN
-                         message:@"Error while creating import regexp pattern, %@", [error localizedDescription]];
-        return;
-    }
-
-    NSMutableString *mutableString = [self.rawStylesheet mutableCopy];
-
-    NSArray<NSTextCheckingResult *> *matches = [importRegexp matchesInString:mutableString
-                                                                     options:0
-                                                                       range:NSMakeRange(0, [mutableString length])];
-
-    // Reverse the result list so that replacing the string elements doesn't break the other ranges
-    // This only works if we assume that results are sorted correctly
-    for (NSTextCheckingResult *result in [matches reverseObjectEnumerator]) {
-        NSString *importName = [mutableString substringWithRange:[result rangeAtIndex:1]];
-        NSString *importContent = [importProvider contentForImportNamed:importName];
-        if (importContent == nil) {
-            importContent = @"";
-        }
-        [mutableString replaceCharactersInRange:[result rangeAtIndex:0] withString:importContent];
-    }
-
-    self.rawStylesheet = [mutableString copy];
-}
-
 - (BACSSDocument *)parseWithError:(NSError **)error {
     [self reset];
 
     NSError *err = nil;
+    BACSSTokenizer *tokenizer = [[BACSSTokenizer alloc] initWithString:_rawStylesheet importProvider:importProvider];
 
     @try {
-        err = [self scan];
+        err = [tokenizer tokenizeWithDelegate:self];
     } @catch (NSException *exception) {
         err = [NSError errorWithDomain:BACSS_PARSER_ERROR_DOMAIN
                                   code:-3
                               userInfo:@{
                                   NSLocalizedDescriptionKey : @"Internal state error. Check the validity of your file.",
-                                  NSLocalizedFailureReasonErrorKey : exception.reason != nil ? exception.reason : @""
+                                  NSLocalizedFailureReasonErrorKey : exception.reason != nil ? exception.reason : @"",
+                                  kBACSSParserErrorOffsetKey : @(tokenizer.offset)
                               }];
     }
 
@@ -152,45 +107,6 @@ typedef NS_ENUM(NSUInteger, BACSSParserSubstate) {
     shouldMergePreviousToken = NO;
 }
 
-- (NSError *)scan {
-    NSString *commentlessStylesheet =
-        [commentRegexp stringByReplacingMatchesInString:_rawStylesheet
-                                                options:0
-                                                  range:NSMakeRange(0, [_rawStylesheet length])
-                                           withTemplate:@""];
-    NSScanner *scanner = [NSScanner scannerWithString:commentlessStylesheet];
-    scanner.charactersToBeSkipped = nil;
-
-    NSMutableCharacterSet *speicalTokensSet = [NSMutableCharacterSet newlineCharacterSet];
-    [speicalTokensSet addCharactersInString:@":;{}\n"];
-
-    NSString *token = @"";
-    NSString *specialTokenString = @"";
-
-    NSError *err;
-
-    while (![scanner isAtEnd]) {
-        [scanner scanUpToCharactersFromSet:speicalTokensSet intoString:&token];
-        [self consumeToken:[token stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]]];
-
-        if (![scanner scanCharactersFromSet:speicalTokensSet intoString:&specialTokenString]) {
-            return [NSError
-                errorWithDomain:BACSS_PARSER_ERROR_DOMAIN
-                           code:-1
-                       userInfo:@{NSLocalizedDescriptionKey : @"Internal error. Check the validity of your file."}];
-        }
-
-        for (int i = 0; i < [specialTokenString length]; i++) {
-            err = [self consumeSpecialToken:[specialTokenString characterAtIndex:i]];
-            if (err) {
-                return err;
-            }
-        }
-    }
-
-    return nil;
-}
-
 - (void)consumeToken:(NSString *)token {
 #if DEBUG_CSS
     NSLog(@"|%@|", token);
@@ -209,9 +125,7 @@ typedef NS_ENUM(NSUInteger, BACSSParserSubstate) {
     NSLog(@"Special: %c", c);
 #endif
 
-    BACSSSpecialToken *specialToken = [BACSSSpecialToken specialTokenWithChar:c];
-
-    switch (specialToken.kind) {
+    switch ([BACSSSpecialToken kindForChar:c]) {
         case BACSSSpecialTokenKindUnknown:
             break;
         case BACSSSpecialTokenKindBlockStart:
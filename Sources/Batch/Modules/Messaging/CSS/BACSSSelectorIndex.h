@@ -0,0 +1,30 @@
+//
+//  BACSSSelectorIndex.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSS.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Compiled form of a list of rulesets, used to find the ones matching a node without scanning them all.
+
+ Selectors are split, trimmed and lowercased once, and rulesets are indexed by the ids and classes they select.
+ Matching follows -[BACSSDOMNode matchesSelector:]: declarations are returned in the rulesets' order, so that later
+ rulesets override earlier ones, and "*" rulesets only contribute their variables.
+ */
+@interface BACSSSelectorIndex : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithRulesets:(NSArray<BACSSRuleset *> *)rulesets NS_DESIGNATED_INITIALIZER;
+
+- (NSArray<BACSSDeclaration *> *)declarationsForNode:(BACSSDOMNode *)node;
+
+@end
+
+NS_ASSUME_NONNULL_END
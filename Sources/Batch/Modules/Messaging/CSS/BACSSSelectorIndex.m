@@ -0,0 +1,108 @@
+//
+//  BACSSSelectorIndex.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSSSelectorIndex.h>
+
+@implementation BACSSSelectorIndex {
+    // Declarations each ruleset contributes when matched, in the rulesets' order
+    NSArray<NSArray<BACSSDeclaration *> *> *_declarations;
+
+    // Positions of the rulesets selecting an id/class, keyed by the lowercased id/class
+    NSDictionary<NSString *, NSIndexSet *> *_idIndex;
+    NSDictionary<NSString *, NSIndexSet *> *_classIndex;
+
+    // Positions of the "*" rulesets, which match every node
+    NSIndexSet *_universalPositions;
+}
+
+- (instancetype)initWithRulesets:(NSArray<BACSSRuleset *> *)rulesets {
+    self = [super init];
+    if (self) {
+        NSMutableArray<NSArray<BACSSDeclaration *> *> *declarations =
+            [[NSMutableArray alloc] initWithCapacity:rulesets.count];
+        NSMutableDictionary<NSString *, NSMutableIndexSet *> *idIndex = [NSMutableDictionary new];
+        NSMutableDictionary<NSString *, NSMutableIndexSet *> *classIndex = [NSMutableDictionary new];
+        NSMutableIndexSet *universalPositions = [NSMutableIndexSet new];
+
+        NSCharacterSet *whitespaces = [NSCharacterSet whitespaceCharacterSet];
+        [rulesets enumerateObjectsUsingBlock:^(BACSSRuleset *ruleset, NSUInteger position, BOOL *stop) {
+          // Only extract the variables from *
+          // Everybody will get them though
+          // Basically it means that the * block is merged with
+          // every other in the scope (where the scope is whether we're in a media query or not)
+          if ([ruleset.selector isEqualToString:@"*"]) {
+              NSMutableArray<BACSSDeclaration *> *variables = [NSMutableArray new];
+              for (BACSSDeclaration *declaration in ruleset.declarations) {
+                  if ([declaration isKindOfClass:[BACSSVariable class]]) {
+                      [variables addObject:declaration];
+                  }
+              }
+              [declarations addObject:variables];
+              [universalPositions addIndex:position];
+              return;
+          }
+
+          [declarations addObject:[ruleset.declarations copy] ?: @[]];
+
+          for (__strong NSString *selector in [ruleset.selector componentsSeparatedByString:@","]) {
+              selector = [selector stringByTrimmingCharactersInSet:whitespaces];
+              if ([selector length] < 2) {
+                  continue;
+              }
+
+              NSMutableDictionary<NSString *, NSMutableIndexSet *> *index;
+              unichar selectorType = [selector characterAtIndex:0];
+              if (selectorType == '#') {
+                  index = idIndex;
+              } else if (selectorType == '.') {
+                  index = classIndex;
+              } else {
+                  continue;
+              }
+
+              NSString *selectorValue = [[selector substringFromIndex:1] lowercaseString];
+              NSMutableIndexSet *positions = index[selectorValue];
+              if (positions == nil) {
+                  positions = [NSMutableIndexSet new];
+                  index[selectorValue] = positions;
+              }
+              [positions addIndex:position];
+          }
+        }];
+
+        _declarations = declarations;
+        _idIndex = idIndex;
+        _classIndex = classIndex;
+        _universalPositions = universalPositions;
+    }
+    return self;
+}
+
+- (NSArray<BACSSDeclaration *> *)declarationsForNode:(BACSSDOMNode *)node {
+    // A ruleset matching through several selectors must only be applied once: merge the positions before reading them
+    NSMutableIndexSet *positions = [_universalPositions mutableCopy];
+
+    NSIndexSet *identifierPositions = node.identifier != nil ? _idIndex[[node.identifier lowercaseString]] : nil;
+    if (identifierPositions != nil) {
+        [positions addIndexes:identifierPositions];
+    }
+
+    for (NSString *class in node.classes) {
+        NSIndexSet *classPositions = _classIndex[[class lowercaseString]];
+        if (classPositions != nil) {
+            [positions addIndexes:classPositions];
+        }
+    }
+
+    NSMutableArray<BACSSDeclaration *> *declarations = [NSMutableArray new];
+    [positions enumerateIndexesUsingBlock:^(NSUInteger position, BOOL *stop) {
+      [declarations addObjectsFromArray:self->_declarations[position]];
+    }];
+    return declarations;
+}
+
+@end
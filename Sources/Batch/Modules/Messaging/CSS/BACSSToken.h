@@ -20,6 +20,8 @@ typedef NS_ENUM(NSUInteger, BACSSSpecialTokenKind) {
 
 + (instancetype)specialTokenWithChar:(char)specialToken;
 
++ (BACSSSpecialTokenKind)kindForChar:(char)specialToken;
+
 - (instancetype)initWithChar:(char)specialToken;
 
 @property char value;
@@ -22,36 +22,33 @@ static const NSString *kBACSSTokenChar_selectorClass = '.';*/
     return [[BACSSSpecialToken alloc] initWithChar:specialToken];
 }
 
-- (instancetype)initWithChar:(char)specialToken {
-    self = [super init];
-    if (self) {
-        self.value = specialToken;
++ (BACSSSpecialTokenKind)kindForChar:(char)specialToken {
+    switch (specialToken) {
+        case kBACSSTokenChar_rulesetStart:
+            return BACSSSpecialTokenKindBlockStart;
 
-        switch (specialToken) {
-            case kBACSSTokenChar_rulesetStart:
-                self.kind = BACSSSpecialTokenKindBlockStart;
-                break;
+        case kBACSSTokenChar_rulesetEnd:
+            return BACSSSpecialTokenKindBlockEnd;
 
-            case kBACSSTokenChar_rulesetEnd:
-                self.kind = BACSSSpecialTokenKindBlockEnd;
-                break;
+        case kBACSSTokenChar_propertyEnd:
+            return BACSSSpecialTokenKindPropertyEnd;
 
-            case kBACSSTokenChar_propertyEnd:
-                self.kind = BACSSSpecialTokenKindPropertyEnd;
-                break;
+        case kBACSSTokenChar_propertySeparator:
+            return BACSSSpecialTokenKindPropertySeparator;
 
-            case kBACSSTokenChar_propertySeparator:
-                self.kind = BACSSSpecialTokenKindPropertySeparator;
-                break;
+        case kBACSSTokenChar_newLine:
+            return BACSSSpecialTokenKindNewline;
 
-            case kBACSSTokenChar_newLine:
-                self.kind = BACSSSpecialTokenKindNewline;
-                break;
+        default:
+            return BACSSSpecialTokenKindUnknown;
+    }
+}
 
-            default:
-                self.kind = BACSSSpecialTokenKindUnknown;
-                break;
-        }
+- (instancetype)initWithChar:(char)specialToken {
+    self = [super init];
+    if (self) {
+        self.value = specialToken;
+        self.kind = [BACSSSpecialToken kindForChar:specialToken];
     }
     return self;
 }
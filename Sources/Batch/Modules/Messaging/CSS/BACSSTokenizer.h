@@ -0,0 +1,61 @@
+//
+//  BACSSTokenizer.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSSImportProvider.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define BACSS_PARSER_ERROR_DOMAIN @"BACSSParsingErrorDomain"
+
+/**
+ Key of a parsing error's userInfo holding the UTF-16 offset in the stylesheet at which parsing failed (NSNumber).
+ Errors occurring in imported content point to their @import.
+ */
+extern NSString *const kBACSSParserErrorOffsetKey;
+
+@protocol BACSSTokenizerDelegate <NSObject>
+
+/**
+ A token has been read. Tokens are the whitespace-trimmed text found before a run of special characters.
+ */
+- (void)consumeToken:(NSString *)token;
+
+/**
+ A special character (see BACSSSpecialTokenKind) has been read. Returning an error stops the tokenization.
+ */
+- (nullable NSError *)consumeSpecialToken:(char)c;
+
+@end
+
+/**
+ Single pass CSS tokenizer, working directly on the stylesheet's UTF-16 characters.
+
+ Comments are skipped and "@import sdk("name");" directives are expanded as they are read, without making copies of
+ the stylesheet. Token strings are only allocated when they are reported.
+ */
+@interface BACSSTokenizer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithString:(NSString *)string
+                importProvider:(nullable id<BACSSImportProvider>)importProvider NS_DESIGNATED_INITIALIZER;
+
+/**
+ Tokenize the whole stylesheet, stopping at the first error.
+ Errors have the offset at which they occurred in their userInfo, see kBACSSParserErrorOffsetKey.
+ */
+- (nullable NSError *)tokenizeWithDelegate:(id<BACSSTokenizerDelegate>)delegate;
+
+/**
+ Offset of the character being read, or of the import being expanded
+ */
+@property (readonly) NSUInteger offset;
+
+@end
+
+NS_ASSUME_NONNULL_END
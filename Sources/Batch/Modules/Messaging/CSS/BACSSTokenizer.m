@@ -0,0 +1,300 @@
+//
+//  BACSSTokenizer.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSSTokenizer.h>
+
+NSString *const kBACSSParserErrorOffsetKey = @"offset";
+
+static const unichar kBACSSImportDirectivePrefix[] = {'@', 'i', 'm', 'p', 'o', 'r', 't', ' ', 's', 'd', 'k', '(', '"'};
+static const unichar kBACSSImportDirectiveSuffix[] = {'"', ')', ';'};
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof(array[0]))
+
+// Special characters end tokens: ":;{}" and newlines (matching NSCharacterSet's newlineCharacterSet)
+static inline BOOL BACSSIsSpecialCharacter(unichar c) {
+    switch (c) {
+        case '{':
+        case '}':
+        case ':':
+        case ';':
+        case 0x000A:
+        case 0x000B:
+        case 0x000C:
+        case 0x000D:
+        case 0x0085:
+        case 0x2028:
+        case 0x2029:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Matches NSCharacterSet's whitespaceCharacterSet
+static inline BOOL BACSSIsWhitespaceCharacter(unichar c) {
+    return c == ' ' || c == '\t' || c == 0x00A0 || c == 0x1680 || (c >= 0x2000 && c <= 0x200A) || c == 0x202F ||
+           c == 0x205F || c == 0x3000;
+}
+
+static inline BOOL BACSSHasCharactersAtIndex(const unichar *chars,
+                                             NSUInteger length,
+                                             NSUInteger index,
+                                             const unichar *expected,
+                                             NSUInteger expectedLength) {
+    if (index + expectedLength > length) {
+        return false;
+    }
+    return memcmp(chars + index, expected, expectedLength * sizeof(unichar)) == 0;
+}
+
+@implementation BACSSTokenizer {
+    NSString *_string;
+
+    id<BACSSImportProvider> _importProvider;
+
+    // Only set while tokenizing
+    id<BACSSTokenizerDelegate> _delegate;
+
+    // Parts of the current token that have already been read, when it isn't contiguous in a buffer (because of a
+    // comment or an import). nil most of the time.
+    NSMutableString *_tokenParts;
+
+    // Whether the last character read was a special one. Only the first special character of a run ends a token.
+    BOOL _inSpecialRun;
+
+    // Whether any character that isn't part of a comment has been read
+    BOOL _readCharacters;
+}
+
+- (instancetype)initWithString:(NSString *)string importProvider:(nullable id<BACSSImportProvider>)importProvider {
+    self = [super init];
+    if (self) {
+        _string = [string copy];
+        _importProvider = importProvider;
+    }
+    return self;
+}
+
+- (nullable NSError *)tokenizeWithDelegate:(id<BACSSTokenizerDelegate>)delegate {
+    _delegate = delegate;
+    _tokenParts = nil;
+    _inSpecialRun = false;
+    _readCharacters = false;
+    _offset = 0;
+
+    NSError *err = [self tokenizeString:_string isImport:false];
+    if (err == nil && _readCharacters && !_inSpecialRun) {
+        // Stylesheets must end with a special character
+        err = [self errorWithCode:-1 message:@"Internal error. Check the validity of your file."];
+    }
+
+    _delegate = nil;
+    _tokenParts = nil;
+    return err;
+}
+
+#pragma mark Private methods
+
+- (nullable NSError *)tokenizeString:(NSString *)string isImport:(BOOL)isImport {
+    NSUInteger length = [string length];
+    if (length == 0) {
+        return nil;
+    }
+
+    // Read the string's storage directly if possible, only copy it otherwise
+    const unichar *chars = CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    unichar *copiedChars = NULL;
+    if (chars == NULL) {
+        copiedChars = malloc(length * sizeof(unichar));
+        if (copiedChars == NULL) {
+            return [self errorWithCode:-1 message:@"Internal error. Could not allocate the tokenizer's buffer."];
+        }
+        [string getCharacters:copiedChars range:NSMakeRange(0, length)];
+        chars = copiedChars;
+    }
+
+    // Delegates may throw, which the parser recovers from
+    @try {
+        return [self tokenizeCharacters:chars length:length isImport:isImport];
+    } @finally {
+        free(copiedChars);
+    }
+}
+
+- (nullable NSError *)tokenizeCharacters:(const unichar *)chars length:(NSUInteger)length isImport:(BOOL)isImport {
+    NSUInteger i = 0;
+    NSUInteger tokenStart = 0; // Start of the current token's part in this buffer
+
+    BOOL inComment = false;
+    NSUInteger commentStart = 0;
+    // An unterminated comment isn't a comment: once one has been found, the rest of the buffer is read as is
+    BOOL commentsDisabled = false;
+
+    while (true) {
+        if (i >= length) {
+            if (!inComment) {
+                break;
+            }
+            inComment = false;
+            commentsDisabled = true;
+            i = commentStart;
+            tokenStart = commentStart;
+            continue;
+        }
+
+        unichar c = chars[i];
+
+        if (inComment) {
+            if (c == '*' && i + 1 < length && chars[i + 1] == '/') {
+                inComment = false;
+                i += 2;
+                tokenStart = i;
+            } else {
+                i++;
+            }
+            continue;
+        }
+
+        if (!isImport) {
+            _offset = i;
+        }
+
+        if (!commentsDisabled && c == '/' && i + 1 < length && chars[i + 1] == '*') {
+            [self appendTokenPartWithCharacters:chars + tokenStart length:i - tokenStart];
+            inComment = true;
+            commentStart = i;
+            i += 2;
+            continue;
+        }
+
+        if (!isImport && c == '@') {
+            NSRange nameRange;
+            NSUInteger directiveLength = [self importDirectiveLengthInCharacters:chars
+                                                                          length:length
+                                                                           index:i
+                                                                       nameRange:&nameRange];
+            if (directiveLength > 0) {
+                [self appendTokenPartWithCharacters:chars + tokenStart length:i - tokenStart];
+
+                NSString *importName = [[NSString alloc] initWithCharacters:chars + nameRange.location
+                                                                     length:nameRange.length];
+                NSString *importContent = [_importProvider contentForImportNamed:importName];
+                if (importContent != nil) {
+                    // Imported content is read as if it was written in place of the directive, which is what
+                    // offsets of errors occurring in it will point to. Imports are not expanded in imported content.
+                    NSError *err = [self tokenizeString:importContent isImport:true];
+                    if (err != nil) {
+                        return err;
+                    }
+                }
+
+                i += directiveLength;
+                tokenStart = i;
+                continue;
+            }
+        }
+
+        if (BACSSIsSpecialCharacter(c)) {
+            if (!_inSpecialRun) {
+                [self emitTokenWithCharacters:chars + tokenStart length:i - tokenStart];
+                _inSpecialRun = true;
+            }
+            _readCharacters = true;
+
+            NSError *err = [_delegate consumeSpecialToken:(char)c];
+            if (err != nil) {
+                return [self errorByAddingOffset:err];
+            }
+
+            i++;
+            tokenStart = i;
+            continue;
+        }
+
+        _inSpecialRun = false;
+        _readCharacters = true;
+        i++;
+    }
+
+    // The current token might continue in the next buffer
+    [self appendTokenPartWithCharacters:chars + tokenStart length:length - tokenStart];
+    return nil;
+}
+
+/**
+ Returns the length of the "@import sdk("name");" directive starting at index, or 0 if there is none
+ */
+- (NSUInteger)importDirectiveLengthInCharacters:(const unichar *)chars
+                                         length:(NSUInteger)length
+                                          index:(NSUInteger)index
+                                      nameRange:(NSRange *)nameRange {
+    NSUInteger prefixLength = ARRAY_LENGTH(kBACSSImportDirectivePrefix);
+    if (!BACSSHasCharactersAtIndex(chars, length, index, kBACSSImportDirectivePrefix, prefixLength)) {
+        return 0;
+    }
+
+    NSUInteger nameStart = index + prefixLength;
+    NSUInteger nameEnd = nameStart;
+    while (nameEnd < length && chars[nameEnd] != '"') {
+        nameEnd++;
+    }
+
+    NSUInteger suffixLength = ARRAY_LENGTH(kBACSSImportDirectiveSuffix);
+    if (!BACSSHasCharactersAtIndex(chars, length, nameEnd, kBACSSImportDirectiveSuffix, suffixLength)) {
+        return 0;
+    }
+
+    *nameRange = NSMakeRange(nameStart, nameEnd - nameStart);
+    return nameEnd + suffixLength - index;
+}
+
+- (void)appendTokenPartWithCharacters:(const unichar *)chars length:(NSUInteger)length {
+    if (length == 0) {
+        return;
+    }
+    if (_tokenParts == nil) {
+        _tokenParts = [NSMutableString new];
+    }
+    CFStringAppendCharacters((__bridge CFMutableStringRef)_tokenParts, chars, (CFIndex)length);
+}
+
+- (void)emitTokenWithCharacters:(const unichar *)chars length:(NSUInteger)length {
+    NSString *token;
+    if (_tokenParts != nil) {
+        [self appendTokenPartWithCharacters:chars length:length];
+        token = [_tokenParts stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        _tokenParts = nil;
+    } else {
+        // Fast path: trim the characters before making a string out of them
+        NSUInteger start = 0;
+        NSUInteger end = length;
+        while (start < end && BACSSIsWhitespaceCharacter(chars[start])) {
+            start++;
+        }
+        while (end > start && BACSSIsWhitespaceCharacter(chars[end - 1])) {
+            end--;
+        }
+        token = end > start ? [[NSString alloc] initWithCharacters:chars + start length:end - start] : @"";
+    }
+    [_delegate consumeToken:token];
+}
+
+#pragma mark Errors
+
+- (NSError *)errorWithCode:(NSInteger)code message:(NSString *)message {
+    return [NSError errorWithDomain:BACSS_PARSER_ERROR_DOMAIN
+                               code:code
+                           userInfo:@{NSLocalizedDescriptionKey : message, kBACSSParserErrorOffsetKey : @(_offset)}];
+}
+
+- (NSError *)errorByAddingOffset:(NSError *)error {
+    NSMutableDictionary *userInfo = [error.userInfo mutableCopy] ?: [NSMutableDictionary new];
+    userInfo[kBACSSParserErrorOffsetKey] = @(_offset);
+    return [NSError errorWithDomain:error.domain code:error.code userInfo:userInfo];
+}
+
+@end
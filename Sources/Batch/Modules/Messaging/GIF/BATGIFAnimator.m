@@ -68,6 +68,8 @@
 
     _lastTimestamp = 0;
     _needsDisplayWhenPossible = true;
+    // Frames might have been evicted from the shared cache while paused
+    [_file willDisplayFrameAtIndex:_currentFrameIndex];
     _displayLink.paused = false;
 }
 
@@ -105,7 +107,7 @@
 
     // Store the image in a variable, as consuming it might remove its reference
     if (_needsDisplayWhenPossible) {
-        UIImage *currentFrameImage = _currentFrame.image;
+        UIImage *currentFrameImage = [_file imageAtIndex:_currentFrameIndex];
         if (currentFrameImage != nil) {
             [_file consumeFrameAtIndex:_currentFrameIndex];
             [_delegate animator:self needsToDisplayImage:currentFrameImage];
@@ -1,22 +1,14 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
 
+@class BATGIFFrameCache;
+
 NS_ASSUME_NONNULL_BEGIN
 typedef NS_ENUM(NSInteger, BATGIFError) {
     BATGIFErrorCouldNotCreateImageSource, // CoreGraphics failed to create the source
     BATGIFErrorNotAGif,                   // Source is not a GIF
     BATGIFErrorAnimationNotNeeded,        // Animation is not needed (not more than 1 frame)
-};
-
-/**
- Cache sizes. Note that an extra frame will be held at all times : the current frame.
- Meaning that if you have a cache size of 2, 3 frames will be held in memory at all times.
- */
-typedef NS_ENUM(NSInteger, BATGIFCacheSize) {
-    BATGIFCacheSizeUndefined = -1,
-    BATGIFCacheSizeNoCache = 0,
-    BATGIFCacheSizeNormal = 10,
-    BATGIFCacheSizeSmall = 2,
+    BATGIFErrorNoValidFrame,              // None of the frames could be read
 };
 
 /**
@@ -29,19 +21,14 @@ typedef NS_ENUM(NSInteger, BATGIFCacheSize) {
 
 @property (readonly) NSTimeInterval duration;
 
-@property (strong, nullable) UIImage *image;
-
-/**
- Returns true if the image is available
- */
-@property (readonly) BOOL cached;
-
 - (instancetype)initWithSourceIndex:(size_t)index duration:(NSTimeInterval)duration;
 
 @end
 
 /**
  Represents a GIF file, and its extracted frames
+
+ Decoded frames are stored in a shared BATGIFFrameCache: they are decoded in the background, ahead of their display.
  */
 @interface BATGIFFile : NSObject
 
@@ -53,24 +40,48 @@ typedef NS_ENUM(NSInteger, BATGIFCacheSize) {
 + (BOOL)isPotentiallyAGif:(NSData *)data;
 
 @property (readonly) NSUInteger frameCount; // Number of frames available. This reflects the number of frames we were
-                                            // able to decode from the GIF, not the number it told it had
+                                            // able to read from the GIF headers, not the number it told it had
+
+@property (readonly) NSString *contentHash; // SHA-256 of the GIF data, identifying its frames in the frame cache
+
+@property (readonly) NSUInteger frameCost; // Estimated number of bytes taken by a decoded frame
 
 /**
- Make a new BATGIFFile from the given data.
+ Make a new BATGIFFile from the given data, using the shared frame cache.
+ Only the frame headers are read, but the first frame is decoded so that it can be displayed right away.
  This is an expensive operation that should not be done on the main thread
  */
 - (nullable instancetype)initWithData:(NSData *)data error:(NSError **)error;
 
+- (nullable instancetype)initWithData:(NSData *)data
+                           frameCache:(BATGIFFrameCache *)frameCache
+                                error:(NSError **)error;
+
 /**
  Get the frame at an index.
  */
 - (BATGIFFrame *)frameAtIndex:(NSUInteger)index;
 
+/**
+ Get the key of the frame at an index in the frame cache
+ */
+- (NSString *)frameCacheKeyAtIndex:(NSUInteger)index;
+
+/**
+ Get the decoded image of the frame at an index, or nil if it has not been decoded yet.
+ */
+- (nullable UIImage *)imageAtIndex:(NSUInteger)index;
+
+/**
+ Decode the image of the frame at an index, bypassing the frame cache.
+ Must not be called on the main thread
+ */
+- (nullable UIImage *)decodeImageAtIndex:(NSUInteger)index;
+
 /**
  Consume the frame at an index.
 
- The cache will consider this frame and all the ones before it consumed (if all frames don't fit in memory).
- It is also going to start caching next ones in the background.
+ If all frames don't fit in the frame cache, the frame is evicted from it, unless other files display the same GIF.
  */
 - (void)consumeFrameAtIndex:(NSUInteger)index;
 
@@ -79,7 +90,7 @@ typedef NS_ENUM(NSInteger, BATGIFCacheSize) {
  The difference between this method and "consumeFrameAtIndex" is that the frame will NOT be attempted to be freed.
 
  Call this method when you're about to display the frame at the specified index, so that
- this class may take this opportunity to add more in the cache.
+ this class may take this opportunity to preload it and the next ones in the background.
  */
 - (void)willDisplayFrameAtIndex:(NSUInteger)index;
 
@@ -1,5 +1,9 @@
 #import <Batch/BATGIFFile.h>
 
+#import <Batch/BAInjection.h>
+#import <Batch/BASHA.h>
+#import <Batch/BAStringUtils.h>
+#import <Batch/BATGIFFrameCache.h>
 #import <MobileCoreServices/MobileCoreServices.h>
 
 // Simple macro that prevents from setting and error and forgetting to return
@@ -28,6 +32,11 @@ const NSTimeInterval kBATGIFFrameMinimumDuration = 0.02;
  */
 const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
 
+/**
+ Maximum number of frames preloaded ahead of the displayed one, when the GIF doesn't fit in the frame cache
+ */
+const NSUInteger kBATGIFMaxPreloadedFrames = 10;
+
 @implementation BATGIFFrame
 
 - (instancetype)initWithSourceIndex:(size_t)index duration:(NSTimeInterval)duration {
@@ -39,20 +48,14 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
     return self;
 }
 
-- (BOOL)cached {
-    return self.image != nil;
-}
-
 @end
 
 @interface BATGIFFile () {
     CGImageSourceRef _imageSource;
-    NSMutableArray<BATGIFFrame *> *_frames; // Frame cache. Once the initial setup has finished, only the dedicated
-                                            // serial queue should manage the UIImages
-    BATGIFCacheSize _cacheSize;
-    dispatch_queue_t _cacheQueue;
-    NSMutableIndexSet *_indexesScheduledForPreloading; // Indexes that the worker has been asked to preload. MUST ONLY
-                                                       // BE mutated by the main thread.
+    NSMutableArray<BATGIFFrame *> *_frames;
+    BATGIFFrameCache *_frameCache;
+    // Keys of the frames in the frame cache, built once
+    NSArray<NSString *> *_frameKeys;
 }
 
 @end
@@ -79,8 +82,13 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
 }
 
 - (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+    return [self initWithData:data frameCache:[BAInjection injectClass:BATGIFFrameCache.class] error:error];
+}
+
+- (instancetype)initWithData:(NSData *)data frameCache:(BATGIFFrameCache *)frameCache error:(NSError **)error {
     self = [super init];
     if (self) {
+        _frameCache = frameCache;
         if (![self setupWithData:(NSData *)data error:error]) {
             return nil;
         }
@@ -92,40 +100,37 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
     return _frames[index];
 }
 
+- (NSString *)frameCacheKeyAtIndex:(NSUInteger)index {
+    return _frameKeys[index];
+}
+
+- (nullable UIImage *)imageAtIndex:(NSUInteger)index {
+    return [_frameCache imageForKey:_frameKeys[index]];
+}
+
+- (nullable UIImage *)decodeImageAtIndex:(NSUInteger)index {
+    size_t sourceIndex = _frames[index].sourceIndex;
+    // Decode right away rather than when the image is first drawn, which would happen on the main thread
+    NSDictionary *options = @{(NSString *)kCGImageSourceShouldCacheImmediately : @(true)};
+    CGImageRef imageRef = CGImageSourceCreateImageAtIndex(_imageSource, sourceIndex, (__bridge CFDictionaryRef)options);
+    if (imageRef == NULL) {
+        [BALogger debugForDomain:@"GIF" message:@"Couldn't decode frame %lu", (unsigned long)sourceIndex];
+        return nil;
+    }
+    UIImage *img = [UIImage imageWithCGImage:imageRef];
+    CGImageRelease(imageRef);
+    return img;
+}
+
 - (void)consumeFrameAtIndex:(NSUInteger)index {
-    if (_cacheQueue) {
-        _frames[index].image = nil;
+    if (![self fitsInFrameCache]) {
+        [_frameCache consumeImageForKey:_frameKeys[index] contentHash:_contentHash];
     }
-    return;
 }
 
 - (void)willDisplayFrameAtIndex:(NSUInteger)index {
-    if (_cacheQueue) {
-        __weak BATGIFFile *weakSelf = self;
-        NSArray *indexesSupposedToPreload = [self indexesToPreloadWithStartingIndex:index];
-        // Look at all the indexes we should add to the queue, and skip jobs that already are scheduled
-        // The main thread will be our coordinator in all of this
-        for (NSNumber *nbIndex in indexesSupposedToPreload) {
-            NSUInteger index = nbIndex.unsignedIntegerValue;
-            if (![_indexesScheduledForPreloading containsIndex:index]) {
-                [_indexesScheduledForPreloading addIndex:index];
-
-                dispatch_async(_cacheQueue, ^{
-                  BATGIFFile *unboxedSelf = weakSelf;
-                  if (unboxedSelf && [unboxedSelf->_indexesScheduledForPreloading containsIndex:index]) {
-                      BATGIFFrame *frame = unboxedSelf->_frames[index];
-                      UIImage *loadedImage = [unboxedSelf produceFrameAtSourceIndex:frame.sourceIndex];
-                      if (loadedImage) {
-                          dispatch_async(dispatch_get_main_queue(), ^{
-                            [unboxedSelf setCachedImage:loadedImage atIndex:index];
-                          });
-                      }
-                  }
-                });
-            }
-        }
-    }
-    return;
+    // Include the frame itself, in case it has been evicted
+    [_frameCache preloadFramesOfFile:self fromIndex:index count:[self preloadedFrameCount] + 1];
 }
 
 #pragma mark GIF Parsing
@@ -138,14 +143,6 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
     }
     *error = nil;
 
-    // Listen to memory warning notifications
-    [[NSNotificationCenter defaultCenter] addObserver:self
-                                             selector:@selector(didReceiveMemoryWarning:)
-                                                 name:UIApplicationDidReceiveMemoryWarningNotification
-                                               object:nil];
-
-    _cacheSize = BATGIFCacheSizeUndefined;
-
     _imageSource = CGImageSourceCreateWithData(
         (__bridge CFDataRef)data, (__bridge CFDictionaryRef) @{(NSString *)kCGImageSourceShouldCache : @(false)});
 
@@ -158,54 +155,62 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
         BAIL([self errorWithCode:BATGIFErrorNotAGif message:@"Image is not a GIF"]);
     }
 
-    // Iterate over all frames in the gif, extracting the duration
+    // Iterate over all frames in the gif, extracting the duration from their headers
     // Don't store the raw frame count in _framesCount just yet, as we will only count the VALID frames (aka ones that
-    // CoreGraphics was able to decode) We can still use the frame count to initialize the structures as the difference
+    // have readable headers) We can still use the frame count to initialize the structures as the difference
     // should be slim (if any)
+    // Frames are not decoded here: this is deferred to the frame cache, which will only keep those it has room for
 
     size_t sourceFrameCount = CGImageSourceGetCount(_imageSource);
     _frames = [[NSMutableArray alloc] initWithCapacity:sourceFrameCount];
 
-    NSUInteger insertedFrameIndex = 0;
     NSTimeInterval previousDuration = kBATGIFFrameDefaultDuration;
-    BATGIFFrame *decodedFrame;
+    BATGIFFrame *frame;
     @autoreleasepool {
         for (size_t i = 0; i < sourceFrameCount; i++) {
-            decodedFrame = [self frameForIndex:i previousDuration:previousDuration];
-            if (decodedFrame != nil) {
-                previousDuration = decodedFrame.duration;
-                // We need a valid image to compute the cache strategy, as we can now know the number of bytes per frame
-                if (_cacheSize == BATGIFCacheSizeUndefined) {
-                    [self computeCacheStrategyUsingReferenceFrame:decodedFrame expectedFrames:sourceFrameCount];
-                } else if (_cacheSize != BATGIFCacheSizeNoCache) {
-                    if (insertedFrameIndex >= _cacheSize) {
-                        // We're over the cache, purge the image
-                        decodedFrame.image = nil;
-                    }
-                }
-                [_frames addObject:decodedFrame];
-                insertedFrameIndex++;
+            frame = [self frameForIndex:i previousDuration:previousDuration];
+            if (frame != nil) {
+                previousDuration = frame.duration;
+                [_frames addObject:frame];
             }
         }
     }
     _frameCount = [_frames count];
 
-    [self recomputeCacheStrategyWithRealFrameCount:_frameCount];
+    if (_frameCount == 0) {
+        BAIL([self errorWithCode:BATGIFErrorNoValidFrame message:@"GIF has no valid frame"]);
+    }
+
+    _frameCost = [self estimatedFrameCost];
+    double expectedUncompressedSize = (double)(_frameCost * _frameCount) / (1024 * 1024);
+    [BALogger debugForDomain:@"GIF" message:@"Expecting GIF to take %f MBs", expectedUncompressedSize];
+
+    _contentHash = [BAStringUtils hexStringValueForData:[BASHA sha256HashOf:data]];
+
+    NSMutableArray<NSString *> *frameKeys = [[NSMutableArray alloc] initWithCapacity:_frameCount];
+    for (NSUInteger i = 0; i < _frameCount; i++) {
+        [frameKeys addObject:[BATGIFFrameCache keyForContentHash:_contentHash frameIndex:i]];
+    }
+    _frameKeys = frameKeys;
+    [_frameCache retainFramesForContentHash:_contentHash];
+
+    // Identical GIFs share their frames: the first one might already be there
+    if ([self imageAtIndex:0] == nil) {
+        UIImage *firstImage = [self decodeImageAtIndex:0];
+        if (firstImage != nil) {
+            [_frameCache setImage:firstImage forContentHash:_contentHash frameIndex:0];
+        }
+    }
 
     return true;
 }
 
-// Get a frame out from the raw source index
+// Read a frame's properties out from the raw source index
 // This should only be done once and cached
 - (BATGIFFrame *)frameForIndex:(size_t)index previousDuration:(NSTimeInterval)previousDuration {
-    // Decode a UIImage from the frame, to make sure it can be decoded later
-    CGImageRef imageRef = CGImageSourceCreateImageAtIndex(_imageSource, index, NULL);
-    if (imageRef == NULL) {
-        return nil;
-    }
-    UIImage *image = [UIImage imageWithCGImage:imageRef];
-    CGImageRelease(imageRef);
-    if (image == nil) {
+    // Make sure that the frame can be decoded later
+    CGImageSourceStatus status = CGImageSourceGetStatusAtIndex(_imageSource, index);
+    if (status != kCGImageStatusComplete && status != kCGImageStatusIncomplete) {
         return nil;
     }
 
@@ -249,191 +254,56 @@ const NSTimeInterval kBATGIFFrameDefaultDuration = 0.1;
         duration = MAX(kBATGIFFrameMinimumDuration, duration);
     }
 
-    BATGIFFrame *frame = [[BATGIFFrame alloc] initWithSourceIndex:index duration:duration];
-    frame.image = image;
-
-    return frame;
+    return [[BATGIFFrame alloc] initWithSourceIndex:index duration:duration];
 }
 
 /**
- Compute the cache strategy according to the size we expect to take all bitmaps to fit in memory
+ Estimate the size of a decoded frame from the GIF's dimensions, assuming 4 bytes per pixel
  */
-- (void)computeCacheStrategyUsingReferenceFrame:(BATGIFFrame *)decodedFrame expectedFrames:(size_t)sourceFrameCount {
-    if (decodedFrame.image == nil) {
-        return;
-    }
-
-    CGImageRef cgImg = decodedFrame.image.CGImage;
-    // Compute size used in MB
-    double expectedUncompressedSize =
-        (sourceFrameCount * (CGImageGetBytesPerRow(cgImg) * CGImageGetHeight(cgImg))) / (1024 * 1024);
-    [BALogger debugForDomain:@"GIF" message:@"Expecting GIF to take %f MBs", expectedUncompressedSize];
-
-    // TODO make something dynamic based on the free ram
-
-    NSUInteger gifSizeThreshold;
-    // Tweak the cache settings according to the available RAM
-    NSUInteger availableRam = (NSUInteger)(NSProcessInfo.processInfo.physicalMemory / 1024 / 1024);
-    if (availableRam > 2000) {
-        gifSizeThreshold = 60;
-    } else if (availableRam > 1000) {
-        gifSizeThreshold = 45;
-    } else if (availableRam > 512) {
-        gifSizeThreshold = 25;
-    } else {
-        gifSizeThreshold = 15;
-    }
-
-    if (expectedUncompressedSize >= gifSizeThreshold) {
-        _cacheSize = BATGIFCacheSizeNormal;
-        [BALogger debugForDomain:@"GIF" message:@"Cache enabled"];
-    } else {
-        _cacheSize = BATGIFCacheSizeNoCache;
-        [BALogger debugForDomain:@"GIF" message:@"Cache disabled"];
-    }
-
-    [self setupCacheIfNeeded];
+- (NSUInteger)estimatedFrameCost {
+    size_t sourceIndex = _frames[0].sourceIndex;
+    NSDictionary *properties =
+        (__bridge_transfer NSDictionary *)CGImageSourceCopyPropertiesAtIndex(_imageSource, sourceIndex, NULL);
+    NSUInteger width = [properties[(NSString *)kCGImagePropertyPixelWidth] unsignedIntegerValue];
+    NSUInteger height = [properties[(NSString *)kCGImagePropertyPixelHeight] unsignedIntegerValue];
+    return width * height * 4;
 }
 
-/**
- Check if the cache is still needed.
-
- If the cache is bigger than the total number of frames, we will waste a lot of time redecoding frames
- So, disable the cache rather than adding complicated logic everywhere else
- */
-- (void)recomputeCacheStrategyWithRealFrameCount:(NSUInteger)frameCount {
-    if (_cacheSize >= frameCount) {
-        _cacheSize = BATGIFCacheSizeNoCache;
-        _cacheQueue = nil;
-        _indexesScheduledForPreloading = nil;
-
-        // For safety, make sure we have all images loaded
-        for (BATGIFFrame *frame in _frames) {
-            frame.image = [self produceFrameAtSourceIndex:frame.sourceIndex];
-        }
-    }
-}
+#pragma mark Cache
 
 /**
- Generate a frame for the specified index, and save it in the cache
+ Check if all frames fit comfortably in the frame cache, leaving room for other GIFs.
 
- Must not be called on the main thread
+ If they do, they're kept there while looping. Otherwise, they're evicted once displayed to make room for the next
+ ones: keeping them would only evict frames that we're about to display.
  */
-- (UIImage *)produceFrameAtSourceIndex:(size_t)sourceIndex {
-    CGImageRef imageRef = CGImageSourceCreateImageAtIndex(_imageSource, sourceIndex, NULL);
-    if (imageRef == NULL) {
-        [BALogger debugForDomain:@"GIF" message:@"Couldn't cache frame %lu", (unsigned long)sourceIndex];
-        return false;
-    }
-    UIImage *img = [UIImage imageWithCGImage:imageRef];
-    CGImageRelease(imageRef);
-    return img;
-}
-
-#pragma mark Cache
-
-- (void)setupCacheIfNeeded {
-    if (_cacheSize != BATGIFCacheSizeNoCache) {
-        if (!_cacheQueue) {
-            _cacheQueue = dispatch_queue_create("com.batch.gif.cache_worker", DISPATCH_QUEUE_SERIAL);
-        }
-
-        if (!_indexesScheduledForPreloading) {
-            _indexesScheduledForPreloading = [NSMutableIndexSet new];
-        }
-    }
-}
-
-- (void)setCachedImage:(UIImage *)image atIndex:(NSUInteger)index {
-    _frames[index].image = image;
-    [_indexesScheduledForPreloading removeIndex:index];
+- (BOOL)fitsInFrameCache {
+    return _frameCost * _frameCount <= _frameCache.byteBudget / 2;
 }
 
 /**
- Return the ordered indexes to preload
+ Number of frames to preload ahead of the displayed one.
+ Frames of a GIF that fits in the cache are not evicted once displayed: after the first loop, they are all there.
  */
-- (NSArray *)indexesToPreloadWithStartingIndex:(NSUInteger)index {
-    if (_cacheSize <= 0) {
-        return nil;
+- (NSUInteger)preloadedFrameCount {
+    if ([self fitsInFrameCache]) {
+        return MIN(kBATGIFMaxPreloadedFrames, _frameCount - 1);
     }
-
-    NSArray *indexes;
-
-    // We want to preload starting from the next frame while respecting the cache size
-    // Note: this could be rewritten without the ranges, and only the modulo. I kept that in the meantime so I could
-    // switch to another datastructure easily.
-    NSUInteger startIndex = [self incrementIndex:index by:1];
-    NSUInteger endIndex = [self incrementIndex:index by:_cacheSize];
-
-    if (startIndex == endIndex) {
-        indexes = @[ @(startIndex) ];
-    } else if (endIndex >= startIndex) {
-        NSMutableArray *mutableIndexes = [[NSMutableArray alloc] initWithCapacity:_cacheSize];
-        for (NSUInteger i = startIndex; i < endIndex + 1; i++) {
-            [mutableIndexes addObject:@(i)];
-        }
-        indexes = mutableIndexes;
-    } else {
-        // We need to manually make the two ranges, from startIndex to the end, and from 0 to endIndex
-        NSMutableArray *mutableIndexes = [[NSMutableArray alloc] initWithCapacity:_cacheSize];
-        for (NSUInteger i = startIndex; i < _frameCount; i++) {
-            [mutableIndexes addObject:@(i)];
-        }
-        for (NSUInteger i = 0; i < endIndex + 1; i++) {
-            [mutableIndexes addObject:@(i)];
-        }
-        indexes = mutableIndexes;
-    }
-
-    if (indexes.count > _cacheSize) {
-        [BALogger debugForDomain:@"GIF"
-                         message:@"Trying to cache too many frames (%lu)", (unsigned long)[indexes count]];
-    }
-
-    return indexes;
-}
-
-/**
- Increment the index, looping if necessary
- */
-- (NSUInteger)incrementIndex:(NSUInteger)index by:(NSUInteger)byValue {
-    return (index + byValue) % _frameCount;
+    // Leave room for other GIFs
+    NSUInteger affordableFrames = _frameCost > 0 ? _frameCache.byteBudget / 4 / _frameCost : kBATGIFMaxPreloadedFrames;
+    return MIN(MIN(kBATGIFMaxPreloadedFrames, MAX(1, affordableFrames)), _frameCount - 1);
 }
 
 #pragma mark Lifecycle
 
-- (void)didReceiveMemoryWarning:(NSNotification *)notification {
-    switch (_cacheSize) {
-        case BATGIFCacheSizeNoCache:
-            [BALogger debugForDomain:@"GIF" message:@"Memory warning: Turning on cache"];
-            _cacheSize = BATGIFCacheSizeNormal;
-            break;
-        case BATGIFCacheSizeNormal:
-            [BALogger debugForDomain:@"GIF" message:@"Memory warning: Reducing cache size"];
-            _cacheSize = BATGIFCacheSizeSmall;
-            break;
-        default:
-            return;
-    }
-
-    [self setupCacheIfNeeded];
-    // Purge the cache to free up memory ASAP. The animator will fix this up itself
-    for (BATGIFFrame *frame in _frames) {
-        frame.image = nil;
-    }
-}
-
 - (void)dealloc {
-    [[NSNotificationCenter defaultCenter] removeObserver:self];
-
+    if (_contentHash != nil) {
+        [_frameCache releaseFramesForContentHash:_contentHash];
+    }
     if (_imageSource) {
         CFRelease(_imageSource);
         _imageSource = NULL;
     }
-
-    if (_cacheQueue) {
-        _cacheQueue = NULL;
-    }
 }
 
 #pragma mark Error helper
@@ -0,0 +1,68 @@
+//
+//  BATGIFFrameCache.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BATGIFFile;
+
+/// Process-wide store of decoded GIF frames.
+///
+/// Frames are keyed by the content hash of their GIF, so that two views displaying the same GIF share their decoded
+/// frames. The total size of the decoded bitmaps is capped by a byte budget: least recently used frames are evicted
+/// first. Everything is evicted on memory warnings.
+///
+/// Frames are decoded on a background queue when preloaded. All methods are thread safe.
+@interface BATGIFFrameCache : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget NS_DESIGNATED_INITIALIZER;
+
++ (BATGIFFrameCache *)sharedCache;
+
+/// Default budget, depending on the device's physical memory
++ (NSUInteger)defaultByteBudget;
+
+/// Key of a frame in the cache. Files build them once, rather than for every displayed frame.
++ (NSString *)keyForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index;
+
+@property (readonly) NSUInteger byteBudget;
+
+/// Bytes currently used by the decoded frames
+@property (readonly) NSUInteger totalCost;
+
+- (nullable UIImage *)imageForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index;
+
+- (nullable UIImage *)imageForKey:(NSString *)key;
+
+/// Store a decoded frame. Frames bigger than the whole budget are not stored.
+- (void)setImage:(UIImage *)image forContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index;
+
+- (void)removeImageForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index;
+
+- (void)removeAllImages;
+
+/// Register a file using the frames of a GIF, until the matching -releaseFramesForContentHash:.
+- (void)retainFramesForContentHash:(NSString *)contentHash;
+
+- (void)releaseFramesForContentHash:(NSString *)contentHash;
+
+/// Evict a frame that has been displayed, unless other files use the same GIF: they will display it too, so it is
+/// left to the budget eviction.
+- (void)consumeImageForKey:(NSString *)key contentHash:(NSString *)contentHash;
+
+/// Decode frames of a file in the background, skipping the ones that are already cached or being decoded.
+/// Frames are decoded in order, from the start index and looping over the end of the file.
+/// The file isn't retained: frames of a deallocated file are skipped.
+- (void)preloadFramesOfFile:(BATGIFFile *)file fromIndex:(NSUInteger)startIndex count:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,241 @@
+//
+//  BATGIFFrameCache.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BALogger.h>
+#import <Batch/BATGIFFile.h>
+#import <Batch/BATGIFFrameCache.h>
+
+#define LOGGER_DOMAIN @"GIF"
+
+@implementation BATGIFFrameCache {
+    // All of the following is guarded by @synchronized(self)
+
+    NSMutableDictionary<NSString *, UIImage *> *_images;
+
+    NSMutableDictionary<NSString *, NSNumber *> *_costs;
+
+    // Keys of _images, least recently used first
+    NSMutableOrderedSet<NSString *> *_lruKeys;
+
+    // Keys of the frames waiting to be decoded
+    NSMutableSet<NSString *> *_scheduledKeys;
+
+    // Number of files using each GIF, by content hash
+    NSCountedSet<NSString *> *_fileCounts;
+
+    NSUInteger _totalCost;
+
+    // Incremented on purge, so that decodings started before it don't fill the cache back
+    NSUInteger _generation;
+
+    dispatch_queue_t _decodeQueue;
+}
+
++ (BATGIFFrameCache *)sharedCache {
+    static BATGIFFrameCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      sharedInstance = [[BATGIFFrameCache alloc] initWithByteBudget:[BATGIFFrameCache defaultByteBudget]];
+    });
+
+    return sharedInstance;
+}
+
++ (NSUInteger)defaultByteBudget {
+    NSUInteger budgetMB;
+    NSUInteger availableRam = (NSUInteger)(NSProcessInfo.processInfo.physicalMemory / 1024 / 1024);
+    if (availableRam > 2000) {
+        budgetMB = 60;
+    } else if (availableRam > 1000) {
+        budgetMB = 45;
+    } else if (availableRam > 512) {
+        budgetMB = 25;
+    } else {
+        budgetMB = 15;
+    }
+    return budgetMB * 1024 * 1024;
+}
+
++ (NSString *)keyForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index {
+    return [NSString stringWithFormat:@"%@/%lu", contentHash, (unsigned long)index];
+}
+
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget {
+    self = [super init];
+    if (self) {
+        _byteBudget = byteBudget;
+        _images = [NSMutableDictionary new];
+        _costs = [NSMutableDictionary new];
+        _lruKeys = [NSMutableOrderedSet new];
+        _scheduledKeys = [NSMutableSet new];
+        _fileCounts = [NSCountedSet new];
+        _decodeQueue = dispatch_queue_create(
+            "com.batch.gif.decoder",
+            dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark Public methods
+
+- (NSUInteger)totalCost {
+    @synchronized(self) {
+        return _totalCost;
+    }
+}
+
+- (nullable UIImage *)imageForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index {
+    return [self imageForKey:[BATGIFFrameCache keyForContentHash:contentHash frameIndex:index]];
+}
+
+- (nullable UIImage *)imageForKey:(NSString *)key {
+    @synchronized(self) {
+        UIImage *image = _images[key];
+        if (image != nil) {
+            [_lruKeys removeObject:key];
+            [_lruKeys addObject:key];
+        }
+        return image;
+    }
+}
+
+- (void)setImage:(UIImage *)image forContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index {
+    NSString *key = [BATGIFFrameCache keyForContentHash:contentHash frameIndex:index];
+    @synchronized(self) {
+        [self storeImage:image forKey:key];
+    }
+}
+
+- (void)removeImageForContentHash:(NSString *)contentHash frameIndex:(NSUInteger)index {
+    NSString *key = [BATGIFFrameCache keyForContentHash:contentHash frameIndex:index];
+    @synchronized(self) {
+        [self removeImageForKey:key];
+    }
+}
+
+- (void)removeAllImages {
+    @synchronized(self) {
+        [_images removeAllObjects];
+        [_costs removeAllObjects];
+        [_lruKeys removeAllObjects];
+        [_scheduledKeys removeAllObjects];
+        _totalCost = 0;
+        _generation++;
+    }
+}
+
+- (void)retainFramesForContentHash:(NSString *)contentHash {
+    @synchronized(self) {
+        [_fileCounts addObject:contentHash];
+    }
+}
+
+- (void)releaseFramesForContentHash:(NSString *)contentHash {
+    @synchronized(self) {
+        [_fileCounts removeObject:contentHash];
+    }
+}
+
+- (void)consumeImageForKey:(NSString *)key contentHash:(NSString *)contentHash {
+    @synchronized(self) {
+        if ([_fileCounts countForObject:contentHash] > 1) {
+            return;
+        }
+        [self removeImageForKey:key];
+    }
+}
+
+- (void)preloadFramesOfFile:(BATGIFFile *)file fromIndex:(NSUInteger)startIndex count:(NSUInteger)count {
+    NSUInteger frameCount = file.frameCount;
+    if (frameCount == 0) {
+        return;
+    }
+    __weak BATGIFFile *weakFile = file;
+
+    @synchronized(self) {
+        NSUInteger generation = _generation;
+        for (NSUInteger i = 0; i < MIN(count, frameCount); i++) {
+            NSUInteger index = (startIndex + i) % frameCount;
+            NSString *key = [file frameCacheKeyAtIndex:index];
+            if (_images[key] != nil || [_scheduledKeys containsObject:key]) {
+                continue;
+            }
+            [_scheduledKeys addObject:key];
+
+            dispatch_async(_decodeQueue, ^{
+              @synchronized(self) {
+                  if (generation != self->_generation || ![self->_scheduledKeys containsObject:key]) {
+                      return;
+                  }
+              }
+
+              UIImage *image = [weakFile decodeImageAtIndex:index];
+
+              @synchronized(self) {
+                  [self->_scheduledKeys removeObject:key];
+                  if (image != nil && generation == self->_generation) {
+                      [self storeImage:image forKey:key];
+                  }
+              }
+            });
+        }
+    }
+}
+
+#pragma mark Private methods
+
+// Must be called in @synchronized(self)
+- (void)storeImage:(UIImage *)image forKey:(NSString *)key {
+    CGImageRef cgImage = image.CGImage;
+    NSUInteger cost = cgImage != NULL ? CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage) : 0;
+
+    [self removeImageForKey:key];
+    if (cost > _byteBudget) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Frame is bigger than the cache budget, not caching it"];
+        return;
+    }
+
+    while (_totalCost + cost > _byteBudget && _lruKeys.count > 0) {
+        [self removeImageForKey:_lruKeys.firstObject];
+    }
+
+    _images[key] = image;
+    _costs[key] = @(cost);
+    [_lruKeys addObject:key];
+    _totalCost += cost;
+}
+
+// Must be called in @synchronized(self)
+- (void)removeImageForKey:(NSString *)key {
+    NSNumber *cost = _costs[key];
+    if (cost == nil) {
+        return;
+    }
+    _totalCost -= cost.unsignedIntegerValue;
+    [_images removeObjectForKey:key];
+    [_costs removeObjectForKey:key];
+    [_lruKeys removeObject:key];
+}
+
+#pragma mark Lifecycle
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification {
+    [BALogger debugForDomain:LOGGER_DOMAIN message:@"Memory warning: purging decoded frames"];
+    // Animators will preload the frames they need again
+    [self removeAllImages];
+}
+
+@end
@@ -13,6 +13,7 @@
 #import <Batch/BAMSGButton.h>
 #import <Batch/BAMSGCloseButton.h>
 #import <Batch/BAMSGGradientView.h>
+#import <Batch/BAMSGImageDecoder.h>
 #import <Batch/BAMSGImageView.h>
 #import <Batch/BAMSGLabel.h>
 #import <Batch/BAMSGStackViewItem.h>
@@ -373,7 +374,7 @@ static NSString *kBAMSGInterstitialViewControllerHeroConstraint = @"BAMainHeroCo
                            message:@"Could not load gif file: (%ld) %@", (long)(err ? err.code : 0),
                                    err ? err.localizedDescription : @"unknown"];
           // Try to fall back on a static UIImage
-          UIImage *img = [UIImage imageWithData:gifData];
+          UIImage *img = [BAMSGImageDecoder decodedImageWithData:gifData maxPixelSize:0];
           if (img != nil) {
               [weakSelf didFinishLoadingHero:img];
           }
@@ -54,16 +54,9 @@ handler without having to eval anything
  */
 - (nonnull BAPromise<NSString *> *)executeBridgeMethod:(nullable NSString *)method
                                              arguments:(nullable NSDictionary *)rawJSONArguments {
-    // Our promises don't (yet) implement chaining so we have to do this little forwarding dance
-    BAPromise *outerPromise = [BAPromise new];
-
     BAPromise *internalPromise = [self internalExecuteMethod:method arguments:rawJSONArguments];
 
-    [internalPromise then:^(NSObject *_Nullable value) {
-      [outerPromise resolve:value];
-    }];
-
-    [internalPromise catch:^(NSError *_Nullable error) {
+    return [internalPromise mapError:^NSError *_Nullable(NSError *_Nullable error) {
       NSError *outerError;
       if (error.code == BATWebviewJavascriptBridgeErrorCodePublicError) {
           outerError = error;
@@ -88,10 +81,8 @@ handler without having to eval anything
                                    error.localizedDescription];
           outerError = [self makePublicError:[NSString stringWithFormat:@"Internal error (2)"]];
       }
-      [outerPromise reject:outerError];
+      return outerError;
     }];
-
-    return outerPromise;
 }
 
 /**
@@ -136,44 +136,21 @@ static UIFont *sBAMSGButtonBoldItalicFontOverride = nil;
 }
 
 - (void)applyRules:(nonnull BACSSRules *)rules {
-    [BAMSGStylableViewHelper applyCommonRules:rules toView:self];
+    BAMSGStyle *style = [BAMSGStyle styleForRules:rules];
+    [BAMSGStylableViewHelper applyCommonStyle:style toView:self];
 
-    UIEdgeInsets padding = UIEdgeInsetsZero;
-
-    // Assuming the rules are lowercased, and variables already resolved
-    for (NSString *rule in [rules allKeys]) {
-        NSString *value = rules[rule];
-
-        if ([@"color" isEqualToString:rule]) {
-            UIColor *color = [BAMSGStylableViewHelper colorFromValue:value];
-            if (color) {
-                [self setTitleColor:color forState:UIControlStateNormal];
-            }
-        }
-        // "padding: x x x x" rules have been splitted elsewhere for easier handling
-        else if ([@"padding-top" isEqualToString:rule]) {
-            padding.top = [value floatValue];
-        } else if ([@"padding-bottom" isEqualToString:rule]) {
-            padding.bottom = [value floatValue];
-        } else if ([@"padding-left" isEqualToString:rule]) {
-            padding.left = [value floatValue];
-        } else if ([@"padding-right" isEqualToString:rule]) {
-            padding.right = [value floatValue];
-        }
+    if (style.textColor != nil) {
+        [self setTitleColor:style.textColor forState:UIControlStateNormal];
     }
 
     // Compute and apply the padding, with respect to its label
+    UIEdgeInsets padding = style.padding;
     UIEdgeInsets titleInsets = UIEdgeInsetsMake(0.0f, padding.left, 0.0f, -padding.right);
     UIEdgeInsets contentInsets = UIEdgeInsetsMake(padding.top, 0.0f, padding.bottom, padding.left + padding.right);
     self.titleEdgeInsets = titleInsets;
     self.contentEdgeInsets = contentInsets;
 
-    UIFont *customFont = [BAMSGStylableViewHelper fontFromRules:rules
-                                                       baseFont:sBAMSGButtonFontOverride
-                                                   baseBoldFont:sBAMSGButtonBoldFontOverride];
-    if (customFont) {
-        self.titleLabel.font = customFont;
-    }
+    self.titleLabel.font = [style fontWithBaseFont:sBAMSGButtonFontOverride baseBoldFont:sBAMSGButtonBoldFontOverride];
 }
 
 @end
@@ -1,4 +1,5 @@
 #import <Batch/BALogger.h>
+#import <Batch/BAMSGImageDecoder.h>
 #import <Batch/BAMSGRemoteImageView.h>
 #import <Batch/BATGIFAnimator.h>
 #import <Batch/BATGIFFile.h>
@@ -59,6 +60,7 @@
     [BAMSGImageDownloader
         downloadImageForURL:url
             downloadTimeout:20
+               maxPixelSize:[BAMSGImageDecoder maxPixelSizeForView:self]
           completionHandler:^(NSData *_Nullable data, BOOL isGif, UIImage *_Nullable image, NSError *_Nullable error) {
             if (error != nil) {
                 [BALogger debugForDomain:@"BAMSGRemoteImageView"
@@ -121,7 +123,7 @@
                            message:@"Could not load gif file: (%lu) %@", err ? (long)err.code : 0,
                                    err ? err.localizedDescription : @"unknown"];
           // Try to fall back on a static UIImage
-          UIImage *img = [UIImage imageWithData:gifData];
+          UIImage *img = [BAMSGImageDecoder decodedImageWithData:gifData maxPixelSize:0];
           if (img != nil) {
               dispatch_async(dispatch_get_main_queue(), ^{
                 weakSelf.image = img;
@@ -6,6 +6,7 @@
 //
 
 #import <Batch/BACSS.h>
+#import <Batch/BAMSGStyle.h>
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
 
@@ -19,6 +20,8 @@
 
 + (void)applyCommonRules:(nonnull BACSSRules *)rules toView:(nonnull UIView *)view;
 
++ (void)applyCommonStyle:(nonnull BAMSGStyle *)style toView:(nonnull UIView *)view;
+
 + (nullable UIColor *)colorFromValue:(nonnull NSString *)value;
 
 + (nullable UIColor *)colorFromRGBAValue:(nonnull NSString *)rgbaValue;
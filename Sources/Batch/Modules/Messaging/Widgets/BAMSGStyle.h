@@ -0,0 +1,134 @@
+//
+//  BAMSGStyle.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BACSS.h>
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Background gradient, decoded from "background: linear-gradient(angle, color [location], ...)"
+ */
+@interface BAMSGStyleGradient : NSObject
+
+@property (readonly) float angle;
+
+@property (readonly) NSArray<UIColor *> *colors;
+
+/**
+ Locations of the colors, in [0;1]. nil if they were not all specified.
+ */
+@property (readonly, nullable) NSArray<NSNumber *> *locations;
+
+@end
+
+/**
+ Typed values of a rules object.
+
+ Rules are decoded once, when the style is first asked for: views apply the decoded values rather than going through
+ the rules' strings themselves. Optional scalar values are nil when they are not part of the rules.
+ Styles are immutable.
+ */
+@interface BAMSGStyle : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Get the style of a rules object, decoding it on the first call.
+ Rules objects must not be modified once their style has been asked for.
+ */
++ (BAMSGStyle *)styleForRules:(BACSSRules *)rules NS_SWIFT_NAME(style(forRules:));
+
+#pragma mark Common values
+
+/**
+ From "background-color", "layer-color" or a "background" color
+ */
+@property (readonly, nullable) UIColor *backgroundColor;
+
+/**
+ From a "background" gradient. Views able to display it use it instead of the background color.
+ */
+@property (readonly, nullable) BAMSGStyleGradient *backgroundGradient;
+
+/**
+ Already clamped to [0;1]
+ */
+@property (readonly, nullable) NSNumber *opacity;
+
+@property (readonly, nullable) UIColor *borderColor;
+
+@property (readonly, nullable) NSNumber *borderWidth;
+
+@property (readonly, nullable) NSNumber *borderRadius;
+
+/**
+ Whether "shadow-layer" was valid. The shadow color is optional.
+ */
+@property (readonly) BOOL hasShadow;
+
+@property (readonly) float shadowRadius;
+
+@property (readonly) float shadowOpacity;
+
+@property (readonly, nullable) UIColor *shadowColor;
+
+@property (readonly, nullable) NSNumber *horizontalHuggingPriority;
+
+@property (readonly, nullable) NSNumber *verticalHuggingPriority;
+
+@property (readonly, nullable) NSNumber *horizontalCompressionResistance;
+
+@property (readonly, nullable) NSNumber *verticalCompressionResistance;
+
+#pragma mark Text values
+
+/**
+ From "color"
+ */
+@property (readonly, nullable) UIColor *textColor;
+
+/**
+ Sides that are not part of the rules are 0
+ */
+@property (readonly) UIEdgeInsets padding;
+
+/**
+ Defaults to NSTextAlignmentCenter
+ */
+@property (readonly) NSTextAlignment textAlignment;
+
+@property (readonly) float letterSpacing;
+
+@property (readonly) float lineHeightMultiple;
+
+@property (readonly) float lineSpacing;
+
+/**
+ Font matching the font rules. Fonts are cached between styles.
+
+ If a base font is given, only the font size of the rules is used.
+ */
+- (UIFont *)fontWithBaseFont:(nullable UIFont *)baseFont baseBoldFont:(nullable UIFont *)baseBoldFont;
+
+#pragma mark Value decoding
+
+/**
+ Decode a color value: "transparent", "#RRGGBB", "#RRGGBBAA" or a UIColor name ("red" for [UIColor redColor]).
+ Colors are cached.
+ */
++ (nullable UIColor *)colorFromValue:(NSString *)value;
+
+/**
+ Decode a "#RRGGBB" or "#RRGGBBAA" color value
+ */
++ (nullable UIColor *)colorFromHexValue:(NSString *)value;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,366 @@
+//
+//  BAMSGStyle.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMSGStyle.h>
+#import <Batch/BAMessagingCenter.h>
+
+#import <objc/runtime.h>
+
+// Key of the style associated to a rules object
+static char kBAMSGStyleRulesKey;
+
+// Parses the hexadecimal digits following the "#" of a color value, like NSScanner's scanHexInt would.
+// Values that are too large saturate.
+static unsigned BAMSGParseHexColor(NSString *value) {
+    NSUInteger length = [value length];
+    unsigned long long result = 0;
+    for (NSUInteger i = 1; i < length; i++) {
+        unichar c = [value characterAtIndex:i];
+        unsigned digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            break;
+        }
+        result = MIN((result << 4) | digit, (unsigned long long)UINT_MAX);
+    }
+    return (unsigned)result;
+}
+
+@implementation BAMSGStyleGradient
+
+- (instancetype)initWithAngle:(float)angle
+                       colors:(NSArray<UIColor *> *)colors
+                    locations:(nullable NSArray<NSNumber *> *)locations {
+    self = [super init];
+    if (self) {
+        _angle = angle;
+        _colors = colors;
+        _locations = locations;
+    }
+    return self;
+}
+
++ (nullable BAMSGStyleGradient *)gradientFromValue:(NSString *)value {
+    if (![value hasPrefix:@"linear-gradient("] || ![value hasSuffix:@")"]) {
+        return nil;
+    }
+
+    value = [value substringWithRange:NSMakeRange(16, [value length] - 17)];
+    NSArray<NSString *> *arguments = [value componentsSeparatedByString:@","];
+    if ([arguments count] < 3) {
+        return nil;
+    }
+    float angle = [[arguments[0] stringByReplacingOccurrencesOfString:@"deg" withString:@""] floatValue];
+
+    NSMutableArray<UIColor *> *colors = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *locations = [NSMutableArray new];
+    for (int i = 1; i < [arguments count]; i++) {
+        NSString *argument = [arguments[i] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+
+        // Split on the space, to see if there's a position
+        // The position must be in [0;100]
+        // ex: linear-gradient(90, #FFBBAA 50, #FFAAEE 100)
+        // "%" will be stripped
+        argument = [argument stringByReplacingOccurrencesOfString:@"%" withString:@""];
+        NSArray<NSString *> *components = [argument componentsSeparatedByString:@" "];
+
+        UIColor *parsedColor = [BAMSGStyle colorFromValue:[components objectAtIndex:0]];
+        if (parsedColor) {
+            [colors addObject:parsedColor];
+        }
+
+        if ([components count] > 1) {
+            float location = [components[1] floatValue] / 100;
+            if (location >= 0 && location <= 1) {
+                [locations addObject:@(location)];
+            }
+        }
+    }
+
+    if (colors.count == 0) {
+        return nil;
+    }
+
+    return [[BAMSGStyleGradient alloc] initWithAngle:angle
+                                              colors:colors
+                                           locations:locations.count == colors.count ? locations : nil];
+}
+
+@end
+
+@implementation BAMSGStyle {
+    NSString *_fontName;
+    NSNumber *_fontSize;
+    float _fontWeight;
+    BOOL _boldFont;
+    BOOL _italicFont;
+}
+
++ (BAMSGStyle *)styleForRules:(BACSSRules *)rules {
+    BAMSGStyle *style = objc_getAssociatedObject(rules, &kBAMSGStyleRulesKey);
+    if (style == nil) {
+        style = [[BAMSGStyle alloc] initWithRules:rules];
+        objc_setAssociatedObject(rules, &kBAMSGStyleRulesKey, style, OBJC_ASSOCIATION_RETAIN);
+    }
+    return style;
+}
+
+- (instancetype)initWithRules:(BACSSRules *)rules {
+    self = [super init];
+    if (self) {
+        _textAlignment = NSTextAlignmentCenter;
+
+        // Assuming the rules are lowercased, and variables already resolved
+        for (NSString *rule in [rules allKeys]) {
+            [self decodeRule:rule value:rules[rule]];
+        }
+    }
+    return self;
+}
+
+- (void)decodeRule:(NSString *)rule value:(NSString *)value {
+    if ([@"background-color" isEqualToString:rule] || [@"layer-color" isEqualToString:rule]) {
+        [self decodeBackgroundColor:value];
+    } else if ([@"background" isEqualToString:rule]) {
+        if ([value hasPrefix:@"#"]) {
+            // That's a color
+            [self decodeBackgroundColor:value];
+        } else {
+            BAMSGStyleGradient *gradient = [BAMSGStyleGradient gradientFromValue:value];
+            if (gradient != nil) {
+                _backgroundGradient = gradient;
+            }
+        }
+    } else if ([@"opacity" isEqualToString:rule]) {
+        _opacity = @(MAX(0.0, MIN(1.0, [value floatValue])));
+    } else if ([@"border-color" isEqualToString:rule]) {
+        _borderColor = [BAMSGStyle colorFromValue:value] ?: _borderColor;
+    } else if ([@"border-width" isEqualToString:rule]) {
+        _borderWidth = @([value floatValue]);
+    } else if ([@"border-radius" isEqualToString:rule]) {
+        _borderRadius = @([value floatValue]);
+    } else if ([@"shadow-layer" isEqualToString:rule]) {
+        NSArray<NSString *> *arguments = [value componentsSeparatedByString:@" "];
+        if ([arguments count] >= 3) {
+            _hasShadow = true;
+            _shadowRadius = [arguments[0] floatValue];
+            _shadowOpacity = [arguments[1] floatValue];
+            _shadowColor = [BAMSGStyle colorFromValue:arguments[2]];
+        }
+    } else if ([@"content-hug-h" isEqualToString:rule]) {
+        _horizontalHuggingPriority = @(MAX(1, MIN(1000, [value integerValue])));
+    } else if ([@"content-hug-v" isEqualToString:rule]) {
+        _verticalHuggingPriority = @(MAX(1, MIN(1000, [value integerValue])));
+    } else if ([@"compression-res-h" isEqualToString:rule]) {
+        _horizontalCompressionResistance = @([value integerValue]);
+    } else if ([@"compression-res-v" isEqualToString:rule]) {
+        _verticalCompressionResistance = @([value integerValue]);
+    } else if ([@"color" isEqualToString:rule]) {
+        _textColor = [BAMSGStyle colorFromValue:value];
+    }
+    // "padding: x x x x" rules have been splitted elsewhere for easier handling
+    else if ([@"padding-top" isEqualToString:rule]) {
+        _padding.top = [value floatValue];
+    } else if ([@"padding-bottom" isEqualToString:rule]) {
+        _padding.bottom = [value floatValue];
+    } else if ([@"padding-left" isEqualToString:rule]) {
+        _padding.left = [value floatValue];
+    } else if ([@"padding-right" isEqualToString:rule]) {
+        _padding.right = [value floatValue];
+    } else if ([@"text-align" isEqualToString:rule]) {
+        if ([@"left" isEqualToString:value]) {
+            _textAlignment = NSTextAlignmentLeft;
+        } else if ([@"right" isEqualToString:value]) {
+            _textAlignment = NSTextAlignmentRight;
+        } else if ([@"justify" isEqualToString:value]) {
+            _textAlignment = NSTextAlignmentJustified;
+        }
+    } else if ([@"letter-spacing" isEqualToString:rule]) {
+        _letterSpacing = [value floatValue];
+    } else if ([@"line-height" isEqualToString:rule]) {
+        _lineHeightMultiple = [value floatValue];
+    } else if ([@"line-spacing" isEqualToString:rule]) {
+        _lineSpacing = [value floatValue];
+    } else if ([@"font-weight" isEqualToString:rule]) {
+        if ([@"bold" isEqualToString:value]) {
+            _boldFont = true;
+        } else {
+            // Maybe remove this as it only works with the system font
+            _fontWeight = [value floatValue];
+        }
+    } else if ([@"font-style" isEqualToString:rule]) {
+        if ([@"italic" isEqualToString:value]) {
+            _italicFont = true;
+        }
+    } else if ([@"font-size" isEqualToString:rule]) {
+        _fontSize = @([value floatValue]);
+    } else if ([@"font" isEqualToString:rule]) {
+        _fontName = value;
+    }
+}
+
+- (void)decodeBackgroundColor:(NSString *)value {
+    UIColor *color = [BAMSGStyle colorFromValue:value];
+    if (color != nil) {
+        _backgroundColor = color;
+    }
+}
+
+#pragma mark Fonts
+
+- (UIFont *)fontWithBaseFont:(nullable UIFont *)baseFont baseBoldFont:(nullable UIFont *)baseBoldFont {
+    CGFloat fontSize = _fontSize != nil ? [_fontSize floatValue] : [UIFont systemFontSize];
+
+    // If the dev overrides the font: do not try to be smart.
+    // If the dev forgot to give a bold font override, use the system bold font.
+    if (_boldFont && baseBoldFont != nil) {
+        return [baseBoldFont fontWithSize:fontSize];
+    } else if (baseFont != nil) {
+        return [baseFont fontWithSize:fontSize];
+    }
+
+    UIFont *font = [BAMSGStyle fontWithName:_fontName
+                                       size:fontSize
+                                     weight:_fontWeight
+                                       bold:_boldFont
+                                     italic:_italicFont];
+    if ([BAMessagingCenter instance].enableDynamicType) {
+        // Scales font if dynamic type is enabled
+        font = [[UIFontMetrics defaultMetrics] scaledFontForFont:font];
+    }
+    return font;
+}
+
++ (NSCache<NSString *, UIFont *> *)fontCache {
+    static NSCache *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      cache = [NSCache new];
+      cache.countLimit = 50;
+    });
+    return cache;
+}
+
++ (UIFont *)fontWithName:(nullable NSString *)fontName
+                    size:(CGFloat)fontSize
+                  weight:(float)fontWeight
+                    bold:(BOOL)boldFont
+                  italic:(BOOL)italicFont {
+    NSString *cacheKey = [NSString
+        stringWithFormat:@"%@|%f|%f|%d|%d", fontName ?: @"", fontSize, fontWeight, boldFont, italicFont];
+    UIFont *font = [[self fontCache] objectForKey:cacheKey];
+    if (font != nil) {
+        return font;
+    }
+
+    // If fontName isn't found, use the system one
+    if (fontName) {
+        font = [UIFont fontWithName:fontName size:fontSize];
+    }
+
+    if (font == nil) {
+        if (boldFont) {
+            font = [UIFont boldSystemFontOfSize:fontSize];
+        } else if (italicFont) {
+            font = [UIFont italicSystemFontOfSize:fontSize];
+        } else if (fontWeight > 0) {
+            font = [UIFont systemFontOfSize:fontSize weight:fontWeight];
+        } else {
+            font = [UIFont systemFontOfSize:fontSize];
+        }
+    } else {
+        // Try to guess the bold/italic version of the font, but that can fail.
+
+        UIFontDescriptorSymbolicTraits traits = 0;
+        if (boldFont) {
+            traits |= UIFontDescriptorTraitBold;
+        } else if (italicFont) {
+            traits |= UIFontDescriptorTraitItalic;
+        }
+
+        UIFont *guessedFont = [UIFont fontWithDescriptor:[[font fontDescriptor] fontDescriptorWithSymbolicTraits:traits]
+                                                    size:fontSize];
+
+        if (guessedFont) {
+            font = guessedFont;
+        }
+    }
+
+    [[self fontCache] setObject:font forKey:cacheKey];
+    return font;
+}
+
+#pragma mark Colors
+
++ (NSCache<NSString *, id> *)colorCache {
+    static NSCache *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      cache = [NSCache new];
+      cache.countLimit = 200;
+    });
+    return cache;
+}
+
++ (nullable UIColor *)colorFromValue:(NSString *)value {
+    if (value == nil) {
+        return nil;
+    }
+
+    // Unknown color names are cached as NSNull
+    id cachedColor = [[self colorCache] objectForKey:value];
+    if (cachedColor != nil) {
+        return cachedColor != [NSNull null] ? cachedColor : nil;
+    }
+
+    UIColor *color = nil;
+    if ([@"transparent" isEqualToString:value]) {
+        color = [UIColor clearColor];
+    } else if ([value hasPrefix:@"#"]) {
+        color = [self colorFromHexValue:value];
+    } else {
+        // Try to transorm the color into a native color (ex. "red" -> "[UIColor redColor]")
+        SEL colorSelector = NSSelectorFromString([[value lowercaseString] stringByAppendingString:@"Color"]);
+        if ([UIColor respondsToSelector:colorSelector]) {
+            UIColor *(*colorImp)(id, SEL) = (UIColor * (*)(id, SEL))[UIColor methodForSelector:colorSelector];
+            id namedColor = colorImp([UIColor class], colorSelector);
+            if ([namedColor isKindOfClass:[UIColor class]]) {
+                color = namedColor;
+            }
+        }
+    }
+
+    [[self colorCache] setObject:color ?: [NSNull null] forKey:value];
+    return color;
+}
+
++ (nullable UIColor *)colorFromHexValue:(NSString *)value {
+    if (![value hasPrefix:@"#"]) {
+        return nil;
+    }
+
+    unsigned hexVal = BAMSGParseHexColor(value);
+    if ([value length] == 9) {
+        // Color is RGBA
+        return [UIColor colorWithRed:((hexVal & 0xFF000000) >> 24) / 255.0
+                               green:((hexVal & 0x00FF0000) >> 16) / 255.0
+                                blue:((hexVal & 0x0000FF00) >> 8) / 255.0
+                               alpha:(hexVal & 0x000000FF) / 255.0];
+    } else {
+        return [UIColor colorWithRed:((hexVal & 0xFF0000) >> 16) / 255.0
+                               green:((hexVal & 0xFF00) >> 8) / 255.0
+                                blue:(hexVal & 0xFF) / 255.0
+                               alpha:1.0];
+    }
+}
+
+@end
@@ -0,0 +1,30 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A counter that can be incremented from any thread.
+///
+/// Increments are a single atomic add: they never wait on other threads and never allocate.
+@interface BAAtomicCounter : NSObject
+
+- (instancetype)initWithValue:(uint64_t)value NS_DESIGNATED_INITIALIZER;
+
+- (void)increment;
+
+- (void)add:(uint64_t)amount;
+
+/// Current value
+@property (readonly) uint64_t value;
+
+/// Atomically read the value and reset it to 0, so that increments racing with the read are not lost
+- (uint64_t)drain;
+
+@end
+
+NS_ASSUME_NONNULL_END
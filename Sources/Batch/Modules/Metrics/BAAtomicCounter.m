@@ -0,0 +1,43 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAAtomicCounter.h>
+
+#import <stdatomic.h>
+
+@implementation BAAtomicCounter {
+    _Atomic(uint64_t) _value;
+}
+
+- (instancetype)init {
+    return [self initWithValue:0];
+}
+
+- (instancetype)initWithValue:(uint64_t)value {
+    self = [super init];
+    if (self) {
+        atomic_init(&_value, value);
+    }
+    return self;
+}
+
+- (void)increment {
+    atomic_fetch_add_explicit(&_value, 1, memory_order_relaxed);
+}
+
+- (void)add:(uint64_t)amount {
+    atomic_fetch_add_explicit(&_value, amount, memory_order_relaxed);
+}
+
+- (uint64_t)value {
+    return atomic_load_explicit(&_value, memory_order_relaxed);
+}
+
+- (uint64_t)drain {
+    return atomic_exchange_explicit(&_value, 0, memory_order_relaxed);
+}
+
+@end
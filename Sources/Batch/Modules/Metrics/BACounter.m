@@ -4,6 +4,7 @@
 //  Copyright © Batch.com. All rights reserved.
 //
 
+#import <Batch/BAAtomicCounter.h>
 #import <Batch/BACounter.h>
 
 @interface BACounter (Protected)
@@ -15,8 +16,18 @@
 
 @implementation BACounter {
     /// Current counter value
-    double _value;
+    BAAtomicCounter *_counter;
 }
+
+- (instancetype)initWithName:(nonnull NSString *)name
+           andLabelNamesList:(nullable NSArray<NSString *> *)labelNames {
+    self = [super initWithName:name andLabelNamesList:labelNames];
+    if (self) {
+        _counter = [BAAtomicCounter new];
+    }
+    return self;
+}
+
 #pragma mark - BAMetricProtocol methods
 
 - (BAMetric *)newChild:(nonnull NSMutableArray<NSString *> *)labels {
@@ -26,21 +37,40 @@
 }
 
 - (void)reset {
-    _value = 0;
-    [[super values] removeAllObjects];
-    [[super children] removeAllObjects];
+    [_counter drain];
+    [self removeAllChildren];
 }
 
 - (NSString *)type {
     return @"counter";
 }
 
+#pragma mark - BAMetric methods
+
+/// The value is only boxed when it is read: incrementing doesn't allocate
+- (NSMutableArray<NSNumber *> *)values {
+    uint64_t value = [_counter value];
+    if (value == 0) {
+        return [NSMutableArray array];
+    }
+    return [NSMutableArray arrayWithObject:[NSNumber numberWithDouble:(double)value]];
+}
+
+- (nullable BAMetric *)drainChanges {
+    // Increments racing with the drain are either in the returned copy or left in the counter, never lost
+    uint64_t value = [_counter drain];
+    if (value == 0) {
+        return nil;
+    }
+    BACounter *changes = [self copy];
+    changes->_counter = [[BAAtomicCounter alloc] initWithValue:value];
+    return changes;
+}
+
 #pragma mark - BACounter methods
 
 - (void)increment {
-    _value++;
-    [[super values] removeAllObjects];
-    [[super values] addObject:[NSNumber numberWithDouble:_value]];
+    [_counter increment];
     [self update];
 }
 
@@ -49,7 +79,7 @@
 - (nonnull id)copyWithZone:(nullable NSZone *)zone {
     BACounter *copy = [super copyWithZone:zone];
     if (copy) {
-        copy->_value = _value;
+        copy->_counter = [[BAAtomicCounter alloc] initWithValue:[_counter value]];
     }
     return copy;
 }
@@ -0,0 +1,63 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Values of a histogram at the time it was drained
+@interface BAHistogramSnapshot : NSObject
+
+/// Upper bounds of the buckets, in ascending order
+@property (readonly) NSArray<NSNumber *> *bucketBounds;
+
+/// Number of values per bucket. Has one more element than the bounds: values above the last bound.
+@property (readonly) NSArray<NSNumber *> *bucketCounts;
+
+/// Sum of the bucket counts
+@property (readonly) uint64_t count;
+
+/// Sum of the values, with a precision of a millionth
+@property (readonly) double sum;
+
+@end
+
+/// A histogram that can record values from any thread.
+///
+/// Buckets are fixed when the histogram is created: recording a value finds its bucket with a binary search, then
+/// increments the bucket and the sum atomically. It never waits on other threads and never allocates.
+@interface BAHistogram : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Create a histogram with the given bucket upper bounds, which must be in ascending order
+- (instancetype)initWithBucketBounds:(NSArray<NSNumber *> *)bucketBounds NS_DESIGNATED_INITIALIZER;
+
+/// Buckets suited for network durations, in seconds: from 5ms to 30s
++ (NSArray<NSNumber *> *)defaultDurationBucketBounds;
+
+@property (readonly) NSArray<NSNumber *> *bucketBounds;
+
+/// Record a value. A value goes in the first bucket whose bound it doesn't exceed.
+- (void)observe:(double)value;
+
+/// Number of values recorded since the last drain
+@property (readonly) uint64_t count;
+
+/// Read the recorded values, without resetting them
+- (BAHistogramSnapshot *)snapshot;
+
+/// Add the values of a snapshot taken from a histogram with the same buckets
+- (void)addSnapshot:(BAHistogramSnapshot *)snapshot;
+
+/// Read the recorded values and reset them.
+/// Values recorded while draining are counted either in this snapshot or in the next one, never lost. Only their
+/// addition to the sum may land in the other one.
+- (BAHistogramSnapshot *)drain;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,135 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAHistogram.h>
+
+#import <stdatomic.h>
+
+// Sums are kept as integers so that they can be added atomically
+#define SUM_SCALE 1000000.0
+
+@implementation BAHistogramSnapshot
+
+- (instancetype)initWithBucketBounds:(NSArray<NSNumber *> *)bucketBounds
+                        bucketCounts:(NSArray<NSNumber *> *)bucketCounts
+                               count:(uint64_t)count
+                                 sum:(double)sum {
+    self = [super init];
+    if (self) {
+        _bucketBounds = bucketBounds;
+        _bucketCounts = bucketCounts;
+        _count = count;
+        _sum = sum;
+    }
+    return self;
+}
+
+@end
+
+@implementation BAHistogram {
+    double *_bounds;
+    NSUInteger _boundsCount;
+
+    // One more bucket than bounds, for values above the last one
+    // The count is the sum of the buckets, so that both can't disagree when drained while recording
+    _Atomic(uint64_t) *_buckets;
+
+    _Atomic(int64_t) _scaledSum;
+}
+
+- (instancetype)initWithBucketBounds:(NSArray<NSNumber *> *)bucketBounds {
+    self = [super init];
+    if (self) {
+        _bucketBounds = [bucketBounds copy];
+        _boundsCount = [_bucketBounds count];
+        _bounds = malloc(sizeof(double) * MAX(_boundsCount, (NSUInteger)1));
+        for (NSUInteger i = 0; i < _boundsCount; i++) {
+            _bounds[i] = [_bucketBounds[i] doubleValue];
+        }
+        _buckets = calloc(_boundsCount + 1, sizeof(_Atomic(uint64_t)));
+        atomic_init(&_scaledSum, 0);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_bounds);
+    free(_buckets);
+}
+
++ (NSArray<NSNumber *> *)defaultDurationBucketBounds {
+    return @[ @0.005, @0.01, @0.025, @0.05, @0.1, @0.25, @0.5, @1, @2.5, @5, @10, @30 ];
+}
+
+- (void)observe:(double)value {
+    // First bound >= value
+    NSUInteger low = 0;
+    NSUInteger high = _boundsCount;
+    while (low < high) {
+        NSUInteger middle = low + (high - low) / 2;
+        if (_bounds[middle] < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    atomic_fetch_add_explicit(&_buckets[low], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_scaledSum, llround(value * SUM_SCALE), memory_order_relaxed);
+}
+
+- (uint64_t)count {
+    uint64_t count = 0;
+    for (NSUInteger i = 0; i <= _boundsCount; i++) {
+        count += atomic_load_explicit(&_buckets[i], memory_order_relaxed);
+    }
+    return count;
+}
+
+- (BAHistogramSnapshot *)snapshot {
+    uint64_t count = 0;
+    NSMutableArray<NSNumber *> *bucketCounts = [NSMutableArray arrayWithCapacity:_boundsCount + 1];
+    for (NSUInteger i = 0; i <= _boundsCount; i++) {
+        uint64_t bucketCount = atomic_load_explicit(&_buckets[i], memory_order_relaxed);
+        count += bucketCount;
+        [bucketCounts addObject:@(bucketCount)];
+    }
+    int64_t scaledSum = atomic_load_explicit(&_scaledSum, memory_order_relaxed);
+
+    return [[BAHistogramSnapshot alloc] initWithBucketBounds:_bucketBounds
+                                                bucketCounts:bucketCounts
+                                                       count:count
+                                                         sum:(double)scaledSum / SUM_SCALE];
+}
+
+- (void)addSnapshot:(BAHistogramSnapshot *)snapshot {
+    if ([snapshot.bucketCounts count] != _boundsCount + 1) {
+        return;
+    }
+    for (NSUInteger i = 0; i <= _boundsCount; i++) {
+        atomic_fetch_add_explicit(&_buckets[i], [snapshot.bucketCounts[i] unsignedLongLongValue],
+                                  memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&_scaledSum, llround(snapshot.sum * SUM_SCALE), memory_order_relaxed);
+}
+
+- (BAHistogramSnapshot *)drain {
+    uint64_t count = 0;
+    NSMutableArray<NSNumber *> *bucketCounts = [NSMutableArray arrayWithCapacity:_boundsCount + 1];
+    for (NSUInteger i = 0; i <= _boundsCount; i++) {
+        uint64_t bucketCount = atomic_exchange_explicit(&_buckets[i], 0, memory_order_relaxed);
+        count += bucketCount;
+        [bucketCounts addObject:@(bucketCount)];
+    }
+    int64_t scaledSum = atomic_exchange_explicit(&_scaledSum, 0, memory_order_relaxed);
+
+    return [[BAHistogramSnapshot alloc] initWithBucketBounds:_bucketBounds
+                                                bucketCounts:bucketCounts
+                                                       count:count
+                                                         sum:(double)scaledSum / SUM_SCALE];
+}
+
+@end
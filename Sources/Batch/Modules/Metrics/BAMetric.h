@@ -3,9 +3,12 @@
 //
 //  Copyright © Batch.com. All rights reserved.
 //
+#import <Batch/BAMetricLabelSet.h>
 #import <Batch/BAMetricProtocol.h>
 #import <Foundation/Foundation.h>
 
+@class BAMetricManager;
+
 @interface BAMetric : NSObject <BAMetricProtocol, NSCopying>
 
 /// Metric name
@@ -23,8 +26,12 @@
 /// Metric label values  (eg: post / 200)
 @property (atomic, strong, readwrite, nullable) NSMutableArray<NSString *> *labelValues;
 
-/// Metric children (meaning every label values association is a child)
-@property (atomic, strong, readonly, nullable) NSMutableDictionary *children;
+/// Manager the metric is registered to, notified when a value is recorded. Children share their parent's.
+@property (atomic, weak, readwrite, nullable) BAMetricManager *manager;
+
+/// Metric children (meaning every label values association is a child).
+/// Children are added from any thread: enumerate them through childrenSnapshot.
+@property (atomic, strong, readonly, nullable) NSMutableDictionary<BAMetricLabelSet *, BAMetric *> *children;
 
 - (nonnull instancetype)initWithName:(nonnull NSString *)name;
 
@@ -32,11 +39,21 @@
                        andLabelNames:(nonnull NSString *)firstLabel, ... NS_REQUIRES_NIL_TERMINATION;
 
 - (nonnull instancetype)initWithName:(nonnull NSString *)name
-                   andLabelNamesList:(nonnull NSArray<NSString *> *)labelNames;
+                   andLabelNamesList:(nullable NSArray<NSString *> *)labelNames;
 
 /// Get or create a child from labels values
 - (nonnull id)labels:(nonnull NSArray<NSString *> *)args;
 
+/// Get or create a child from a label set.
+/// Callers recording the same child often should keep its label set, or the child itself.
+- (nonnull id)childForLabelSet:(nonnull BAMetricLabelSet *)labelSet;
+
+/// Children at the time of the call
+- (nonnull NSArray<BAMetric *> *)childrenSnapshot;
+
+/// Remove all children
+- (void)removeAllChildren;
+
 /// Register this metric to the BAMetricManager instance
 - (nonnull id)registerMetric;
 
@@ -46,6 +63,10 @@
 /// Flag indicating whether the metric values has changed
 - (BOOL)hasChanged;
 
+/// Atomically take the values recorded since the last call: returns a copy holding them, and resets the metric's.
+/// Returns nil if the metric has not changed. Children are not drained.
+- (nullable BAMetric *)drainChanges;
+
 /// Convert metric to dictionary for serialization
 - (nonnull NSDictionary *)toDictionary;
 
@@ -15,47 +15,34 @@
 #pragma mark - Instance setup
 
 - (instancetype)initWithName:(nonnull NSString *)name {
-    self = [super init];
-    if (self) {
-        _name = name;
-        _type = [self type];
-        _children = [NSMutableDictionary dictionary];
-        _values = [NSMutableArray array];
-    };
-    return self;
+    return [self initWithName:name andLabelNamesList:nil];
 }
 
 - (instancetype)initWithName:(nonnull NSString *)name andLabelNames:(nonnull NSString *)firstLabel, ... {
-    self = [super init];
-    if (self) {
-        _name = name;
-        _type = [self type];
-        _children = [NSMutableDictionary dictionary];
-        _values = [NSMutableArray array];
-        _labelNames = [NSMutableArray array];
-        NSString *label;
-        va_list argumentList;
-        if (firstLabel) {
-            [_labelNames addObject:firstLabel];
-            va_start(argumentList, firstLabel);
-            while ((label = va_arg(argumentList, id)) != nil) {
-                [_labelNames addObject:label];
-            }
-            va_end(argumentList);
+    NSMutableArray<NSString *> *labelNames = [NSMutableArray array];
+    NSString *label;
+    va_list argumentList;
+    if (firstLabel) {
+        [labelNames addObject:firstLabel];
+        va_start(argumentList, firstLabel);
+        while ((label = va_arg(argumentList, id)) != nil) {
+            [labelNames addObject:label];
         }
-    };
-    return self;
+        va_end(argumentList);
+    }
+    return [self initWithName:name andLabelNamesList:labelNames];
 }
 
+// All initializers go through this one, so that subclasses only have to override it
 - (instancetype)initWithName:(nonnull NSString *)name
-           andLabelNamesList:(nonnull NSMutableArray<NSString *> *)labelNames {
+           andLabelNamesList:(nullable NSArray<NSString *> *)labelNames {
     self = [super init];
     if (self) {
         _name = name;
         _type = [self type];
         _children = [NSMutableDictionary dictionary];
         _values = [NSMutableArray array];
-        _labelNames = labelNames;
+        _labelNames = [labelNames mutableCopy];
     };
     return self;
 }
@@ -63,39 +50,66 @@
 #pragma mark - Metric Methods
 
 - (id)registerMetric {
-    [[BAInjection injectClass:BAMetricManager.class] addMetric:self];
+    BAMetricManager *manager = [BAInjection injectClass:BAMetricManager.class];
+    self.manager = manager;
+    [manager addMetric:self];
     return self;
 }
 
 - (id)labels:(nonnull NSArray<NSString *> *)args {
-    NSMutableArray *labels = [NSMutableArray array];
-    NSString *firstLabel = args.firstObject;
+    return [self childForLabelSet:[BAMetricLabelSet labelSetWithValues:args]];
+}
 
-    if (firstLabel) {
-        [labels addObject:firstLabel];
-        for (NSUInteger i = 1; i < args.count; i++) {
-            NSString *label = args[i];
-            [labels addObject:label];
+- (id)childForLabelSet:(nonnull BAMetricLabelSet *)labelSet {
+    @synchronized(_children) {
+        id child = [_children objectForKey:labelSet];
+        if (child == nil) {
+            child = [self newChild:[labelSet.values mutableCopy]];
+            ((BAMetric *)child).manager = self.manager;
+            [_children setObject:child forKey:labelSet];
         }
+        return child;
     }
-    id child = [_children objectForKey:labels];
-    if (child == nil) {
-        child = [self newChild:labels];
-        [_children setObject:child forKey:labels];
+}
+
+- (nonnull NSArray<BAMetric *> *)childrenSnapshot {
+    @synchronized(_children) {
+        return [_children allValues];
+    }
+}
+
+- (void)removeAllChildren {
+    @synchronized(_children) {
+        [_children removeAllObjects];
     }
-    return child;
 }
 
 - (BOOL)hasChildren {
-    return [_children count] > 0;
+    @synchronized(_children) {
+        return [_children count] > 0;
+    }
 }
 
 - (BOOL)hasChanged {
-    return [_values count] > 0;
+    NSMutableArray<NSNumber *> *values = [self values];
+    @synchronized(values) {
+        return [values count] > 0;
+    }
+}
+
+- (nullable BAMetric *)drainChanges {
+    @synchronized(_values) {
+        if ([_values count] == 0) {
+            return nil;
+        }
+        BAMetric *changes = [self copy];
+        [_values removeAllObjects];
+        return changes;
+    }
 }
 
 - (void)update {
-    [[BAInjection injectClass:BAMetricManager.class] sendMetrics];
+    [self.manager metricDidRecord];
 }
 
 #pragma mark - BAMetricProtocol methods (must be override in a subclass)
@@ -117,7 +131,10 @@
     NSMutableDictionary *metricDict = [NSMutableDictionary dictionary];
     [metricDict setObject:_name forKey:@"name"];
     [metricDict setObject:_type forKey:@"type"];
-    [metricDict setObject:_values forKey:@"values"];
+    NSMutableArray<NSNumber *> *values = [self values];
+    @synchronized(values) {
+        [metricDict setObject:[values copy] forKey:@"values"];
+    }
     if (_labelNames != nil && _labelValues != nil && [_labelNames count] == [_labelValues count]) {
         NSMutableDictionary *labelsDict = [NSMutableDictionary dictionary];
         unsigned long i, size = [_labelNames count];
@@ -136,10 +153,14 @@
     if (copy) {
         copy->_name = _name;
         copy->_type = _type;
-        copy->_values = [_values mutableCopy];
+        @synchronized(_values) {
+            copy->_values = [_values mutableCopy];
+        }
         copy->_labelNames = [_labelNames mutableCopy];
         copy->_labelValues = [_labelValues mutableCopy];
-        copy->_children = [_children mutableCopy];
+        @synchronized(_children) {
+            copy->_children = [_children mutableCopy];
+        }
     }
     return copy;
 }
@@ -0,0 +1,43 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BADateProviderProtocol.h>
+#import <Batch/BAMetric.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Batches metric changes and sends them to the metrics webservice.
+///
+/// Exported metrics hold the changes since the previous export: counters their increments, observations their new
+/// values. The exporter merges them into a pending batch where each series (name, type and labels) appears once,
+/// summing counters and appending observations, so that exports made while the webservice is unavailable don't grow
+/// the batch with duplicate series.
+/// Pending and in-flight batches are persisted, and sent on the next launch if the app is killed before they are.
+/// A batch that was in flight when the app was killed is sent again.
+@interface BAMetricExporter : NSObject
+
+- (instancetype)init;
+
+/// Create an exporter persisting its batches at the given URL. A nil URL disables persistence.
+- (instancetype)initWithFileURL:(nullable NSURL *)fileURL
+                   dateProvider:(id<BADateProviderProtocol>)dateProvider NS_DESIGNATED_INITIALIZER;
+
+/// Merge metric changes into the pending batch, and send it if the webservice is available
+- (void)exportMetrics:(NSArray<BAMetric *> *)metrics;
+
+/// Metrics waiting to be sent, in flight or not, serialized in the webservice format
+- (NSArray<NSDictionary *> *)pendingMetrics;
+
+/// Whether a batch is waiting to be sent or in flight, once the exports made before this call are merged
+@property (readonly) BOOL hasPendingMetrics;
+
+/// Send a batch. Overridable for testing purposes.
+- (void)sendBatch:(NSArray<NSDictionary *> *)batch completion:(void (^)(NSError *_Nullable error))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
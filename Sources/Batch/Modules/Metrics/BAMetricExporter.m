@@ -0,0 +1,291 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BADirectories.h>
+#import <Batch/BAJson.h>
+#import <Batch/BALogger.h>
+#import <Batch/BAMetricExporter.h>
+#import <Batch/BAMetricWebserviceClient.h>
+#import <Batch/BASecureDateProvider.h>
+#import <Batch/BAWebserviceClientExecutor.h>
+
+#define LOGGER_DOMAIN @"BAMetricExporter"
+#define ERROR_DOMAIN @"com.batch.ios.metrics.exporter"
+
+#define FILE_NAME @"metrics.json"
+#define FILE_VERSION 1
+
+/// Default retry after in fail case (in seconds)
+#define DEFAULT_RETRY_AFTER @60
+
+/// Bounds of the pending batch, so that it doesn't grow forever while the webservice is unavailable
+#define MAX_PENDING_SERIES 200
+#define MAX_VALUES_PER_SERIES 100
+
+@implementation BAMetricExporter {
+    /// Serial queue guarding the batches
+    dispatch_queue_t _queue;
+
+    NSURL *_fileURL;
+
+    id<BADateProviderProtocol> _dateProvider;
+
+    /// Pending series by key, and their keys in insertion order
+    NSMutableDictionary<NSString *, NSMutableDictionary *> *_pendingSeries;
+    NSMutableArray<NSString *> *_pendingKeys;
+
+    /// Batch being sent, nil if none
+    NSArray<NSDictionary *> *_inflightBatch;
+
+    /// Timestamp to wait before metric service be available again.
+    NSTimeInterval _nextAvailableMetricServiceTimestamp;
+}
+
+- (instancetype)init {
+    NSURL *fileURL = [NSURL fileURLWithPathComponents:@[ [BADirectories pathForBatchAppSupportDirectory], FILE_NAME ]];
+    return [self initWithFileURL:fileURL dateProvider:[BASecureDateProvider new]];
+}
+
+- (instancetype)initWithFileURL:(nullable NSURL *)fileURL dateProvider:(id<BADateProviderProtocol>)dateProvider {
+    self = [super init];
+    if (self) {
+        _queue = dispatch_queue_create("com.batch.ios.metrics.exporter", DISPATCH_QUEUE_SERIAL);
+        _fileURL = fileURL;
+        _dateProvider = dateProvider;
+        _pendingSeries = [NSMutableDictionary dictionary];
+        _pendingKeys = [NSMutableArray array];
+
+        dispatch_async(_queue, ^{
+          [self loadPersistedBatches];
+        });
+    }
+    return self;
+}
+
+#pragma mark - Public methods
+
+- (void)exportMetrics:(NSArray<BAMetric *> *)metrics {
+    NSMutableArray<NSDictionary *> *serializedMetrics = [NSMutableArray arrayWithCapacity:[metrics count]];
+    for (BAMetric *metric in metrics) {
+        [serializedMetrics addObject:[metric toDictionary]];
+    }
+
+    dispatch_async(_queue, ^{
+      if ([serializedMetrics count] > 0) {
+          [self mergeSerializedMetrics:serializedMetrics];
+          [self persistBatches];
+      }
+      [self sendPendingBatchIfPossible];
+    });
+}
+
+- (NSArray<NSDictionary *> *)pendingMetrics {
+    __block NSArray<NSDictionary *> *pendingMetrics;
+    dispatch_sync(_queue, ^{
+      pendingMetrics = [self allBatchedMetrics];
+    });
+    return pendingMetrics;
+}
+
+- (BOOL)hasPendingMetrics {
+    __block BOOL hasPendingMetrics;
+    dispatch_sync(_queue, ^{
+      hasPendingMetrics = self->_inflightBatch != nil || [self->_pendingKeys count] > 0;
+    });
+    return hasPendingMetrics;
+}
+
+- (void)sendBatch:(NSArray<NSDictionary *> *)batch completion:(void (^)(NSError *_Nullable error))completion {
+    BAWebserviceClient *wsClient = [[BAMetricWebserviceClient alloc] initWithSerializedMetrics:batch
+        success:^() {
+          completion(nil);
+        }
+        error:^(NSError *error) {
+          completion(error);
+        }];
+    if (wsClient == nil) {
+        // Fail like a request would, so that the batch is put back and retried later
+        completion([NSError errorWithDomain:ERROR_DOMAIN
+                                       code:-1
+                                   userInfo:@{NSLocalizedDescriptionKey : @"Could not create the metrics request"}]);
+        return;
+    }
+    [BAWebserviceClientExecutor.sharedInstance addClient:wsClient];
+}
+
+#pragma mark - Batching
+
+/// Series are identified by their name, type and labels
+- (NSString *)keyForSerializedMetric:(NSDictionary *)metric {
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@|%@", metric[@"name"], metric[@"type"]];
+    NSDictionary<NSString *, NSString *> *labels = metric[@"labels"];
+    if (![labels isKindOfClass:[NSDictionary class]]) {
+        return key;
+    }
+    for (NSString *labelName in [[labels allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        [key appendFormat:@"|%@=%@", labelName, labels[labelName]];
+    }
+    return key;
+}
+
+- (void)mergeSerializedMetrics:(NSArray<NSDictionary *> *)metrics {
+    for (NSDictionary *metric in metrics) {
+        NSArray<NSNumber *> *values = metric[@"values"];
+        if (![metric[@"name"] isKindOfClass:[NSString class]] || ![metric[@"type"] isKindOfClass:[NSString class]] ||
+            ![values isKindOfClass:[NSArray class]] || [values count] == 0) {
+            continue;
+        }
+
+        NSString *key = [self keyForSerializedMetric:metric];
+        NSMutableDictionary *series = _pendingSeries[key];
+        if (series == nil) {
+            if ([_pendingKeys count] >= MAX_PENDING_SERIES) {
+                BALogDebug(LOGGER_DOMAIN, @"Too many pending metrics, dropping %@", key);
+                continue;
+            }
+            series = [metric mutableCopy];
+            series[@"values"] = [values mutableCopy];
+            _pendingSeries[key] = series;
+            [_pendingKeys addObject:key];
+            continue;
+        }
+
+        NSMutableArray<NSNumber *> *pendingValues = series[@"values"];
+        if ([metric[@"type"] isEqualToString:@"counter"]) {
+            // Counters hold their increments since the previous export
+            double total = [pendingValues.firstObject doubleValue] + [values.firstObject doubleValue];
+            [pendingValues setArray:@[ @(total) ]];
+        } else {
+            [pendingValues addObjectsFromArray:values];
+            if ([pendingValues count] > MAX_VALUES_PER_SERIES) {
+                // Keep the most recent observations
+                [pendingValues removeObjectsInRange:NSMakeRange(0, [pendingValues count] - MAX_VALUES_PER_SERIES)];
+            }
+        }
+    }
+}
+
+- (NSArray<NSDictionary *> *)serializedPendingSeries {
+    NSMutableArray<NSDictionary *> *serializedSeries = [NSMutableArray arrayWithCapacity:[_pendingKeys count]];
+    for (NSString *key in _pendingKeys) {
+        NSMutableDictionary *series = [_pendingSeries[key] mutableCopy];
+        series[@"values"] = [series[@"values"] copy];
+        [serializedSeries addObject:series];
+    }
+    return serializedSeries;
+}
+
+- (NSArray<NSDictionary *> *)allBatchedMetrics {
+    NSArray<NSDictionary *> *inflightBatch = _inflightBatch != nil ? _inflightBatch : @[];
+    return [inflightBatch arrayByAddingObjectsFromArray:[self serializedPendingSeries]];
+}
+
+#pragma mark - Sending
+
+- (BOOL)isMetricServiceAvailable {
+    return ([[_dateProvider currentDate] timeIntervalSince1970] >= _nextAvailableMetricServiceTimestamp);
+}
+
+- (void)sendPendingBatchIfPossible {
+    if (_inflightBatch != nil || [_pendingKeys count] == 0) {
+        return;
+    }
+
+    if (![self isMetricServiceAvailable]) {
+        BALogDebug(LOGGER_DOMAIN, @"Metric webservice not available. Retrying later.");
+        return;
+    }
+
+    NSArray<NSDictionary *> *batch = [self serializedPendingSeries];
+    _inflightBatch = batch;
+    [_pendingSeries removeAllObjects];
+    [_pendingKeys removeAllObjects];
+
+    [self sendBatch:batch
+         completion:^(NSError *_Nullable error) {
+           dispatch_async(self->_queue, ^{
+             [self batchSendingDidFinishWithError:error];
+           });
+         }];
+}
+
+- (void)batchSendingDidFinishWithError:(nullable NSError *)error {
+    NSArray<NSDictionary *> *batch = _inflightBatch;
+    _inflightBatch = nil;
+
+    if (error == nil) {
+        BALogDebug(LOGGER_DOMAIN, @"Metrics sent with success");
+    } else {
+        BALogDebug(LOGGER_DOMAIN, @"Fail sending metrics.");
+        // Check if server respond with RetryAfter
+        NSNumber *retryAfter = DEFAULT_RETRY_AFTER;
+        if (error.userInfo != nil) {
+            retryAfter = error.userInfo[@"retryAfter"];
+            if (retryAfter == nil) {
+                retryAfter = DEFAULT_RETRY_AFTER;
+            }
+        }
+        _nextAvailableMetricServiceTimestamp =
+            [[_dateProvider currentDate] timeIntervalSince1970] + retryAfter.doubleValue;
+
+        // Put the batch back before what was exported since, keeping the series order
+        NSArray<NSDictionary *> *exportedSince = [self serializedPendingSeries];
+        [_pendingSeries removeAllObjects];
+        [_pendingKeys removeAllObjects];
+        [self mergeSerializedMetrics:batch];
+        [self mergeSerializedMetrics:exportedSince];
+    }
+
+    [self persistBatches];
+}
+
+#pragma mark - Persistence
+
+- (void)persistBatches {
+    if (_fileURL == nil) {
+        return;
+    }
+
+    NSArray<NSDictionary *> *metrics = [self allBatchedMetrics];
+    if ([metrics count] == 0) {
+        [[NSFileManager defaultManager] removeItemAtURL:_fileURL error:nil];
+        return;
+    }
+
+    NSData *json = [BAJson serializeData:@{@"version" : @(FILE_VERSION), @"data" : metrics} error:nil];
+    if (json == nil || ![json writeToURL:_fileURL atomically:YES]) {
+        BALogDebug(LOGGER_DOMAIN, @"Failed to persist pending metrics");
+    }
+}
+
+- (void)loadPersistedBatches {
+    if (_fileURL == nil) {
+        return;
+    }
+
+    NSData *json = [NSData dataWithContentsOfURL:_fileURL];
+    if (json == nil) {
+        return;
+    }
+
+    NSDictionary *persisted = [BAJson deserializeDataAsDictionary:json error:nil];
+    NSArray *metrics = persisted[@"data"];
+    if (![persisted[@"version"] isEqual:@(FILE_VERSION)] || ![metrics isKindOfClass:[NSArray class]]) {
+        [[NSFileManager defaultManager] removeItemAtURL:_fileURL error:nil];
+        return;
+    }
+
+    NSMutableArray<NSDictionary *> *validMetrics = [NSMutableArray arrayWithCapacity:[metrics count]];
+    for (id metric in metrics) {
+        if ([metric isKindOfClass:[NSDictionary class]]) {
+            [validMetrics addObject:metric];
+        }
+    }
+    [self mergeSerializedMetrics:validMetrics];
+    BALogDebug(LOGGER_DOMAIN, @"Loaded %lu persisted metrics", (unsigned long)[_pendingKeys count]);
+}
+
+@end
@@ -0,0 +1,27 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Immutable label values of a metric child, hashed once on creation.
+///
+/// NSArray's hash is its count, so using label arrays as dictionary keys compares every child of a metric on lookup.
+/// Label sets are meant to be created once and kept by their caller, making lookups a hash and a single comparison.
+@interface BAMetricLabelSet : NSObject <NSCopying>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithValues:(NSArray<NSString *> *)values NS_DESIGNATED_INITIALIZER;
+
++ (instancetype)labelSetWithValues:(NSArray<NSString *> *)values;
+
+@property (readonly) NSArray<NSString *> *values;
+
+@end
+
+NS_ASSUME_NONNULL_END
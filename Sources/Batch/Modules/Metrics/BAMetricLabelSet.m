@@ -0,0 +1,72 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAMetricLabelSet.h>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+@implementation BAMetricLabelSet {
+    NSUInteger _hash;
+}
+
+- (instancetype)initWithValues:(NSArray<NSString *> *)values {
+    self = [super init];
+    if (self) {
+        _values = [values copy];
+        _hash = [BAMetricLabelSet hashForValues:_values];
+    }
+    return self;
+}
+
++ (instancetype)labelSetWithValues:(NSArray<NSString *> *)values {
+    return [[BAMetricLabelSet alloc] initWithValues:values];
+}
+
+/// FNV-1a of the values' UTF-16 characters, each value followed by a separator so that ["ab"] and ["a", "b"] differ
++ (NSUInteger)hashForValues:(NSArray<NSString *> *)values {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    unichar buffer[64];
+    for (NSString *value in values) {
+        NSUInteger length = [value length];
+        for (NSUInteger location = 0; location < length; location += 64) {
+            NSRange range = NSMakeRange(location, MIN((NSUInteger)64, length - location));
+            [value getCharacters:buffer range:range];
+            for (NSUInteger i = 0; i < range.length; i++) {
+                hash = (hash ^ buffer[i]) * FNV_PRIME;
+            }
+        }
+        hash = (hash ^ 0xFFFF) * FNV_PRIME;
+    }
+    return (NSUInteger)hash;
+}
+
+- (NSUInteger)hash {
+    return _hash;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (self == object) {
+        return true;
+    }
+    if (![object isKindOfClass:[BAMetricLabelSet class]]) {
+        return false;
+    }
+
+    BAMetricLabelSet *other = object;
+    return _hash == other->_hash && [_values isEqualToArray:other->_values];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    // Immutable
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<BAMetricLabelSet: %@>", [_values componentsJoinedByString:@", "]];
+}
+
+@end
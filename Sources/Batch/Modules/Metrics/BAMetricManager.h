@@ -5,19 +5,34 @@
 //
 
 #import <Batch/BAMetric.h>
+#import <Batch/BAMetricExporter.h>
 #import <Foundation/Foundation.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Keeps the registered metrics, and periodically hands their changes to the exporter.
+///
+/// Recording a value only counts the record: the metrics are drained on a fixed interval, or as soon as enough
+/// records are waiting. The interval timer only runs while values or batches are waiting to be sent.
 @interface BAMetricManager : NSObject
 
 /// Singleton shared instance
 + (instancetype)sharedInstance;
 
+- (instancetype)initWithExporter:(BAMetricExporter *)exporter NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) BAMetricExporter *exporter;
+
 /// Add a metric to the registered metric list
 - (void)addMetric:(BAMetric *)metric;
 
-/// Send metrics that have changed
+/// Called by the metrics when they record a value
+- (void)metricDidRecord;
+
+/// Number of values recorded since the last export
+@property (readonly) uint64_t pendingRecordCount;
+
+/// Export metrics that have changed, without waiting for the next interval
 - (void)sendMetrics;
 
 @end
@@ -7,33 +7,31 @@
 #import <Batch/BACounter.h>
 #import <Batch/BAMetric.h>
 #import <Batch/BAMetricManager.h>
-#import <Batch/BAMetricWebserviceClient.h>
 #import <Batch/BAObservation.h>
-#import <Batch/BASecureDateProvider.h>
-#import <Batch/BAWebserviceClientExecutor.h>
+#import <Batch/BATimerWheel.h>
+
+#import <stdatomic.h>
 
 #define LOGGER_DOMAIN @"BAMetricManager"
 
-#define DELAY_BEFORE_SENDING 1 /// sec
+/// Interval between two exports (in seconds)
+#define EXPORT_INTERVAL 15
 
-/// Default retry after in fail case (in seconds)
-#define DEFAULT_RETRY_AFTER @60
+/// Number of recorded values triggering an export before the end of the interval
+#define RECORDS_WATERMARK 50
 
 @implementation BAMetricManager {
     /// Metrics registered
     NSMutableArray<BAMetric *> *_metrics;
 
-    /// Flag indicating whether we are stacking metrics before sending them
-    BOOL _isSending;
-
     /// Dispatch queue
     dispatch_queue_t _dispatchQueue;
 
-    /// Timestamp to wait before metric service be available again.
-    NSTimeInterval _nextAvailableMetricServiceTimestamp;
+    /// Next periodic export. Scheduled when the first metric is registered or the first value since the last export
+    /// is recorded, and after each export while something is left to send.
+    BATimerWheelTimeout *_exportTimeout;
 
-    /// Date provider
-    id<BADateProviderProtocol> _dateProvider;
+    _Atomic(uint64_t) _pendingRecordCount;
 }
 
 #pragma mark - Instance setup
@@ -49,88 +47,105 @@
 }
 
 - (instancetype)init {
+    return [self initWithExporter:[BAMetricExporter new]];
+}
+
+- (instancetype)initWithExporter:(BAMetricExporter *)exporter {
     self = [super init];
     if (self) {
-        _isSending = NO;
+        _exporter = exporter;
         _metrics = [NSMutableArray array];
-        _dateProvider = [BASecureDateProvider new];
         _dispatchQueue = dispatch_queue_create("com.batch.ios.metrics", NULL);
+        atomic_init(&_pendingRecordCount, 0);
+
+        __weak BAMetricManager *weakSelf = self;
+        _exportTimeout = [[BATimerWheelTimeout alloc] initWithWheel:[BATimerWheel sharedWheel]
+                                                              queue:_dispatchQueue
+                                                               task:^{
+                                                                 [weakSelf exportMetrics];
+                                                               }];
     }
     return self;
 }
+
+- (void)dealloc {
+    [_exportTimeout cancel];
+}
+
 #pragma mark - Public methods
 
 - (void)addMetric:(BAMetric *)metric {
-    [_metrics addObject:metric];
+    @synchronized(_metrics) {
+        [_metrics addObject:metric];
+        // Sends what the exporter loaded from the disk
+        if ([_metrics count] == 1) {
+            [self scheduleExportIfNeeded];
+        }
+    }
 }
 
-- (void)sendMetrics {
-    // We are stacking metrics before sending
-    if (_isSending) {
-        return;
+- (void)metricDidRecord {
+    uint64_t pendingRecordCount = atomic_fetch_add_explicit(&_pendingRecordCount, 1, memory_order_relaxed) + 1;
+    // The export timer stops once everything is sent: the first record since then restarts it
+    if (pendingRecordCount == 1) {
+        [self scheduleExportIfNeeded];
     }
-
-    if (![self isMetricServiceAvailable]) {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Metric webservice not available. Retrying later."];
-        return;
+    // Only the record reaching the watermark triggers an export
+    if (pendingRecordCount == RECORDS_WATERMARK) {
+        [self sendMetrics];
     }
+}
 
-    self->_isSending = YES;
-
-    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(DELAY_BEFORE_SENDING * NSEC_PER_SEC)), _dispatchQueue, ^{
-      NSArray *metrics = [self getMetricsToSend];
-
-      if ([metrics count] <= 0) {
-          return;
-      }
-
-      BAWebserviceClient *wsClient = [[BAMetricWebserviceClient alloc] initWithMetrics:metrics
-          success:^() {
-            self->_isSending = NO;
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"Metrics sent with success"];
-          }
-          error:^(NSError *error) {
-            [BALogger debugForDomain:LOGGER_DOMAIN message:@"Fail sending metrics."];
-            // Check if server respond with RetryAfter
-            NSNumber *retryAfter = DEFAULT_RETRY_AFTER;
-            if (error.userInfo != nil) {
-                retryAfter = error.userInfo[@"retryAfter"];
-                if (retryAfter == nil) {
-                    retryAfter = DEFAULT_RETRY_AFTER;
-                }
-            }
-            self->_nextAvailableMetricServiceTimestamp =
-                [[self->_dateProvider currentDate] timeIntervalSince1970] + retryAfter.doubleValue;
-            self->_isSending = NO;
-          }];
-      [BAWebserviceClientExecutor.sharedInstance addClient:wsClient];
+- (uint64_t)pendingRecordCount {
+    return atomic_load_explicit(&_pendingRecordCount, memory_order_relaxed);
+}
+
+- (void)sendMetrics {
+    dispatch_async(_dispatchQueue, ^{
+      [self exportMetrics];
     });
 }
 
 #pragma mark - Private methods
+
+- (void)scheduleExportIfNeeded {
+    // Don't postpone a pending export
+    if (![_exportTimeout isScheduled]) {
+        [_exportTimeout scheduleAfter:EXPORT_INTERVAL];
+    }
+}
+
+- (void)exportMetrics {
+    atomic_store_explicit(&_pendingRecordCount, 0, memory_order_relaxed);
+    // The exporter also retries the batches it couldn't send, so it gets called even without changes
+    [_exporter exportMetrics:[self getMetricsToSend]];
+
+    // Keep exporting while values were recorded since, or batches are left to send or confirm.
+    // Exporting early, when reaching the watermark, postpones the next periodic export.
+    // Otherwise the timer stops, and the next record restarts it: a timeout left scheduled is never cancelled, so
+    // that a record made meanwhile isn't left without an export.
+    if (atomic_load_explicit(&_pendingRecordCount, memory_order_relaxed) > 0 || [_exporter hasPendingMetrics]) {
+        [_exportTimeout scheduleAfter:EXPORT_INTERVAL];
+    }
+}
+
 - (NSArray *)getMetricsToSend {
+    NSArray<BAMetric *> *metrics;
+    @synchronized(_metrics) {
+        metrics = [_metrics copy];
+    }
+
     NSMutableArray *metricsToSend = [NSMutableArray array];
-    for (BAMetric *metric in _metrics) {
-        if ([metric hasChildren]) {
-            [metric.children enumerateKeysAndObjectsUsingBlock:^(id labels, id child, BOOL *stop) {
-              BAMetric *childMetric = (BAMetric *)child;
-              if ([childMetric hasChanged]) {
-                  [metricsToSend addObject:[childMetric copy]];
-                  [childMetric reset];
-              }
-            }];
-        } else {
-            if ([metric hasChanged]) {
-                [metricsToSend addObject:[metric copy]];
-                [metric reset];
+    for (BAMetric *metric in metrics) {
+        NSArray<BAMetric *> *seriesMetrics = [metric hasChildren] ? [metric childrenSnapshot] : @[ metric ];
+        for (BAMetric *seriesMetric in seriesMetrics) {
+            BAMetric *changes = [seriesMetric drainChanges];
+            if (changes != nil) {
+                [metricsToSend addObject:changes];
             }
         }
     }
     return [metricsToSend copy];
 }
 
-- (BOOL)isMetricServiceAvailable {
-    return ([[_dateProvider currentDate] timeIntervalSince1970] >= _nextAvailableMetricServiceTimestamp);
-}
-
 @end
@@ -13,4 +13,9 @@
                                  success:(void (^_Nullable)(void))successHandler
                                    error:(void (^_Nullable)(NSError *_Nonnull error))errorHandler;
 
+/// Send metrics already serialized by -[BAMetric toDictionary]
+- (nullable instancetype)initWithSerializedMetrics:(nonnull NSArray<NSDictionary *> *)metrics
+                                           success:(void (^_Nullable)(void))successHandler
+                                             error:(void (^_Nullable)(NSError *_Nonnull error))errorHandler;
+
 @end
@@ -14,15 +14,24 @@
 #define LOGGER_DOMAIN @"BAMetricsWebserviceClient"
 
 @implementation BAMetricWebserviceClient {
-    NSArray *_metrics;
+    NSArray<NSDictionary *> *_metrics;
     void (^_successHandler)(void);
     void (^_errorHandler)(NSError *_Nonnull error);
 }
 
 - (nullable instancetype)initWithMetrics:(NSArray *)metrics
                                  success:(void (^)(void))successHandler
-                                   error:(void (^)(NSError *error))errorHandler;
-{
+                                   error:(void (^)(NSError *error))errorHandler {
+    NSMutableArray<NSDictionary *> *serializedMetrics = [NSMutableArray arrayWithCapacity:[metrics count]];
+    for (BAMetric *metric in metrics) {
+        [serializedMetrics addObject:[metric toDictionary]];
+    }
+    return [self initWithSerializedMetrics:serializedMetrics success:successHandler error:errorHandler];
+}
+
+- (nullable instancetype)initWithSerializedMetrics:(NSArray<NSDictionary *> *)metrics
+                                           success:(void (^)(void))successHandler
+                                             error:(void (^)(NSError *error))errorHandler {
     NSString *host = [[BAInjection injectProtocol:@protocol(BADomainManagerProtocol)] urlFor:BADomainServiceMetric
                                                                         overrideWithOriginal:FALSE];
     NSURL *url = [NSURL URLWithString:host relativeToURL:nil];
@@ -40,15 +49,10 @@
         return nil;
     }
 
-    // Build the metrics array by converting each metric to its dictionary representation
+    // Metrics are already converted to their dictionary representation
     // Note: We return the array itself, not wrapped in an object, to match the interface.metrics schema
     // Expected format: [{name: "...", type: "...", values: [...], labels: {...}}, ...]
-    NSMutableArray *metricsArray = [NSMutableArray arrayWithCapacity:[_metrics count]];
-    for (BAMetric *metric in _metrics) {
-        [metricsArray addObject:[metric toDictionary]];
-    }
-
-    return metricsArray;
+    return _metrics;
 }
 
 - (void)connectionDidFinishLoadingWithData:(NSData *)data {
@@ -6,6 +6,12 @@
 
 #import <Batch/BAMetric.h>
 #import <Foundation/Foundation.h>
+
+/// Durations, in seconds, recorded in a fixed-size BASampleBuffer.
+/// Recording never waits on other threads and never allocates. Only the most recent durations are kept between two
+/// exports.
+///
+/// Values are the durations themselves, as the metrics webservice expects them.
 @interface BAObservation : BAMetric
 
 /// Increment the observation value
@@ -14,6 +20,9 @@
 /// Observe the duration since startTimer has been called
 - (void)observeDuration;
 
+/// Observe a duration, in seconds
+- (void)observe:(NSTimeInterval)duration;
+
 /// Reset the observation value
 - (void)reset;
 
@@ -6,6 +6,12 @@
 
 #import "BAObservation.h"
 
+#import <Batch/BASampleBuffer.h>
+#import <Batch/BAUptimeProvider.h>
+
+/// Durations kept between two exports, matching the exporter's bound per series
+#define MAX_SAMPLES 100
+
 @interface BAObservation (Protected)
 
 /// Protected method from BAMetric
@@ -14,8 +20,20 @@
 @end
 
 @implementation BAObservation {
-    /// Start time
-    NSNumber *_startTime;
+    /// Start time, on the monotonic clock (in nanoseconds)
+    uint64_t _startTime;
+
+    /// Recorded durations, in seconds
+    BASampleBuffer *_samples;
+}
+
+- (instancetype)initWithName:(nonnull NSString *)name
+           andLabelNamesList:(nullable NSArray<NSString *> *)labelNames {
+    self = [super initWithName:name andLabelNamesList:labelNames];
+    if (self) {
+        _samples = [[BASampleBuffer alloc] initWithCapacity:MAX_SAMPLES];
+    }
+    return self;
 }
 
 #pragma mark - BAMetricProtocol methods
@@ -27,33 +45,63 @@
 }
 
 - (void)reset {
-    [[super values] removeAllObjects];
-    [[super children] removeAllObjects];
+    [_samples drain];
+    [self removeAllChildren];
 }
 
 - (NSString *)type {
     return @"observation";
 }
 
+#pragma mark - BAMetric methods
+
+/// The durations are only boxed when they are read: recording doesn't allocate
+- (NSMutableArray<NSNumber *> *)values {
+    return [[_samples snapshot] mutableCopy];
+}
+
+- (nullable BAMetric *)drainChanges {
+    // Durations racing with the drain are either in the returned copy or left in the buffer, never lost
+    NSArray<NSNumber *> *samples = [_samples drain];
+    if ([samples count] == 0) {
+        return nil;
+    }
+    BAObservation *changes = [self copy];
+    changes->_samples = [self sampleBufferWithValues:samples];
+    return changes;
+}
+
 #pragma mark - BAObservation methods
 
 - (void)startTimer {
-    _startTime = @(floor([[NSDate date] timeIntervalSince1970] * 1000));
+    _startTime = [BAUptimeProvider uptimeNanoseconds];
 }
 
 - (void)observeDuration {
-    NSNumber *now = @(floor([[NSDate date] timeIntervalSince1970] * 1000));
-    float delta = [now doubleValue] - [_startTime doubleValue];
-    [[super values] addObject:[NSNumber numberWithFloat:(float)delta / 1000]];
+    // Wall clock changes would make durations negative or huge: measure them on the monotonic clock
+    [self observe:[BAUptimeProvider secondsSinceUptimeNanoseconds:_startTime]];
+}
+
+- (void)observe:(NSTimeInterval)duration {
+    [_samples record:duration];
     [self update];
 }
 
+- (BASampleBuffer *)sampleBufferWithValues:(NSArray<NSNumber *> *)values {
+    BASampleBuffer *samples = [[BASampleBuffer alloc] initWithCapacity:MAX_SAMPLES];
+    for (NSNumber *value in values) {
+        [samples record:[value doubleValue]];
+    }
+    return samples;
+}
+
 #pragma mark - NSCopying methods
 
 - (nonnull id)copyWithZone:(nullable NSZone *)zone {
     BAObservation *copy = [super copyWithZone:zone];
     if (copy) {
         copy->_startTime = _startTime;
+        copy->_samples = [self sampleBufferWithValues:[_samples snapshot]];
     }
     return copy;
 }
@@ -0,0 +1,35 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Fixed-size buffer of the most recent values, that can record values from any thread.
+///
+/// Recording a value claims a slot with an atomic add and stores the value atomically: it never waits on other threads
+/// and never allocates. Once the buffer is full, new values replace the oldest ones.
+@interface BASampleBuffer : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+@property (readonly) NSUInteger capacity;
+
+/// Record a value. NaN values are ignored.
+- (void)record:(double)value;
+
+/// Read the recorded values, oldest first, without resetting them
+- (NSArray<NSNumber *> *)snapshot;
+
+/// Read the recorded values, oldest first, and reset them.
+/// Values recorded while draining are either in the returned array or left in the buffer, never lost.
+- (NSArray<NSNumber *> *)drain;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,76 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BASampleBuffer.h>
+
+#import <stdatomic.h>
+
+// Slots hold the bits of their value. This one is a NaN, which is never recorded.
+#define EMPTY_SLOT UINT64_MAX
+
+@implementation BASampleBuffer {
+    _Atomic(uint64_t) *_slots;
+
+    /// Number of values recorded so far: the next value goes in the slot at this index modulo the capacity
+    _Atomic(uint64_t) _next;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        _capacity = MAX(capacity, (NSUInteger)1);
+        _slots = malloc(sizeof(_Atomic(uint64_t)) * _capacity);
+        for (NSUInteger i = 0; i < _capacity; i++) {
+            atomic_init(&_slots[i], EMPTY_SLOT);
+        }
+        atomic_init(&_next, 0);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_slots);
+}
+
+- (void)record:(double)value {
+    if (isnan(value)) {
+        return;
+    }
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint64_t index = atomic_fetch_add_explicit(&_next, 1, memory_order_relaxed) % _capacity;
+    atomic_store_explicit(&_slots[index], bits, memory_order_relaxed);
+}
+
+- (NSArray<NSNumber *> *)snapshot {
+    return [self readSlotsResetting:false];
+}
+
+- (NSArray<NSNumber *> *)drain {
+    return [self readSlotsResetting:true];
+}
+
+- (NSArray<NSNumber *> *)readSlotsResetting:(BOOL)reset {
+    // The next slot to be written holds the oldest value, if the buffer has been filled
+    uint64_t start = atomic_load_explicit(&_next, memory_order_relaxed) % _capacity;
+
+    NSMutableArray<NSNumber *> *values = [NSMutableArray array];
+    for (NSUInteger i = 0; i < _capacity; i++) {
+        _Atomic(uint64_t) *slot = &_slots[(start + i) % _capacity];
+        uint64_t bits = reset ? atomic_exchange_explicit(slot, EMPTY_SLOT, memory_order_relaxed)
+                              : atomic_load_explicit(slot, memory_order_relaxed);
+        if (bits == EMPTY_SLOT) {
+            continue;
+        }
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        [values addObject:@(value)];
+    }
+    return values;
+}
+
+@end
@@ -98,21 +98,21 @@ NSString *const kBATOptOutWipeDataKey = @"wipe_data";
             [BALogger debugForDomain:@"OptOut"
                              message:@"Waiting for server and developer response before optin-out and/or wiping data"];
 
-            [waitPromise then:^(NSObject *_Nullable value) {
-              [BAThreading performBlockOnMainThreadAsync:^{
-                completionHandler(true);
-                [self applyOptOut:shouldOptOut wipeData:wipeData];
-              }];
-            }];
-
-            [waitPromise catch:^(NSError *_Nullable error) {
-              [BAThreading performBlockOnMainThreadAsync:^{
-                BatchOptOutNetworkErrorPolicy errorPolicy = completionHandler(false);
-                if (errorPolicy == BatchOptOutNetworkErrorPolicyIgnore) {
-                    [self applyOptOut:shouldOptOut wipeData:wipeData];
+            [waitPromise
+                then:^(NSObject *_Nullable value) {
+                  completionHandler(true);
+                  [self applyOptOut:shouldOptOut wipeData:wipeData];
                 }
-              }];
-            }];
+               queue:dispatch_get_main_queue()];
+
+            [waitPromise
+                catch:^(NSError *_Nullable error) {
+                  BatchOptOutNetworkErrorPolicy errorPolicy = completionHandler(false);
+                  if (errorPolicy == BatchOptOutNetworkErrorPolicyIgnore) {
+                      [self applyOptOut:shouldOptOut wipeData:wipeData];
+                  }
+                }
+                queue:dispatch_get_main_queue()];
         } else {
             [self applyOptOut:shouldOptOut wipeData:wipeData];
         }
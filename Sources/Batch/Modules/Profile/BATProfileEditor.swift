@@ -240,8 +240,12 @@ public class BATProfileEditor: NSObject, BATSerializableProfileEditorProtocol, N
             try validateStringArray(updatedArray)
             customAttributes[targetAttributeKey] = BATProfileAttributeSetOperation<[String]>(type: .array, value: updatedArray)
         } else if let existingOperation = existingOperation as? BATProfileAttributePartialArrayUpdateOperation {
+            // Adding a value supersedes any pending removal of it, and adding it twice is useless
             var updatedPartialUpdate = existingOperation
-            updatedPartialUpdate.itemsToAdd.append(value)
+            updatedPartialUpdate.itemsToRemove.removeAll { $0 == value }
+            if !updatedPartialUpdate.itemsToAdd.contains(value) {
+                updatedPartialUpdate.itemsToAdd.append(value)
+            }
             try validateParialUpdate(updatedPartialUpdate)
             customAttributes[targetAttributeKey] = updatedPartialUpdate
         } else {
@@ -276,8 +280,12 @@ public class BATProfileEditor: NSObject, BATSerializableProfileEditorProtocol, N
                 customAttributes[targetAttributeKey] = BATProfileAttributeSetOperation<[String]>(type: .array, value: updatedArray)
             }
         } else if let existingOperation = existingOperation as? BATProfileAttributePartialArrayUpdateOperation {
+            // Removing a value supersedes any pending addition of it, and removing it twice is useless
             var updatedPartialUpdate = existingOperation
-            updatedPartialUpdate.itemsToRemove.append(value)
+            updatedPartialUpdate.itemsToAdd.removeAll { $0 == value }
+            if !updatedPartialUpdate.itemsToRemove.contains(value) {
+                updatedPartialUpdate.itemsToRemove.append(value)
+            }
             try validateParialUpdate(updatedPartialUpdate)
             customAttributes[targetAttributeKey] = updatedPartialUpdate
         } else {
@@ -16,10 +16,11 @@
 #import <Batch/BAOptOut.h>
 #import <Batch/BAParameter.h>
 #import <Batch/BAQueryWebserviceClient.h>
-#import <Batch/BARandom.h>
 #import <Batch/BATJsonDictionary.h>
+#import <Batch/BATaskDebouncer.h>
 #import <Batch/BATrackerCenter.h>
 #import <Batch/BATrackerSignpostHelper.h>
+#import <Batch/BAUptimeProvider.h>
 #import <Batch/Batch-Swift.h>
 #import <Batch/BatchEventAttributesPrivate.h>
 
@@ -34,7 +35,10 @@
     BATrackerScheduler *_scheduler;
     dispatch_queue_t _dispatchQueue;
     BAConcurrentQueue *_memoryQueue;
-    NSDate *_lastTrackedLocationTimestamp;
+    /// Flushes the memory queue 1 second after the last tracked event, to allow more events to be enqueued
+    BATaskDebouncer *_flushDebouncer;
+    /// Uptime of the last tracked location, 0 if none has been tracked
+    uint64_t _lastTrackedLocationUptime;
     BAOptOut *_optOutModule;
     id<BATrackerSignpostHelperProtocol> _signpostHelper;
 
@@ -42,8 +46,6 @@
     BOOL _started;
 }
 
-@property (atomic) NSString *flushHash;
-
 - (BOOL)internalTrackEvent:(NSString *)name withParameters:(NSDictionary *)parameters collapsable:(BOOL)collapsable;
 
 - (BOOL)internalTrackEvent:(BAEvent *)event;
@@ -84,8 +86,7 @@
                                                        allowNil:YES
                                                           error:&err];
         if (err) {
-            [BALogger debugForDomain:DEBUG_DOMAIN
-                             message:@"Failed to deserialize attributes: %@", err.debugDescription];
+            BALogDebug(DEBUG_DOMAIN, @"Failed to deserialize attributes: %@", err.debugDescription);
         }
 
         [[BALocalCampaignsCenter instance] processTrackerPublicEventNamed:name
@@ -99,16 +100,16 @@
         return;
     }
 
-    NSDate *currentDate = [NSDate date];
+    // The throttle uses the monotonic clock, so that changing the date doesn't disable it
+    uint64_t currentUptime = [BAUptimeProvider uptimeNanoseconds];
 
     // See if a location update should be sent.
     BOOL shouldTrackLocation = NO;
 
-    if (_lastTrackedLocationTimestamp == nil) {
-        [BALogger debugForDomain:DEBUG_DOMAIN
-                         message:@"Tracking location because no previous location has been tracked"];
+    if (_lastTrackedLocationUptime == 0) {
+        BALogDebug(DEBUG_DOMAIN, @"Tracking location because no previous location has been tracked");
         shouldTrackLocation = YES;
-    } else if ([currentDate timeIntervalSinceDate:_lastTrackedLocationTimestamp] * 1000 >=
+    } else if ([BAUptimeProvider secondsSinceUptimeNanoseconds:_lastTrackedLocationUptime] * 1000 >=
                LOCATION_UPDATE_MINIMUM_TIME_MS) {
         [BALogger
             debugForDomain:DEBUG_DOMAIN
@@ -119,7 +120,7 @@
 
     // Yes this could have been a big "if", but it would have been less readable
     if (!shouldTrackLocation) {
-        [BALogger debugForDomain:DEBUG_DOMAIN message:@"Ignoring location track"];
+        BALogDebug(DEBUG_DOMAIN, @"Ignoring location track");
         return;
     }
 
@@ -146,7 +147,7 @@
 
     [self trackPrivateEvent:@"_LOCATION_CHANGED" parameters:params collapsable:YES];
 
-    _lastTrackedLocationTimestamp = currentDate;
+    _lastTrackedLocationUptime = currentUptime;
 }
 
 - (void)trackPrivateEvent:(nonnull NSString *)name
@@ -229,6 +230,12 @@
     _scheduler = [[BATrackerScheduler alloc] init];
     _dispatchQueue = dispatch_queue_create("com.batch.ios.tr", NULL);
     _memoryQueue = [[BAConcurrentQueue alloc] init];
+    __weak BATrackerCenter *weakSelf = self;
+    _flushDebouncer = [BATaskDebouncer debouncerWithDelay:1
+                                                    queue:_dispatchQueue
+                                                     task:^{
+                                                       [weakSelf flushMemoryQueue];
+                                                     }];
     _flushing = NO;
     _started = NO;
     _optOutModule = [BAOptOut instance];
@@ -271,7 +278,7 @@
 
 - (void)optOutValueDidChange:(NSNotification *)notification {
     if ([@(true) isEqualToNumber:[notification.userInfo objectForKey:kBATOptOutWipeDataKey]]) {
-        [BALogger debugForDomain:@"BATrackerCenter" message:@"Wiping user data"];
+        BALogDebug(@"BATrackerCenter", @"Wiping user data");
         [self deleteAllEvents];
     }
 }
@@ -316,8 +323,8 @@
         [BALogger errorForDomain:@"Batch.User" message:@"Batch is opted out from: refusing to track event"];
     }
 
-    [BALogger debugForDomain:NSStringFromClass([self class])
-                     message:@"Tracking event: %@ with parameters: %@", name, [parameters description]];
+    BALogDebug(NSStringFromClass([self class]), @"Tracking event: %@ with parameters: %@", name,
+               [parameters description]);
 
     [_memoryQueue push:event];
 
@@ -328,31 +335,24 @@
 
 - (void)flush {
     if (_started && _dispatchQueue && _memoryQueue && _datasource) {
-        // Create a hash. If hash hasn't changed when executing block, proceed.
-        NSString *hash = [BARandom randomAlphanumericStringWithLength:10];
-        self.flushHash = hash;
-
-        // Dispatch after 1 second to allow more events to be enqueued.
-        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1 * NSEC_PER_SEC)), _dispatchQueue, ^{
-          if (![self.flushHash isEqualToString:hash]) {
-              // Instance's flush hash has changed since block was enqueued. Don't need to continue.
-              return;
-          }
-
-          self->_flushing = YES;
-          while (![self->_memoryQueue empty]) {
-              BAEvent *event = (BAEvent *)[self->_memoryQueue poll];
-              if (event == nil || ![self->_datasource addEvent:event]) {
-                  [BALogger debugForDomain:DEBUG_DOMAIN message:@"Failed to add event: %@", event];
-              }
-          }
-
-          [self->_scheduler newEventsAvailable];
-          self->_flushing = NO;
-        });
+        [_flushDebouncer schedule];
     }
 }
 
+// Runs on the dispatch queue
+- (void)flushMemoryQueue {
+    _flushing = YES;
+    while (![_memoryQueue empty]) {
+        BAEvent *event = (BAEvent *)[_memoryQueue poll];
+        if (event == nil || ![_datasource addEvent:event]) {
+            BALogDebug(DEBUG_DOMAIN, @"Failed to add event: %@", event);
+        }
+    }
+
+    [_scheduler newEventsAvailable];
+    _flushing = NO;
+}
+
 - (BAConcurrentQueue *)queue {
     return _memoryQueue;
 }
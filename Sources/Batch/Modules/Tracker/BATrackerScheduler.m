@@ -11,16 +11,13 @@
 #import <Batch/BAErrorHelper.h>
 #import <Batch/BAParameter.h>
 #import <Batch/BAReachabilityHelper.h>
-#import <Batch/BAThreading.h>
+#import <Batch/BATaskBackoff.h>
 #import <Batch/BATrackerSender.h>
 
 @interface BATrackerScheduler () {
     BATrackerSender *_sender;
     BOOL _hasNewEvents;
-    NSTimer *_retryTimer;
-    NSUInteger _initialRetryDelay;
-    NSUInteger _maxRetryDelay;
-    NSUInteger _currentRetryDelay;
+    BATaskBackoff *_retryBackoff;
 }
 
 @end
@@ -36,11 +33,17 @@
     _sender = [BATrackerSender new];
     _hasNewEvents = false;
 
-    _initialRetryDelay = [[BAParameter objectForKey:kParametersTrackerInitialDelayKey
-                                           fallback:kParametersTrackerInitialDelayValue] unsignedIntegerValue];
-    _maxRetryDelay = [[BAParameter objectForKey:kParametersTrackerMaxDelayKey
-                                       fallback:kParametersTrackerMaxDelayValue] unsignedIntegerValue];
-    _currentRetryDelay = _initialRetryDelay;
+    NSNumber *initialRetryDelay = [BAParameter objectForKey:kParametersTrackerInitialDelayKey
+                                                   fallback:kParametersTrackerInitialDelayValue];
+    NSNumber *maxRetryDelay = [BAParameter objectForKey:kParametersTrackerMaxDelayKey
+                                               fallback:kParametersTrackerMaxDelayValue];
+    __weak BATrackerScheduler *weakSelf = self;
+    _retryBackoff = [BATaskBackoff backoffWithInitialDelay:[initialRetryDelay unsignedIntegerValue]
+                                                  maxDelay:[maxRetryDelay unsignedIntegerValue]
+                                                     queue:dispatch_get_main_queue()
+                                                      task:^{
+                                                        [weakSelf send];
+                                                      }];
 
     //    [BAReachabilityHelper reachabilityForInternetConnection];
     [BAReachabilityHelper addObserver:self selector:@selector(reachabilityChanged)];
@@ -49,20 +52,20 @@
 }
 
 - (void)dealloc {
-    [self stopTimer];
+    [_retryBackoff cancel];
 
     [BAReachabilityHelper removeObserver:self];
 }
 
 - (void)newEventsAvailable {
     // Don't try to send if we are waiting for a retry
-    if (!_retryTimer) {
+    if (![_retryBackoff isScheduled]) {
         [self send];
     }
 }
 
 - (void)reachabilityChanged {
-    if ([BAReachabilityHelper isInternetReachable] && _retryTimer) {
+    if ([BAReachabilityHelper isInternetReachable] && [_retryBackoff isScheduled]) {
         // Force a retry
         [self send];
     }
@@ -71,61 +74,27 @@
 - (void)trackingWebserviceDidSucceedForEvents:(NSArray *)array {
     [_sender trackingWebserviceDidFinish:YES forEvents:array];
 
-    _currentRetryDelay = _initialRetryDelay;
+    [_retryBackoff reset];
     [self newEventsAvailable];
 }
 
 - (void)trackingWebserviceDidFail:(NSError *)error forEvents:(NSArray *)array {
     [_sender trackingWebserviceDidFinish:NO forEvents:array];
 
-    [self incrementDelay];
-    [self scheduleTimer];
+    // Retries are delayed exponentially
+    [_retryBackoff scheduleRetry];
 }
 
 #pragma mark -
 #pragma mark Private methods
 
-- (void)incrementDelay {
-    // Increment the delay exponentially
-    // Don't increment exponentially if this is the first retry, but increment it to know we waited once
-    if (_currentRetryDelay == _initialRetryDelay) {
-        _currentRetryDelay++;
-        return;
-    }
-
-    _currentRetryDelay = MIN(_maxRetryDelay, _currentRetryDelay * 2);
-}
-
-- (void)scheduleTimer {
-    [BAThreading performBlockOnMainThread:^{
-      if (self->_retryTimer) {
-          [self->_retryTimer invalidate];
-      }
-
-      self->_retryTimer = [NSTimer scheduledTimerWithTimeInterval:self->_currentRetryDelay
-                                                           target:self
-                                                         selector:@selector(send)
-                                                         userInfo:nil
-                                                          repeats:NO];
-    }];
-}
-
-- (void)stopTimer {
-    [BAThreading performBlockOnMainThread:^{
-      if (self->_retryTimer) {
-          [self->_retryTimer invalidate];
-          self->_retryTimer = nil;
-      }
-    }];
-}
-
 - (void)send {
-    [self stopTimer];
+    [_retryBackoff cancel];
 
     if (![_sender send]) {
-        // There was nothing to send, reset the retry timer since trackingWebserviceDidFinish:forEvents: will never be
+        // There was nothing to send, reset the retry delay since trackingWebserviceDidFinish:forEvents: will never be
         // called
-        _currentRetryDelay = _initialRetryDelay;
+        [_retryBackoff reset];
     }
 }
 
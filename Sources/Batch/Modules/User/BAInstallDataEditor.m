@@ -14,6 +14,7 @@
 #import <Batch/BATrackerCenter.h>
 #import <Batch/BAUserDataDiff.h>
 #import <Batch/BAUserDataManager.h>
+#import <Batch/BAUserDataOperation.h>
 #import <Batch/BAUserDatasourceProtocol.h>
 #import <Batch/BAUserProfile.h>
 #import <Batch/BAUserSQLiteDatasource.h>
@@ -64,7 +65,7 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 @end
 
 @implementation BAInstallDataEditor {
-    NSMutableArray<BOOL (^)(void)> *_operationQueue;
+    NSMutableArray<BAUserDataOperation *> *_operationQueue;
     id<BAUserDatasourceProtocol> _datasource;
 
     NSRegularExpression *_attributeNameValidationRegexp;
@@ -146,10 +147,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
     INIT_AND_BLANK_ERROR_IF_NEEDED(error)
     VALIDATE_ATTRIBUTE_KEY_OR_BAIL()
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setBoolAttribute:attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setBoolAttribute:attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -159,10 +162,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
     VALIDATE_ATTRIBUTE_KEY_OR_BAIL()
     ENSURE_ATTRIBUTE_VALUE_CLASS(attribute, [NSDate class])
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setDateAttribute:attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setDateAttribute:attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -182,10 +187,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
         return false;
     }
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setStringAttribute:(NSString *)attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setStringAttribute:(NSString *)attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -214,10 +221,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
         return false;
     }
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setURLAttribute:(NSURL *)attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setURLAttribute:(NSURL *)attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -291,7 +300,7 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
     }
 
     if (operationBlock) {
-        [self addToQueueSynchronized:operationBlock];
+        [self addAttributeOperationForKey:key block:operationBlock];
         return true;
     }
 
@@ -309,10 +318,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
     INIT_AND_BLANK_ERROR_IF_NEEDED(error)
     VALIDATE_ATTRIBUTE_KEY_OR_BAIL()
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setLongLongAttribute:attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setLongLongAttribute:attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -325,10 +336,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
     INIT_AND_BLANK_ERROR_IF_NEEDED(error)
     VALIDATE_ATTRIBUTE_KEY_OR_BAIL()
 
-    [self addToQueueSynchronized:^BOOL() {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource setDoubleAttribute:attribute forKey:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL() {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource setDoubleAttribute:attribute forKey:key];
+                                }];
 
     return true;
 }
@@ -343,14 +356,16 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 
     [BALogger debugForDomain:DEBUG_DOMAIN message:@"Removing attribute for key '%@'", key];
 
-    [self addToQueueSynchronized:^BOOL {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource removeAttributeNamed:key];
-    }];
+    [self addAttributeOperationForKey:key
+                                block:^BOOL {
+                                  id<BAUserDatasourceProtocol> datasource =
+                                      [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                  return [datasource removeAttributeNamed:key];
+                                }];
 }
 
 - (void)clearAttributes {
-    [self addToQueueSynchronized:^BOOL {
+    [self addClearAttributesOperation:^BOOL {
       id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
       return [datasource clearAttributes];
     }];
@@ -379,10 +394,13 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 
     tag = [self normalizeTag:tag];
 
-    [self addToQueueSynchronized:^BOOL {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource addTag:tag toCollection:collection];
-    }];
+    [self addTagOperationForTag:tag
+                   inCollection:collection
+                          block:^BOOL {
+                            id<BAUserDatasourceProtocol> datasource =
+                                [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                            return [datasource addTag:tag toCollection:collection];
+                          }];
 }
 
 - (void)removeTag:(nonnull NSString *)tag fromCollection:(nonnull NSString *)collection {
@@ -408,14 +426,17 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 
     tag = [self normalizeTag:tag];
 
-    [self addToQueueSynchronized:^BOOL {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource removeTag:tag fromCollection:collection];
-    }];
+    [self addTagOperationForTag:tag
+                   inCollection:collection
+                          block:^BOOL {
+                            id<BAUserDatasourceProtocol> datasource =
+                                [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                            return [datasource removeTag:tag fromCollection:collection];
+                          }];
 }
 
 - (void)clearTags {
-    [self addToQueueSynchronized:^BOOL {
+    [self addClearTagsOperation:^BOOL {
       id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
       return [datasource clearTags];
     }];
@@ -431,10 +452,12 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
         return;
     }
 
-    [self addToQueueSynchronized:^BOOL {
-      id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-      return [datasource clearTagsFromCollection:collection];
-    }];
+    [self addClearOperationForTagCollection:collection
+                                      block:^BOOL {
+                                        id<BAUserDatasourceProtocol> datasource =
+                                            [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+                                        return [datasource clearTagsFromCollection:collection];
+                                      }];
 }
 
 /**
@@ -471,21 +494,42 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 }
 
 - (NSArray<BOOL (^)(void)> *)operationQueue {
-    return [_operationQueue copy];
+    @synchronized(_operationQueue) {
+        return [self compiledOperationQueue];
+    }
 }
 
 #pragma mark Private methods
 
-- (void)addToQueueSynchronized:(BOOL (^)(void))operationBlock {
+- (void)addToQueueSynchronized:(BAUserDataOperation *)operation {
     @synchronized(_operationQueue) {
-        [_operationQueue addObject:operationBlock];
+        [_operationQueue addObject:operation];
     }
 }
 
-- (void)addfirstToQueueSynchronized:(BOOL (^)(void))operationBlock {
-    @synchronized(_operationQueue) {
-        [_operationQueue insertObject:operationBlock atIndex:0];
-    }
+- (void)addAttributeOperationForKey:(NSString *)key block:(BOOL (^)(void))operationBlock {
+    [self addToQueueSynchronized:[BAUserDataOperation attributeOperationForKey:key block:operationBlock]];
+}
+
+- (void)addClearAttributesOperation:(BOOL (^)(void))operationBlock {
+    [self addToQueueSynchronized:[BAUserDataOperation clearAttributesOperationWithBlock:operationBlock]];
+}
+
+- (void)addTagOperationForTag:(NSString *)tag
+                 inCollection:(NSString *)collection
+                        block:(BOOL (^)(void))operationBlock {
+    [self addToQueueSynchronized:[BAUserDataOperation tagOperationForTag:tag
+                                                            inCollection:collection
+                                                                   block:operationBlock]];
+}
+
+- (void)addClearOperationForTagCollection:(NSString *)collection block:(BOOL (^)(void))operationBlock {
+    [self addToQueueSynchronized:[BAUserDataOperation clearTagCollectionOperationForCollection:collection
+                                                                                          block:operationBlock]];
+}
+
+- (void)addClearTagsOperation:(BOOL (^)(void))operationBlock {
+    [self addToQueueSynchronized:[BAUserDataOperation clearTagsOperationWithBlock:operationBlock]];
 }
 
 - (void)executeUserUpdateOperation {
@@ -525,11 +569,29 @@ NSErrorDomain const BAInstallDataEditorErrorDomain = @"com.batch.ios.installdata
 }
 
 - (NSArray<BOOL (^)(void)> *)popOperationQueue {
-    NSMutableArray<BOOL (^)(void)> *applyQueue = [_operationQueue mutableCopy];
+    NSArray<BOOL (^)(void)> *applyQueue = [self compiledOperationQueue];
     [_operationQueue removeAllObjects];
     return applyQueue;
 }
 
+/// Collapse the queued operations to their net effect, so that overwritten or cancelled changes
+/// never reach the datasource.
+/// Not thread-safe: callers must synchronize on the operation queue.
+- (NSArray<BOOL (^)(void)> *)compiledOperationQueue {
+    NSArray<BAUserDataOperation *> *compiled = [BAUserDataOperationCompiler compileOperations:_operationQueue];
+    [BALogger debugForDomain:DEBUG_DOMAIN
+                     message:@"Compiled %lu queued operations into %lu", (unsigned long)_operationQueue.count,
+                             (unsigned long)compiled.count];
+
+    NSMutableArray<BOOL (^)(void)> *applyQueue = [NSMutableArray arrayWithCapacity:compiled.count];
+    for (BAUserDataOperation *operation in compiled) {
+        [applyQueue addObject:^BOOL {
+          return [operation run];
+        }];
+    }
+    return applyQueue;
+}
+
 - (BOOL)validateAttributeKey:(NSString *)key error:(NSError *_Nullable *_Nonnull)error {
     if (key == nil) {
         *error = [self logAndMakeSaveErrorWithCode:BAInstallDataEditorErrorInvalidKey
@@ -1,6 +1,7 @@
 #import <Foundation/Foundation.h>
 
 #import <Batch/BAUserAttribute.h>
+#import <Batch/BAUserDataJournal.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -13,6 +14,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithNewAttributes:(BAUserAttributes *)newAttributes previous:(BAUserAttributes *)previousAttributes;
 
+/**
+ Compute the diff from journal entries, rather than from full snapshots.
+
+ Entries must be ordered by version. Cost is proportional to the number of entries, not to the number of attributes.
+ An attribute that has been changed and then restored to its original value doesn't appear in the diff.
+ Tag entries are ignored.
+ */
+- (instancetype)initWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries;
+
 - (BOOL)hasChanges;
 
 @property (readonly) BAUserAttributes *added;
@@ -33,6 +43,13 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithNewTagCollections:(BAUserTagCollections *)newCollections
                                  previous:(BAUserTagCollections *)previousCollections;
 
+/**
+ Compute the diff from journal entries, rather than from full snapshots.
+
+ Entries must be ordered by version. Attribute entries are ignored.
+ */
+- (instancetype)initWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries;
+
 - (BOOL)hasChanges;
 
 @property (readonly) BAUserTagCollections *added;
@@ -14,10 +14,59 @@ typedef NSSet<NSString *> TagSet;
     return self;
 }
 
+- (instancetype)initWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries {
+    self = [super init];
+    if (self) {
+        [self computeWithJournalEntries:entries];
+    }
+    return self;
+}
+
 - (BOOL)hasChanges {
     return self.added.count != 0 || self.removed.count != 0;
 }
 
+- (void)computeWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries {
+    // The first entry of a key tells us what the value was before the changeset:
+    // a removal holds the previous value, while a set means that there was none.
+    // The last entry tells us the current value.
+    NSMutableDictionary<NSString *, id> *initialValues = [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, id> *finalValues = [NSMutableDictionary new];
+
+    for (BAUserDataJournalEntry *entry in entries) {
+        BOOL isSet = entry.operation == BAUserDataJournalOperationAttributeSet;
+        if ((!isSet && entry.operation != BAUserDataJournalOperationAttributeRemoved) || entry.attribute == nil) {
+            continue;
+        }
+
+        if (initialValues[entry.name] == nil) {
+            initialValues[entry.name] = isSet ? (id)[NSNull null] : entry.attribute;
+        }
+        finalValues[entry.name] = isSet ? entry.attribute : (id)[NSNull null];
+    }
+
+    NSMutableDictionary *newEntries = [NSMutableDictionary new];
+    NSMutableDictionary *missingEntries = [NSMutableDictionary new];
+
+    for (NSString *key in finalValues.allKeys) {
+        id initialValue = initialValues[key];
+        id finalValue = finalValues[key];
+        if ([initialValue isEqual:finalValue]) {
+            continue;
+        }
+
+        if (finalValue != [NSNull null]) {
+            [newEntries setObject:finalValue forKey:key];
+        }
+        if (initialValue != [NSNull null]) {
+            [missingEntries setObject:initialValue forKey:key];
+        }
+    }
+
+    _added = newEntries;
+    _removed = missingEntries;
+}
+
 - (void)computeWithNewAttributes:(NSDictionary<NSString *, BAUserAttribute *> *)newAttributes
                         previous:(NSDictionary<NSString *, BAUserAttribute *> *)previousAttributes {
     // Clone the old dictionary, and progressively remove entries that have been found in the new one
@@ -55,10 +104,91 @@ typedef NSSet<NSString *> TagSet;
     return self;
 }
 
+- (instancetype)initWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries {
+    self = [super init];
+    if (self) {
+        [self computeWithJournalEntries:entries];
+    }
+    return self;
+}
+
 - (BOOL)hasChanges {
     return self.added.count != 0 || self.removed.count != 0;
 }
 
+- (void)computeWithJournalEntries:(NSArray<BAUserDataJournalEntry *> *)entries {
+    // Tags are only journaled when they effectively change, so the first entry of a tag tells us whether it was
+    // there before the changeset, and the last one whether it is there now.
+    NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, NSNumber *> *> *initialStates =
+        [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, NSNumber *> *> *finalStates =
+        [NSMutableDictionary new];
+
+    for (BAUserDataJournalEntry *entry in entries) {
+        BOOL added;
+        if (entry.operation == BAUserDataJournalOperationTagAdded) {
+            added = YES;
+        } else if (entry.operation == BAUserDataJournalOperationTagRemoved) {
+            added = NO;
+        } else {
+            continue;
+        }
+
+        if (entry.tag == nil) {
+            continue;
+        }
+
+        NSMutableDictionary<NSString *, NSNumber *> *collectionInitialStates = initialStates[entry.name];
+        NSMutableDictionary<NSString *, NSNumber *> *collectionFinalStates = finalStates[entry.name];
+        if (collectionInitialStates == nil) {
+            collectionInitialStates = [NSMutableDictionary new];
+            collectionFinalStates = [NSMutableDictionary new];
+            initialStates[entry.name] = collectionInitialStates;
+            finalStates[entry.name] = collectionFinalStates;
+        }
+
+        if (collectionInitialStates[entry.tag] == nil) {
+            collectionInitialStates[entry.tag] = @(!added);
+        }
+        collectionFinalStates[entry.tag] = @(added);
+    }
+
+    BAMutableUserTagCollections *addedResult = [NSMutableDictionary new];
+    BAMutableUserTagCollections *removedResult = [NSMutableDictionary new];
+
+    for (NSString *collectionName in finalStates.allKeys) {
+        NSDictionary<NSString *, NSNumber *> *collectionInitialStates = initialStates[collectionName];
+        NSDictionary<NSString *, NSNumber *> *collectionFinalStates = finalStates[collectionName];
+
+        NSMutableSet<NSString *> *addedTags = [NSMutableSet new];
+        NSMutableSet<NSString *> *removedTags = [NSMutableSet new];
+
+        for (NSString *tag in collectionFinalStates.allKeys) {
+            BOOL wasPresent = [collectionInitialStates[tag] boolValue];
+            BOOL isPresent = [collectionFinalStates[tag] boolValue];
+            if (wasPresent == isPresent) {
+                continue;
+            }
+
+            if (isPresent) {
+                [addedTags addObject:tag];
+            } else {
+                [removedTags addObject:tag];
+            }
+        }
+
+        if ([addedTags count] > 0) {
+            addedResult[collectionName] = addedTags;
+        }
+        if ([removedTags count] > 0) {
+            removedResult[collectionName] = removedTags;
+        }
+    }
+
+    _added = addedResult;
+    _removed = removedResult;
+}
+
 - (void)computeWithNewTagCollections:(BAUserTagCollections *)newCollections
                             previous:(BAUserTagCollections *)previousCollections {
     // Works quite like the attributes comparaison, with a custom diff for collections that still exist on both sides
@@ -0,0 +1,63 @@
+//
+//  BAUserDataJournal.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <Batch/BAUserAttribute.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Kind of change recorded in the user data journal
+typedef NS_ENUM(int, BAUserDataJournalOperation) {
+    /// An attribute has been written. The entry holds the new value.
+    BAUserDataJournalOperationAttributeSet = 1,
+    /// An attribute has been removed or overwritten. The entry holds the previous value.
+    BAUserDataJournalOperationAttributeRemoved = 2,
+    /// A tag has been added to a collection it was not part of.
+    BAUserDataJournalOperationTagAdded = 3,
+    /// A tag has been removed from a collection it was part of.
+    BAUserDataJournalOperationTagRemoved = 4,
+};
+
+/**
+ Single entry of the append-only user data journal.
+
+ The datasource only journals effective changes: writing an attribute with its current value
+ or adding a tag that is already in its collection doesn't produce any entry.
+ Overwriting an attribute produces two entries: the removal of the old value, then the new value.
+ */
+@interface BAUserDataJournalEntry : NSObject
+
+- (instancetype)initWithVersion:(long long)version
+                      changeset:(long long)changeset
+                      operation:(BAUserDataJournalOperation)operation
+                           name:(NSString *)name
+                      attribute:(nullable BAUserAttribute *)attribute
+                            tag:(nullable NSString *)tag;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Monotonic version of the entry. Never reused, even after the journal is pruned.
+@property (readonly) long long version;
+
+/// Changeset (user data version) that was being written when the entry was recorded
+@property (readonly) long long changeset;
+
+@property (readonly) BAUserDataJournalOperation operation;
+
+/// Prefixed attribute name ("c.xxx") for attribute operations, collection name for tag operations
+@property (readonly) NSString *name;
+
+/// Attribute value, for attribute operations only
+@property (readonly, nullable) BAUserAttribute *attribute;
+
+/// Tag value, for tag operations only
+@property (readonly, nullable) NSString *tag;
+
+@end
+
+NS_ASSUME_NONNULL_END
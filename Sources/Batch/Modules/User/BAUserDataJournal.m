@@ -0,0 +1,36 @@
+//
+//  BAUserDataJournal.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAUserDataJournal.h>
+
+@implementation BAUserDataJournalEntry
+
+- (instancetype)initWithVersion:(long long)version
+                      changeset:(long long)changeset
+                      operation:(BAUserDataJournalOperation)operation
+                           name:(NSString *)name
+                      attribute:(nullable BAUserAttribute *)attribute
+                            tag:(nullable NSString *)tag {
+    self = [super init];
+    if (self) {
+        _version = version;
+        _changeset = changeset;
+        _operation = operation;
+        _name = name;
+        _attribute = attribute;
+        _tag = tag;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<BAUserDataJournalEntry v%lld changeset: %lld op: %d name: %@ value: %@>",
+                                      _version, _changeset, _operation, _name,
+                                      _attribute != nil ? _attribute : _tag];
+}
+
+@end
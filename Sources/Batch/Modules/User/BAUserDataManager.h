@@ -8,6 +8,9 @@
 
 #import <Foundation/Foundation.h>
 
+@class BAUserDataDeltaSendServiceDatasource;
+@protocol BAUserDatasourceProtocol;
+
 /*!
  @class BAUserDataManager
  @abstract Manages the user data: webservices, shared queue, etc...
@@ -21,8 +24,22 @@
 + (nonnull dispatch_queue_t)sharedQueue;
 
 // Delay is in ms
+// Sends the changes since the last version acknowledged by the server if possible, the full snapshot otherwise
 + (void)startAttributesSendWSWithDelay:(long long)delay;
 
+// Delay is in ms
+// Always sends the full snapshot: use this when the server's data may have diverged from ours
++ (void)startFullAttributesSendWSWithDelay:(long long)delay;
+
+// Must be called once an attributes send succeeded, so that the next one can start
++ (void)attributesSendDidFinish;
+
+// Must be called once an attributes send failed: a full snapshot is sent again with a backoff
++ (void)attributesSendDidFailWithDeltaSend:(BOOL)deltaSend;
+
+// Deltas are only sent once the server said it accepts them
++ (void)setDeltaSendSupported:(BOOL)supported;
+
 + (void)startAttributesCheckWSWithDelay:(long long)delay;
 
 + (void)storeTransactionID:(nonnull NSString *)transaction forVersion:(nonnull NSNumber *)version;
@@ -47,4 +64,10 @@
 
 + (BOOL)writeChangesToDatasource:(NSArray<BOOL (^)(void)> *_Nonnull)applyQueue
                        changeset:(long long)changeset NS_SWIFT_NAME(writeToDatasource(changes:changeset:));
+
+/// Returns nil if a delta can't be built from baseVersion, meaning that a full snapshot should be sent
++ (nullable BAUserDataDeltaSendServiceDatasource *)
+    deltaSendDatasourceForVersion:(long long)version
+                      baseVersion:(long long)baseVersion
+                       datasource:(nonnull id<BAUserDatasourceProtocol>)datasource;
 @end
@@ -14,9 +14,10 @@
 #import <Batch/BAOptOut.h>
 #import <Batch/BAParameter.h>
 #import <Batch/BAQueryWebserviceClient.h>
+#import <Batch/BATaskBackoff.h>
+#import <Batch/BATimerWheel.h>
 #import <Batch/BATrackerCenter.h>
 #import <Batch/BAUserDataDiff.h>
-#import <Batch/BAUserDataManager.h>
 #import <Batch/BAUserDataServices.h>
 #import <Batch/BAUserDatasourceProtocol.h>
 #import <Batch/BAUserSQLiteDatasource.h>
@@ -28,15 +29,33 @@
 /// Waiting time before operations are submitted (in ms)
 #define DISPATCH_QUEUE_TIMER 500
 
+/// Past this many unacknowledged changesets, the journal is dropped and a full snapshot will be sent
+#define MAX_DELTA_CHANGESETS 50
+
+/// Past this many journal entries, a full snapshot is usually smaller than the delta
+#define MAX_DELTA_JOURNAL_ENTRIES 1000
+
+/// Delays before a failed send is retried (in seconds)
+#define SEND_RETRY_INITIAL_DELAY 5
+#define SEND_RETRY_MAX_DELAY 600
+
 @implementation BAUserDataManager
 
 static NSLock *baUserDataManagerCheckScheduledLock;
 static BOOL baUserDataManagerCheckScheduled = NO;
 static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
 
+// The following are only accessed on the shared queue
+static BOOL submitScheduled = NO;
+static NSMutableArray<void (^)(void)> *pendingSubmitCompletions;
+static BOOL attributesSendInFlight = NO;
+static BOOL attributesSendPending = NO;
+static BOOL attributesSendPendingFullSnapshot = NO;
+
 + (void)load {
     baUserDataManagerCheckScheduledLock = [NSLock new];
     operationsQueues = [NSMutableArray new];
+    pendingSubmitCompletions = [NSMutableArray new];
 }
 
 + (dispatch_queue_t)sharedQueue {
@@ -49,36 +68,170 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
     return queue;
 }
 
++ (BATaskBackoff *)sendRetryBackoff {
+    static BATaskBackoff *backoff;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      // Whatever failed, the server may have missed changes: retries send the full snapshot
+      dispatch_block_t retryTask = ^{
+        [BAUserDataManager startFullAttributesSendWSWithDelay:0];
+      };
+      backoff = [BATaskBackoff backoffWithInitialDelay:SEND_RETRY_INITIAL_DELAY
+                                              maxDelay:SEND_RETRY_MAX_DELAY
+                                                 queue:[BAUserDataManager sharedQueue]
+                                                  task:retryTask];
+    });
+    return backoff;
+}
+
 + (void)startAttributesSendWSWithDelay:(long long)delay {
-    dispatch_after(
-        dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_MSEC)), [BAUserDataManager sharedQueue], ^{
-          id<BAUserDatasourceProtocol> database = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-
-          if (database == nil) {
-              [BALogger errorForDomain:@"BAUserDataManager"
-                               message:@"Could not send attributes to backend, missing database."];
-              return;
-          }
+    [BAUserDataManager startAttributesSendWSWithDelay:delay fullSnapshot:NO];
+}
+
++ (void)startFullAttributesSendWSWithDelay:(long long)delay {
+    [BAUserDataManager startAttributesSendWSWithDelay:delay fullSnapshot:YES];
+}
+
++ (void)startAttributesSendWSWithDelay:(long long)delay fullSnapshot:(BOOL)fullSnapshot {
+    dispatch_block_t sendTask = ^{
+      id<BAUserDatasourceProtocol> database = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
 
-          NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(1)];
-          // Sanity
-          if (![changeset isKindOfClass:[NSNumber class]]) {
-              changeset = @(1);
-              [BAParameter setValue:changeset forKey:kParametersUserProfileDataVersionKey saved:YES];
+      if (database == nil) {
+          [BALogger errorForDomain:@"BAUserDataManager"
+                           message:@"Could not send attributes to backend, missing database."];
+          return;
+      }
+
+      // Only one send at a time: sends requested meanwhile are merged into a single one,
+      // started once the current one is done. It will read the latest data anyway.
+      if (attributesSendInFlight) {
+          attributesSendPending = YES;
+          attributesSendPendingFullSnapshot = attributesSendPendingFullSnapshot || fullSnapshot;
+          return;
+      }
+
+      NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(1)];
+      // Sanity
+      if (![changeset isKindOfClass:[NSNumber class]]) {
+          changeset = @(1);
+          [BAParameter setValue:changeset forKey:kParametersUserProfileDataVersionKey saved:YES];
+      }
+
+      id<BAQueryWebserviceClientDatasource> wsDatasource = nil;
+
+      if (fullSnapshot) {
+          // We don't know what the server has anymore: deltas can only be sent once it acknowledges this snapshot
+          [BAUserDataManager resetSyncedVersionWithDatasource:database];
+      } else {
+          NSNumber *syncedVersion = [BAParameter objectForKey:kParametersUserProfileSyncedVersionKey fallback:nil];
+          NSNumber *deltaSupported = [BAParameter objectForKey:kParametersUserProfileDeltaSupportedKey fallback:@NO];
+          if ([syncedVersion isKindOfClass:[NSNumber class]] && [deltaSupported isKindOfClass:[NSNumber class]] &&
+              [deltaSupported boolValue]) {
+              wsDatasource = [BAUserDataManager deltaSendDatasourceForVersion:[changeset longLongValue]
+                                                                  baseVersion:[syncedVersion longLongValue]
+                                                                   datasource:database];
           }
+      }
 
+      BOOL deltaSend = wsDatasource != nil;
+      if (!deltaSend) {
           NSDictionary *attributes = [BAUserAttribute serverJsonRepresentationForAttributes:[database attributes]];
-          BAUserDataSendServiceDatasource *wsDatasource;
           wsDatasource = [[BAUserDataSendServiceDatasource alloc] initWithVersion:[changeset longLongValue]
                                                                        attributes:attributes
                                                                           andTags:[database tagCollections]];
+      } else {
+          [BALogger debugForDomain:DEBUG_DOMAIN message:@"Sending attributes delta"];
+      }
 
-          BAQueryWebserviceClient *ws =
-              [[BAQueryWebserviceClient alloc] initWithDatasource:wsDatasource
-                                                         delegate:[BAUserDataSendServiceDelegate new]];
+      BAUserDataSendServiceDelegate *wsDelegate = [[BAUserDataSendServiceDelegate alloc] initWithDeltaSend:deltaSend];
+      BAQueryWebserviceClient *ws = [[BAQueryWebserviceClient alloc] initWithDatasource:wsDatasource
+                                                                               delegate:wsDelegate];
 
-          [BAWebserviceClientExecutor.sharedInstance addClient:ws];
-        });
+      attributesSendInFlight = YES;
+      [BAWebserviceClientExecutor.sharedInstance addClient:ws];
+    };
+    [[BATimerWheel sharedWheel] dispatchAfter:delay / 1000.0 queue:[BAUserDataManager sharedQueue] task:sendTask];
+}
+
++ (void)attributesSendDidFinish {
+    dispatch_async([BAUserDataManager sharedQueue], ^{
+      attributesSendInFlight = NO;
+
+      if (attributesSendPending) {
+          BOOL fullSnapshot = attributesSendPendingFullSnapshot;
+          attributesSendPending = NO;
+          attributesSendPendingFullSnapshot = NO;
+          [BAUserDataManager startAttributesSendWSWithDelay:0 fullSnapshot:fullSnapshot];
+      }
+    });
+}
+
++ (void)attributesSendDidFailWithDeltaSend:(BOOL)deltaSend {
+    dispatch_async([BAUserDataManager sharedQueue], ^{
+      attributesSendInFlight = NO;
+
+      if (deltaSend) {
+          // The server may not accept deltas: only send them again once it says it does
+          [BALogger debugForDomain:DEBUG_DOMAIN message:@"Attributes delta send failed, falling back on full sends"];
+          [BAParameter removeObjectForKey:kParametersUserProfileDeltaSupportedKey];
+      }
+
+      // The retry reads the latest data: it covers the sends requested meanwhile
+      attributesSendPending = NO;
+      attributesSendPendingFullSnapshot = NO;
+      [[BAUserDataManager sendRetryBackoff] scheduleRetry];
+    });
+}
+
++ (void)setDeltaSendSupported:(BOOL)supported {
+    dispatch_async([BAUserDataManager sharedQueue], ^{
+      if (supported) {
+          [BAParameter setValue:@YES forKey:kParametersUserProfileDeltaSupportedKey saved:YES];
+      } else {
+          [BAParameter removeObjectForKey:kParametersUserProfileDeltaSupportedKey];
+      }
+    });
+}
+
++ (nullable BAUserDataDeltaSendServiceDatasource *)
+    deltaSendDatasourceForVersion:(long long)version
+                      baseVersion:(long long)baseVersion
+                       datasource:(nonnull id<BAUserDatasourceProtocol>)datasource {
+    // If the server already has our version, something diverged: only a full snapshot can fix it
+    if (baseVersion <= 0 || baseVersion >= version) {
+        return nil;
+    }
+
+    NSArray<BAUserDataJournalEntry *> *journal = [datasource journalEntriesAfterChangeset:baseVersion
+                                                                            upToChangeset:version];
+    if ([journal count] > MAX_DELTA_JOURNAL_ENTRIES) {
+        return nil;
+    }
+
+    BAUserAttributesDiff *attributesDiff = [[BAUserAttributesDiff alloc] initWithJournalEntries:journal];
+    BAUserTagCollectionsDiff *tagCollectionsDiff = [[BAUserTagCollectionsDiff alloc] initWithJournalEntries:journal];
+
+    // Same flat representation as the change event
+    NSDictionary *changes = [BAUserDataDiffTransformer eventParametersFromAttributes:attributesDiff
+                                                                      tagCollections:tagCollectionsDiff
+                                                                             version:@(version)];
+
+    return [[BAUserDataDeltaSendServiceDatasource alloc] initWithVersion:version
+                                                             baseVersion:baseVersion
+                                                                   added:changes[@"added"]
+                                                                 removed:changes[@"removed"]];
+}
+
+/// Forget the version the server acknowledged, along with the journal kept to build deltas from it.
+/// Must be called on the shared queue.
++ (void)resetSyncedVersionWithDatasource:(nullable id<BAUserDatasourceProtocol>)datasource {
+    NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(0)];
+    if (![changeset isKindOfClass:[NSNumber class]]) {
+        changeset = @(0);
+    }
+
+    [BAParameter removeObjectForKey:kParametersUserProfileSyncedVersionKey];
+    [datasource pruneJournalUpToChangeset:[changeset longLongValue]];
 }
 
 + (void)startAttributesCheckWSWithDelay:(long long)delay {
@@ -86,51 +239,51 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
     baUserDataManagerCheckScheduled = YES;
     [baUserDataManagerCheckScheduledLock unlock];
 
-    dispatch_after(
-        dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_MSEC)), [BAUserDataManager sharedQueue], ^{
-          BOOL shouldStop = NO;
-
-          [baUserDataManagerCheckScheduledLock lock];
-          // Stop if a check wasn't scheduled (meaning it was already done by another scheduled check)
-          // No need to spam with checks!
-          shouldStop = !baUserDataManagerCheckScheduled;
-          baUserDataManagerCheckScheduled = NO;
-          [baUserDataManagerCheckScheduledLock unlock];
+    dispatch_block_t checkTask = ^{
+      BOOL shouldStop = NO;
 
-          if (shouldStop) {
-              return;
-          }
+      [baUserDataManagerCheckScheduledLock lock];
+      // Stop if a check wasn't scheduled (meaning it was already done by another scheduled check)
+      // No need to spam with checks!
+      shouldStop = !baUserDataManagerCheckScheduled;
+      baUserDataManagerCheckScheduled = NO;
+      [baUserDataManagerCheckScheduledLock unlock];
 
-          NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(0)];
+      if (shouldStop) {
+          return;
+      }
 
-          NSString *trid = [BAParameter objectForKey:kParametersUserProfileTransactionIDKey fallback:nil];
-          if (![trid isKindOfClass:[NSString class]] || [trid length] == 0) {
-              // No need to send a check if we don't have a transaction ID.
-              // If we do have a valid data version though, send the data.
+      NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(0)];
 
-              if ([changeset isKindOfClass:[NSNumber class]] && [changeset longLongValue] > 0) {
-                  [BAUserDataManager startAttributesSendWSWithDelay:0];
-              }
+      NSString *trid = [BAParameter objectForKey:kParametersUserProfileTransactionIDKey fallback:nil];
+      if (![trid isKindOfClass:[NSString class]] || [trid length] == 0) {
+          // No need to send a check if we don't have a transaction ID.
+          // If we do have a valid data version though, send the data.
 
-              return;
+          if ([changeset isKindOfClass:[NSNumber class]] && [changeset longLongValue] > 0) {
+              [BAUserDataManager startAttributesSendWSWithDelay:0];
           }
 
-          // Check if our changeset is okay before proceeding
-          if (![changeset isKindOfClass:[NSNumber class]] || [changeset longLongValue] <= 0) {
-              changeset = @(1);
-              [BAParameter setValue:changeset forKey:kParametersUserProfileDataVersionKey saved:YES];
-          }
+          return;
+      }
+
+      // Check if our changeset is okay before proceeding
+      if (![changeset isKindOfClass:[NSNumber class]] || [changeset longLongValue] <= 0) {
+          changeset = @(1);
+          [BAParameter setValue:changeset forKey:kParametersUserProfileDataVersionKey saved:YES];
+      }
 
-          BAUserDataCheckServiceDatasource *wsDatasource;
-          wsDatasource = [[BAUserDataCheckServiceDatasource alloc] initWithVersion:[changeset longLongValue]
-                                                                     transactionID:trid];
+      BAUserDataCheckServiceDatasource *wsDatasource;
+      wsDatasource = [[BAUserDataCheckServiceDatasource alloc] initWithVersion:[changeset longLongValue]
+                                                                 transactionID:trid];
 
-          BAQueryWebserviceClient *ws =
-              [[BAQueryWebserviceClient alloc] initWithDatasource:wsDatasource
-                                                         delegate:[BAUserDataCheckServiceDelegate new]];
+      BAQueryWebserviceClient *ws =
+          [[BAQueryWebserviceClient alloc] initWithDatasource:wsDatasource
+                                                     delegate:[BAUserDataCheckServiceDelegate new]];
 
-          [BAWebserviceClientExecutor.sharedInstance addClient:ws];
-        });
+      [BAWebserviceClientExecutor.sharedInstance addClient:ws];
+    };
+    [[BATimerWheel sharedWheel] dispatchAfter:delay / 1000.0 queue:[BAUserDataManager sharedQueue] task:checkTask];
 }
 
 + (void)storeTransactionID:(NSString *)transaction forVersion:(NSNumber *)version {
@@ -147,9 +300,19 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
       if ([version isEqualToNumber:changeset]) {
           [BAParameter setValue:transaction forKey:kParametersUserProfileTransactionIDKey saved:YES];
 
+          // The server has everything up to this version: next sends can be deltas from it
+          [BAParameter setValue:version forKey:kParametersUserProfileSyncedVersionKey saved:YES];
+          id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+          [datasource pruneJournalUpToChangeset:[version longLongValue]];
+          [[BAUserDataManager sendRetryBackoff] reset];
+
           [BALogger debugForDomain:@"BAUserDataManager" message:@"Send successful, checking in 15s (%@)", transaction];
           // Check in 15s
           [BAUserDataManager startAttributesCheckWSWithDelay:15000];
+      } else if (attributesSendPending) {
+          // A send of our latest changeset will start as soon as this one is done
+          [BALogger debugForDomain:@"BAUserDataManager"
+                           message:@"Wrong changeset (ours: %@, server %@), send already pending", changeset, version];
       } else {
           [BALogger debugForDomain:@"BAUserDataManager"
                            message:@"Wrong changeset (ours: %@, server %@), resending", changeset, version];
@@ -171,7 +334,8 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
       if ([changeset longLongValue] < targetVersion) {
           [BAParameter setValue:@(targetVersion) forKey:kParametersUserProfileDataVersionKey saved:YES];
           [BAParameter removeObjectForKey:kParametersUserProfileTransactionIDKey];
-          [BAUserDataManager startAttributesSendWSWithDelay:0];
+          // The server's data version is ahead of ours: we can't know what it has
+          [BAUserDataManager startFullAttributesSendWSWithDelay:0];
       } else {
           // We probably corrected this already
       }
@@ -186,6 +350,11 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
     dispatch_async([BAUserDataManager sharedQueue], ^{
       [BAParameter removeObjectForKey:kParametersUserProfileDataVersionKey];
       [BAParameter removeObjectForKey:kParametersUserProfileTransactionIDKey];
+      [BAParameter removeObjectForKey:kParametersUserProfileSyncedVersionKey];
+      [BAParameter removeObjectForKey:kParametersUserProfileDeltaSupportedKey];
+      [[BAUserDataManager sendRetryBackoff] reset];
+      attributesSendPending = NO;
+      attributesSendPendingFullSnapshot = NO;
 
       id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
       [datasource clear];
@@ -277,70 +446,93 @@ static NSMutableArray<NSArray<BOOL (^)(void)> *> *operationsQueues;
 }
 
 + (void)submitWithCompletion:(void (^_Nullable)(void))completion {
-    dispatch_after(
-        dispatch_time(DISPATCH_TIME_NOW, (int64_t)(DISPATCH_QUEUE_TIMER * NSEC_PER_MSEC)),
-        [BAUserDataManager sharedQueue], ^{
-          if ([operationsQueues count] == 0) {
-              if (completion != nil) {
-                  completion();
-              }
-              return;
-          }
+    if (completion != nil) {
+        [pendingSubmitCompletions addObject:completion];
+    }
 
-          NSMutableArray<BOOL (^)(void)> *applyQueue = [NSMutableArray array];
-          for (NSArray<BOOL (^)(void)> *queue in operationsQueues) {
-              [applyQueue addObjectsFromArray:queue];
-          }
-          [operationsQueues removeAllObjects];
+    // Changesets submitted within the same window are merged into a single transaction:
+    // only the first submit schedules the work, the next ones will be picked up with it.
+    if (submitScheduled) {
+        return;
+    }
+    submitScheduled = YES;
 
-          id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
-          NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(0)];
-          // Sanity
-          if (![changeset isKindOfClass:[NSNumber class]]) {
-              [BAParameter setValue:@(0) forKey:kParametersUserProfileDataVersionKey saved:YES];
-              changeset = @(0);
-          }
+    dispatch_block_t submitTask = ^{
+      submitScheduled = NO;
 
-          BAUserAttributes *oldAttributes = [datasource attributes];
-          BAUserTagCollections *oldTagCollections = [datasource tagCollections];
+      NSArray<void (^)(void)> *completions = [pendingSubmitCompletions copy];
+      [pendingSubmitCompletions removeAllObjects];
 
-          long long newChangeset = [changeset longLongValue] + 1;
+      [BAUserDataManager applyOperationQueues];
 
-          if (![BAUserDataManager writeChangesToDatasource:applyQueue changeset:newChangeset]) {
-              if (completion != nil) {
-                  completion();
-              }
-              return;
-          }
+      for (void (^submitCompletion)(void) in completions) {
+          submitCompletion();
+      }
+    };
+    [[BATimerWheel sharedWheel] dispatchAfter:DISPATCH_QUEUE_TIMER / 1000.0
+                                        queue:[BAUserDataManager sharedQueue]
+                                         task:submitTask];
+}
 
-          BAUserAttributes *newAttributes = [datasource attributes];
-          BAUserTagCollections *newTagCollections = [datasource tagCollections];
+/// Apply all the pending operation queues as one changeset, and send it if anything changed.
+/// Must be called on the shared queue.
++ (void)applyOperationQueues {
+    if ([operationsQueues count] == 0) {
+        return;
+    }
 
-          BAUserAttributesDiff *attributesDiff = [[BAUserAttributesDiff alloc] initWithNewAttributes:newAttributes
-                                                                                            previous:oldAttributes];
-          BAUserTagCollectionsDiff *tagCollectionsDiff =
-              [[BAUserTagCollectionsDiff alloc] initWithNewTagCollections:newTagCollections previous:oldTagCollections];
+    NSMutableArray<BOOL (^)(void)> *applyQueue = [NSMutableArray array];
+    for (NSArray<BOOL (^)(void)> *queue in operationsQueues) {
+        [applyQueue addObjectsFromArray:queue];
+    }
+    [operationsQueues removeAllObjects];
 
-          if ([attributesDiff hasChanges] || [tagCollectionsDiff hasChanges]) {
-              NSNumber *newChangesetNumber = @(newChangeset);
-              [BAParameter setValue:newChangesetNumber forKey:kParametersUserProfileDataVersionKey saved:YES];
-              [BAParameter removeObjectForKey:kParametersUserProfileTransactionIDKey];
-              [BAUserDataManager startAttributesSendWSWithDelay:0];
+    id<BAUserDatasourceProtocol> datasource = [BAInjection injectProtocol:@protocol(BAUserDatasourceProtocol)];
+    NSNumber *changeset = [BAParameter objectForKey:kParametersUserProfileDataVersionKey fallback:@(0)];
+    // Sanity
+    if (![changeset isKindOfClass:[NSNumber class]]) {
+        [BAParameter setValue:@(0) forKey:kParametersUserProfileDataVersionKey saved:YES];
+        changeset = @(0);
+    }
 
-              NSDictionary *eventParams = [BAUserDataDiffTransformer eventParametersFromAttributes:attributesDiff
-                                                                                    tagCollections:tagCollectionsDiff
-                                                                                           version:newChangesetNumber];
-              [BATrackerCenter trackPrivateEvent:@"_INSTALL_DATA_CHANGED" parameters:eventParams];
+    long long newChangeset = [changeset longLongValue] + 1;
 
-              [BALogger debugForDomain:DEBUG_DOMAIN message:@"Changes in install occurred: YES"];
-          } else {
-              [BALogger debugForDomain:DEBUG_DOMAIN message:@"Changes in install occurred: NO"];
-          }
+    if (![BAUserDataManager writeChangesToDatasource:applyQueue changeset:newChangeset]) {
+        return;
+    }
 
-          if (completion != nil) {
-              completion();
-          }
-        });
+    // The datasource journals what changed in the same transaction as the changes themselves,
+    // so we don't need to snapshot and compare every attribute and tag.
+    NSArray<BAUserDataJournalEntry *> *journal = [datasource journalEntriesAfterChangeset:newChangeset - 1
+                                                                            upToChangeset:newChangeset];
+
+    BAUserAttributesDiff *attributesDiff = [[BAUserAttributesDiff alloc] initWithJournalEntries:journal];
+    BAUserTagCollectionsDiff *tagCollectionsDiff = [[BAUserTagCollectionsDiff alloc] initWithJournalEntries:journal];
+
+    // The journal is kept until the server acknowledges it, so that only deltas are sent.
+    // If the server is too far behind, a full snapshot will be cheaper than the accumulated journal.
+    NSNumber *syncedVersion = [BAParameter objectForKey:kParametersUserProfileSyncedVersionKey fallback:nil];
+    if (![syncedVersion isKindOfClass:[NSNumber class]] ||
+        newChangeset - [syncedVersion longLongValue] > MAX_DELTA_CHANGESETS) {
+        [BAParameter removeObjectForKey:kParametersUserProfileSyncedVersionKey];
+        [datasource pruneJournalUpToChangeset:newChangeset];
+    }
+
+    if ([attributesDiff hasChanges] || [tagCollectionsDiff hasChanges]) {
+        NSNumber *newChangesetNumber = @(newChangeset);
+        [BAParameter setValue:newChangesetNumber forKey:kParametersUserProfileDataVersionKey saved:YES];
+        [BAParameter removeObjectForKey:kParametersUserProfileTransactionIDKey];
+        [BAUserDataManager startAttributesSendWSWithDelay:0];
+
+        NSDictionary *eventParams = [BAUserDataDiffTransformer eventParametersFromAttributes:attributesDiff
+                                                                              tagCollections:tagCollectionsDiff
+                                                                                     version:newChangesetNumber];
+        [BATrackerCenter trackPrivateEvent:@"_INSTALL_DATA_CHANGED" parameters:eventParams];
+
+        [BALogger debugForDomain:DEBUG_DOMAIN message:@"Changes in install occurred: YES"];
+    } else {
+        [BALogger debugForDomain:DEBUG_DOMAIN message:@"Changes in install occurred: NO"];
+    }
 }
 
 @end
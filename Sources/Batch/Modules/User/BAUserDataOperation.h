@@ -8,6 +8,24 @@
 
 #import <Foundation/Foundation.h>
 
+NS_ASSUME_NONNULL_BEGIN
+
+/// What a user data operation touches, so that operations can be fused before being applied
+typedef NS_ENUM(NSUInteger, BAUserDataOperationKind) {
+    /// Unknown effect: never fused
+    BAUserDataOperationKindOpaque = 0,
+    /// An attribute has been set or removed
+    BAUserDataOperationKindAttribute,
+    /// All attributes have been cleared
+    BAUserDataOperationKindClearAttributes,
+    /// A tag has been added to or removed from a collection
+    BAUserDataOperationKindTag,
+    /// A tag collection has been cleared
+    BAUserDataOperationKindClearTagCollection,
+    /// All tag collections have been cleared
+    BAUserDataOperationKindClearTags,
+};
+
 // Inspired by NSBlockOperation, but supports returning a value
 @interface BAUserDataOperation : NSObject {
     BOOL (^_operationBlock)(void);
@@ -15,6 +33,41 @@
 
 - (instancetype)initWithBlock:(BOOL (^)(void))block;
 
++ (instancetype)attributeOperationForKey:(NSString *)key block:(BOOL (^)(void))block;
+
++ (instancetype)clearAttributesOperationWithBlock:(BOOL (^)(void))block;
+
++ (instancetype)tagOperationForTag:(NSString *)tag inCollection:(NSString *)collection block:(BOOL (^)(void))block;
+
++ (instancetype)clearTagCollectionOperationForCollection:(NSString *)collection block:(BOOL (^)(void))block;
+
++ (instancetype)clearTagsOperationWithBlock:(BOOL (^)(void))block;
+
 - (BOOL)run;
 
+@property (readonly) BAUserDataOperationKind kind;
+
+/// Normalized attribute or collection name. Nil for global clears and opaque operations.
+@property (readonly, nullable) NSString *key;
+
+/// Normalized tag, for tag operations only
+@property (readonly, nullable) NSString *tag;
+
+@end
+
+/**
+ Collapses a queue of operations to its net effect.
+
+ An operation is dropped when a later one supersedes it: set then remove an attribute only removes it,
+ add then remove a tag only removes it, and clearing attributes, tags or a tag collection drops every
+ earlier operation in its scope.
+ Kept operations stay in their original order, so applying the compiled queue results in the same data
+ as applying the original one, with fewer datasource writes.
+ */
+@interface BAUserDataOperationCompiler : NSObject
+
++ (NSArray<BAUserDataOperation *> *)compileOperations:(NSArray<BAUserDataOperation *> *)operations;
+
 @end
+
+NS_ASSUME_NONNULL_END
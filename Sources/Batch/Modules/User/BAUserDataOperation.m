@@ -11,13 +11,43 @@
 @implementation BAUserDataOperation
 
 - (instancetype)initWithBlock:(BOOL (^)(void))block {
+    return [self initWithKind:BAUserDataOperationKindOpaque key:nil tag:nil block:block];
+}
+
+- (instancetype)initWithKind:(BAUserDataOperationKind)kind
+                         key:(nullable NSString *)key
+                         tag:(nullable NSString *)tag
+                       block:(BOOL (^)(void))block {
     self = [super init];
     if (self) {
         _operationBlock = block;
+        _kind = kind;
+        _key = key;
+        _tag = tag;
     }
     return self;
 }
 
++ (instancetype)attributeOperationForKey:(NSString *)key block:(BOOL (^)(void))block {
+    return [[self alloc] initWithKind:BAUserDataOperationKindAttribute key:key tag:nil block:block];
+}
+
++ (instancetype)clearAttributesOperationWithBlock:(BOOL (^)(void))block {
+    return [[self alloc] initWithKind:BAUserDataOperationKindClearAttributes key:nil tag:nil block:block];
+}
+
++ (instancetype)tagOperationForTag:(NSString *)tag inCollection:(NSString *)collection block:(BOOL (^)(void))block {
+    return [[self alloc] initWithKind:BAUserDataOperationKindTag key:collection tag:tag block:block];
+}
+
++ (instancetype)clearTagCollectionOperationForCollection:(NSString *)collection block:(BOOL (^)(void))block {
+    return [[self alloc] initWithKind:BAUserDataOperationKindClearTagCollection key:collection tag:nil block:block];
+}
+
++ (instancetype)clearTagsOperationWithBlock:(BOOL (^)(void))block {
+    return [[self alloc] initWithKind:BAUserDataOperationKindClearTags key:nil tag:nil block:block];
+}
+
 - (BOOL)run {
     if (!_operationBlock)
         return YES;
@@ -26,3 +56,68 @@
 }
 
 @end
+
+@implementation BAUserDataOperationCompiler
+
++ (NSArray<BAUserDataOperation *> *)compileOperations:(NSArray<BAUserDataOperation *> *)operations {
+    // Walk the queue backwards: the first operation met for a key is the one that wins.
+    // Anything older on that key, or in the scope of a clear that has already been met, is superseded.
+    BOOL attributesCleared = false;
+    BOOL tagsCleared = false;
+    NSMutableSet<NSString *> *seenAttributes = [NSMutableSet new];
+    NSMutableSet<NSString *> *clearedCollections = [NSMutableSet new];
+    NSMutableDictionary<NSString *, NSMutableSet<NSString *> *> *seenTags = [NSMutableDictionary new];
+
+    NSMutableArray<BAUserDataOperation *> *compiled = [NSMutableArray arrayWithCapacity:operations.count];
+
+    for (BAUserDataOperation *operation in [operations reverseObjectEnumerator]) {
+        NSString *key = operation.key;
+        switch (operation.kind) {
+            case BAUserDataOperationKindOpaque:
+                break;
+            case BAUserDataOperationKindAttribute:
+                if (attributesCleared || [seenAttributes containsObject:key]) {
+                    continue;
+                }
+                [seenAttributes addObject:key];
+                break;
+            case BAUserDataOperationKindClearAttributes:
+                if (attributesCleared) {
+                    continue;
+                }
+                attributesCleared = true;
+                break;
+            case BAUserDataOperationKindTag: {
+                if (tagsCleared || [clearedCollections containsObject:key]) {
+                    continue;
+                }
+                NSMutableSet<NSString *> *collectionTags = seenTags[key];
+                if (collectionTags == nil) {
+                    collectionTags = [NSMutableSet new];
+                    seenTags[key] = collectionTags;
+                } else if ([collectionTags containsObject:operation.tag]) {
+                    continue;
+                }
+                [collectionTags addObject:operation.tag];
+                break;
+            }
+            case BAUserDataOperationKindClearTagCollection:
+                if (tagsCleared || [clearedCollections containsObject:key]) {
+                    continue;
+                }
+                [clearedCollections addObject:key];
+                break;
+            case BAUserDataOperationKindClearTags:
+                if (tagsCleared) {
+                    continue;
+                }
+                tagsCleared = true;
+                break;
+        }
+        [compiled addObject:operation];
+    }
+
+    return [[compiled reverseObjectEnumerator] allObjects];
+}
+
+@end
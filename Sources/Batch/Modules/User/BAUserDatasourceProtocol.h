@@ -7,6 +7,7 @@
 //
 
 #import <Batch/BAUserAttribute.h>
+#import <Batch/BAUserDataJournal.h>
 #import <Foundation/Foundation.h>
 
 @class BAUserAttribute;
@@ -64,10 +65,30 @@
 
 #pragma mark Reader methods
 
+// Readers only see committed data: changes of a transaction in progress are not visible until it is committed.
+// They can be called from any thread.
+
 - (nonnull NSDictionary<NSString *, BAUserAttribute *> *)attributes;
 
 - (nonnull NSDictionary<NSString *, NSSet<NSString *> *> *)tagCollections;
 
+#pragma mark Journal methods
+
+/*!
+ @method journalEntriesAfterChangeset:upToChangeset:
+ @abstract Returns the journal entries recorded while writing the changesets in ]baseChangeset, changeset], ordered by
+ version
+ */
+- (nonnull NSArray<BAUserDataJournalEntry *> *)journalEntriesAfterChangeset:(long long)baseChangeset
+                                                              upToChangeset:(long long)changeset
+    NS_SWIFT_NAME(journalEntries(afterChangeset:upToChangeset:));
+
+/*!
+ @method pruneJournalUpToChangeset:
+ @abstract Removes the journal entries of the given changeset and all the ones before it
+ */
+- (BOOL)pruneJournalUpToChangeset:(long long)changeset NS_SWIFT_NAME(pruneJournal(upToChangeset:));
+
 #pragma mark Debug methods
 
 - (nonnull NSString *)printDebugDump;
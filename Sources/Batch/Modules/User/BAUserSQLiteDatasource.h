@@ -36,4 +36,9 @@
  * |name|action|value|changeset|date|
  * +----+------+-----+---------+----+
  *
+ * journal: append-only changes, read back to build delta sends
+ * +-------+---------+---------+----+----+-----+
+ * |version|changeset|operation|name|type|value|
+ * +-------+---------+---------+----+----+-----+
+ *
  */
@@ -15,6 +15,7 @@
 #define USER_DATABASE_NAME @"ba_user_profile.db"
 #define TABLE_ATTRIBUTES @"attributes"
 #define TABLE_TAGS @"tags"
+#define TABLE_JOURNAL @"journal"
 #define COLUMN_DB_ID @"_db_id"
 
 #define USER_DB_VERSION @1
@@ -24,6 +25,10 @@
 @interface BAUserSQLiteDatasource () {
     sqlite3 *_database;
 
+    // Read-only connection serving the committed data, so that readers never wait for a changeset to be applied.
+    // Same as _database if the write-ahead log couldn't be enabled.
+    sqlite3 *_readDatabase;
+
     sqlite3_stmt *_attributeInsertStatement;
 
     sqlite3_stmt *_tagInsertStatement;
@@ -34,6 +39,21 @@
 
     sqlite3_stmt *_tagDeleteStatement;
 
+    sqlite3_stmt *_journalInsertStatement;
+
+    sqlite3_stmt *_journalAttributeReplacedStatement;
+
+    sqlite3_stmt *_journalAttributeRemovedStatement;
+
+    sqlite3_stmt *_journalTagCollectionRemovedStatement;
+
+    // Reader statements are prepared once and shared: synchronize on self when using them
+    sqlite3_stmt *_attributesSelectStatement;
+
+    sqlite3_stmt *_tagCollectionsSelectStatement;
+
+    sqlite3_stmt *_journalSelectStatement;
+
     BOOL _transactionOccuring;
 
     long long _currentChangeset;
@@ -41,6 +61,86 @@
 
 @end
 
+// Reads an attribute stored as a (type, value) column pair
+static BAUserAttribute *BAUserAttributeFromStatement(sqlite3_stmt *statement, int typeColumn, int valueColumn) {
+    const BAUserAttributeType type = (const int)sqlite3_column_int(statement, typeColumn);
+
+    id objcValue = nil;
+
+    switch (type) {
+        case BAUserAttributeTypeBool:
+            objcValue = [NSNumber numberWithBool:(sqlite3_column_int(statement, valueColumn) ? YES : NO)];
+            break;
+        case BAUserAttributeTypeDouble:
+            objcValue = [NSNumber numberWithDouble:sqlite3_column_double(statement, valueColumn)];
+            break;
+        case BAUserAttributeTypeLongLong:
+            objcValue = [NSNumber numberWithLongLong:sqlite3_column_int64(statement, valueColumn)];
+            break;
+        case BAUserAttributeTypeDate:
+            objcValue = [NSDate dateWithTimeIntervalSince1970:sqlite3_column_double(statement, valueColumn)];
+            break;
+        case BAUserAttributeTypeString:
+            objcValue = [NSString stringWithCString:(const char *)sqlite3_column_text(statement, valueColumn)
+                                           encoding:NSUTF8StringEncoding];
+            break;
+        case BAUserAttributeTypeURL:
+            objcValue = [NSURL
+                URLWithString:[NSString stringWithCString:(const char *)sqlite3_column_text(statement, valueColumn)
+                                                 encoding:NSUTF8StringEncoding]];
+            break;
+        default:
+            return nil;
+    }
+
+    if (!objcValue) {
+        return nil;
+    }
+
+    return [BAUserAttribute attributeWithValue:objcValue type:type];
+}
+
+// Reads a journal entry from a (version, operation, name, type, value, changeset) row
+static BAUserDataJournalEntry *BAUserDataJournalEntryFromStatement(sqlite3_stmt *statement) {
+    const BAUserDataJournalOperation operation = (const int)sqlite3_column_int(statement, 1);
+    const char *name = (const char *)sqlite3_column_text(statement, 2);
+    if (name == NULL) {
+        return nil;
+    }
+
+    BAUserAttribute *attribute = nil;
+    NSString *tag = nil;
+
+    switch (operation) {
+        case BAUserDataJournalOperationAttributeSet:
+        case BAUserDataJournalOperationAttributeRemoved:
+            attribute = BAUserAttributeFromStatement(statement, 3, 4);
+            if (attribute == nil) {
+                return nil;
+            }
+            break;
+        case BAUserDataJournalOperationTagAdded:
+        case BAUserDataJournalOperationTagRemoved: {
+            const char *tagValue = (const char *)sqlite3_column_text(statement, 4);
+            if (tagValue == NULL) {
+                return nil;
+            }
+            tag = [NSString stringWithCString:tagValue encoding:NSUTF8StringEncoding];
+            break;
+        }
+        default:
+            return nil;
+    }
+
+    return [[BAUserDataJournalEntry alloc] initWithVersion:sqlite3_column_int64(statement, 0)
+                                                 changeset:sqlite3_column_int64(statement, 5)
+                                                 operation:operation
+                                                      name:[NSString stringWithCString:name
+                                                                              encoding:NSUTF8StringEncoding]
+                                                 attribute:attribute
+                                                       tag:tag];
+}
+
 @implementation BAUserSQLiteDatasource
 
 + (BAUserSQLiteDatasource *)instance {
@@ -64,6 +164,7 @@
     }
 
     _database = NULL;
+    _readDatabase = NULL;
 
     _attributeInsertStatement = NULL;
     _tagInsertStatement = NULL;
@@ -71,6 +172,15 @@
     _attributeDeleteStatement = NULL;
     _tagDeleteStatement = NULL;
 
+    _journalInsertStatement = NULL;
+    _journalAttributeReplacedStatement = NULL;
+    _journalAttributeRemovedStatement = NULL;
+    _journalTagCollectionRemovedStatement = NULL;
+
+    _attributesSelectStatement = NULL;
+    _tagCollectionsSelectStatement = NULL;
+    _journalSelectStatement = NULL;
+
     _currentChangeset = 0;
     _transactionOccuring = NO;
 
@@ -100,7 +210,9 @@
         return nil;
     }
 
-    // Create the three tables with it.
+    BOOL writeAheadLogEnabled = [self enableWriteAheadLog];
+
+    // Create the tables with it.
     // See the header for a human readable schema.
 
     if (![self executeSimpleStatement:@"BEGIN;"]) {
@@ -121,7 +233,15 @@
                                              @"null, changeset integer, unique(collection, value) on conflict abort);",
                                              TABLE_TAGS]];
 
-    if (!attributesCreated || !tagsCreated) {
+    // The journal is append-only: the version is never reused, even once older entries have been pruned
+    BOOL journalCreated = [self
+        executeSimpleStatement:[NSString stringWithFormat:@"create table if not exists %@ (version integer primary key "
+                                                          @"autoincrement, changeset integer not null, operation "
+                                                          @"integer not null, name text not null, type integer, "
+                                                          @"value text);",
+                                                          TABLE_JOURNAL]];
+
+    if (!attributesCreated || !tagsCreated || !journalCreated) {
         [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while creating tables"];
         return nil;
     }
@@ -181,9 +301,136 @@
         return nil;
     }
 
+    if (![self prepareJournalStatements]) {
+        return nil;
+    }
+
+    // Readers get their own connection once the tables exist, as it cannot create them
+    _readDatabase = _database;
+    if (writeAheadLogEnabled) {
+        sqlite3 *readDatabase = NULL;
+        if (sqlite3_open_v2([dbPath cStringUsingEncoding:NSUTF8StringEncoding], &readDatabase,
+                            SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, NULL) == SQLITE_OK) {
+            _readDatabase = readDatabase;
+        } else {
+            [BALogger debugForDomain:LOGGER_DOMAIN
+                             message:@"Could not open the read-only connection, reads will share the write one."];
+            sqlite3_close(readDatabase);
+        }
+    }
+
+    if (![self prepareReaderStatements]) {
+        return nil;
+    }
+
     return self;
 }
 
+// Switches the database to the write-ahead log, which lets readers see the last committed data
+// while a transaction is being written, instead of being blocked by it.
+// The journal mode is persistent, so this only does actual work the first time.
+- (BOOL)enableWriteAheadLog {
+    sqlite3_stmt *statement;
+    if (sqlite3_prepare_v2(_database, "PRAGMA journal_mode=WAL;", -1, &statement, NULL) != SQLITE_OK) {
+        return NO;
+    }
+
+    BOOL enabled = NO;
+    if (sqlite3_step(statement) == SQLITE_ROW) {
+        const char *mode = (const char *)sqlite3_column_text(statement, 0);
+        enabled = mode != NULL && sqlite3_stricmp(mode, "wal") == 0;
+    }
+    sqlite3_finalize(statement);
+
+    if (!enabled) {
+        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Could not enable the write-ahead log."];
+    }
+    return enabled;
+}
+
+- (BOOL)prepareReaderStatements {
+    NSString *statement = [NSString stringWithFormat:@"SELECT name, type, value FROM %@", TABLE_ATTRIBUTES];
+
+    if (sqlite3_prepare_v2(_readDatabase, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_attributesSelectStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while preparing the attributes select statement."];
+        return NO;
+    }
+
+    statement = [NSString stringWithFormat:@"SELECT collection, value FROM %@ ORDER BY collection", TABLE_TAGS];
+
+    if (sqlite3_prepare_v2(_readDatabase, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_tagCollectionsSelectStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while preparing the tags select statement."];
+        return NO;
+    }
+
+    // The journal is read by the writer, while its changeset may still be in progress:
+    // this one has to use the write connection.
+    statement = [NSString stringWithFormat:@"SELECT version, operation, name, type, value, changeset FROM %@ WHERE "
+                                           @"changeset > ? AND changeset <= ? ORDER BY version",
+                                           TABLE_JOURNAL];
+
+    if (sqlite3_prepare_v2(_database, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_journalSelectStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while preparing the journal select statement."];
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)prepareJournalStatements {
+    NSString *statement =
+        [NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, value) VALUES (?, ?, ?, ?, ?)",
+                                   TABLE_JOURNAL];
+
+    if (sqlite3_prepare_v2(_database, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_journalInsertStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN
+                         message:@"Error while preparing the journal insert statement, not persisting data."];
+        return NO;
+    }
+
+    // Snapshots the previous value of an attribute, unless it is about to be overwritten with the same value
+    statement = [NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, value) SELECT ?, %d, "
+                                           @"name, type, value FROM %@ WHERE name=? AND NOT (type=? AND value=?)",
+                                           TABLE_JOURNAL, BAUserDataJournalOperationAttributeRemoved,
+                                           TABLE_ATTRIBUTES];
+
+    if (sqlite3_prepare_v2(_database, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_journalAttributeReplacedStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN
+                         message:@"Error while preparing the journal replace statement, not persisting data."];
+        return NO;
+    }
+
+    statement = [NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, value) SELECT ?, %d, "
+                                           @"name, type, value FROM %@ WHERE name=?",
+                                           TABLE_JOURNAL, BAUserDataJournalOperationAttributeRemoved,
+                                           TABLE_ATTRIBUTES];
+
+    if (sqlite3_prepare_v2(_database, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_journalAttributeRemovedStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN
+                         message:@"Error while preparing the journal remove statement, not persisting data."];
+        return NO;
+    }
+
+    statement = [NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, value) SELECT ?, %d, "
+                                           @"collection, NULL, value FROM %@ WHERE collection=?",
+                                           TABLE_JOURNAL, BAUserDataJournalOperationTagRemoved, TABLE_TAGS];
+
+    if (sqlite3_prepare_v2(_database, [statement cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                           &_journalTagCollectionRemovedStatement, NULL) != SQLITE_OK) {
+        [BALogger errorForDomain:LOGGER_DOMAIN
+                         message:@"Error while preparing the journal collection statement, not persisting data."];
+        return NO;
+    }
+
+    return YES;
+}
+
 - (void)close {
     if (_transactionOccuring) {
         [self rollbackTransaction];
@@ -194,6 +441,7 @@
     if (!_transactionOccuring) {
         [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@;", TABLE_ATTRIBUTES]];
         [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@;", TABLE_TAGS]];
+        [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@;", TABLE_JOURNAL]];
     }
 }
 
@@ -321,6 +569,14 @@
     if (!_transactionOccuring || !_currentChangeset)
         return NO;
 
+    if (![self executeSimpleStatement:[NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, "
+                                                                 @"value) SELECT %lld, %d, collection, NULL, value "
+                                                                 @"FROM %@;",
+                                                                 TABLE_JOURNAL, _currentChangeset,
+                                                                 BAUserDataJournalOperationTagRemoved, TABLE_TAGS]]) {
+        return NO;
+    }
+
     return [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@;", TABLE_TAGS]];
 }
 
@@ -328,6 +584,20 @@
     if (!_transactionOccuring || !_tagCollectionDeleteStatement || !_currentChangeset || !collection)
         return NO;
 
+    sqlite3_clear_bindings(_journalTagCollectionRemovedStatement);
+
+    sqlite3_bind_int64(_journalTagCollectionRemovedStatement, 1, _currentChangeset);
+    sqlite3_bind_text(_journalTagCollectionRemovedStatement, 2, [collection cStringUsingEncoding:NSUTF8StringEncoding],
+                      -1, NULL);
+
+    int journalResult = sqlite3_step(_journalTagCollectionRemovedStatement);
+    sqlite3_reset(_journalTagCollectionRemovedStatement);
+
+    if (journalResult != SQLITE_DONE) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while journaling tag collection %@.", collection];
+        return NO;
+    }
+
     sqlite3_clear_bindings(_tagCollectionDeleteStatement);
 
     sqlite3_bind_text(_tagCollectionDeleteStatement, 1, [collection cStringUsingEncoding:NSUTF8StringEncoding], -1,
@@ -348,6 +618,14 @@
     if (!_transactionOccuring || !_currentChangeset)
         return NO;
 
+    if (![self executeSimpleStatement:[NSString stringWithFormat:@"INSERT INTO %@ (changeset, operation, name, type, "
+                                                                 @"value) SELECT %lld, %d, name, type, value FROM %@;",
+                                                                 TABLE_JOURNAL, _currentChangeset,
+                                                                 BAUserDataJournalOperationAttributeRemoved,
+                                                                 TABLE_ATTRIBUTES]]) {
+        return NO;
+    }
+
     return [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@;", TABLE_ATTRIBUTES]];
 }
 
@@ -355,72 +633,38 @@
 
 - (nonnull NSDictionary<NSString *, BAUserAttribute *> *)attributes;
 {
-    NSString *selectSQL = [NSString stringWithFormat:@"SELECT name, type, value FROM %@", TABLE_ATTRIBUTES];
-
-    sqlite3_stmt *statement;
-
     NSMutableDictionary<NSString *, BAUserAttribute *> *attributes = [NSMutableDictionary new];
 
-    if (sqlite3_prepare_v2(self->_database, [selectSQL cStringUsingEncoding:NSUTF8StringEncoding], -1, &statement,
-                           NULL) == SQLITE_OK) {
+    @synchronized(self) {
+        sqlite3_stmt *statement = _attributesSelectStatement;
+
         while (sqlite3_step(statement) == SQLITE_ROW) {
             const char *name = (const char *)sqlite3_column_text(statement, 0);
-            const BAUserAttributeType type = (const int)sqlite3_column_int(statement, 1);
-
-            id objcValue = nil;
-
-            switch (type) {
-                case BAUserAttributeTypeBool:
-                    objcValue = [NSNumber numberWithBool:(sqlite3_column_int(statement, 2) ? YES : NO)];
-                    break;
-                case BAUserAttributeTypeDouble:
-                    objcValue = [NSNumber numberWithDouble:sqlite3_column_double(statement, 2)];
-                    break;
-                case BAUserAttributeTypeLongLong:
-                    objcValue = [NSNumber numberWithLongLong:sqlite3_column_int64(statement, 2)];
-                    break;
-                case BAUserAttributeTypeDate:
-                    objcValue = [NSDate dateWithTimeIntervalSince1970:sqlite3_column_double(statement, 2)];
-                    break;
-                case BAUserAttributeTypeString:
-                    objcValue = [NSString stringWithCString:(const char *)sqlite3_column_text(statement, 2)
-                                                   encoding:NSUTF8StringEncoding];
-                    break;
-                case BAUserAttributeTypeURL:
-                    objcValue =
-                        [NSURL URLWithString:[NSString stringWithCString:(const char *)sqlite3_column_text(statement, 2)
-                                                                encoding:NSUTF8StringEncoding]];
-                    break;
-                default:
-                    continue;
-            }
 
-            if (!objcValue) {
+            BAUserAttribute *attribute = BAUserAttributeFromStatement(statement, 1, 2);
+            if (attribute == nil) {
                 continue;
             }
 
             NSString *nameString = [NSString stringWithCString:name encoding:NSUTF8StringEncoding];
             if (nameString != nil) {
-                [attributes setObject:[BAUserAttribute attributeWithValue:objcValue type:type] forKey:nameString];
+                [attributes setObject:attribute forKey:nameString];
             }
         }
 
-        sqlite3_finalize(statement);
+        // Resetting ends the read transaction, so that the reader doesn't hold on an old snapshot
+        sqlite3_reset(statement);
     }
 
     return attributes;
 }
 
 - (nonnull NSDictionary<NSString *, NSSet<NSString *> *> *)tagCollections {
-    NSString *selectSQL =
-        [NSString stringWithFormat:@"SELECT collection, value FROM %@ ORDER BY collection", TABLE_TAGS];
-
-    sqlite3_stmt *statement;
-
     NSMutableDictionary<NSString *, NSSet<NSString *> *> *tagCollections = [NSMutableDictionary new];
 
-    if (sqlite3_prepare_v2(self->_database, [selectSQL cStringUsingEncoding:NSUTF8StringEncoding], -1, &statement,
-                           NULL) == SQLITE_OK) {
+    @synchronized(self) {
+        sqlite3_stmt *statement = _tagCollectionsSelectStatement;
+
         NSString *currentCollection = nil;
         NSMutableSet<NSString *> *currentTags = nil;
 
@@ -449,12 +693,43 @@
             [tagCollections setObject:currentTags forKey:currentCollection];
         }
 
-        sqlite3_finalize(statement);
+        sqlite3_reset(statement);
     }
 
     return tagCollections;
 }
 
+#pragma mark Journal methods
+
+- (nonnull NSArray<BAUserDataJournalEntry *> *)journalEntriesAfterChangeset:(long long)baseChangeset
+                                                              upToChangeset:(long long)changeset {
+    NSMutableArray<BAUserDataJournalEntry *> *entries = [NSMutableArray new];
+
+    @synchronized(self) {
+        sqlite3_stmt *statement = _journalSelectStatement;
+
+        sqlite3_clear_bindings(statement);
+        sqlite3_bind_int64(statement, 1, baseChangeset);
+        sqlite3_bind_int64(statement, 2, changeset);
+
+        while (sqlite3_step(statement) == SQLITE_ROW) {
+            BAUserDataJournalEntry *entry = BAUserDataJournalEntryFromStatement(statement);
+            if (entry != nil) {
+                [entries addObject:entry];
+            }
+        }
+
+        sqlite3_reset(statement);
+    }
+
+    return entries;
+}
+
+- (BOOL)pruneJournalUpToChangeset:(long long)changeset {
+    return [self executeSimpleStatement:[NSString stringWithFormat:@"DELETE FROM %@ WHERE changeset <= %lld;",
+                                                                   TABLE_JOURNAL, changeset]];
+}
+
 #pragma mark Debug
 
 - (NSString *)printDebugDump {
@@ -487,6 +762,23 @@
 
     key = [(native ? @"n." : @"c.") stringByAppendingString:key];
 
+    // Journal the previous value first, as the insert will replace it
+    sqlite3_clear_bindings(_journalAttributeReplacedStatement);
+
+    sqlite3_bind_int64(_journalAttributeReplacedStatement, 1, _currentChangeset);
+    sqlite3_bind_text(_journalAttributeReplacedStatement, 2, [key cStringUsingEncoding:NSUTF8StringEncoding], -1,
+                      NULL);
+    sqlite3_bind_int(_journalAttributeReplacedStatement, 3, type);
+    bindBlock(_journalAttributeReplacedStatement, 4);
+
+    int journalResult = sqlite3_step(_journalAttributeReplacedStatement);
+    sqlite3_reset(_journalAttributeReplacedStatement);
+
+    if (journalResult != SQLITE_DONE) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while journaling custom attribute update."];
+        return NO;
+    }
+
     sqlite3_clear_bindings(_attributeInsertStatement);
 
     sqlite3_bind_text(_attributeInsertStatement, 1, [key cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL); // name
@@ -498,12 +790,20 @@
     int result = sqlite3_step(_attributeInsertStatement);
     sqlite3_reset(_attributeInsertStatement);
 
-    if (result != SQLITE_DONE && result != SQLITE_CONSTRAINT) {
+    if (result == SQLITE_CONSTRAINT) {
+        // Same value: nothing changed, nothing to journal
+        return YES;
+    }
+
+    if (result != SQLITE_DONE) {
         [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while setting custom attribute to sqlite."];
         return NO;
     }
 
-    return YES;
+    return [self journalOperation:BAUserDataJournalOperationAttributeSet
+                             name:key
+                             type:type
+                        bindValue:bindBlock];
 }
 
 - (BOOL)deleteAttributeForKey:(NSString *)key isNative:(BOOL)native {
@@ -512,6 +812,19 @@
 
     key = [(native ? @"n." : @"c.") stringByAppendingString:key];
 
+    sqlite3_clear_bindings(_journalAttributeRemovedStatement);
+
+    sqlite3_bind_int64(_journalAttributeRemovedStatement, 1, _currentChangeset);
+    sqlite3_bind_text(_journalAttributeRemovedStatement, 2, [key cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL);
+
+    int journalResult = sqlite3_step(_journalAttributeRemovedStatement);
+    sqlite3_reset(_journalAttributeRemovedStatement);
+
+    if (journalResult != SQLITE_DONE) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while journaling custom attribute removal."];
+        return NO;
+    }
+
     sqlite3_clear_bindings(_attributeDeleteStatement);
 
     sqlite3_bind_text(_attributeDeleteStatement, 1, [key cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL); // name
@@ -540,12 +853,17 @@
     int result = sqlite3_step(_tagInsertStatement);
     sqlite3_reset(_tagInsertStatement);
 
-    if (result != SQLITE_DONE && result != SQLITE_CONSTRAINT) {
+    if (result == SQLITE_CONSTRAINT) {
+        // Tag is already in the collection
+        return YES;
+    }
+
+    if (result != SQLITE_DONE) {
         [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while adding a custom tag to sqlite."];
         return NO;
     }
 
-    return YES;
+    return [self journalOperation:BAUserDataJournalOperationTagAdded name:collection tag:tag];
 }
 
 - (BOOL)_removeTag:(NSString *)tag fromCollection:(NSString *)collection {
@@ -565,6 +883,54 @@
         return NO;
     }
 
+    if (sqlite3_changes(_database) == 0) {
+        // Tag wasn't in the collection
+        return YES;
+    }
+
+    return [self journalOperation:BAUserDataJournalOperationTagRemoved name:collection tag:tag];
+}
+
+- (BOOL)journalOperation:(BAUserDataJournalOperation)operation
+                    name:(NSString *)name
+                    type:(BAUserAttributeType)type
+               bindValue:(void (^)(sqlite3_stmt *statement, int columnNumber))bindBlock {
+    sqlite3_clear_bindings(_journalInsertStatement);
+
+    sqlite3_bind_int64(_journalInsertStatement, 1, _currentChangeset);
+    sqlite3_bind_int(_journalInsertStatement, 2, operation);
+    sqlite3_bind_text(_journalInsertStatement, 3, [name cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL);
+    sqlite3_bind_int(_journalInsertStatement, 4, type);
+    bindBlock(_journalInsertStatement, 5);
+
+    int result = sqlite3_step(_journalInsertStatement);
+    sqlite3_reset(_journalInsertStatement);
+
+    if (result != SQLITE_DONE) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while writing to the user data journal."];
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)journalOperation:(BAUserDataJournalOperation)operation name:(NSString *)collection tag:(NSString *)tag {
+    sqlite3_clear_bindings(_journalInsertStatement);
+
+    sqlite3_bind_int64(_journalInsertStatement, 1, _currentChangeset);
+    sqlite3_bind_int(_journalInsertStatement, 2, operation);
+    sqlite3_bind_text(_journalInsertStatement, 3, [collection cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL);
+    sqlite3_bind_null(_journalInsertStatement, 4);
+    sqlite3_bind_text(_journalInsertStatement, 5, [tag cStringUsingEncoding:NSUTF8StringEncoding], -1, NULL);
+
+    int result = sqlite3_step(_journalInsertStatement);
+    sqlite3_reset(_journalInsertStatement);
+
+    if (result != SQLITE_DONE) {
+        [BALogger errorForDomain:LOGGER_DOMAIN message:@"Error while writing to the user data journal."];
+        return NO;
+    }
+
     return YES;
 }
 
@@ -12,6 +12,7 @@
 #import <Batch/BAWSQueryPushToken.h>
 #import <Batch/BAWSQuery.h>
 #import <Batch/BAWSQueryAttributes.h>
+#import <Batch/BAWSQueryAttributesDelta.h>
 #import <Batch/BAWSQueryTracking.h>
 #import <Batch/BAWSResponseAttributesCheck.h>
 #import <Batch/BAWSResponseAttributes.h>
@@ -81,11 +82,16 @@
 #import <Batch/BALocalCampaignOutputProtocol.h>
 #import <Batch/BAMetricWebserviceClient.h>
 #import <Batch/BAMetricManager.h>
+#import <Batch/BAMetricExporter.h>
 #import <Batch/BACounter.h>
 #import <Batch/BAMetricRegistry.h>
 #import <Batch/BAObservation.h>
 #import <Batch/BAMetric.h>
 #import <Batch/BAMetricProtocol.h>
+#import <Batch/BAHistogram.h>
+#import <Batch/BASampleBuffer.h>
+#import <Batch/BAAtomicCounter.h>
+#import <Batch/BAMetricLabelSet.h>
 #import <Batch/BAInbox.h>
 #import <Batch/BAInboxDatasourceProtocol.h>
 #import <Batch/BAInboxFetchWebserviceClient.h>
@@ -124,6 +130,7 @@
 #import <Batch/BAInstallDataEditor.h>
 #import <Batch/BAUserAttribute.h>
 #import <Batch/BAUserDataDiff.h>
+#import <Batch/BAUserDataJournal.h>
 #import <Batch/BAUserDatasourceProtocol.h>
 #import <Batch/BAUserCenter.h>
 #import <Batch/BAUserSQLiteDatasource.h>
@@ -149,19 +156,27 @@
 #import <Batch/BAMSGImageViewController.h>
 #import <Batch/BAMSGAction.h>
 #import <Batch/BATHtmlParser.h>
+#import <Batch/BATAttributedTextBuilder.h>
 #import <Batch/BAMSGPayloadParser.h>
 #import <Batch/BACSSImportProvider.h>
 #import <Batch/BACSSToken.h>
 #import <Batch/BACSSBuiltinImportProvider.h>
 #import <Batch/BACSS.h>
 #import <Batch/BACSSParser.h>
+#import <Batch/BACSSSelectorIndex.h>
+#import <Batch/BACSSTokenizer.h>
+#import <Batch/BACSSDocumentCache.h>
 #import <Batch/BATWebviewUtils.h>
 #import <Batch/BATWebviewBridgeLegacyWKHandler.h>
 #import <Batch/BATWebviewJavascriptBridge.h>
 #import <Batch/BATWebviewBridgeWKHandler.h>
 #import <Batch/BAMessagingAnalyticsDelegate.h>
 #import <Batch/BAMSGOverlayWindow.h>
+#import <Batch/BAMSGImageCache.h>
+#import <Batch/BAMSGImageDecoder.h>
 #import <Batch/BAMSGImageDownloader.h>
+#import <Batch/BAMSGImagePipeline.h>
+#import <Batch/BAMSGAssetPrefetcher.h>
 #import <Batch/BAMSGCTA.h>
 #import <Batch/BABatchMessagingDelegateWrapper.h>
 #import <Batch/BAMessagingAnalyticsDeduplicatingDelegate.h>
@@ -180,12 +195,14 @@
 #import <Batch/BAMSGPannableContainerView.h>
 #import <Batch/BAMSGButton.h>
 #import <Batch/BAMSGStylableView.h>
+#import <Batch/BAMSGStyle.h>
 #import <Batch/BAMSGImageView.h>
 #import <Batch/BAMSGRemoteImageView.h>
 #import <Batch/BABatchInAppDelegateWrapper.h>
 #import <Batch/BATMessagingCloseErrorCause.h>
 #import <Batch/BATGIFFile.h>
 #import <Batch/BATGIFAnimator.h>
+#import <Batch/BATGIFFrameCache.h>
 #import <Batch/BAOptOut.h>
 #import <Batch/BAOptOutEventTracker.h>
 #import <Batch/BAOptOutWebserviceClient.h>
@@ -198,12 +215,15 @@
 #import <Batch/BADBGIdentifiersViewController.h>
 #import <Batch/BADBGModule.h>
 #import <Batch/BADBGLocalCampaignsViewController.h>
+#import <Batch/BADBGLogsViewController.h>
 #import <Batch/BADBGNameValueListItem.h>
 #import <Batch/BASHA.h>
 #import <Batch/BAAESB64Cryptor.h>
 #import <Batch/BAEncryptionProtocol.h>
 #import <Batch/BALogger.h>
 #import <Batch/BALoggerUnified.h>
+#import <Batch/BALogRingBuffer.h>
+#import <Batch/BAAsyncLogger.h>
 #import <Batch/BALoggerProtocol.h>
 #import <Batch/BATZAwareDate.h>
 #import <Batch/BASystemDateProvider.h>
@@ -222,6 +242,9 @@
 #import <Batch/BAInjectable.h>
 #import <Batch/BAPromise.h>
 #import <Batch/BATaskDebouncer.h>
+#import <Batch/BATaskBackoff.h>
+#import <Batch/BATaskThrottler.h>
+#import <Batch/BATimerWheel.h>
 #import <Batch/BAConcurrentQueue.h>
 #import <Batch/BAReachabilityHelper.h>
 #import <Batch/BAReachability.h>
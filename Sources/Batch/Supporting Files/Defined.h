@@ -85,6 +85,8 @@
 #define kParametersUserProfileDataVersionKey @"user_profile.data.version"
 #define kParametersUserProfileTransactionIDKey @"user_profile.trid"
 #define kParametersUserProfileDBVersion @"user_profile.db.version"
+#define kParametersUserProfileSyncedVersionKey @"user_profile.synced.version"
+#define kParametersUserProfileDeltaSupportedKey @"user_profile.delta.supported"
 #define kParametersUserStartCheckInitialDelay @1000
 
 #define kParametersInAppTrackerDBVersion @"messaging.inapp.db.version"
@@ -107,6 +109,7 @@
 #define kQueryWebserviceTypeTracking @"TRACKING"
 #define kQueryWebserviceTypeAttributes @"ATTRIBUTES"
 #define kQueryWebserviceTypeAttributesCheck @"ATTRIBUTES_CHECK"
+#define kQueryWebserviceTypeAttributesDelta @"ATTRIBUTES_DELTA"
 #define kQueryWebserviceTypeLocalCampaigns @"LOCAL_CAMPAIGNS"
 
 #define kWebserviceKeyMainHeader @"header"
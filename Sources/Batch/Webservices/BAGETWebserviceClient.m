@@ -28,7 +28,7 @@
     if (self) {
         _identifier = [identifier copy];
 
-        [BALogger debugForDomain:@"Webservice" message:@"GET URL: %@", url.absoluteString];
+        BALogDebug(@"Webservice", @"GET URL: %@", url.absoluteString);
 
         [self setTimeout:DEFAULT_GET_TIMEOUT];
     }
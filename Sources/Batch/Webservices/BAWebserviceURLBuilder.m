@@ -31,8 +31,7 @@
                                shortname:(nonnull NSString *)shortname
                                   apiKey:(nonnull NSString *)apiKey {
     if ([BANullHelper isStringEmpty:apiKey]) {
-        [BALogger debugForDomain:@"WebserviceURLBuilder"
-                         message:@"Tried to call a webservice with a nil or empty API Key. Aborting."];
+        BALogDebug(@"WebserviceURLBuilder", @"Tried to call a webservice with a nil or empty API Key. Aborting.");
         return nil;
     }
 
@@ -117,9 +117,9 @@
 // Start the query asynchronously.
 - (void)start {
     if ([[BAOptOut instance] isOptedOut] && !self.canBypassOptOut) {
-        [BALogger debugForDomain:@"BAConnection"
-                         message:@"Refusing to execute webservice client, as Batch is opted-out from, and webservice "
-                                 @"isn't whitelisted"];
+        BALogDebug(@"BAConnection",
+                   @"Refusing to execute webservice client, as Batch is opted-out from, and webservice "
+                   @"isn't whitelisted");
 
         dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
           [self.delegate connectionDidFinishSuccessfully:NO];
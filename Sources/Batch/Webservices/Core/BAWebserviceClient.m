@@ -53,8 +53,7 @@
     self = [super init];
     if (self) {
         if (url == nil) {
-            [BALogger debugForDomain:NETWORKING_ERROR_DOMAIN
-                             message:@"Could not instanciate Webservice Client: URL is nil"];
+            BALogDebug(NETWORKING_ERROR_DOMAIN, @"Could not instanciate Webservice Client: URL is nil");
             return nil;
         }
 
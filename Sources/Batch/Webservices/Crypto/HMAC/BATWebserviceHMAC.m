@@ -39,7 +39,7 @@
     NSURL *url = request.URL;
 
     if (url == nil) {
-        [BALogger debugForDomain:DEBUG_DOMAIN message:@"Cannot append to request: nil URL"];
+        BALogDebug(DEBUG_DOMAIN, @"Cannot append to request: nil URL");
         return;
     }
 
@@ -48,7 +48,7 @@
                                  headers:request.allHTTPHeaderFields];
 
     if ([BANullHelper isStringEmpty:hmac]) {
-        [BALogger debugForDomain:DEBUG_DOMAIN message:@"Cannot append to request: nil or empty computed hmac"];
+        BALogDebug(DEBUG_DOMAIN, @"Cannot append to request: nil or empty computed hmac");
         return;
     }
 
@@ -182,7 +182,7 @@
                                    userInfo:nil] raise];
         }
     } @catch (NSException *exception) {
-        [BALogger debugForDomain:LOGGER_DOMAIN message:@"Error webservice: %@", [exception description]];
+        BALogDebug(LOGGER_DOMAIN, @"Error webservice: %@", [exception description]);
         NSMutableDictionary *info = [NSMutableDictionary dictionary];
         [info setValue:exception.name forKey:@"ExceptionName"];
         [info setValue:exception.reason forKey:@"ExceptionReason"];
@@ -220,8 +220,7 @@
                                                  allowNil:NO
                                                     error:&err];
     if (eligibleCampaignsObject == nil || err != nil) {
-        [BALogger debugForDomain:LOGGER_DOMAIN
-                         message:@"Could not fetch eligibleCampaigns: %@", [err localizedDescription]];
+        BALogDebug(LOGGER_DOMAIN, @"Could not fetch eligibleCampaigns: %@", [err localizedDescription]);
 
         // Check if server respond with RetryAfter
         _errorHandler(err, [self retryAfter:err]);
@@ -243,7 +242,7 @@
     if (error == nil || _errorHandler == nil) {
         return;
     }
-    [BALogger debugForDomain:LOGGER_DOMAIN message:@"Failure - %@", [error localizedDescription]];
+    BALogDebug(LOGGER_DOMAIN, @"Failure - %@", [error localizedDescription]);
 
     _errorHandler(error, [self retryAfter:error]);
 }
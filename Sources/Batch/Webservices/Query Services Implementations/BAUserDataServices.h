@@ -21,8 +21,24 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/// Sends only the changes made since a version the server acknowledged, rather than the full snapshot.
+@interface BAUserDataDeltaSendServiceDatasource : NSObject <BAQueryWebserviceClientDatasource>
+
+- (instancetype)initWithVersion:(long long)version
+                    baseVersion:(long long)baseVersion
+                          added:(nonnull NSDictionary *)added
+                        removed:(nonnull NSDictionary *)removed;
+
+@end
+
+/// Handles both full and delta send responses
 @interface BAUserDataSendServiceDelegate : NSObject <BAQueryWebserviceClientDelegate>
 
+- (instancetype)initWithDeltaSend:(BOOL)deltaSend;
+
+/// Whether the handled send is a delta: if it fails, a full snapshot is sent instead
+@property (readonly) BOOL deltaSend;
+
 @end
 
 @interface BAUserDataCheckServiceDatasource : NSObject <BAQueryWebserviceClientDatasource>
@@ -15,6 +15,7 @@
 #import <Batch/BAUserDataManager.h>
 #import <Batch/BAWSQueryAttributes.h>
 #import <Batch/BAWSQueryAttributesCheck.h>
+#import <Batch/BAWSQueryAttributesDelta.h>
 #import <Batch/BAWSResponseAttributes.h>
 #import <Batch/BAWSResponseAttributesCheck.h>
 #import <Batch/BAWebserviceURLBuilder.h>
@@ -74,10 +75,74 @@
 
 @end
 
+@interface BAUserDataDeltaSendServiceDatasource ()
+
+@property long long version;
+@property long long baseVersion;
+@property (nonnull) NSDictionary *added;
+@property (nonnull) NSDictionary *removed;
+
+@end
+
+@implementation BAUserDataDeltaSendServiceDatasource : NSObject
+
+- (instancetype)initWithVersion:(long long)version
+                    baseVersion:(long long)baseVersion
+                          added:(nonnull NSDictionary *)added
+                        removed:(nonnull NSDictionary *)removed {
+    self = [super init];
+    if (self) {
+        _version = version;
+        _baseVersion = baseVersion;
+        _added = added;
+        _removed = removed;
+    }
+    return self;
+}
+
+- (NSURL *)requestURL {
+    NSString *host = [[BAInjection injectProtocol:@protocol(BADomainManagerProtocol)] urlFor:BADomainServiceWeb
+                                                                        overrideWithOriginal:FALSE];
+    return [BAWebserviceURLBuilder webserviceURLForHost:host shortname:self.requestShortIdentifier];
+}
+
+- (NSString *)requestIdentifier {
+    return @"attributesDeltaSend";
+}
+
+- (NSString *)requestShortIdentifier {
+    return kParametersAttributesSendWebserviceShortname;
+}
+
+- (NSArray<id<BAWSQuery>> *)queriesToSend {
+    BAWSQueryAttributesDelta *query = [[BAWSQueryAttributesDelta alloc] initWithVersion:self.version
+                                                                            baseVersion:self.baseVersion
+                                                                                  added:self.added
+                                                                                removed:self.removed];
+    return @[ query ];
+}
+
+- (nullable BAWSResponse *)responseForQuery:(BAWSQuery *)query content:(NSDictionary *)content {
+    if ([query isKindOfClass:[BAWSQueryAttributesDelta class]]) {
+        return [[BAWSResponseAttributes alloc] initWithResponse:content];
+    }
+    return nil;
+}
+
+@end
+
 @implementation BAUserDataSendServiceDelegate : NSObject
 
+- (instancetype)initWithDeltaSend:(BOOL)deltaSend {
+    self = [super init];
+    if (self) {
+        _deltaSend = deltaSend;
+    }
+    return self;
+}
+
 - (void)webserviceClient:(BAQueryWebserviceClient *)client didFailWithError:(NSError *)error {
-    // TODO: backoff on the send
+    [BAUserDataManager attributesSendDidFailWithDeltaSend:self.deltaSend];
 }
 
 - (void)webserviceClient:(BAQueryWebserviceClient *)client
@@ -85,7 +150,14 @@
     for (BAWSResponse *response in responses) {
         if ([response isKindOfClass:[BAWSResponseAttributes class]]) {
             BAWSResponseAttributes *castedResponse = (BAWSResponseAttributes *)response;
-            [BAUserDataManager storeTransactionID:castedResponse.transactionID forVersion:castedResponse.version];
+            if (castedResponse.resyncRequired) {
+                // The server's data diverged from the delta's base version
+                [BAUserDataManager startFullAttributesSendWSWithDelay:0];
+            } else {
+                [BAUserDataManager setDeltaSendSupported:castedResponse.deltaSupported];
+                [BAUserDataManager storeTransactionID:castedResponse.transactionID
+                                           forVersion:castedResponse.version];
+            }
             if (castedResponse.projectKey != nil) {
                 NSString *oldProjectKey = [BAParameter objectForKey:kParametersProjectKey fallback:nil];
                 if (![castedResponse.projectKey isEqualToString:oldProjectKey]) {
@@ -98,6 +170,8 @@
             }
         }
     }
+
+    [BAUserDataManager attributesSendDidFinish];
 }
 
 @end
@@ -202,7 +276,7 @@
                         timeToWait = 0;
                     }
 
-                    [BAUserDataManager startAttributesSendWSWithDelay:timeToWait];
+                    [BAUserDataManager startFullAttributesSendWSWithDelay:timeToWait];
 
                     break;
                 }
@@ -0,0 +1,39 @@
+//
+//  BAWSQueryAttributesDelta.h
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <Batch/BAWSQuery.h>
+
+/*!
+ @class BAWSQueryAttributesDelta
+ @abstract Query that sends the attributes and tags changes since a version the server already has.
+ @discussion The server applies the changes only if its data version matches the base version. Otherwise, it asks for a
+ full resync.
+ */
+@interface BAWSQueryAttributesDelta : BAWSQuery <BAWSQuery>
+
+/*!
+ @method init
+ @warning Never call this method.
+ */
+- (nonnull instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Standard constructor.
+ @param version     :   Data version once the changes are applied
+ @param baseVersion :   Data version the changes apply to
+ @param added       :   Added attributes and tags, in their flat server representation
+ @param removed     :   Removed attributes and tags, in their flat server representation
+ @return Instance or nil.
+ */
+- (nonnull instancetype)initWithVersion:(long long)version
+                            baseVersion:(long long)baseVersion
+                                  added:(nonnull NSDictionary *)added
+                                removed:(nonnull NSDictionary *)removed;
+
+@end
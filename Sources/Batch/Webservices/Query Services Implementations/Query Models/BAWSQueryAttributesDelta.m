@@ -0,0 +1,49 @@
+//
+//  BAWSQueryAttributesDelta.m
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <Batch/BAWSQueryAttributesDelta.h>
+
+@interface BAWSQueryAttributesDelta () {
+    NSDictionary *_added;
+    NSDictionary *_removed;
+    long long _version;
+    long long _baseVersion;
+}
+@end
+
+@implementation BAWSQueryAttributesDelta
+
+// Standard constructor.
+- (id<BAWSQuery>)initWithVersion:(long long)version
+                     baseVersion:(long long)baseVersion
+                           added:(nonnull NSDictionary *)added
+                         removed:(nonnull NSDictionary *)removed {
+    self = [super initWithType:kQueryWebserviceTypeAttributesDelta];
+    if (self) {
+        _added = added;
+        _removed = removed;
+        _version = version;
+        _baseVersion = baseVersion;
+    }
+
+    return self;
+}
+
+// Build the basic object to send to the server as a query.
+- (NSMutableDictionary *)objectToSend;
+{
+    NSMutableDictionary *dictionary = [super objectToSend];
+
+    [dictionary setObject:@(_version) forKey:@"ver"];
+    [dictionary setObject:@(_baseVersion) forKey:@"base_ver"];
+    [dictionary setObject:_added forKey:@"added"];
+    [dictionary setObject:_removed forKey:@"removed"];
+
+    return dictionary;
+}
+
+@end
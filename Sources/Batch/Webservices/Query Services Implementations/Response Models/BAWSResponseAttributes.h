@@ -33,6 +33,19 @@
  */
 @property (readonly) NSNumber *version;
 
+/*!
+ @property resyncRequired
+ @abstract Whether the server refused a delta because its data doesn't match the base version, and wants a full
+ snapshot instead.
+ */
+@property (readonly) BOOL resyncRequired;
+
+/*!
+ @property deltaSupported
+ @abstract Whether the server accepts delta sends. Servers that don't know about them don't send this flag.
+ */
+@property (readonly) BOOL deltaSupported;
+
 /*!
  @property projectKey
  @abstract ProjectKey attached the application
@@ -27,6 +27,12 @@
         _version = nil;
     }
 
+    NSNumber *resync = [response objectForKey:@"resync"];
+    _resyncRequired = [resync isKindOfClass:[NSNumber class]] && [resync boolValue];
+
+    NSNumber *delta = [response objectForKey:@"delta"];
+    _deltaSupported = [delta isKindOfClass:[NSNumber class]] && [delta boolValue];
+
     _projectKey = [response objectForKey:@"project_key"];
     if ([BANullHelper isStringEmpty:_projectKey]) {
         _projectKey = nil;
@@ -0,0 +1,232 @@
+//
+//  promiseTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class promiseTests: XCTestCase {
+    let error = NSError(domain: "tests", code: 1)
+
+    func testSettlesOnce() {
+        let promise = BAPromise<NSString>()
+        XCTAssertEqual(BAPromiseStatus.pending, promise.status)
+
+        promise.resolve("first")
+        promise.reject(error)
+        promise.resolve("second")
+
+        XCTAssertEqual(BAPromiseStatus.resolved, promise.status)
+        XCTAssertResolves("first", promise)
+    }
+
+    func testCallbacksOrder() {
+        let promise = BAPromise<NSString>()
+        var calls: [Int] = []
+        promise.then { _ in calls.append(1) }
+        promise.then { _ in calls.append(2) }
+        promise.catch { _ in XCTFail("Promise should not be rejected") }
+        promise.then { _ in calls.append(3) }
+
+        XCTAssertEqual([], calls)
+        promise.resolve(nil)
+        XCTAssertEqual([1, 2, 3], calls)
+
+        // Settled promises call the blocks synchronously
+        promise.then { _ in calls.append(4) }
+        XCTAssertEqual([1, 2, 3, 4], calls)
+    }
+
+    func testMultipleCatch() {
+        let promise = BAPromise<NSString>()
+        var catchCount = 0
+        promise.catch { _ in catchCount += 1 }
+        promise.catch { err in
+            XCTAssertEqual(self.error, err as NSError?)
+            catchCount += 1
+        }
+        promise.then { _ in XCTFail("Promise should not be resolved") }
+
+        promise.reject(error)
+        XCTAssertEqual(2, catchCount)
+        XCTAssertEqual(BAPromiseStatus.rejected, promise.status)
+    }
+
+    func testQueue() {
+        let queue = DispatchQueue(label: "com.batch.tests.promise")
+        let key = DispatchSpecificKey<Bool>()
+        queue.setSpecific(key: key, value: true)
+
+        let thenExpectation = expectation(description: "Then called on queue")
+        let catchExpectation = expectation(description: "Catch called on queue")
+
+        var called = false
+        queue.sync {
+            BAPromise<NSString>.resolved("value").then({ value in
+                XCTAssertEqual(true, DispatchQueue.getSpecific(key: key))
+                XCTAssertEqual("value", value)
+                called = true
+                thenExpectation.fulfill()
+            }, queue: queue)
+            BAPromise<NSString>.rejected(error).catch({ _ in
+                XCTAssertEqual(true, DispatchQueue.getSpecific(key: key))
+                catchExpectation.fulfill()
+            }, queue: queue)
+
+            // Queued blocks are always asynchronous, even on settled promises
+            XCTAssertFalse(called)
+        }
+        wait(for: [thenExpectation, catchExpectation], timeout: 2)
+    }
+
+    func testMap() {
+        let promise = BAPromise<NSString>()
+        let mapped = promise.map { value in
+            NSNumber(value: (value as String? ?? "").count)
+        }
+        promise.resolve("four")
+        XCTAssertResolves(NSNumber(value: 4), mapped)
+
+        let rejected = BAPromise<NSString>.rejected(error).map { _ in
+            XCTFail("Rejected promises should not be mapped")
+            return nil
+        }
+        XCTAssertEqual(BAPromiseStatus.rejected, rejected.status)
+    }
+
+    func testMapError() {
+        let mappedError = NSError(domain: "tests", code: 2)
+        let promise = BAPromise<NSString>.rejected(error).mapError { err in
+            XCTAssertEqual(self.error, err as NSError?)
+            return mappedError
+        }
+        var caughtError: Error?
+        promise.catch { caughtError = $0 }
+        XCTAssertEqual(mappedError, caughtError as NSError?)
+
+        XCTAssertResolves("value", BAPromise<NSString>.resolved("value").mapError { $0 })
+    }
+
+    func testFlatMap() {
+        let inner = BAPromise<NSObject>()
+        let promise = BAPromise<NSString>.resolved("outer").flatMap { value in
+            XCTAssertEqual("outer", value)
+            return inner
+        }
+        XCTAssertEqual(BAPromiseStatus.pending, promise.status)
+        inner.resolve("inner" as NSString)
+        XCTAssertResolves("inner" as NSString, promise)
+
+        let rejected = BAPromise<NSString>.resolved("outer").flatMap { _ in BAPromise<NSObject>.rejected(self.error) }
+        XCTAssertEqual(BAPromiseStatus.rejected, rejected.status)
+    }
+
+    func testAll() {
+        let first = BAPromise<NSObject>()
+        let second = BAPromise<NSObject>()
+        let all = BAPromise<NSObject>.all([first, BAPromise<NSObject>.resolved(nil), second])
+
+        second.resolve("second" as NSString)
+        XCTAssertEqual(BAPromiseStatus.pending, all.status)
+        first.resolve("first" as NSString)
+
+        var values: [Any]?
+        all.then { values = $0 as? [Any] }
+        XCTAssertEqual(3, values?.count)
+        XCTAssertEqual("first", values?[0] as? String)
+        XCTAssertTrue(values?[1] is NSNull)
+        XCTAssertEqual("second", values?[2] as? String)
+
+        let rejected = BAPromise<NSObject>.all([BAPromise<NSObject>(), BAPromise<NSObject>.rejected(error)])
+        XCTAssertEqual(BAPromiseStatus.rejected, rejected.status)
+
+        XCTAssertEqual(BAPromiseStatus.resolved, BAPromise<NSObject>.all([]).status)
+    }
+
+    func testRace() {
+        let first = BAPromise<NSObject>()
+        let second = BAPromise<NSObject>()
+        let race = BAPromise<NSObject>.race([first, second])
+
+        XCTAssertEqual(BAPromiseStatus.pending, race.status)
+        second.resolve("second" as NSString)
+        first.reject(error)
+        XCTAssertResolves("second" as NSString, race)
+
+        XCTAssertEqual(BAPromiseStatus.pending, BAPromise<NSObject>.race([]).status)
+    }
+
+    // Settles promises while blocks are being registered, from many threads: every block must be called exactly
+    // once, with the value of the single settle that won.
+    func testContention() {
+        let iterations = 500
+        let threads = 8
+        let lock = NSLock()
+
+        for _ in 0..<iterations {
+            let promise = BAPromise<NSNumber>()
+            var calls = 0
+            var settledValues = Set<Int>()
+
+            DispatchQueue.concurrentPerform(iterations: threads * 2) { i in
+                if i % 2 == 0 {
+                    for _ in 0..<10 {
+                        promise.then { value in
+                            lock.lock()
+                            calls += 1
+                            settledValues.insert(value?.intValue ?? -1)
+                            lock.unlock()
+                        }
+                        promise.catch { _ in
+                            lock.lock()
+                            calls += 1
+                            settledValues.insert(-2)
+                            lock.unlock()
+                        }
+                    }
+                } else if i % 4 == 1 {
+                    promise.resolve(NSNumber(value: i))
+                } else {
+                    promise.reject(self.error)
+                }
+            }
+
+            XCTAssertNotEqual(BAPromiseStatus.pending, promise.status)
+            lock.lock()
+            // Only one of each then/catch pair matches the settled status
+            XCTAssertEqual(threads * 10, calls)
+            XCTAssertEqual(1, settledValues.count)
+            lock.unlock()
+        }
+    }
+
+    func testContentionWithQueues() {
+        let promises = (0..<200).map { _ in BAPromise<NSObject>() }
+        let group = DispatchGroup()
+        let queue = DispatchQueue(label: "com.batch.tests.promise.concurrent", attributes: .concurrent)
+        let lock = NSLock()
+        var calls = 0
+
+        DispatchQueue.concurrentPerform(iterations: promises.count) { i in
+            let promise = promises[i]
+            for _ in 0..<5 {
+                group.enter()
+                promise.then({ _ in
+                    lock.lock()
+                    calls += 1
+                    lock.unlock()
+                    group.leave()
+                }, queue: queue)
+            }
+            queue.async { promise.resolve(NSNumber(value: i)) }
+        }
+
+        XCTAssertEqual(.success, group.wait(timeout: .now() + 5))
+        XCTAssertEqual(promises.count * 5, calls)
+        let expected = NSArray(array: (0..<promises.count).map { NSNumber(value: $0) })
+        XCTAssertResolves(expected, BAPromise<NSObject>.all(promises))
+    }
+}
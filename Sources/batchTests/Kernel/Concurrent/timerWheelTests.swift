@@ -0,0 +1,254 @@
+//
+//  timerWheelTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class timerWheelTests: XCTestCase {
+    // 512 slots of 5ms: a revolution lasts 2.56 seconds
+    let wheel = BATimerWheel(tickInterval: 0.005)
+    let queue = DispatchQueue(label: "com.batch.tests.timerwheel")
+
+    func testTimeoutFires() {
+        let expectation = self.expectation(description: "Timeout fired")
+        let start = BAUptimeProvider.uptimeNanoseconds()
+        let timeout = BATimerWheelTimeout(wheel: wheel, queue: queue) {
+            XCTAssertGreaterThanOrEqual(BAUptimeProvider.secondsSince(uptimeNanoseconds: start), 0.1)
+            expectation.fulfill()
+        }
+        timeout.schedule(after: 0.1)
+        XCTAssertTrue(timeout.isScheduled)
+        XCTAssertEqual(1, wheel.pendingCount)
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+        XCTAssertFalse(timeout.isScheduled)
+        XCTAssertEqual(0, wheel.pendingCount)
+    }
+
+    func testZeroDelayRunsRightAway() {
+        // A wheel coarse enough for a tick to be noticed
+        let coarseWheel = BATimerWheel(tickInterval: 10)
+        let expectation = self.expectation(description: "Task ran")
+        let timeout = coarseWheel.dispatch(after: 0, queue: queue) {
+            expectation.fulfill()
+        }
+        XCTAssertFalse(timeout.isScheduled)
+        XCTAssertEqual(0, coarseWheel.pendingCount)
+
+        waitForExpectations(timeout: 1.0, handler: nil)
+    }
+
+    func testEarlierDeadlineRearms() {
+        let farTimeout = BATimerWheelTimeout(wheel: wheel, queue: queue) {
+            XCTFail("Far timeout should not fire")
+        }
+        farTimeout.schedule(after: 10)
+
+        // Scheduled after a far deadline, but has to fire first
+        let expectation = self.expectation(description: "Near timeout fired")
+        wheel.dispatch(after: 0.1, queue: queue) {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 2.0, handler: nil)
+
+        XCTAssertTrue(farTimeout.isScheduled)
+        farTimeout.cancel()
+    }
+
+    func testRescheduleMovesDeadline() {
+        var callCounter = 0
+        let expectation = self.expectation(description: "Timeout fired")
+        let timeout = BATimerWheelTimeout(wheel: wheel, queue: queue) {
+            callCounter += 1
+            expectation.fulfill()
+        }
+        for _ in 0..<100 {
+            timeout.schedule(after: 0.2)
+        }
+        XCTAssertEqual(1, wheel.pendingCount)
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+        // Give a second firing a chance to happen
+        Thread.sleep(forTimeInterval: 0.3)
+        queue.sync {
+            XCTAssertEqual(1, callCounter)
+        }
+    }
+
+    func testCancel() {
+        let timeout = BATimerWheelTimeout(wheel: wheel, queue: queue) {
+            XCTFail("Cancelled timeouts should not fire")
+        }
+        timeout.schedule(after: 0.05)
+        timeout.cancel()
+        XCTAssertFalse(timeout.isScheduled)
+        XCTAssertEqual(0, wheel.pendingCount)
+
+        Thread.sleep(forTimeInterval: 0.2)
+        queue.sync {}
+    }
+
+    func testDeadlinesBeyondARevolution() {
+        let nearExpectation = expectation(description: "Near timeout fired")
+        let farExpectation = expectation(description: "Far timeout fired")
+        let start = BAUptimeProvider.uptimeNanoseconds()
+
+        // 2.56s is a revolution: both timeouts hash to the same slot
+        wheel.dispatch(after: 0.1, queue: queue) {
+            nearExpectation.fulfill()
+        }
+        wheel.dispatch(after: 2.66, queue: queue) {
+            XCTAssertGreaterThanOrEqual(BAUptimeProvider.secondsSince(uptimeNanoseconds: start), 2.66)
+            farExpectation.fulfill()
+        }
+
+        wait(for: [nearExpectation, farExpectation], timeout: 5.0, enforceOrder: true)
+    }
+
+    func testConcurrentScheduling() {
+        let count = 1000
+        let group = DispatchGroup()
+        let timeouts = (0..<count).map { _ -> BATimerWheelTimeout in
+            group.enter()
+            return BATimerWheelTimeout(wheel: wheel, queue: queue) {
+                group.leave()
+            }
+        }
+
+        // Deadlines are far enough for all the scheduling to be done before the first one: each timeout fires once
+        DispatchQueue.concurrentPerform(iterations: count) { i in
+            timeouts[i].schedule(after: 0.5 + Double(i % 50) / 100)
+            timeouts[(i * 7) % count].schedule(after: 0.5)
+            if i % 10 == 0 {
+                timeouts[i].cancel()
+                timeouts[i].schedule(after: 0.6)
+            }
+        }
+
+        XCTAssertEqual(.success, group.wait(timeout: .now() + 5))
+        XCTAssertEqual(0, wheel.pendingCount)
+    }
+
+    func testThrottler() {
+        let lock = NSLock()
+        var runs: [UInt64] = []
+        let throttler = BATaskThrottler(interval: 0.3, queue: queue) {
+            lock.lock()
+            runs.append(BAUptimeProvider.uptimeNanoseconds())
+            lock.unlock()
+        }
+
+        let expectation = self.expectation(description: "Throttled runs done")
+        throttler?.schedule()
+        DispatchQueue.global().asyncAfter(deadline: .now() + 0.1) {
+            // Delayed until an interval after the first run, and merged together
+            throttler?.schedule()
+            throttler?.schedule()
+        }
+        DispatchQueue.global().asyncAfter(deadline: .now() + 1) {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 2.0, handler: nil)
+
+        lock.lock()
+        defer { lock.unlock() }
+        XCTAssertEqual(runs.count, 2)
+        if runs.count == 2 {
+            XCTAssertGreaterThanOrEqual(Double(runs[1] - runs[0]) / Double(NSEC_PER_SEC), 0.3)
+        }
+    }
+
+    func testThrottlerBurst() {
+        let lock = NSLock()
+        var runs = 0
+        let throttler = BATaskThrottler(interval: 0.3, queue: queue) {
+            lock.lock()
+            runs += 1
+            lock.unlock()
+        }
+
+        // The first run isn't delayed: calls made before it starts are merged into it
+        DispatchQueue.concurrentPerform(iterations: 100) { _ in
+            throttler?.schedule()
+        }
+        let expectation = self.expectation(description: "Throttled run done")
+        DispatchQueue.global().asyncAfter(deadline: .now() + 0.2) {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1.0, handler: nil)
+
+        lock.lock()
+        XCTAssertEqual(runs, 1)
+        lock.unlock()
+    }
+
+    func testThrottlerCancel() {
+        let lock = NSLock()
+        var runs = 0
+        let throttler = BATaskThrottler(interval: 0.3, queue: queue) {
+            lock.lock()
+            runs += 1
+            lock.unlock()
+        }
+
+        // Keep the queue busy so that the run dispatched right away can't start before the cancel
+        let semaphore = DispatchSemaphore(value: 0)
+        queue.async { semaphore.wait() }
+        throttler?.schedule()
+        throttler?.cancel()
+        semaphore.signal()
+        queue.sync {}
+
+        lock.lock()
+        XCTAssertEqual(runs, 0)
+        lock.unlock()
+    }
+
+    func testBackoff() {
+        let backoff = BATaskBackoff(initialDelay: 1, maxDelay: 5, queue: queue) {}
+        XCTAssertEqual(1, backoff?.currentDelay)
+        XCTAssertEqual(false, backoff?.isScheduled)
+
+        backoff?.scheduleRetry()
+        XCTAssertEqual(true, backoff?.isScheduled)
+        XCTAssertEqual(2, backoff?.currentDelay)
+        backoff?.scheduleRetry()
+        backoff?.scheduleRetry()
+        XCTAssertEqual(5, backoff?.currentDelay)
+
+        backoff?.cancel()
+        XCTAssertEqual(false, backoff?.isScheduled)
+        XCTAssertEqual(5, backoff?.currentDelay)
+
+        backoff?.scheduleRetry()
+        backoff?.reset()
+        XCTAssertEqual(false, backoff?.isScheduled)
+        XCTAssertEqual(1, backoff?.currentDelay)
+    }
+
+    func testBackoffRuns() {
+        let expectation = self.expectation(description: "Retry ran")
+        let backoff = BATaskBackoff(initialDelay: 0.05, maxDelay: 1, queue: queue) {
+            expectation.fulfill()
+        }
+        backoff?.scheduleRetry()
+        waitForExpectations(timeout: 2.0, handler: nil)
+        XCTAssertEqual(false, backoff?.isScheduled)
+    }
+
+    func testSchedulingPerformance() {
+        let timeouts = (0..<1000).map { _ in BATimerWheelTimeout(wheel: wheel, queue: queue) {} }
+        measure {
+            for _ in 0..<100 {
+                for timeout in timeouts {
+                    timeout.schedule(after: 10)
+                }
+            }
+        }
+        timeouts.forEach { $0.cancel() }
+    }
+}
@@ -192,6 +192,78 @@ class dependencyInjectionTests: XCTestCase {
         XCTAssertNil(registry.inject(class: injectionOffsetableTestClass.self))
         XCTAssertNotNil(registry.inject(protocol: injectionTestProtocol.self))
     }
+
+    func testSingletonInjection() throws {
+        let registry = BAInjectionRegistry()
+
+        var initializerCallCount = 0
+        let injectable = BAInjectable.singleton { () -> Any? in
+            initializerCallCount += 1
+            return injectionOffsetableTestClass(offset: initializerCallCount)
+        }
+        XCTAssertTrue(injectable.cacheable)
+        XCTAssertFalse(BAInjectable { () -> Any? in nil }.cacheable)
+        registry.register(injectable: injectable, forClass: injectionOffsetableTestClass.self)
+        XCTAssertEqual(0, initializerCallCount)
+
+        let first = registry.inject(class: injectionOffsetableTestClass.self) as AnyObject
+        let second = registry.inject(class: injectionOffsetableTestClass.self) as AnyObject
+        XCTAssertTrue(first === second)
+        XCTAssertEqual(1, initializerCallCount)
+    }
+
+    // Cached instances must not outlive the registrations and overlays they were resolved with
+    func testCacheInvalidation() throws {
+        let registry = BAInjectionRegistry()
+
+        registry.register(injectable: BAInjectable(instance: injectionOffsetableTestClass(offset: 1)), forClass: injectionOffsetableTestClass.self)
+        XCTAssertEqual(1, (registry.inject(class: injectionOffsetableTestClass.self) as? injectionOffsetableTestClass)?.echo(0))
+
+        registry.register(injectable: BAInjectable(instance: injectionOffsetableTestClass(offset: 2)), forClass: injectionOffsetableTestClass.self)
+        XCTAssertEqual(2, (registry.inject(class: injectionOffsetableTestClass.self) as? injectionOffsetableTestClass)?.echo(0))
+
+        var overlay: BAOverlayedInjectable? = registry.overlayClass(injectionOffsetableTestClass.self, returnedInstance: injectionOffsetableTestClassMock(offset: 0))
+        XCTAssertEqual(90, (registry.inject(class: injectionOffsetableTestClass.self) as? injectionOffsetableTestClass)?.echo(0))
+
+        registry.unregisterOverlay(overlay!)
+        overlay = nil
+        XCTAssertEqual(2, (registry.inject(class: injectionOffsetableTestClass.self) as? injectionOffsetableTestClass)?.echo(0))
+
+        // nil instances are cached too
+        registry.register(injectable: BAInjectable(instance: nil), forClass: injectionOffsetableTestClass.self)
+        XCTAssertNil(registry.inject(class: injectionOffsetableTestClass.self))
+        XCTAssertNil(registry.inject(class: injectionOffsetableTestClass.self))
+    }
+
+    func testResolutionPerformance() throws {
+        let registry = BAInjectionRegistry()
+        registry.register(injectable: BAInjectable(instance: injectionTestClass()), forClass: injectionTestClass.self)
+        registry.register(injectable: BAInjectable.singleton { injectionTestClass() }, forProtocol: injectionTestProtocol.self)
+
+        measure {
+            for _ in 0..<100_000 {
+                _ = registry.inject(class: injectionTestClass.self)
+                _ = registry.inject(protocol: injectionTestProtocol.self)
+            }
+        }
+    }
+
+    func testResolutionWithOverlaysPerformance() throws {
+        let registry = BAInjectionRegistry()
+        registry.register(injectable: BAInjectable(instance: injectionTestClass()), forClass: injectionTestClass.self)
+        registry.register(injectable: BAInjectable.singleton { injectionTestClass() }, forProtocol: injectionTestProtocol.self)
+
+        // The overlaid protocol goes through its callback, while the class is still cached
+        let overlay = registry.overlayProtocol(injectionTestProtocol.self, returnedInstance: injectionTestClassMock())
+
+        measure {
+            for _ in 0..<100_000 {
+                _ = registry.inject(class: injectionTestClass.self)
+                _ = registry.inject(protocol: injectionTestProtocol.self)
+            }
+        }
+        registry.unregisterOverlay(overlay)
+    }
 }
 
 @objc
@@ -30,4 +30,46 @@ class base91jTests: XCTestCase {
         XCTAssertEqual(try! base91.decode(simpleCaseEncoded.data(using: .utf8)!), simpleCase.data(using: .utf8))
         XCTAssertEqual(try! base91.decode(complexJSONEncoded.data(using: .utf8)!), complexJSON.data(using: .utf8))
     }
+
+    func testRoundTrip() {
+        let base91 = BATBase91J()
+
+        XCTAssertEqual(Data(), base91.encode(Data()))
+        XCTAssertEqual(Data(), try! base91.decode(Data()))
+
+        for length in 1...256 {
+            let data = Data((0..<length).map { _ in UInt8.random(in: 0...255) })
+            XCTAssertEqual(data, try! base91.decode(base91.encode(data)))
+        }
+    }
+
+    func testDecodeCorruptedInput() {
+        let base91 = BATBase91J()
+
+        // '"' and '-' are not part of the alphabet
+        XCTAssertThrowsError(try base91.decode("OPWf\"d".data(using: .utf8)!))
+        XCTAssertThrowsError(try base91.decode("-".data(using: .utf8)!))
+    }
+
+    func testEncodePerformance() {
+        let base91 = BATBase91J()
+        let data = complexJSON.data(using: .utf8)!
+
+        measure {
+            for _ in 0..<1000 {
+                _ = base91.encode(data)
+            }
+        }
+    }
+
+    func testDecodePerformance() {
+        let base91 = BATBase91J()
+        let data = complexJSONEncoded.data(using: .utf8)!
+
+        measure {
+            for _ in 0..<1000 {
+                _ = try! base91.decode(data)
+            }
+        }
+    }
 }
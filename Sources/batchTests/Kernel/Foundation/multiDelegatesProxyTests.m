@@ -0,0 +1,167 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+@import Batch.Batch_Private;
+
+@protocol multiDelegatesProxyTestsProtocol <NSObject>
+
+@optional
+- (void)ping:(NSString *)value;
+- (NSInteger)doubled:(NSInteger)value;
+- (void)secondaryOnly;
+
+@end
+
+@interface multiDelegatesProxyTestsDelegate : NSObject <multiDelegatesProxyTestsProtocol>
+
+@property NSMutableArray<NSString *> *receivedValues;
+@property NSInteger multiplier;
+
+@end
+
+@implementation multiDelegatesProxyTestsDelegate
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _receivedValues = [NSMutableArray new];
+        _multiplier = 2;
+    }
+    return self;
+}
+
+- (void)ping:(NSString *)value {
+    [_receivedValues addObject:value];
+}
+
+- (NSInteger)doubled:(NSInteger)value {
+    [_receivedValues addObject:[NSString stringWithFormat:@"%ld", (long)value]];
+    return value * _multiplier;
+}
+
+@end
+
+@interface multiDelegatesProxyTestsSecondaryDelegate : multiDelegatesProxyTestsDelegate
+@end
+
+@implementation multiDelegatesProxyTestsSecondaryDelegate
+
+- (void)secondaryOnly {
+    [self.receivedValues addObject:@"secondaryOnly"];
+}
+
+@end
+
+@interface BAMultiDelegatesProxy (Tests)
+
+- (id)newProxyWithDelegates:(NSArray *)delegates;
+
+@end
+
+@interface multiDelegatesProxyTests : XCTestCase
+@end
+
+@implementation multiDelegatesProxyTests
+
+- (void)testForwardsToAllDelegates {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+    id<multiDelegatesProxyTestsProtocol> proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main
+                                                                                           other:@[ secondary ]];
+
+    [proxy ping:@"first"];
+    [proxy ping:@"second"];
+    XCTAssertEqualObjects((@[ @"first", @"second" ]), main.receivedValues);
+    XCTAssertEqualObjects((@[ @"first", @"second" ]), secondary.receivedValues);
+}
+
+- (void)testReturnsMainDelegateValue {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+    secondary.multiplier = 10;
+    id<multiDelegatesProxyTestsProtocol> proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main
+                                                                                           other:@[ secondary ]];
+
+    XCTAssertEqual(42, [proxy doubled:21]);
+    // Other delegates get the arguments too
+    XCTAssertEqualObjects(@[ @"21" ], secondary.receivedValues);
+}
+
+- (void)testIgnoresOtherDelegatesReturnValues {
+    multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+    id<multiDelegatesProxyTestsProtocol> proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:[NSObject new]
+                                                                                           other:@[ secondary ]];
+
+    XCTAssertEqual(0, [proxy doubled:21]);
+    XCTAssertEqualObjects(@[ @"21" ], secondary.receivedValues);
+}
+
+- (void)testRespondsToSelector {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+    id proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main other:@[ secondary ]];
+
+    XCTAssertTrue([proxy respondsToSelector:@selector(ping:)]);
+    XCTAssertTrue([proxy respondsToSelector:@selector(secondaryOnly)]);
+    XCTAssertFalse([proxy respondsToSelector:@selector(testRespondsToSelector)]);
+    // Cached answers are the same
+    XCTAssertTrue([proxy respondsToSelector:@selector(secondaryOnly)]);
+    XCTAssertFalse([proxy respondsToSelector:@selector(testRespondsToSelector)]);
+
+    XCTAssertThrows([proxy methodSignatureForSelector:@selector(testRespondsToSelector)]);
+
+    [proxy secondaryOnly];
+    XCTAssertEqualObjects(@[ @"secondaryOnly" ], secondary.receivedValues);
+}
+
+- (void)testDeallocatedDelegatesAreSkipped {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    id<multiDelegatesProxyTestsProtocol> proxy;
+    @autoreleasepool {
+        multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+        proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main other:@[ secondary ]];
+        [proxy ping:@"first"];
+    }
+
+    [proxy ping:@"second"];
+    XCTAssertEqualObjects((@[ @"first", @"second" ]), main.receivedValues);
+    XCTAssertEqual(0, [[(BAMultiDelegatesProxy *)proxy delegates] count]);
+}
+
+- (void)testChangingDelegatesInvalidatesCache {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    multiDelegatesProxyTestsSecondaryDelegate *secondary = [multiDelegatesProxyTestsSecondaryDelegate new];
+    BAMultiDelegatesProxy *proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main other:@[]];
+
+    XCTAssertFalse([proxy respondsToSelector:@selector(secondaryOnly)]);
+
+    proxy = [proxy newProxyWithDelegates:@[ secondary ]];
+    XCTAssertTrue([proxy respondsToSelector:@selector(secondaryOnly)]);
+    [(id<multiDelegatesProxyTestsProtocol>)proxy ping:@"value"];
+    XCTAssertEqualObjects(@[ @"value" ], secondary.receivedValues);
+
+    proxy = [proxy newProxyWithDelegates:@[]];
+    XCTAssertFalse([proxy respondsToSelector:@selector(secondaryOnly)]);
+}
+
+- (void)testForwardingPerformance {
+    multiDelegatesProxyTestsDelegate *main = [multiDelegatesProxyTestsDelegate new];
+    NSMutableArray *delegates = [NSMutableArray new];
+    for (int i = 0; i < 5; i++) {
+        [delegates addObject:[multiDelegatesProxyTestsDelegate new]];
+    }
+    id<multiDelegatesProxyTestsProtocol> proxy = [BAMultiDelegatesProxy newProxyWithMainDelegate:main
+                                                                                           other:delegates];
+
+    [self measureBlock:^{
+      for (int i = 0; i < 10000; i++) {
+          [proxy doubled:i];
+      }
+    }];
+}
+
+@end
@@ -0,0 +1,44 @@
+//
+//  Batch
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import Foundation
+import XCTest
+
+class uptimeProviderTests: XCTestCase {
+    func testUptimeIsMonotonic() {
+        let start = BAUptimeProvider.uptimeNanoseconds()
+        XCTAssertGreaterThan(start, 0)
+
+        var previous = start
+        for _ in 0..<1000 {
+            let now = BAUptimeProvider.uptimeNanoseconds()
+            XCTAssertGreaterThanOrEqual(now, previous)
+            previous = now
+        }
+
+        XCTAssertEqual(BAUptimeProvider.uptime(), Double(BAUptimeProvider.uptimeNanoseconds()) / Double(NSEC_PER_SEC), accuracy: 0.1)
+    }
+
+    func testSecondsSinceUptime() {
+        let start = BAUptimeProvider.uptimeNanoseconds()
+        Thread.sleep(forTimeInterval: 0.05)
+        let elapsed = BAUptimeProvider.secondsSince(uptimeNanoseconds: start)
+        XCTAssertGreaterThanOrEqual(elapsed, 0.05)
+        XCTAssertLessThan(elapsed, 5)
+
+        // Values from the future don't produce negative durations
+        XCTAssertEqual(BAUptimeProvider.secondsSince(uptimeNanoseconds: start + 3600 * NSEC_PER_SEC), 0)
+    }
+
+    func testUptimePerformance() {
+        measure {
+            for _ in 0..<100_000 {
+                _ = BAUptimeProvider.uptime()
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  randomTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class randomTests: XCTestCase {
+    static let alphabet = Set("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789")
+
+    func testAlphanumericString() {
+        XCTAssertEqual("", BARandom.randomAlphanumericString(withLength: 0))
+        XCTAssertEqual("", BARandom.randomAlphanumericString(withLength: -1))
+
+        // Longer than the pool, to go through refills
+        for length: Int32 in [1, 8, 32, 300, 1000] {
+            let string = BARandom.randomAlphanumericString(withLength: length)
+            XCTAssertEqual(Int(length), string.count)
+            XCTAssertTrue(Set(string).isSubset(of: randomTests.alphabet))
+        }
+    }
+
+    func testAlphanumericStringDistribution() {
+        var counts: [Character: Int] = [:]
+        for _ in 0..<1000 {
+            for char in BARandom.randomAlphanumericString(withLength: 62) {
+                counts[char, default: 0] += 1
+            }
+        }
+
+        // Every character is expected 1000 times: a modulo bias or a missing character would show
+        XCTAssertEqual(randomTests.alphabet, Set(counts.keys))
+        for count in counts.values {
+            XCTAssertTrue((700...1300).contains(count))
+        }
+    }
+
+    func testAlphanumericStringConcurrency() {
+        let lock = NSLock()
+        var strings = Set<String>()
+        DispatchQueue.concurrentPerform(iterations: 1000) { _ in
+            let string = BARandom.randomAlphanumericString(withLength: 16)
+            lock.lock()
+            strings.insert(string)
+            lock.unlock()
+        }
+        XCTAssertEqual(1000, strings.count)
+    }
+
+    func testAlphanumericStringPerformance() {
+        measure {
+            for _ in 0..<100_000 {
+                _ = BARandom.randomAlphanumericString(withLength: 16)
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+//
+//  stringUtilsTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class stringUtilsTests: XCTestCase {
+    func testHexGoldenVectors() {
+        XCTAssertEqual("", BAStringUtils.hexStringValue(for: Data()))
+        XCTAssertEqual("00", BAStringUtils.hexStringValue(for: Data([0x00])))
+        XCTAssertEqual("0001abff7f80", BAStringUtils.hexStringValue(for: Data([0x00, 0x01, 0xAB, 0xFF, 0x7F, 0x80])))
+        XCTAssertEqual("4261746368", BAStringUtils.hexStringValue(for: Data("Batch".utf8)))
+    }
+
+    func testHexMatchesFormat() {
+        for length in [1, 2, 15, 16, 32, 255, 1024] {
+            let data = Data((0..<length).map { _ in UInt8.random(in: 0...255) })
+            let expected = data.map { String(format: "%02x", $0) }.joined()
+            XCTAssertEqual(expected, BAStringUtils.hexStringValue(for: data))
+        }
+    }
+
+    func testHexPerformance() {
+        // A SHA-256 hash, as hashed for cache keys and tokens
+        let data = Data((0..<32).map { _ in UInt8.random(in: 0...255) })
+        measure {
+            for _ in 0..<100_000 {
+                _ = BAStringUtils.hexStringValue(for: data)
+            }
+        }
+    }
+}
@@ -0,0 +1,194 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+@import Batch.Batch_Private;
+
+@interface asyncLoggerTestsLogger : NSObject <BALoggerProtocol>
+
+@property NSMutableArray<NSString *> *messages;
+
+/// If set, the first logged message waits for it to be signaled
+@property dispatch_semaphore_t gate;
+
+@end
+
+@implementation asyncLoggerTestsLogger
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _messages = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)logMessage:(NSString *)message
+         subsystem:(NSString *)subsystem
+          internal:(BOOL)internal
+             level:(os_log_type_t)level {
+    if (_gate != nil) {
+        dispatch_semaphore_wait(_gate, DISPATCH_TIME_FOREVER);
+        _gate = nil;
+    }
+    [_messages addObject:message];
+}
+
+@end
+
+@interface asyncLoggerTests : XCTestCase {
+    NSURL *_logFileURL;
+}
+@end
+
+@implementation asyncLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    _logFileURL = [[[NSURL fileURLWithPath:NSTemporaryDirectory()]
+        URLByAppendingPathComponent:[NSUUID UUID].UUIDString] URLByAppendingPathComponent:@"batch.log"];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:[_logFileURL URLByDeletingLastPathComponent] error:nil];
+    [super tearDown];
+}
+
+- (void)testRingBufferOrder {
+    BALogRingBuffer<NSNumber *> *buffer = [[BALogRingBuffer alloc] initWithCapacity:3];
+    XCTAssertEqual(buffer.capacity, 4);
+    XCTAssertNil([buffer pop]);
+
+    for (int i = 0; i < 5; i++) {
+        XCTAssertEqual([buffer push:@(i)], i < 4);
+    }
+    XCTAssertEqual([buffer drainDroppedCount], 1);
+    XCTAssertEqual([buffer drainDroppedCount], 0);
+
+    XCTAssertEqualObjects([buffer pop], @0);
+    XCTAssertTrue([buffer push:@4]);
+    XCTAssertEqualObjects([buffer pop], @1);
+    XCTAssertEqualObjects([buffer pop], @2);
+    XCTAssertEqualObjects([buffer pop], @3);
+    XCTAssertEqualObjects([buffer pop], @4);
+    XCTAssertNil([buffer pop]);
+}
+
+- (void)testRingBufferConcurrentProducers {
+    BALogRingBuffer<NSNumber *> *buffer = [[BALogRingBuffer alloc] initWithCapacity:64];
+    NSUInteger popped = 0;
+
+    dispatch_group_t producers = dispatch_group_create();
+    for (int producer = 0; producer < 8; producer++) {
+        dispatch_group_async(producers, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+          for (int i = 0; i < 10000; i++) {
+              [buffer push:@(i)];
+          }
+        });
+    }
+
+    // Consume while producing, then what's left once they are done
+    BOOL producing = true;
+    while (producing) {
+        producing = dispatch_group_wait(producers, DISPATCH_TIME_NOW) != 0;
+        while ([buffer pop] != nil) {
+            popped++;
+        }
+    }
+
+    // Every pushed object is either popped or counted as dropped
+    XCTAssertEqual(popped + [buffer drainDroppedCount], 80000);
+}
+
+- (void)testLogsAreForwardedAndKept {
+    asyncLoggerTestsLogger *recorder = [asyncLoggerTestsLogger new];
+    BAAsyncLogger *logger = [[BAAsyncLogger alloc] initWithLogger:recorder logFileURL:nil maxFileSize:1024];
+
+    [logger logMessage:@"first" subsystem:@"Tests - " internal:false level:OS_LOG_TYPE_INFO];
+    [logger logMessage:@"second" subsystem:@"" internal:true level:OS_LOG_TYPE_DEBUG];
+    [logger flush];
+    XCTAssertEqualObjects(recorder.messages, (@[ @"first", @"second" ]));
+
+    XCTestExpectation *exported = [self expectationWithDescription:@"Logs exported"];
+    [logger exportLogs:^(NSString *logs) {
+      NSArray<NSString *> *lines = [logs componentsSeparatedByString:@"\n"];
+      XCTAssertEqual([lines count], 3);
+      XCTAssertTrue([lines[0] hasSuffix:@"[Batch] info Tests - first"]);
+      XCTAssertTrue([lines[1] hasSuffix:@"[Batch-Internal] debug second"]);
+      [exported fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+- (void)testDroppedLogsAreReported {
+    asyncLoggerTestsLogger *recorder = [asyncLoggerTestsLogger new];
+    dispatch_semaphore_t gate = dispatch_semaphore_create(0);
+    recorder.gate = gate;
+    BAAsyncLogger *logger = [[BAAsyncLogger alloc] initWithLogger:recorder logFileURL:nil maxFileSize:1024];
+
+    // Block the drainer on the first message, then overflow the buffer
+    [logger logMessage:@"first" subsystem:@"" internal:false level:OS_LOG_TYPE_INFO];
+    [NSThread sleepForTimeInterval:0.1];
+    for (int i = 0; i < 2000; i++) {
+        [logger logMessage:@"message" subsystem:@"" internal:false level:OS_LOG_TYPE_INFO];
+    }
+    dispatch_semaphore_signal(gate);
+    [logger flush];
+
+    NSPredicate *dropNotice = [NSPredicate predicateWithFormat:@"SELF ENDSWITH ' logs dropped'"];
+    NSArray<NSString *> *notices = [recorder.messages filteredArrayUsingPredicate:dropNotice];
+    XCTAssertEqual([notices count], 1);
+    NSUInteger dropped = (NSUInteger)[notices[0] integerValue];
+    XCTAssertGreaterThan(dropped, 0);
+    // Every log is either forwarded or counted as dropped
+    XCTAssertEqual([recorder.messages count] - 1 + dropped, 2001);
+}
+
+- (void)testLogsArePersistedAndRotated {
+    BAAsyncLogger *logger = [[BAAsyncLogger alloc] initWithLogger:[asyncLoggerTestsLogger new]
+                                                       logFileURL:_logFileURL
+                                                      maxFileSize:1024];
+    [logger logMessage:@"not persisted" subsystem:@"" internal:false level:OS_LOG_TYPE_INFO];
+    [logger flush];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_logFileURL.path]);
+
+    logger.persistenceEnabled = true;
+    for (int i = 0; i < 50; i++) {
+        [logger logMessage:[NSString stringWithFormat:@"message %d", i] subsystem:@"" internal:false level:0];
+        [logger flush];
+    }
+
+    NSURL *rotatedLogFileURL = [_logFileURL URLByAppendingPathExtension:@"1"];
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:rotatedLogFileURL.path]);
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:_logFileURL.path error:nil];
+    XCTAssertLessThan([attributes fileSize], 1024);
+
+    XCTestExpectation *exported = [self expectationWithDescription:@"Logs exported"];
+    [logger exportLogs:^(NSString *logs) {
+      XCTAssertTrue([logs hasSuffix:@"message 49\n"]);
+      XCTAssertFalse([logs containsString:@"not persisted"]);
+      [exported fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    [logger clearLogs];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_logFileURL.path]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:rotatedLogFileURL.path]);
+}
+
+- (void)testLoggingPerformance {
+    BAAsyncLogger *logger = [[BAAsyncLogger alloc] initWithLogger:[asyncLoggerTestsLogger new]
+                                                       logFileURL:nil
+                                                      maxFileSize:1024];
+    [self measureBlock:^{
+      for (int i = 0; i < 10000; i++) {
+          [logger logMessage:@"message" subsystem:@"Tests - " internal:true level:OS_LOG_TYPE_DEBUG];
+      }
+      [logger flush];
+    }];
+}
+
+@end
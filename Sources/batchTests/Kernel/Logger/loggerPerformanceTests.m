@@ -0,0 +1,66 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+@import Batch.Batch_Private;
+
+#define BENCHMARK_ITERATIONS 1000000
+
+@interface loggerPerformanceTests : XCTestCase {
+    BOOL _previousInternalLogsEnabled;
+    NSUInteger _evaluationCount;
+}
+@end
+
+@implementation loggerPerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    _previousInternalLogsEnabled = BALogger.internalLogsEnabled;
+    _evaluationCount = 0;
+}
+
+- (void)tearDown {
+    BALogger.internalLogsEnabled = _previousInternalLogsEnabled;
+    [super tearDown];
+}
+
+- (NSString *)expensiveArgument {
+    _evaluationCount++;
+    return @"argument";
+}
+
+- (void)testDisabledLogsDontEvaluateArguments {
+    BALogger.internalLogsEnabled = false;
+    BALogDebug(@"Tests", @"Argument: %@", [self expensiveArgument]);
+    BALogWarning(@"Tests", @"Argument: %@", [self expensiveArgument]);
+    BALogError(@"Tests", @"Argument: %@", [self expensiveArgument]);
+    XCTAssertEqual(_evaluationCount, 0);
+
+    BALogger.internalLogsEnabled = true;
+    BALogDebug(@"Tests", @"Argument: %@", [self expensiveArgument]);
+    XCTAssertEqual(_evaluationCount, 1);
+}
+
+- (void)testDisabledMethodPerformance {
+    BALogger.internalLogsEnabled = false;
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [BALogger debugForDomain:@"Tests" message:@"Iteration %d: %@", i, [self expensiveArgument]];
+      }
+    }];
+}
+
+- (void)testDisabledMacroPerformance {
+    BALogger.internalLogsEnabled = false;
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          BALogDebug(@"Tests", @"Iteration %d: %@", i, [self expensiveArgument]);
+      }
+    }];
+}
+
+@end
@@ -0,0 +1,149 @@
+//
+//  BATGIFFrameCacheTests.swift
+//  batchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Foundation
+import ImageIO
+import Testing
+import UIKit
+import UniformTypeIdentifiers
+
+@testable import Batch
+
+// Serialized, as the memory warning test purges every cache
+@Suite(.serialized)
+struct BATGIFFrameCacheTests {
+    @Test("Only the first frame is decoded when loading a GIF")
+    func testOnlyFirstFrameIsDecoded() throws {
+        let cache = BATGIFFrameCache(byteBudget: 1024 * 1024)
+        let gifFile = try BATGIFFile(data: try makeGIFData(frameCount: 4), frameCache: cache)
+
+        #expect(gifFile.frameCount == 4)
+        #expect(gifFile.image(at: 0) != nil)
+        #expect(gifFile.image(at: 1) == nil)
+        #expect(cache.totalCost > 0)
+    }
+
+    @Test("Identical GIFs share their decoded frames")
+    func testFramesAreSharedByContent() throws {
+        let cache = BATGIFFrameCache(byteBudget: 1024 * 1024)
+        let data = try makeGIFData(frameCount: 3)
+
+        let first = try BATGIFFile(data: data, frameCache: cache)
+        let costAfterFirst = cache.totalCost
+        let second = try BATGIFFile(data: data, frameCache: cache)
+
+        #expect(first.contentHash == second.contentHash)
+        #expect(cache.totalCost == costAfterFirst)
+        #expect(first.image(at: 0) === second.image(at: 0))
+    }
+
+    @Test("Frames are preloaded in the background")
+    func testPreloading() async throws {
+        let cache = BATGIFFrameCache(byteBudget: 1024 * 1024)
+        let gifFile = try BATGIFFile(data: try makeGIFData(frameCount: 4), frameCache: cache)
+
+        gifFile.willDisplayFrame(at: 0)
+
+        try await waitUntil { (0 ..< gifFile.frameCount).allSatisfy { gifFile.image(at: $0) != nil } }
+    }
+
+    @Test("The least recently used frames are evicted when over budget")
+    func testBudgetEviction() throws {
+        let frame = try #require(makeFrame(color: .red))
+        let cgImage = try #require(frame.cgImage)
+        let frameCost = cgImage.bytesPerRow * cgImage.height
+        let cache = BATGIFFrameCache(byteBudget: UInt(frameCost * 2))
+
+        cache.setImage(frame, forContentHash: "gif", frameIndex: 0)
+        cache.setImage(frame, forContentHash: "gif", frameIndex: 1)
+        // Use frame 0, so that frame 1 becomes the least recently used one
+        _ = cache.image(forContentHash: "gif", frameIndex: 0)
+        cache.setImage(frame, forContentHash: "gif", frameIndex: 2)
+
+        #expect(cache.image(forContentHash: "gif", frameIndex: 0) != nil)
+        #expect(cache.image(forContentHash: "gif", frameIndex: 1) == nil)
+        #expect(cache.image(forContentHash: "gif", frameIndex: 2) != nil)
+        #expect(cache.totalCost == UInt(frameCost * 2))
+    }
+
+    @Test("Displayed frames are only evicted if no other file shows the same GIF")
+    func testConsumptionKeepsSharedFrames() throws {
+        // Too small for all frames to fit: displayed frames are evicted
+        let frame = try #require(makeFrame(color: .red))
+        let cgImage = try #require(frame.cgImage)
+        let cache = BATGIFFrameCache(byteBudget: UInt(cgImage.bytesPerRow * cgImage.height * 2))
+        let data = try makeGIFData(frameCount: 4)
+
+        let first = try BATGIFFile(data: data, frameCache: cache)
+        var second: BATGIFFile? = try BATGIFFile(data: data, frameCache: cache)
+
+        first.consumeFrame(at: 0)
+        #expect(second?.image(at: 0) != nil)
+
+        second = nil
+        first.consumeFrame(at: 0)
+        #expect(first.image(at: 0) == nil)
+    }
+
+    @Test("Frame keys are built once per file")
+    func testFrameKeys() throws {
+        let cache = BATGIFFrameCache(byteBudget: 1024 * 1024)
+        let gifFile = try BATGIFFile(data: try makeGIFData(frameCount: 2), frameCache: cache)
+
+        #expect(gifFile.frameCacheKey(at: 1) == BATGIFFrameCache.key(forContentHash: gifFile.contentHash, frameIndex: 1))
+        #expect(gifFile.frameCacheKey(at: 1) === gifFile.frameCacheKey(at: 1))
+        #expect(cache.image(forKey: gifFile.frameCacheKey(at: 0)) === gifFile.image(at: 0))
+    }
+
+    @Test("Memory warnings purge the decoded frames")
+    @MainActor
+    func testMemoryWarningPurges() throws {
+        let cache = BATGIFFrameCache(byteBudget: 1024 * 1024)
+        let gifFile = try BATGIFFile(data: try makeGIFData(frameCount: 2), frameCache: cache)
+        #expect(gifFile.image(at: 0) != nil)
+
+        NotificationCenter.default.post(name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
+
+        #expect(gifFile.image(at: 0) == nil)
+        #expect(cache.totalCost == 0)
+    }
+}
+
+extension BATGIFFrameCacheTests {
+    // MARK: - Helpers
+
+    private func makeFrame(color: UIColor) -> UIImage? {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        return UIGraphicsImageRenderer(size: CGSize(width: 16, height: 16), format: format).image { context in
+            color.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: 16, height: 16))
+        }
+    }
+
+    private func makeGIFData(frameCount: Int) throws -> Data {
+        let data = NSMutableData()
+        let destination = try #require(CGImageDestinationCreateWithData(data, UTType.gif.identifier as CFString, frameCount, nil))
+        let frameProperties = [kCGImagePropertyGIFDictionary: [kCGImagePropertyGIFDelayTime: 0.1]] as CFDictionary
+        let colors: [UIColor] = [.red, .green, .blue, .black]
+        for index in 0 ..< frameCount {
+            let frame = try #require(makeFrame(color: colors[index % colors.count])?.cgImage)
+            CGImageDestinationAddImage(destination, frame, frameProperties)
+        }
+        try #require(CGImageDestinationFinalize(destination))
+        return data as Data
+    }
+
+    private func waitUntil(_ condition: () -> Bool) async throws {
+        var attempts = 0
+        while !condition() && attempts < 100 {
+            try await Task.sleep(nanoseconds: 20_000_000)
+            attempts += 1
+        }
+        #expect(condition())
+    }
+}
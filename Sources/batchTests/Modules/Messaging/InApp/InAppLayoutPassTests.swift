@@ -0,0 +1,125 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Testing
+
+@testable import Batch
+
+struct InAppLayoutPassTests {
+    let margins = UIEdgeInsets(top: 4, left: 10, bottom: 4, right: 10)
+
+    func labelConfiguration(text: String, maxLines: Int = 0) -> InAppLabelView.Configuration {
+        return InAppLabelView.Configuration(
+            content: InAppLabelView.Configuration.Content(text: text),
+            fontStyle: InAppLabelView.Configuration.FontStyle(fontSize: 14, fontDecoration: [.bold]),
+            style: InAppLabelView.Configuration.Style(textAlign: .left, color: .black, maxLines: maxLines),
+            placement: InAppLabelView.Configuration.Placement(margins: margins)
+        )
+    }
+
+    func measureLabel(_ configuration: InAppLabelView.Configuration, width: CGFloat) -> InAppLayoutFrame {
+        return InAppLayoutPass.measureText(
+            configuration.content.text,
+            fontStyle: configuration.fontStyle,
+            maxLines: configuration.style.maxLines,
+            placement: configuration.placement,
+            width: width
+        )
+    }
+
+    @Test func testTextMeasure() async throws {
+        let text = String(repeating: "Je suis un label assez long pour passer à la ligne. ", count: 4)
+        let configuration = labelConfiguration(text: text)
+
+        let wideFrame = measureLabel(configuration, width: 600)
+        let narrowFrame = measureLabel(configuration, width: 200)
+
+        #expect(wideFrame.textWidth == 580)
+        #expect(narrowFrame.textWidth == 180)
+        #expect(narrowFrame.size.width == 200)
+        #expect(narrowFrame.size.height > wideFrame.size.height)
+
+        // Measures are cached
+        #expect(measureLabel(configuration, width: 200) == narrowFrame)
+
+        // Max lines cap the height
+        let cappedFrame = measureLabel(labelConfiguration(text: text, maxLines: 1), width: 200)
+        #expect(cappedFrame.size.height < narrowFrame.size.height)
+        #expect(cappedFrame.size.height > margins.top + margins.bottom)
+    }
+
+    @Test func testBoxMeasure() async throws {
+        let divider = InAppDividerView.Configuration.Placement(
+            margins: margins,
+            widthType: .percent(value: 50),
+            heightType: .fixed(value: 2),
+            horizontalAlignment: .center
+        )
+        #expect(InAppLayoutPass.measureBox(placement: divider, width: 300).size == CGSize(width: 300, height: 10))
+        #expect(InAppLayoutPass.contentWidth(for: divider, width: 300) == 130)
+
+        let spacer = InAppSpacerView.Configuration.Placement(heightType: .fill)
+        #expect(InAppLayoutPass.measureBox(placement: spacer, width: 300).size == CGSize(width: 300, height: 0))
+    }
+
+    @MainActor
+    @Test func testColumnsMeasure() async throws {
+        let label = labelConfiguration(text: "Label")
+        let builder = InAppViewBuilder(
+            component: InAppLabel(id: "label", margin: nil, textAlign: nil, fontSize: 14, color: ["#000000"], maxLines: nil, fontDecoration: nil),
+            expandable: label.placement,
+            measure: { width in measureLabel(label, width: width) },
+            content: { _, _ in InAppLabelView(configuration: label) }
+        )
+        let columns = InAppColumnsView.Configuration(
+            builders: [builder, builder],
+            ratios: [25, 75],
+            style: InAppColumnsView.Configuration.Style(spacing: 20, verticalAlignment: .center),
+            placement: InAppColumnsView.Configuration.Placement(margins: .zero, heightType: nil)
+        )
+
+        let frame = InAppLayoutPass.measureColumns(configuration: columns, width: 420)
+        #expect(frame.children.count == 2)
+        #expect(frame.children[0].size.width == 100)
+        #expect(frame.children[1].size.width == 300)
+        #expect(frame.size.height == frame.children.map(\.size.height).max())
+    }
+
+    @MainActor
+    @Test func testApplyToLabel() async throws {
+        let configuration = labelConfiguration(text: String(repeating: "Je suis un label assez long. ", count: 6))
+        let frame = measureLabel(configuration, width: 200)
+        let label = InAppLabelView(configuration: configuration)
+
+        InAppLayoutPass.apply([frame], to: [label])
+
+        // The label wraps at the measured width, and is as tall as measured, margins aside
+        #expect(label.preferredMaxLayoutWidth == frame.textWidth)
+        #expect(label.intrinsicContentSize.height == frame.size.height - margins.top - margins.bottom)
+    }
+
+    @MainActor
+    @Test func testReusePool() async throws {
+        let pool = InAppViewReusePool()
+        let container = UIView()
+        let label = pool.dequeue(configuration: labelConfiguration(text: "First"), create: InAppLabelView.init(configuration:))
+        container.addSubview(label)
+        label.heightAnchor.constraint(equalToConstant: 20).isActive = true
+
+        pool.recycle(viewsIn: container)
+        #expect(label.superview == nil)
+        #expect(label.constraints.allSatisfy { $0.firstAttribute != .height || !$0.isActive })
+
+        let reused = pool.dequeue(configuration: labelConfiguration(text: "Second"), create: InAppLabelView.init(configuration:))
+        #expect(reused === label)
+        #expect(reused.attributedText?.string == "Second")
+        #expect(reused.configuration.content.text == "Second")
+
+        // Empty pools create new views
+        let created = pool.dequeue(configuration: labelConfiguration(text: "Third"), create: InAppLabelView.init(configuration:))
+        #expect(created !== label)
+    }
+}
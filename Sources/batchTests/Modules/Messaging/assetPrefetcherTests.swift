@@ -0,0 +1,129 @@
+//
+//  assetPrefetcherTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class TestAssetPrefetcher: BAMSGAssetPrefetcher {
+    var reachable = true
+    var metered = false
+    var powerConstrained = false
+
+    override func isNetworkReachable() -> Bool {
+        return reachable
+    }
+
+    override func isNetworkMetered() -> Bool {
+        return metered
+    }
+
+    override func isPowerConstrained() -> Bool {
+        return powerConstrained
+    }
+}
+
+class assetPrefetcherTests: XCTestCase {
+    var cacheDirectory: String!
+
+    override func setUp() {
+        StubImageURLProtocol.reset()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 200, headers: ["Cache-Control": "max-age=3600"], body: Data(count: 1024))
+        }
+        cacheDirectory = (NSTemporaryDirectory() as NSString).appendingPathComponent("assetPrefetcherTests-\(UUID().uuidString)")
+    }
+
+    override func tearDown() {
+        StubImageURLProtocol.reset()
+        try? FileManager.default.removeItem(atPath: cacheDirectory)
+    }
+
+    func testImagesArePrefetched() {
+        let prefetcher = makePrefetcher()
+        let urls = makeURLs(count: 3)
+
+        prefetch(urls, with: prefetcher)
+
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.map(\.url), urls)
+        for url in urls {
+            XCTAssertNotNil(prefetcher.pipeline.cache.cachedImage(for: url))
+        }
+    }
+
+    func testByteBudget() {
+        let prefetcher = makePrefetcher()
+        prefetcher.byteBudget = 2048
+
+        prefetch(makeURLs(count: 5), with: prefetcher)
+
+        // Prefetching stops once the budget has been used
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 2)
+    }
+
+    func testMeteredByteBudget() {
+        let prefetcher = makePrefetcher()
+        prefetcher.metered = true
+        prefetcher.meteredByteBudget = 1024
+
+        prefetch(makeURLs(count: 5), with: prefetcher)
+
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 1)
+    }
+
+    func testWaitsForBetterConditions() {
+        let prefetcher = makePrefetcher()
+        prefetcher.powerConstrained = true
+
+        let finished = expectation(description: "Prefetch finished")
+        prefetcher.prefetchImageURLs(makeURLs(count: 2)) { finished.fulfill() }
+
+        let waited = expectation(description: "Nothing was prefetched")
+        DispatchQueue.global().asyncAfter(deadline: .now() + 0.5) {
+            XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 0)
+            prefetcher.powerConstrained = false
+            prefetcher.conditionsDidChange()
+            waited.fulfill()
+        }
+
+        wait(for: [waited, finished], timeout: 5, enforceOrder: true)
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 2)
+    }
+
+    func testNewPrefetchReplacesThePreviousOne() {
+        let prefetcher = makePrefetcher()
+        prefetcher.startDelay = 0.5
+
+        let replaced = expectation(description: "First prefetch replaced")
+        prefetcher.prefetchImageURLs(makeURLs(count: 3)) { replaced.fulfill() }
+        let second = [URL(string: "https://batch.com/other.png")!]
+        prefetch(second, with: prefetcher)
+
+        wait(for: [replaced], timeout: 1)
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.map(\.url), second)
+    }
+
+    // MARK: Helpers
+
+    func makePrefetcher() -> TestAssetPrefetcher {
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [StubImageURLProtocol.self]
+        let cache = BAMSGImageCache(directory: cacheDirectory, memoryCostLimit: 1024 * 1024, diskSizeLimit: 1024 * 1024)
+        let prefetcher = TestAssetPrefetcher(pipeline: BAMSGImagePipeline(sessionConfiguration: configuration, cache: cache))
+        prefetcher.startDelay = 0
+        return prefetcher
+    }
+
+    func makeURLs(count: Int) -> [URL] {
+        return (0 ..< count).map { URL(string: "https://batch.com/\($0).png")! }
+    }
+
+    func prefetch(_ urls: [URL], with prefetcher: BAMSGAssetPrefetcher) {
+        let finished = expectation(description: "Prefetch finished")
+        prefetcher.prefetchImageURLs(urls) { finished.fulfill() }
+        wait(for: [finished], timeout: 5)
+    }
+}
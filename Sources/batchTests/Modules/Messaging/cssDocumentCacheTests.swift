@@ -0,0 +1,66 @@
+//
+//  cssDocumentCacheTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class cssDocumentCacheTests: XCTestCase {
+    func testDocumentsAreShared() throws {
+        let cache = BACSSDocumentCache(importProvider: StubImportProvider([:]), totalCostLimit: 1024)
+
+        let document = try cache.document(forStylesheet: "#title { color: red; }\n")
+        XCTAssertTrue(document === (try cache.document(forStylesheet: "#title { color: red; }\n")))
+        XCTAssertFalse(document === (try cache.document(forStylesheet: "#title { color: blue; }\n")))
+
+        cache.removeAllDocuments()
+        XCTAssertFalse(document === (try cache.document(forStylesheet: "#title { color: red; }\n")))
+    }
+
+    func testParseErrorsAreNotCached() {
+        let importProvider = StubImportProvider(["theme": "}}"])
+        let cache = BACSSDocumentCache(importProvider: importProvider, totalCostLimit: 1024)
+
+        XCTAssertThrowsError(try cache.document(forStylesheet: "@import sdk(\"theme\");\n"))
+        XCTAssertThrowsError(try cache.document(forStylesheet: "@import sdk(\"theme\");\n"))
+    }
+
+    func testMediaQueriesFollowTheEnvironment() throws {
+        let cache = BACSSDocumentCache(importProvider: StubImportProvider([:]), totalCostLimit: 1024)
+        let document = try cache.document(forStylesheet: """
+        #title { font-size: 12; }
+        @media ios and (max-width: 500) { #title { font-size: 14; } }
+        @ios and dark { #title { color: white; } }
+
+        """)
+
+        let node = BACSSDOMNode()
+        node.identifier = "title"
+
+        let environment = BACSSEnvironment()
+        environment.viewSize = CGSize(width: 400, height: 800)
+        environment.darkMode = true
+        var rules = document.flatRules(for: node, with: environment)
+        XCTAssertEqual(rules["font-size"], "14")
+        XCTAssertEqual(rules["color"], "white")
+
+        environment.viewSize = CGSize(width: 800, height: 400)
+        environment.darkMode = false
+        rules = document.flatRules(for: node, with: environment)
+        XCTAssertEqual(rules["font-size"], "12")
+        XCTAssertNil(rules["color"])
+
+        // Environments with the same traits share the memoized media queries
+        let otherEnvironment = BACSSEnvironment()
+        otherEnvironment.viewSize = CGSize(width: 800, height: 400)
+        XCTAssertEqual(environment.mediaQueryCacheKey(), otherEnvironment.mediaQueryCacheKey())
+        XCTAssertEqual(document.flatRules(for: node, with: otherEnvironment)["font-size"], "12")
+
+        otherEnvironment.darkMode = true
+        XCTAssertNotEqual(environment.mediaQueryCacheKey(), otherEnvironment.mediaQueryCacheKey())
+        XCTAssertEqual(document.flatRules(for: node, with: otherEnvironment)["color"], "white")
+    }
+}
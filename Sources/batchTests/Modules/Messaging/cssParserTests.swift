@@ -0,0 +1,174 @@
+//
+//  cssParserTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class cssParserTests: XCTestCase {
+    /// Stylesheets parsed by the fuzzing and performance tests
+    static let fixtures = [
+        "@import sdk(\"generic1-h-cta\");\n#title { color: #FF0000; }\n",
+        "@import sdk(\"generic1-v-cta\");\n@import sdk(\"image1-detached\");\n",
+        "@import sdk(\"banner1\");\n@media ios and (max-width: 500) { #title { font-size: 14; } }\n",
+        """
+        * { --main-color: #FF0000; }
+        #title { color: var(--main-color); font-size: 12; }
+        .Big, #other { font-size: 20; }
+        .big { margin: 4; }
+        @media ios and (max-width: 500) {
+            #title { font-size: 14; }
+        }
+        @ios and dark {
+            .big { color: #FFFFFF; }
+        }
+
+        """,
+    ]
+
+    func testCommentsAndImports() throws {
+        let css = "/* header */@import sdk(\"base\");\n#title { color: /* inline */ red; }\n/* footer */"
+        let document = try parse(css, imports: ["base": "#title{font-size:12;color:blue}"])
+
+        let rules = document.flatRules(for: node(identifier: "title"), with: BACSSEnvironment())
+        XCTAssertEqual(rules["color"], "red")
+        XCTAssertEqual(rules["font-size"], "12")
+    }
+
+    func testTokensSpanningImports() {
+        let recorder = TokenRecorder()
+        let tokenizer = BACSSTokenizer(string: "#ti@import sdk(\"middle\");le{a:b}", importProvider: StubImportProvider(["middle": "t"]))
+
+        XCTAssertNil(tokenizer.tokenize(with: recorder))
+        XCTAssertEqual(recorder.events, ["#title", "{", "a", ":", "b", "}"])
+    }
+
+    func testUnterminatedCommentIsReadAsText() {
+        let recorder = TokenRecorder()
+        let tokenizer = BACSSTokenizer(string: "a{b:c/*d}", importProvider: nil)
+
+        XCTAssertNil(tokenizer.tokenize(with: recorder))
+        XCTAssertEqual(recorder.events, ["a", "{", "b", ":", "c/*d", "}"])
+    }
+
+    func testErrorOffsets() {
+        var error = parseError("#a{b:c}}")
+        XCTAssertEqual(error?.userInfo[kBACSSParserErrorOffsetKey] as? Int, 7)
+
+        // Stylesheets must end with a special character
+        error = parseError("#a{b:c} #b")
+        XCTAssertEqual(error?.code, -1)
+        XCTAssertEqual(error?.userInfo[kBACSSParserErrorOffsetKey] as? Int, 9)
+
+        // Errors in imported content point to the import
+        error = parseError("#a{b:c}\n@import sdk(\"broken\");\n", imports: ["broken": "}}"])
+        XCTAssertEqual(error?.userInfo[kBACSSParserErrorOffsetKey] as? Int, 8)
+    }
+
+    func testFuzzing() {
+        var generator = SeededGenerator(seed: 0xBA7C)
+        let mutationCharacters: [Character] = ["{", "}", ":", ";", "\n", "/", "*", "@", "\"", " ", "a", "é", "\u{2028}"]
+
+        for _ in 0 ..< 2000 {
+            var css = Array(cssParserTests.fixtures.randomElement(using: &generator)!)
+            for _ in 0 ..< Int.random(in: 1 ... 8, using: &generator) {
+                let index = Int.random(in: 0 ... css.count, using: &generator)
+                switch Int.random(in: 0 ..< 3, using: &generator) {
+                case 0 where index < css.count:
+                    css.remove(at: index)
+                case 1:
+                    css.insert(mutationCharacters.randomElement(using: &generator)!, at: index)
+                default:
+                    let end = min(css.count, index + Int.random(in: 0 ..< 32, using: &generator))
+                    css.insert(contentsOf: css[index ..< end], at: index)
+                }
+            }
+
+            let string = String(css)
+            if let error = parseError(string, imports: ["generic1-h-cta": "*{--a:1}", "banner1": "#x{y:z}"]) {
+                let offset = error.userInfo[kBACSSParserErrorOffsetKey] as? Int
+                XCTAssertNotNil(offset, "Missing offset for '\(string)'")
+                XCTAssertLessThanOrEqual(offset ?? 0, (string as NSString).length)
+            }
+        }
+    }
+
+    func testParsePerformance() {
+        let stylesheets = Array(repeating: cssParserTests.fixtures, count: 50).flatMap { $0 }
+        let importProvider = BACSSBuiltinImportProvider()
+        measure {
+            for stylesheet in stylesheets {
+                XCTAssertNotNil(try? BACSSParser(string: stylesheet, andImportProvider: importProvider).parse())
+            }
+        }
+    }
+
+    // MARK: Helpers
+
+    func parse(_ css: String, imports: [String: String] = [:]) throws -> BACSSDocument {
+        return try BACSSParser(string: css, andImportProvider: StubImportProvider(imports)).parse()
+    }
+
+    func parseError(_ css: String, imports: [String: String] = [:]) -> NSError? {
+        do {
+            _ = try parse(css, imports: imports)
+            return nil
+        } catch {
+            return error as NSError
+        }
+    }
+
+    func node(identifier: String) -> BACSSDOMNode {
+        let node = BACSSDOMNode()
+        node.identifier = identifier
+        return node
+    }
+}
+
+class StubImportProvider: NSObject, BACSSImportProvider {
+    let imports: [String: String]
+
+    init(_ imports: [String: String]) {
+        self.imports = imports
+    }
+
+    func content(forImportNamed importName: String) -> String? {
+        return imports[importName]
+    }
+}
+
+class TokenRecorder: NSObject, BACSSTokenizerDelegate {
+    var events: [String] = []
+
+    func consumeToken(_ token: String) {
+        if !token.isEmpty {
+            events.append(token)
+        }
+    }
+
+    func consumeSpecialToken(_ c: CChar) -> Error? {
+        events.append(String(UnicodeScalar(UInt8(bitPattern: c))))
+        return nil
+    }
+}
+
+/// Deterministic generator, so that fuzzing failures can be reproduced
+struct SeededGenerator: RandomNumberGenerator {
+    var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        // SplitMix64
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
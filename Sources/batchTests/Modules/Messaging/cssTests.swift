@@ -58,4 +58,43 @@ class cssTests: XCTestCase {
         XCTAssertFalse(env.environmentMatchesQuery("@media android and (max-height:600)"))
         XCTAssertFalse(env.environmentMatchesQuery("@media ios and (max-height:599)"))
     }
+
+    func testRulesForNode() throws {
+        let css = """
+        * { --main-color: #FF0000; }
+        #title { color: var(--main-color); font-size: 12; }
+        .Big, #other { font-size: 20; }
+        .big { margin: 4; }
+        @media ios and (max-width: 500) {
+            #title { font-size: 14; }
+        }
+        @ios and dark {
+            .big { color: #FFFFFF; }
+        }
+        """
+        let document = try BACSSParser(string: css, andImportProvider: BACSSBuiltinImportProvider()).parse()
+
+        let node = BACSSDOMNode()
+        node.identifier = "Title"
+        node.classes = ["big", "BIG"]
+
+        let env = BACSSEnvironment()
+        env.viewSize = CGSize(width: 800, height: 600)
+        var rules = document.flatRules(for: node, with: env)
+        // Rulesets are applied once, in order, whatever the number of selectors matching the node
+        XCTAssertEqual(rules["color"], "#FF0000")
+        XCTAssertEqual(rules["font-size"], "20")
+        XCTAssertEqual(rules["margin-top"], "4")
+
+        // Media queries are reevaluated when the environment changes
+        env.viewSize = CGSize(width: 400, height: 600)
+        env.darkMode = true
+        rules = document.flatRules(for: node, with: env)
+        XCTAssertEqual(rules["font-size"], "14")
+        XCTAssertEqual(rules["color"], "#FFFFFF")
+
+        let otherNode = BACSSDOMNode()
+        otherNode.identifier = "unknown"
+        XCTAssertTrue(document.flatRules(for: otherNode, with: env).isEmpty)
+    }
 }
@@ -0,0 +1,48 @@
+//
+//  imageDecoderTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class imageDecoderTests: XCTestCase {
+    func testDownsampling() {
+        let data = makePNG(width: 400, height: 200)
+
+        let image = BAMSGImageDecoder.decodedImage(with: data, maxPixelSize: 100)
+        XCTAssertNotNil(image)
+        XCTAssertEqual(image?.cgImage?.width, 100)
+        XCTAssertEqual(image?.cgImage?.height, 50)
+        // Point size should match what UIImage(data:) would have given
+        XCTAssertEqual(image?.size, CGSize(width: 400, height: 200))
+    }
+
+    func testFullSizeDecoding() {
+        let data = makePNG(width: 400, height: 200)
+
+        for maxPixelSize: CGFloat in [0, 1000] {
+            let image = BAMSGImageDecoder.decodedImage(with: data, maxPixelSize: maxPixelSize)
+            XCTAssertEqual(image?.cgImage?.width, 400)
+            XCTAssertEqual(image?.cgImage?.height, 200)
+            XCTAssertEqual(image?.scale, 1)
+        }
+    }
+
+    func testInvalidData() {
+        XCTAssertNil(BAMSGImageDecoder.decodedImage(with: Data(), maxPixelSize: 0))
+        XCTAssertNil(BAMSGImageDecoder.decodedImage(with: "not an image".data(using: .utf8)!, maxPixelSize: 100))
+    }
+
+    func makePNG(width: Int, height: Int) -> Data {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        let renderer = UIGraphicsImageRenderer(size: CGSize(width: width, height: height), format: format)
+        return renderer.pngData { context in
+            UIColor.red.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        }
+    }
+}
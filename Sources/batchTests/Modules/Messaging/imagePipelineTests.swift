@@ -0,0 +1,225 @@
+//
+//  imagePipelineTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+/// URLProtocol serving canned responses, so that the pipeline can be tested without network
+class StubImageURLProtocol: URLProtocol {
+    struct StubResponse {
+        var statusCode: Int
+        var headers: [String: String]
+        var body: Data?
+        var delay: TimeInterval = 0
+    }
+
+    private static let lock = NSLock()
+    private static var _responder: ((URLRequest) -> StubResponse)?
+    private static var _receivedRequests: [URLRequest] = []
+
+    static var responder: ((URLRequest) -> StubResponse)? {
+        get { lock.withLock { _responder } }
+        set { lock.withLock { _responder = newValue } }
+    }
+
+    static var receivedRequests: [URLRequest] {
+        lock.withLock { _receivedRequests }
+    }
+
+    static func reset() {
+        lock.withLock {
+            _responder = nil
+            _receivedRequests = []
+        }
+    }
+
+    override class func canInit(with _: URLRequest) -> Bool {
+        return true
+    }
+
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest {
+        return request
+    }
+
+    override func startLoading() {
+        StubImageURLProtocol.lock.withLock { StubImageURLProtocol._receivedRequests.append(request) }
+
+        guard let stub = StubImageURLProtocol.responder?(request) else {
+            client?.urlProtocol(self, didFailWithError: URLError(.cannotConnectToHost))
+            return
+        }
+
+        DispatchQueue.global().asyncAfter(deadline: .now() + stub.delay) {
+            let response = HTTPURLResponse(
+                url: self.request.url!,
+                statusCode: stub.statusCode,
+                httpVersion: "HTTP/1.1",
+                headerFields: stub.headers
+            )!
+            self.client?.urlProtocol(self, didReceive: response, cacheStoragePolicy: .notAllowed)
+            if let body = stub.body {
+                self.client?.urlProtocol(self, didLoad: body)
+            }
+            self.client?.urlProtocolDidFinishLoading(self)
+        }
+    }
+
+    override func stopLoading() {}
+}
+
+class imagePipelineTests: XCTestCase {
+    let imageURL = URL(string: "https://batch.com/image.png")!
+
+    var cacheDirectory: String!
+
+    override func setUp() {
+        StubImageURLProtocol.reset()
+        cacheDirectory = (NSTemporaryDirectory() as NSString).appendingPathComponent("imagePipelineTests-\(UUID().uuidString)")
+    }
+
+    override func tearDown() {
+        StubImageURLProtocol.reset()
+        try? FileManager.default.removeItem(atPath: cacheDirectory)
+    }
+
+    func testConcurrentRequestsAreCoalesced() {
+        let pipeline = makePipeline()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 200, headers: [:], body: self.makePNG(), delay: 0.3)
+        }
+
+        var expectations: [XCTestExpectation] = []
+        for i in 0 ..< 5 {
+            let expectation = self.expectation(description: "Image \(i) loaded")
+            expectations.append(expectation)
+            pipeline.loadImage(for: imageURL, timeout: 5, maxPixelSize: 0) { data, isGif, image, error in
+                XCTAssertNotNil(data)
+                XCTAssertFalse(isGif)
+                XCTAssertNotNil(image)
+                XCTAssertNil(error)
+                expectation.fulfill()
+            }
+        }
+
+        wait(for: expectations, timeout: 5)
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 1)
+    }
+
+    func testFreshImageIsServedFromMemory() {
+        let pipeline = makePipeline()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 200, headers: ["Cache-Control": "max-age=3600"], body: self.makePNG())
+        }
+
+        load(pipeline)
+        load(pipeline)
+
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 1)
+    }
+
+    func testStaleImageIsRevalidated() {
+        let cache = makeCache()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(
+                statusCode: 200,
+                headers: ["Cache-Control": "no-cache", "ETag": "\"v1\""],
+                body: self.makePNG()
+            )
+        }
+        load(makePipeline(cache: cache))
+        // Flushes pending disk writes
+        cache.trimDiskCache()
+
+        // A new pipeline with a new cache instance only has the disk tier to work with
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 304, headers: ["Cache-Control": "no-cache"], body: nil)
+        }
+        let revalidated = load(makePipeline(cache: makeCache()))
+
+        XCTAssertNotNil(revalidated.image)
+        XCTAssertNil(revalidated.error)
+
+        let requests = StubImageURLProtocol.receivedRequests
+        XCTAssertEqual(requests.count, 2)
+        XCTAssertEqual(requests.last?.value(forHTTPHeaderField: "If-None-Match"), "\"v1\"")
+    }
+
+    func testNoStoreIsNotCached() {
+        let pipeline = makePipeline()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 200, headers: ["Cache-Control": "no-store"], body: self.makePNG())
+        }
+
+        load(pipeline)
+        load(pipeline)
+
+        XCTAssertEqual(StubImageURLProtocol.receivedRequests.count, 2)
+        XCTAssertNil(pipeline.cache.cachedImage(for: imageURL))
+    }
+
+    func testErrorsAreReported() {
+        let pipeline = makePipeline()
+        StubImageURLProtocol.responder = { _ in
+            StubImageURLProtocol.StubResponse(statusCode: 404, headers: [:], body: nil)
+        }
+
+        let result = load(pipeline)
+        XCTAssertNil(result.image)
+        XCTAssertEqual((result.error as? NSError)?.code, -1)
+    }
+
+    func testDiskCacheSizeIsCapped() {
+        let cache = BAMSGImageCache(directory: cacheDirectory, memoryCostLimit: 1024 * 1024, diskSizeLimit: 64 * 1024)
+        let payload = Data(count: 20 * 1024)
+
+        for i in 0 ..< 10 {
+            let url = URL(string: "https://batch.com/\(i).png")!
+            cache.store(BAMSGCachedImage(url: url, data: payload, etag: nil, lastModified: nil, expirationDate: nil))
+        }
+        cache.trimDiskCache()
+
+        let files = try! FileManager.default.contentsOfDirectory(atPath: cacheDirectory)
+        let totalSize = files.reduce(0) { size, file in
+            let attributes = try? FileManager.default.attributesOfItem(atPath: (cacheDirectory as NSString).appendingPathComponent(file))
+            return size + ((attributes?[.size] as? Int) ?? 0)
+        }
+        XCTAssertLessThan(files.count, 10)
+        XCTAssertLessThanOrEqual(totalSize, 64 * 1024)
+    }
+
+    // MARK: Helpers
+
+    func makeCache() -> BAMSGImageCache {
+        return BAMSGImageCache(directory: cacheDirectory, memoryCostLimit: 1024 * 1024, diskSizeLimit: 1024 * 1024)
+    }
+
+    func makePipeline(cache: BAMSGImageCache? = nil) -> BAMSGImagePipeline {
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [StubImageURLProtocol.self]
+        return BAMSGImagePipeline(sessionConfiguration: configuration, cache: cache ?? makeCache())
+    }
+
+    func makePNG() -> Data {
+        let renderer = UIGraphicsImageRenderer(size: CGSize(width: 4, height: 4))
+        return renderer.pngData { context in
+            UIColor.red.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: 4, height: 4))
+        }
+    }
+
+    @discardableResult
+    func load(_ pipeline: BAMSGImagePipeline) -> (image: UIImage?, error: Error?) {
+        let expectation = self.expectation(description: "Image loaded")
+        var result: (image: UIImage?, error: Error?) = (nil, nil)
+        pipeline.loadImage(for: imageURL, timeout: 5, maxPixelSize: 0) { _, _, image, error in
+            result = (image, error)
+            expectation.fulfill()
+        }
+        wait(for: [expectation], timeout: 5)
+        return result
+    }
+}
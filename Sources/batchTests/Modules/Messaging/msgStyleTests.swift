@@ -0,0 +1,81 @@
+//
+//  msgStyleTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import XCTest
+
+class msgStyleTests: XCTestCase {
+    func testColors() {
+        XCTAssertEqual(BAMSGStyle.color(fromValue: "#FF8000"), UIColor(red: 1, green: 128 / 255, blue: 0, alpha: 1))
+        let translucentOrange = UIColor(red: 1, green: 128 / 255, blue: 0, alpha: 128 / 255)
+        XCTAssertEqual(BAMSGStyle.color(fromValue: "#FF800080"), translucentOrange)
+        XCTAssertEqual(BAMSGStyle.color(fromValue: "transparent"), UIColor.clear)
+        XCTAssertEqual(BAMSGStyle.color(fromValue: "Red"), UIColor.red)
+        XCTAssertNil(BAMSGStyle.color(fromValue: "notacolor"))
+        XCTAssertNil(BAMSGStyle.color(fromHexValue: "red"))
+
+        // Cached colors are shared
+        XCTAssertTrue(BAMSGStyle.color(fromValue: "#123456") === BAMSGStyle.color(fromValue: "#123456"))
+    }
+
+    func testDecodedValues() {
+        let style = BAMSGStyle.style(forRules: [
+            "background-color": "#FF0000",
+            "background": "linear-gradient(90deg, #FFBBAA 0%, #FFAAEE 100%)",
+            "opacity": "2",
+            "padding-top": "4",
+            "padding-left": "8",
+            "text-align": "right",
+            "color": "blue",
+            "shadow-layer": "4 0.5",
+        ])
+
+        XCTAssertEqual(style.backgroundColor, UIColor.red)
+        XCTAssertEqual(style.backgroundGradient?.angle, 90)
+        XCTAssertEqual(style.backgroundGradient?.colors.count, 2)
+        XCTAssertEqual(style.backgroundGradient?.locations, [0, 1])
+        XCTAssertEqual(style.opacity, 1)
+        XCTAssertEqual(style.padding, UIEdgeInsets(top: 4, left: 8, bottom: 0, right: 0))
+        XCTAssertEqual(style.textAlignment, .right)
+        XCTAssertEqual(style.textColor, UIColor.blue)
+        XCTAssertFalse(style.hasShadow)
+        XCTAssertNil(style.borderRadius)
+
+        XCTAssertEqual(BAMSGStyle.style(forRules: [:]).textAlignment, .center)
+    }
+
+    func testGradientWinsOverBackgroundColor() {
+        let style = BAMSGStyle.style(forRules: [
+            "background-color": "#FF0000",
+            "background": "linear-gradient(90deg, #FFBBAA 0%, #FFAAEE 100%)",
+        ])
+
+        let gradientView = BAMSGGradientView()
+        BAMSGStylableViewHelper.applyCommonStyle(style, to: gradientView)
+        XCTAssertNil(gradientView.backgroundColor)
+
+        // Views without gradient support fall back on the color
+        let plainView = UIView()
+        BAMSGStylableViewHelper.applyCommonStyle(style, to: plainView)
+        XCTAssertEqual(plainView.backgroundColor, UIColor.red)
+    }
+
+    func testFonts() {
+        let rules = ["font-size": "17", "font-weight": "bold"]
+        let font = BAMSGStyle.style(forRules: rules).font(withBaseFont: nil, baseBoldFont: nil)
+        XCTAssertEqual(font.pointSize, 17)
+        XCTAssertTrue(font.fontDescriptor.symbolicTraits.contains(.traitBold))
+
+        // Fonts are cached between styles, before being scaled for dynamic type
+        XCTAssertEqual(font, BAMSGStyle.style(forRules: rules).font(withBaseFont: nil, baseBoldFont: nil))
+
+        let baseFont = UIFont(name: "Courier", size: 10)
+        let overriddenFont = BAMSGStyle.style(forRules: rules).font(withBaseFont: baseFont, baseBoldFont: nil)
+        XCTAssertEqual(overriddenFont.fontName, baseFont?.fontName)
+        XCTAssertEqual(overriddenFont.pointSize, 17)
+    }
+}
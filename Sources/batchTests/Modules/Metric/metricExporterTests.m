@@ -0,0 +1,149 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+/// Exporter keeping the batches it is asked to send, completed by the tests
+@interface metricExporterTestsExporter : BAMetricExporter
+
+@property NSMutableArray<NSArray<NSDictionary *> *> *sentBatches;
+@property NSMutableArray<void (^)(NSError *_Nullable)> *completions;
+
+@end
+
+@implementation metricExporterTestsExporter
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL dateProvider:(id<BADateProviderProtocol>)dateProvider {
+    self = [super initWithFileURL:fileURL dateProvider:dateProvider];
+    if (self) {
+        _sentBatches = [NSMutableArray array];
+        _completions = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)sendBatch:(NSArray<NSDictionary *> *)batch completion:(void (^)(NSError *_Nullable))completion {
+    @synchronized(self) {
+        [_sentBatches addObject:batch];
+        [_completions addObject:completion];
+    }
+}
+
+- (void)completeNextBatchWithError:(NSError *)error {
+    void (^completion)(NSError *_Nullable);
+    @synchronized(self) {
+        completion = _completions.firstObject;
+        [_completions removeObjectAtIndex:0];
+    }
+    completion(error);
+}
+
+@end
+
+@interface metricExporterTests : XCTestCase {
+    NSURL *_fileURL;
+    BAMutableDateProvider *_dateProvider;
+}
+@end
+
+@implementation metricExporterTests
+
+- (void)setUp {
+    [super setUp];
+    _fileURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()]
+        URLByAppendingPathComponent:[NSString stringWithFormat:@"metrics-%@.json", [NSUUID UUID].UUIDString]];
+    _dateProvider = [[BAMutableDateProvider alloc] initWithTimestamp:1000];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:_fileURL error:nil];
+    [super tearDown];
+}
+
+- (BACounter *)counterWithValue:(int)value {
+    BACounter *counter = [[BACounter alloc] initWithName:@"counter_test_metric" andLabelNames:@"code", nil];
+    BACounter *child = [counter labels:@[ @"200" ]];
+    for (int i = 0; i < value; i++) {
+        [child increment];
+    }
+    return [child drainChanges];
+}
+
+- (BAObservation *)observationWithValue:(NSNumber *)value {
+    BAObservation *observation = [[BAObservation alloc] initWithName:@"observation_test_metric"];
+    [observation observe:[value doubleValue]];
+    return (BAObservation *)[observation drainChanges];
+}
+
+- (void)testSeriesAreMerged {
+    metricExporterTestsExporter *exporter = [[metricExporterTestsExporter alloc] initWithFileURL:nil
+                                                                                     dateProvider:_dateProvider];
+    [exporter exportMetrics:@[ [self counterWithValue:2], [self observationWithValue:@0.5] ]];
+    [exporter pendingMetrics];
+    XCTAssertEqual([exporter.sentBatches count], 1);
+
+    // While the first batch is in flight, new exports are merged into the next one
+    [exporter exportMetrics:@[ [self counterWithValue:3], [self observationWithValue:@0.7] ]];
+    [exporter exportMetrics:@[ [self counterWithValue:4], [self observationWithValue:@0.9] ]];
+    NSArray<NSDictionary *> *pending = [exporter pendingMetrics];
+    XCTAssertEqual([pending count], 4);
+    XCTAssertEqualObjects(pending[2][@"values"], @[ @7 ]);
+    XCTAssertEqualObjects(pending[2][@"labels"], @{@"code" : @"200"});
+    XCTAssertEqualObjects(pending[3][@"values"], (@[ @0.7, @0.9 ]));
+
+    [exporter completeNextBatchWithError:nil];
+    [exporter exportMetrics:@[]];
+    [exporter pendingMetrics];
+    XCTAssertEqual([exporter.sentBatches count], 2);
+    XCTAssertEqualObjects(exporter.sentBatches[1], [pending subarrayWithRange:NSMakeRange(2, 2)]);
+}
+
+- (void)testFailedBatchIsRequeued {
+    metricExporterTestsExporter *exporter = [[metricExporterTestsExporter alloc] initWithFileURL:nil
+                                                                                     dateProvider:_dateProvider];
+    [exporter exportMetrics:@[ [self counterWithValue:2] ]];
+    [exporter pendingMetrics];
+    [exporter exportMetrics:@[ [self counterWithValue:1], [self observationWithValue:@0.5] ]];
+
+    [exporter completeNextBatchWithError:[NSError errorWithDomain:@"tests" code:0 userInfo:@{@"retryAfter" : @30}]];
+    NSArray<NSDictionary *> *pending = [exporter pendingMetrics];
+    XCTAssertEqual([pending count], 2);
+    XCTAssertEqualObjects(pending[0][@"values"], @[ @3 ]);
+    XCTAssertEqualObjects(pending[1][@"values"], @[ @0.5 ]);
+
+    // The webservice isn't retried before its retry after
+    [exporter exportMetrics:@[]];
+    [exporter pendingMetrics];
+    XCTAssertEqual([exporter.sentBatches count], 1);
+
+    [_dateProvider setTime:1030];
+    [exporter exportMetrics:@[]];
+    [exporter pendingMetrics];
+    XCTAssertEqual([exporter.sentBatches count], 2);
+    XCTAssertEqualObjects(exporter.sentBatches[1], pending);
+}
+
+- (void)testBatchesArePersisted {
+    metricExporterTestsExporter *exporter = [[metricExporterTestsExporter alloc] initWithFileURL:_fileURL
+                                                                                     dateProvider:_dateProvider];
+    [exporter exportMetrics:@[ [self counterWithValue:2] ]];
+    [exporter exportMetrics:@[ [self observationWithValue:@0.5] ]];
+    NSArray<NSDictionary *> *pending = [exporter pendingMetrics];
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:_fileURL.path]);
+
+    // Both the in-flight and pending batches are restored, as the app may have been killed before sending them
+    metricExporterTestsExporter *restoredExporter =
+        [[metricExporterTestsExporter alloc] initWithFileURL:_fileURL dateProvider:_dateProvider];
+    XCTAssertEqualObjects([restoredExporter pendingMetrics], pending);
+
+    [restoredExporter exportMetrics:@[]];
+    [restoredExporter pendingMetrics];
+    [restoredExporter completeNextBatchWithError:nil];
+    XCTAssertEqual([[restoredExporter pendingMetrics] count], 0);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_fileURL.path]);
+}
+
+@end
@@ -6,6 +6,23 @@
 
 #import <XCTest/XCTest.h>
 
+/// Exporter whose batches stay in flight until the tests complete them
+@interface metricManagerTestsExporter : BAMetricExporter
+
+@property (nullable) void (^completion)(NSError *_Nullable);
+
+@end
+
+@implementation metricManagerTestsExporter
+
+- (void)sendBatch:(NSArray<NSDictionary *> *)batch completion:(void (^)(NSError *_Nullable))completion {
+    @synchronized(self) {
+        _completion = completion;
+    }
+}
+
+@end
+
 @interface metricManagerTests : XCTestCase {
     BAMetricManager *_manager;
     BAOverlayedInjectable *_managerOverlay;
@@ -14,6 +31,7 @@
 
 @interface BAMetricManager (Tests)
 - (NSArray *)getMetricsToSend;
+- (void)exportMetrics;
 @end
 
 @implementation metricManagerTests
@@ -21,7 +39,9 @@
 - (void)setUp {
     [super setUp];
     // Put setup code here. This method is called before the invocation of each test method in the class.
-    _manager = [[BAMetricManager alloc] init];
+    BAMetricExporter *exporter = [[metricManagerTestsExporter alloc] initWithFileURL:nil
+                                                                        dateProvider:[BASystemDateProvider new]];
+    _manager = [[BAMetricManager alloc] initWithExporter:exporter];
     _managerOverlay = [BAInjection overlayClass:BAMetricManager.class returnedInstance:_manager];
 }
 
@@ -39,10 +59,10 @@
 
 - (void)testGetMetricToSend {
     BACounter *counter = [[[BACounter alloc] initWithName:@"counter_test_metric"] registerMetric];
-    XCTAssertFalse([[_manager valueForKey:@"_isSending"] boolValue]);
+    XCTAssertEqual(_manager.pendingRecordCount, 0);
 
     [counter increment];
-    XCTAssertTrue([[_manager valueForKey:@"_isSending"] boolValue]);
+    XCTAssertEqual(_manager.pendingRecordCount, 1);
 
     BAObservation *observation = [[[BAObservation alloc] initWithName:@"observation_test_metric"
                                                         andLabelNames:@"label1", @"label2", nil] registerMetric];
@@ -75,6 +95,43 @@
         XCTAssertEqualObjects([actualMetric labelValues], [expectedMetric labelValues]);
         XCTAssertEqualObjects([actualMetric values], [expectedMetric values]);
     }
+
+    // Changes are drained: only new records are sent next time
+    XCTAssertEqual([[_manager getMetricsToSend] count], 0);
+    [counter increment];
+    NSArray<BAMetric *> *changes = [_manager getMetricsToSend];
+    XCTAssertEqual([changes count], 1);
+    XCTAssertEqualObjects([changes.firstObject values], @[ @1 ]);
+}
+
+- (void)testExportTimerStopsWhenIdle {
+    BATimerWheelTimeout *exportTimeout = [_manager valueForKey:@"_exportTimeout"];
+    metricManagerTestsExporter *exporter = (metricManagerTestsExporter *)_manager.exporter;
+    XCTAssertFalse([exportTimeout isScheduled]);
+
+    BACounter *counter = [[[BACounter alloc] initWithName:@"counter_test_metric"] registerMetric];
+    XCTAssertTrue([exportTimeout isScheduled]);
+
+    // Nothing to send: the timer stops
+    [exportTimeout cancel];
+    [_manager exportMetrics];
+    XCTAssertFalse([exportTimeout isScheduled]);
+
+    // The first record restarts it
+    [counter increment];
+    XCTAssertTrue([exportTimeout isScheduled]);
+
+    // It keeps running while the batch is in flight
+    [_manager exportMetrics];
+    XCTAssertTrue([exporter hasPendingMetrics]);
+    XCTAssertTrue([exportTimeout isScheduled]);
+
+    // And stops once it is sent
+    [exportTimeout cancel];
+    exporter.completion(nil);
+    XCTAssertFalse([exporter hasPendingMetrics]);
+    [_manager exportMetrics];
+    XCTAssertFalse([exportTimeout isScheduled]);
 }
 
 @end
@@ -0,0 +1,328 @@
+//
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#define BENCHMARK_ITERATIONS 100000
+
+/// Copy of the counter and observation as they were before the atomic primitives, for the benchmarks: values are
+/// kept in an array changed on every record, and children are keyed by label arrays.
+@interface metricPrimitivesTestsLegacyMetric : NSObject {
+    double _value;
+    NSNumber *_startTime;
+}
+
+@property NSMutableArray<NSNumber *> *values;
+@property NSMutableDictionary<NSArray<NSString *> *, metricPrimitivesTestsLegacyMetric *> *children;
+
+- (id)labels:(NSArray<NSString *> *)args;
+
+- (void)increment;
+
+- (void)startTimer;
+
+- (void)observeDuration;
+
+@end
+
+@implementation metricPrimitivesTestsLegacyMetric
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _values = [NSMutableArray array];
+        _children = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (id)labels:(NSArray<NSString *> *)args {
+    NSMutableArray *labels = [NSMutableArray array];
+    NSString *firstLabel = args.firstObject;
+
+    if (firstLabel) {
+        [labels addObject:firstLabel];
+        for (NSUInteger i = 1; i < args.count; i++) {
+            NSString *label = args[i];
+            [labels addObject:label];
+        }
+    }
+    id child = [_children objectForKey:labels];
+    if (child == nil) {
+        child = [metricPrimitivesTestsLegacyMetric new];
+        [_children setObject:child forKey:labels];
+    }
+    return child;
+}
+
+- (void)increment {
+    _value++;
+    [_values removeAllObjects];
+    [_values addObject:[NSNumber numberWithDouble:_value]];
+    [self update];
+}
+
+- (void)startTimer {
+    _startTime = @(floor([[NSDate date] timeIntervalSince1970] * 1000));
+}
+
+- (void)observeDuration {
+    NSNumber *now = @(floor([[NSDate date] timeIntervalSince1970] * 1000));
+    float delta = [now doubleValue] - [_startTime doubleValue];
+    [_values addObject:[NSNumber numberWithFloat:(float)delta / 1000]];
+    [self update];
+}
+
+/// The manager lookup of every record, without the send that followed it
+- (void)update {
+    [BAInjection injectClass:BAMetricManager.class];
+}
+
+@end
+
+@interface metricPrimitivesTests : XCTestCase {
+    BAOverlayedInjectable *_managerOverlay;
+}
+@end
+
+@implementation metricPrimitivesTests
+
+- (void)setUp {
+    [super setUp];
+    // Metrics notify the manager on every record: keep it away from the shared one
+    BAMetricExporter *exporter = [[BAMetricExporter alloc] initWithFileURL:nil
+                                                              dateProvider:[BASystemDateProvider new]];
+    _managerOverlay = [BAInjection overlayClass:BAMetricManager.class
+                               returnedInstance:[[BAMetricManager alloc] initWithExporter:exporter]];
+}
+
+- (void)tearDown {
+    [BAInjection unregisterOverlay:_managerOverlay];
+    [super tearDown];
+}
+
+- (void)testAtomicCounter {
+    BAAtomicCounter *counter = [BAAtomicCounter new];
+    dispatch_apply(8, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+      for (int i = 0; i < 10000; i++) {
+          [counter increment];
+      }
+    });
+    XCTAssertEqual(counter.value, 80000);
+
+    [counter add:5];
+    XCTAssertEqual([counter drain], 80005);
+    XCTAssertEqual(counter.value, 0);
+}
+
+- (void)testHistogram {
+    BAHistogram *histogram = [[BAHistogram alloc] initWithBucketBounds:@[ @0.1, @1, @10 ]];
+    [histogram observe:0.05];
+    [histogram observe:0.1];
+    [histogram observe:0.5];
+    [histogram observe:42];
+    XCTAssertEqual(histogram.count, 4);
+
+    BAHistogramSnapshot *snapshot = [histogram drain];
+    XCTAssertEqualObjects(snapshot.bucketBounds, (@[ @0.1, @1, @10 ]));
+    XCTAssertEqualObjects(snapshot.bucketCounts, (@[ @2, @1, @0, @1 ]));
+    XCTAssertEqual(snapshot.count, 4);
+    XCTAssertEqualWithAccuracy(snapshot.sum, 42.65, 0.000001);
+
+    // Draining resets the histogram
+    snapshot = [histogram drain];
+    XCTAssertEqual(snapshot.count, 0);
+    XCTAssertEqualObjects(snapshot.bucketCounts, (@[ @0, @0, @0, @0 ]));
+}
+
+- (void)testHistogramConcurrency {
+    BAHistogram *histogram = [[BAHistogram alloc] initWithBucketBounds:[BAHistogram defaultDurationBucketBounds]];
+    dispatch_apply(8, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+      for (int i = 0; i < 10000; i++) {
+          [histogram observe:0.2];
+      }
+    });
+
+    BAHistogramSnapshot *snapshot = [histogram drain];
+    XCTAssertEqual(snapshot.count, 80000);
+    XCTAssertEqualWithAccuracy(snapshot.sum, 16000, 0.001);
+    XCTAssertEqualObjects(snapshot.bucketCounts[5], @80000);
+}
+
+- (void)testHistogramDrainWhileObserving {
+    BAHistogram *histogram = [[BAHistogram alloc] initWithBucketBounds:[BAHistogram defaultDurationBucketBounds]];
+    uint64_t drainedCount = 0;
+    uint64_t drainedBucketCount = 0;
+    double drainedSum = 0;
+
+    dispatch_group_t observers = dispatch_group_create();
+    for (int observer = 0; observer < 8; observer++) {
+        dispatch_group_async(observers, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+          for (int i = 0; i < 10000; i++) {
+              [histogram observe:0.2];
+          }
+        });
+    }
+
+    // Every observation is counted in exactly one snapshot, and its buckets always match its count
+    BOOL observing = true;
+    while (observing) {
+        observing = dispatch_group_wait(observers, DISPATCH_TIME_NOW) != 0;
+        BAHistogramSnapshot *snapshot = [histogram drain];
+        uint64_t bucketCount = 0;
+        for (NSNumber *count in snapshot.bucketCounts) {
+            bucketCount += [count unsignedLongLongValue];
+        }
+        XCTAssertEqual(bucketCount, snapshot.count);
+        drainedCount += snapshot.count;
+        drainedBucketCount += bucketCount;
+        drainedSum += snapshot.sum;
+    }
+    drainedSum += [histogram drain].sum;
+
+    XCTAssertEqual(drainedCount, 80000);
+    XCTAssertEqual(drainedBucketCount, 80000);
+    XCTAssertEqualWithAccuracy(drainedSum, 16000, 0.001);
+}
+
+- (void)testSampleBuffer {
+    BASampleBuffer *samples = [[BASampleBuffer alloc] initWithCapacity:3];
+    [samples record:1];
+    [samples record:NAN];
+    [samples record:2];
+    XCTAssertEqualObjects([samples snapshot], (@[ @1, @2 ]));
+
+    // Once full, the oldest values are replaced
+    [samples record:3];
+    [samples record:4];
+    XCTAssertEqualObjects([samples drain], (@[ @2, @3, @4 ]));
+    XCTAssertEqualObjects([samples drain], @[]);
+}
+
+- (void)testSampleBufferConcurrency {
+    BASampleBuffer *samples = [[BASampleBuffer alloc] initWithCapacity:100000];
+    NSUInteger drained = 0;
+
+    // Draining while recording: every value ends up in exactly one drain
+    dispatch_group_t recorders = dispatch_group_create();
+    for (int recorder = 0; recorder < 8; recorder++) {
+        dispatch_group_async(recorders, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+          for (int i = 0; i < 10000; i++) {
+              [samples record:0.2];
+          }
+        });
+    }
+    BOOL recording = true;
+    while (recording) {
+        recording = dispatch_group_wait(recorders, DISPATCH_TIME_NOW) != 0;
+        drained += [[samples drain] count];
+    }
+    XCTAssertEqual(drained, 80000);
+}
+
+- (void)testObservation {
+    BAObservation *observation = [[BAObservation alloc] initWithName:@"observation_test_metric"];
+    XCTAssertFalse([observation hasChanged]);
+    XCTAssertNil([observation drainChanges]);
+
+    [observation observe:0.5];
+    [observation observe:1.5];
+    XCTAssertTrue([observation hasChanged]);
+
+    BAObservation *changes = (BAObservation *)[observation drainChanges];
+    XCTAssertFalse([observation hasChanged]);
+
+    // Durations are serialized as they were recorded, in seconds
+    NSDictionary *serialized = [changes toDictionary];
+    XCTAssertEqualObjects(serialized[@"type"], @"observation");
+    XCTAssertEqualObjects(serialized[@"values"], (@[ @0.5, @1.5 ]));
+    XCTAssertNil(serialized[@"buckets"]);
+}
+
+- (void)testLabelSet {
+    BAMetricLabelSet *labelSet = [BAMetricLabelSet labelSetWithValues:@[ @"post", @"200" ]];
+    XCTAssertEqualObjects(labelSet, ([BAMetricLabelSet labelSetWithValues:@[ @"post", @"200" ]]));
+    XCTAssertEqual(labelSet.hash, [BAMetricLabelSet labelSetWithValues:@[ @"post", @"200" ]].hash);
+    XCTAssertNotEqualObjects(labelSet, ([BAMetricLabelSet labelSetWithValues:@[ @"post", @"500" ]]));
+    XCTAssertNotEqualObjects([BAMetricLabelSet labelSetWithValues:@[ @"ab" ]],
+                             ([BAMetricLabelSet labelSetWithValues:@[ @"a", @"b" ]]));
+}
+
+- (void)testConcurrentChildren {
+    BACounter *counter = [[BACounter alloc] initWithName:@"counter_test_metric" andLabelNames:@"status", nil];
+    dispatch_apply(8, DISPATCH_APPLY_AUTO, ^(size_t iteration) {
+      for (int i = 0; i < 1000; i++) {
+          [[counter labels:@[ (i % 2 == 0) ? @"OK" : @"KO" ]] increment];
+      }
+    });
+
+    XCTAssertEqual([[counter childrenSnapshot] count], 2);
+    BACounter *okCounter = [counter childForLabelSet:[BAMetricLabelSet labelSetWithValues:@[ @"OK" ]]];
+    XCTAssertEqualObjects([okCounter values], (@[ @4000.0 ]));
+    XCTAssertEqualObjects(okCounter.labelValues, (@[ @"OK" ]));
+}
+
+#pragma mark Benchmarks
+
+- (void)testLegacyCounterPerformance {
+    metricPrimitivesTestsLegacyMetric *counter = [metricPrimitivesTestsLegacyMetric new];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [[counter labels:@[ @"OK" ]] increment];
+      }
+    }];
+}
+
+- (void)testCounterPerformance {
+    BACounter *counter = [[BACounter alloc] initWithName:@"counter_test_metric" andLabelNames:@"status", nil];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [[counter labels:@[ @"OK" ]] increment];
+      }
+    }];
+}
+
+- (void)testAtomicCounterPerformance {
+    BAAtomicCounter *counter = [BAAtomicCounter new];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [counter increment];
+      }
+    }];
+}
+
+- (void)testLegacyObservationPerformance {
+    metricPrimitivesTestsLegacyMetric *observation = [metricPrimitivesTestsLegacyMetric new];
+    [observation startTimer];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [observation observeDuration];
+      }
+      [observation.values removeAllObjects];
+    }];
+}
+
+- (void)testObservationPerformance {
+    BAObservation *observation = [[BAObservation alloc] initWithName:@"observation_test_metric"];
+    [observation startTimer];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [observation observeDuration];
+      }
+      [observation reset];
+    }];
+}
+
+- (void)testHistogramPerformance {
+    BAHistogram *histogram = [[BAHistogram alloc] initWithBucketBounds:[BAHistogram defaultDurationBucketBounds]];
+    [self measureBlock:^{
+      for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+          [histogram observe:(double)(i % 1000) / 100];
+      }
+    }];
+}
+
+@end
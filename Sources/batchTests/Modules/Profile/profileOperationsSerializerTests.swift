@@ -149,6 +149,39 @@ final class profileOperationsSerializerTests: XCTestCase {
         XCTAssertEqual(serializedAttributes["att5.i"] as? Int, 5)
     }
 
+    /// Test that partial array updates are collapsed to their net effect
+    func testPartialArrayUpdateFusion() throws {
+        let serialized = try serializeEditor { editor in
+            try editor.add(value: "foo", toArray: "att1")
+            try editor.add(value: "bar", toArray: "att1")
+            try editor.remove(value: "foo", fromArray: "att1")
+            try editor.remove(value: "foo", fromArray: "att1")
+
+            try editor.add(value: "foo", toArray: "att2")
+            try editor.remove(value: "foo", fromArray: "att2")
+
+            try editor.remove(value: "foo", fromArray: "att3")
+            try editor.remove(value: "bar", fromArray: "att3")
+            try editor.add(value: "foo", toArray: "att3")
+            try editor.add(value: "foo", toArray: "att3")
+        }
+
+        guard let serializedAttributes = serialized["custom_attributes"] as? [AnyHashable: Any] else {
+            XCTFail("missing 'custom_attributes'")
+            return
+        }
+
+        XCTAssertEqual(
+            serializedAttributes["att1.a"] as? NSDictionary,
+            ["$add": ["bar"], "$remove": ["foo"]] as NSDictionary
+        )
+        XCTAssertEqual(serializedAttributes["att2.a"] as? NSDictionary, ["$remove": ["foo"]] as NSDictionary)
+        XCTAssertEqual(
+            serializedAttributes["att3.a"] as? NSDictionary,
+            ["$add": ["foo"], "$remove": ["bar"]] as NSDictionary
+        )
+    }
+
     /// Test that an email cannot be set and is not serialized if not allowed
     func testCantSetEmail() throws {
         let editor = TestProfileEditor()
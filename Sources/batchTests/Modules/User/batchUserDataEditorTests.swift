@@ -274,6 +274,94 @@ class UserDataEditorTests: XCTestCase {
         datasource.verify()
     }
 
+    func testOperationFusion() throws {
+        let datasource = MockUserDatasource()
+        let _ = BAInjection.overlayProtocol(BAUserDatasourceProtocol.self, returnedInstance: datasource)
+
+        datasource.expect()
+            .call(
+                datasource.setStringAttribute(Arg.any(), forKey: Arg.any()),
+                count: 0
+            )
+        datasource.expect()
+            .call(
+                datasource.removeAttributeNamed(Arg.eq("foo"))
+            )
+        datasource.expect()
+            .call(
+                datasource.setLongLongAttribute(Arg.eq(2), forKey: Arg.eq("bar"))
+            )
+        datasource.expect()
+            .call(
+                datasource.setLongLongAttribute(Arg.any(), forKey: Arg.any()),
+                count: 1
+            )
+        datasource.expect()
+            .call(
+                datasource.removeTag(Arg.eq("t"), fromCollection: Arg.eq("c"))
+            )
+        datasource.expect()
+            .call(
+                datasource.addTag(Arg.eq("u"), toCollection: Arg.eq("c"))
+            )
+        datasource.expect()
+            .call(
+                datasource.addTag(Arg.any(), toCollection: Arg.any()),
+                count: 1
+            )
+        datasource.expect()
+            .call(
+                datasource.clearTags(fromCollection: Arg.eq("d"))
+            )
+
+        let editor = BAInstallDataEditor()
+        try editor.setAttribute("value", forKey: "foo")
+        editor.removeAttribute(forKey: "foo")
+        try editor.setAttribute(1 as Int64, forKey: "bar")
+        try editor.setAttribute(2 as Int64, forKey: "bar")
+        editor.addTag("t", inCollection: "c")
+        editor.removeTag("t", fromCollection: "c")
+        editor.addTag("u", inCollection: "c")
+        editor.addTag("x", inCollection: "d")
+        editor.clearTagCollection("d")
+
+        let operations = editor.operationQueue()
+        XCTAssertEqual(operations.count, 5)
+        BAUserDataManager.writeToDatasource(changes: operations, changeset: 1)
+
+        datasource.verify()
+    }
+
+    func testOperationCompilerClears() {
+        var applied: [String] = []
+        func operation(_ name: String) -> () -> Bool {
+            return {
+                applied.append(name)
+                return true
+            }
+        }
+
+        let operations = [
+            BAUserDataOperation.attributeOperation(forKey: "a", block: operation("set a")),
+            BAUserDataOperation.clearAttributesOperation(block: operation("clear attributes")),
+            BAUserDataOperation.attributeOperation(forKey: "b", block: operation("set b")),
+            BAUserDataOperation.clearAttributesOperation(block: operation("clear attributes again")),
+            BAUserDataOperation.attributeOperation(forKey: "c", block: operation("set c")),
+            BAUserDataOperation.tagOperation(forTag: "t", inCollection: "c1", block: operation("add t")),
+            BAUserDataOperation.clearTagCollectionOperation(forCollection: "c2", block: operation("clear c2")),
+            BAUserDataOperation.clearTagsOperation(block: operation("clear tags")),
+            BAUserDataOperation.tagOperation(forTag: "u", inCollection: "c2", block: operation("add u")),
+            BAUserDataOperation.clearTagCollectionOperation(forCollection: "c2", block: operation("clear c2 again")),
+            BAUserDataOperation(block: operation("opaque")),
+        ]
+
+        for compiledOperation in BAUserDataOperationCompiler.compileOperations(operations) {
+            XCTAssertTrue(compiledOperation.run())
+        }
+
+        XCTAssertEqual(applied, ["clear attributes again", "set c", "clear tags", "clear c2 again", "opaque"])
+    }
+
     func testUserOperationQueue() {
         do {
             let editor = BAInstallDataEditor()
@@ -71,4 +71,125 @@
     XCTAssertTrue([_datasource acquireTransactionLockWithChangeset:1]);
 }
 
+- (void)testJournal {
+    XCTAssertTrue([_datasource setStringAttribute:@"String" forKey:@"string"]);
+    // Same value: should not be journaled
+    XCTAssertTrue([_datasource setStringAttribute:@"String" forKey:@"string"]);
+    XCTAssertTrue([_datasource setStringAttribute:@"String2" forKey:@"string"]);
+    XCTAssertTrue([_datasource addTag:@"tag" toCollection:@"collection"]);
+    // Already there: should not be journaled
+    XCTAssertTrue([_datasource addTag:@"tag" toCollection:@"collection"]);
+    // Not there: should not be journaled
+    XCTAssertTrue([_datasource removeTag:@"missing" fromCollection:@"collection"]);
+    XCTAssertTrue([_datasource removeAttributeNamed:@"string"]);
+    XCTAssertTrue([_datasource clearTagsFromCollection:@"collection"]);
+
+    NSArray<BAUserDataJournalEntry *> *entries = [_datasource journalEntriesAfterChangeset:0 upToChangeset:1];
+    XCTAssertEqual(6, [entries count]);
+
+    NSArray *expectedOperations = @[
+        @(BAUserDataJournalOperationAttributeSet), @(BAUserDataJournalOperationAttributeRemoved),
+        @(BAUserDataJournalOperationAttributeSet), @(BAUserDataJournalOperationTagAdded),
+        @(BAUserDataJournalOperationAttributeRemoved), @(BAUserDataJournalOperationTagRemoved)
+    ];
+    long long previousVersion = 0;
+    for (NSUInteger i = 0; i < [entries count]; i++) {
+        BAUserDataJournalEntry *entry = entries[i];
+        XCTAssertEqual([expectedOperations[i] intValue], entry.operation);
+        XCTAssertGreaterThan(entry.version, previousVersion);
+        previousVersion = entry.version;
+    }
+
+    XCTAssertEqualObjects(@"c.string", entries[1].name);
+    XCTAssertEqualObjects([BAUserAttribute attributeWithValue:@"String" type:BAUserAttributeTypeString],
+                          entries[1].attribute);
+    XCTAssertEqualObjects([BAUserAttribute attributeWithValue:@"String2" type:BAUserAttributeTypeString],
+                          entries[2].attribute);
+    XCTAssertEqualObjects(@"collection", entries[3].name);
+    XCTAssertEqualObjects(@"tag", entries[3].tag);
+
+    XCTAssertEqual(0, [[_datasource journalEntriesAfterChangeset:1 upToChangeset:2] count]);
+
+    XCTAssertTrue([_datasource pruneJournalUpToChangeset:1]);
+    XCTAssertEqual(0, [[_datasource journalEntriesAfterChangeset:0 upToChangeset:1] count]);
+}
+
+- (void)testJournalRollback {
+    XCTAssertTrue([_datasource setLongLongAttribute:2 forKey:@"integer"]);
+    XCTAssertTrue([_datasource rollbackTransaction]);
+
+    XCTAssertEqual(0, [[_datasource journalEntriesAfterChangeset:0 upToChangeset:1] count]);
+
+    XCTAssertTrue([_datasource acquireTransactionLockWithChangeset:1]);
+}
+
+- (void)testReadsSeeCommittedSnapshot {
+    XCTAssertTrue([_datasource setStringAttribute:@"String" forKey:@"string"]);
+    XCTAssertTrue([_datasource addTag:@"tag" toCollection:@"collection"]);
+    XCTAssertTrue([_datasource commitTransaction]);
+
+    XCTAssertTrue([_datasource acquireTransactionLockWithChangeset:2]);
+    XCTAssertTrue([_datasource setStringAttribute:@"String2" forKey:@"string"]);
+    XCTAssertTrue([_datasource setLongLongAttribute:2 forKey:@"integer"]);
+    XCTAssertTrue([_datasource clearTags]);
+
+    // The changeset isn't committed yet: readers still get the previous data
+    NSDictionary<NSString *, BAUserAttribute *> *attributes = [_datasource attributes];
+    XCTAssertEqual(1, [attributes count]);
+    XCTAssertEqualObjects([BAUserAttribute attributeWithValue:@"String" type:BAUserAttributeTypeString],
+                          attributes[@"c.string"]);
+    XCTAssertEqualObjects([NSSet setWithObject:@"tag"], [_datasource tagCollections][@"collection"]);
+
+    XCTAssertTrue([_datasource commitTransaction]);
+
+    attributes = [_datasource attributes];
+    XCTAssertEqual(2, [attributes count]);
+    XCTAssertEqualObjects([BAUserAttribute attributeWithValue:@"String2" type:BAUserAttributeTypeString],
+                          attributes[@"c.string"]);
+    XCTAssertEqual(0, [[_datasource tagCollections] count]);
+
+    XCTAssertTrue([_datasource acquireTransactionLockWithChangeset:3]);
+}
+
+// Benchmarks reads while 1000-operation changesets are being applied on another thread
+- (void)testReadLatencyDuringChangeset {
+    for (int i = 0; i < 100; i++) {
+        XCTAssertTrue([_datasource setLongLongAttribute:i forKey:[NSString stringWithFormat:@"attr%d", i]]);
+        XCTAssertTrue([_datasource addTag:[NSString stringWithFormat:@"tag%d", i] toCollection:@"collection"]);
+    }
+    XCTAssertTrue([_datasource commitTransaction]);
+
+    dispatch_queue_t writerQueue = dispatch_queue_create("com.batch.tests.userdata.writer", DISPATCH_QUEUE_SERIAL);
+    id<BAUserDatasourceProtocol> datasource = _datasource;
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics]
+        automaticallyStartMeasuring:NO
+                           forBlock:^{
+                             dispatch_semaphore_t writerStarted = dispatch_semaphore_create(0);
+                             dispatch_group_t writer = dispatch_group_create();
+                             dispatch_group_async(writer, writerQueue, ^{
+                               [datasource acquireTransactionLockWithChangeset:2];
+                               dispatch_semaphore_signal(writerStarted);
+                               for (int i = 0; i < 1000; i++) {
+                                   [datasource setLongLongAttribute:i
+                                                             forKey:[NSString stringWithFormat:@"pending%d", i]];
+                               }
+                               [datasource rollbackTransaction];
+                             });
+                             dispatch_semaphore_wait(writerStarted, DISPATCH_TIME_FOREVER);
+
+                             [self startMeasuring];
+                             for (int i = 0; i < 50; i++) {
+                                 // Never sees a partially applied changeset
+                                 XCTAssertEqual(100, [[datasource attributes] count]);
+                                 XCTAssertEqual(100, [[datasource tagCollections][@"collection"] count]);
+                             }
+                             [self stopMeasuring];
+
+                             dispatch_group_wait(writer, DISPATCH_TIME_FOREVER);
+                           }];
+
+    XCTAssertTrue([_datasource acquireTransactionLockWithChangeset:3]);
+}
+
 @end
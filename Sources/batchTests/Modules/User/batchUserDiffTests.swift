@@ -93,6 +93,83 @@ class BatchUserDiffTests: XCTestCase {
         XCTAssertFalse(noChangeDiff.hasChanges())
     }
 
+    func testJournalAttributesDiff() {
+        let entries = makeJournal([
+            (.attributeSet, "c.integer", BAUserAttribute(value: 2, type: .longLong), nil),
+            (.attributeRemoved, "c.string", BAUserAttribute(value: "foobar", type: .string), nil),
+            (.attributeSet, "c.string", BAUserAttribute(value: "foo", type: .string), nil),
+            (.attributeRemoved, "c.removed", BAUserAttribute(value: "removed", type: .string), nil),
+            // Changed, then restored: no diff expected
+            (.attributeRemoved, "c.restored", BAUserAttribute(value: "old", type: .string), nil),
+            (.attributeSet, "c.restored", BAUserAttribute(value: "new", type: .string), nil),
+            (.attributeRemoved, "c.restored", BAUserAttribute(value: "new", type: .string), nil),
+            (.attributeSet, "c.restored", BAUserAttribute(value: "old", type: .string), nil),
+            // Added, then removed: no diff expected
+            (.attributeSet, "c.temporary", BAUserAttribute(value: 1, type: .longLong), nil),
+            (.attributeRemoved, "c.temporary", BAUserAttribute(value: 1, type: .longLong), nil),
+            (.tagAdded, "collection", nil, "tag"),
+        ])
+
+        let diff = BAUserAttributesDiff(journalEntries: entries)
+
+        XCTAssertEqual(
+            diff.added,
+            [
+                "c.integer": BAUserAttribute(value: 2, type: .longLong),
+                "c.string": BAUserAttribute(value: "foo", type: .string),
+            ]
+        )
+
+        XCTAssertEqual(
+            diff.removed,
+            [
+                "c.removed": BAUserAttribute(value: "removed", type: .string),
+                "c.string": BAUserAttribute(value: "foobar", type: .string),
+            ]
+        )
+
+        XCTAssertTrue(diff.hasChanges())
+        XCTAssertFalse(BAUserAttributesDiff(journalEntries: []).hasChanges())
+    }
+
+    func testJournalTagsDiff() {
+        let entries = makeJournal([
+            (.tagAdded, "newtags", nil, "added"),
+            (.tagRemoved, "removed", nil, "remo"),
+            (.tagRemoved, "removed", nil, "ved"),
+            (.tagAdded, "updated_one", nil, "baz"),
+            (.tagRemoved, "updated_one", nil, "bar"),
+            // Added, then removed: no diff expected
+            (.tagAdded, "updated_one", nil, "temporary"),
+            (.tagRemoved, "updated_one", nil, "temporary"),
+            // Removed, then added back: no diff expected
+            (.tagRemoved, "unchanged", nil, "foo"),
+            (.tagAdded, "unchanged", nil, "foo"),
+            (.attributeSet, "c.integer", BAUserAttribute(value: 2, type: .longLong), nil),
+        ])
+
+        let diff = BAUserTagCollectionsDiff(journalEntries: entries)
+
+        XCTAssertEqual(
+            diff.added,
+            [
+                "updated_one": ["baz"],
+                "newtags": ["added"],
+            ]
+        )
+
+        XCTAssertEqual(
+            diff.removed,
+            [
+                "removed": ["ved", "remo"],
+                "updated_one": ["bar"],
+            ]
+        )
+
+        XCTAssertTrue(diff.hasChanges())
+        XCTAssertFalse(BAUserTagCollectionsDiff(journalEntries: []).hasChanges())
+    }
+
     func testEventSerialization() {
         let newCollections: [String: Set<String>] = [
             "newtags": ["new"]
@@ -133,4 +210,20 @@ class BatchUserDiffTests: XCTestCase {
             ] as NSDictionary
         )
     }
+
+    private func makeJournal(
+        _ entries: [(BAUserDataJournalOperation, String, BAUserAttribute?, String?)]
+    ) -> [BAUserDataJournalEntry] {
+        return entries.enumerated()
+            .map { index, entry in
+                BAUserDataJournalEntry(
+                    version: Int64(index + 1),
+                    changeset: 1,
+                    operation: entry.0,
+                    name: entry.1,
+                    attribute: entry.2,
+                    tag: entry.3
+                )
+            }
+    }
 }
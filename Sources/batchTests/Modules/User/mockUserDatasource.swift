@@ -104,6 +104,19 @@ class MockUserDatasource: Mock, BAUserDatasourceProtocol {
         return [:]
     }
 
+    func journalEntries(
+        afterChangeset baseChangeset: Int64,
+        upToChangeset changeset: Int64
+    ) -> [BAUserDataJournalEntry] {
+        super.call(baseChangeset, changeset)
+        return []
+    }
+
+    func pruneJournal(upToChangeset changeset: Int64) -> Bool {
+        super.call(changeset)
+        return true
+    }
+
     func printDebugDump() -> String {
         super.call()
         return "mock"
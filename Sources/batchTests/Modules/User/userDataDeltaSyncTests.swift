@@ -0,0 +1,237 @@
+//
+//  userDataDeltaSyncTests.swift
+//  BatchTests
+//
+//  Copyright © Batch.com. All rights reserved.
+//
+
+import Batch.Batch_Private
+import Foundation
+import XCTest
+
+/// In-process stand-in for the attributes backend.
+/// Keeps the server side data, and applies full and delta sends the way the server does:
+/// deltas are refused if their base version doesn't match what the server has.
+private class MockAttributesServer {
+    var version: Int64 = 0
+    private(set) var attributes: [String: AnyHashable] = [:]
+    private(set) var tags: [String: Set<String>] = [:]
+    private(set) var receivedDeltas = 0
+
+    func send(_ datasource: BAQueryWebserviceClientDatasource) -> BAWSResponseAttributes? {
+        guard let query = datasource.queriesToSend.first as? BAWSQuery else {
+            return nil
+        }
+
+        let body = query.objectToSend() as! [String: Any]
+        var response = makeBasicQueryResponseDictionary()
+
+        if let baseVersion = body["base_ver"] as? NSNumber {
+            receivedDeltas += 1
+            guard baseVersion.int64Value == version else {
+                response["resync"] = true
+                return datasource.response(for: query, content: response) as? BAWSResponseAttributes
+            }
+            apply(body["removed"] as! [String: Any], adding: false)
+            apply(body["added"] as! [String: Any], adding: true)
+        } else {
+            attributes = body["attrs"] as! [String: AnyHashable]
+            tags = (body["tags"] as! [String: [String]]).mapValues { Set($0) }
+        }
+
+        version = (body["ver"] as! NSNumber).int64Value
+        response["ver"] = version
+        response["trid"] = UUID().uuidString
+        response["delta"] = true
+        return datasource.response(for: query, content: response) as? BAWSResponseAttributes
+    }
+
+    private func apply(_ changes: [String: Any], adding: Bool) {
+        for (key, value) in changes {
+            if key.hasPrefix("t.") {
+                let collection = String(key.dropFirst(2))
+                var collectionTags = tags[collection] ?? []
+                if adding {
+                    collectionTags.formUnion(value as! [String])
+                } else {
+                    collectionTags.subtract(value as! [String])
+                }
+                tags[collection] = collectionTags.isEmpty ? nil : collectionTags
+            } else if adding {
+                attributes[key] = (value as! AnyHashable)
+            } else {
+                attributes.removeValue(forKey: key)
+            }
+        }
+    }
+}
+
+class UserDataDeltaSyncTests: XCTestCase {
+    private var datasource: BAUserSQLiteDatasource!
+    private var server: MockAttributesServer!
+
+    override func setUp() {
+        super.setUp()
+        datasource = BAUserSQLiteDatasource(databaseName: "ba_user_profile_delta_tests.db")
+        XCTAssertNotNil(datasource)
+        datasource.clear()
+        server = MockAttributesServer()
+    }
+
+    override func tearDown() {
+        datasource.clear()
+        super.tearDown()
+    }
+
+    func testDeltaQuerySerialization() {
+        let query = BAWSQueryAttributesDelta(
+            version: 3,
+            baseVersion: 2,
+            added: ["foo.s": "bar"],
+            removed: ["t.collection": ["tag"]]
+        )
+        let body = query.objectToSend() as! [String: Any]
+
+        XCTAssertEqual(body["type"] as? String, "ATTRIBUTES_DELTA")
+        XCTAssertEqual(body["ver"] as? Int64, 3)
+        XCTAssertEqual(body["base_ver"] as? Int64, 2)
+        XCTAssertEqual(body["added"] as? NSDictionary, ["foo.s": "bar"] as NSDictionary)
+        XCTAssertEqual(body["removed"] as? NSDictionary, ["t.collection": ["tag"]] as NSDictionary)
+    }
+
+    func testDeltaSync() {
+        write(changeset: 1) { datasource in
+            datasource.setStringAttribute("foo", forKey: "string")
+            datasource.setLongLongAttribute(2, forKey: "integer")
+            datasource.setBoolAttribute(true, forKey: "unchanged")
+            datasource.addTag("a", toCollection: "letters")
+            datasource.addTag("b", toCollection: "letters")
+        }
+        sendFullSnapshot(version: 1)
+
+        write(changeset: 2) { datasource in
+            datasource.setStringAttribute("bar", forKey: "string")
+            datasource.removeAttributeNamed("integer")
+            datasource.removeTag("a", fromCollection: "letters")
+            datasource.addTag("1", toCollection: "numbers")
+        }
+        write(changeset: 3) { datasource in
+            datasource.setDoubleAttribute(2.5, forKey: "double")
+            datasource.setLongLongAttribute(3, forKey: "string")
+            datasource.clearTags(fromCollection: "numbers")
+            datasource.addTag("c", toCollection: "letters")
+        }
+
+        let delta = BAUserDataManager.deltaSendDatasource(forVersion: 3, baseVersion: 1, datasource: datasource)
+        XCTAssertNotNil(delta)
+
+        let response = server.send(delta!)
+        XCTAssertNotNil(response)
+        XCTAssertFalse(response!.resyncRequired)
+        XCTAssertEqual(response!.version?.int64Value, 3)
+        XCTAssertEqual(server.receivedDeltas, 1)
+
+        assertServerMatchesDatasource()
+    }
+
+    func testDeltaOnlyContainsChanges() {
+        write(changeset: 1) { datasource in
+            for i in 0..<200 {
+                datasource.addTag("tag\(i)", toCollection: "many")
+            }
+        }
+        sendFullSnapshot(version: 1)
+
+        write(changeset: 2) { datasource in
+            datasource.addTag("new", toCollection: "many")
+        }
+
+        let delta = BAUserDataManager.deltaSendDatasource(forVersion: 2, baseVersion: 1, datasource: datasource)!
+        let body = delta.queriesToSend.first!.objectToSend() as! [String: Any]
+        XCTAssertEqual(body["added"] as? NSDictionary, ["t.many": ["new"]] as NSDictionary)
+        XCTAssertEqual(body["removed"] as? NSDictionary, [:] as NSDictionary)
+
+        _ = server.send(delta)
+        assertServerMatchesDatasource()
+    }
+
+    func testDivergedServerRequestsResync() {
+        write(changeset: 1) { datasource in
+            datasource.setStringAttribute("foo", forKey: "string")
+        }
+        sendFullSnapshot(version: 1)
+
+        // Another installation bumped the data on the server
+        server.version = 5
+
+        write(changeset: 2) { datasource in
+            datasource.setStringAttribute("bar", forKey: "string")
+        }
+
+        let delta = BAUserDataManager.deltaSendDatasource(forVersion: 2, baseVersion: 1, datasource: datasource)!
+        let response = server.send(delta)
+        XCTAssertNotNil(response)
+        XCTAssertTrue(response!.resyncRequired)
+        XCTAssertEqual(server.version, 5)
+
+        sendFullSnapshot(version: 6)
+        assertServerMatchesDatasource()
+    }
+
+    func testDeltaSupportFlag() {
+        let datasource = BAUserDataSendServiceDatasource(version: 1, attributes: [:], andTags: [:])
+        let query = datasource.queriesToSend.first as! BAWSQuery
+
+        var content = makeBasicQueryResponseDictionary()
+        content["ver"] = 1
+        content["trid"] = "trid"
+        // Servers that don't know about deltas don't advertise them
+        let legacyResponse = datasource.response(for: query, content: content) as? BAWSResponseAttributes
+        XCTAssertEqual(false, legacyResponse?.deltaSupported)
+
+        content["delta"] = true
+        let response = datasource.response(for: query, content: content) as? BAWSResponseAttributes
+        XCTAssertEqual(true, response?.deltaSupported)
+
+        // Fallback sends after a failure are not deltas
+        XCTAssertTrue(BAUserDataSendServiceDelegate(deltaSend: true).deltaSend)
+        XCTAssertFalse(BAUserDataSendServiceDelegate(deltaSend: false).deltaSend)
+    }
+
+    func testNoDeltaWithoutUsableBase() {
+        write(changeset: 1) { datasource in
+            datasource.setStringAttribute("foo", forKey: "string")
+        }
+
+        XCTAssertNil(BAUserDataManager.deltaSendDatasource(forVersion: 1, baseVersion: 0, datasource: datasource))
+        XCTAssertNil(BAUserDataManager.deltaSendDatasource(forVersion: 1, baseVersion: 1, datasource: datasource))
+        XCTAssertNil(BAUserDataManager.deltaSendDatasource(forVersion: 1, baseVersion: 2, datasource: datasource))
+    }
+
+    private func write(changeset: Int64, _ changes: (BAUserSQLiteDatasource) -> Void) {
+        XCTAssertTrue(datasource.acquireTransactionLock(withChangeset: changeset))
+        changes(datasource)
+        XCTAssertTrue(datasource.commitTransaction())
+    }
+
+    private func sendFullSnapshot(version: Int64) {
+        let full = BAUserDataSendServiceDatasource(
+            version: version,
+            attributes: BAUserAttribute.serverJsonRepresentation(forAttributes: datasource.attributes()),
+            andTags: datasource.tagCollections()
+        )
+        let response = server.send(full)
+        XCTAssertEqual(response?.version?.int64Value, version)
+        XCTAssertEqual(true, response?.deltaSupported)
+        // What BAUserDataManager does once the server acknowledged a version
+        XCTAssertTrue(datasource.pruneJournal(upToChangeset: version))
+    }
+
+    private func assertServerMatchesDatasource() {
+        XCTAssertEqual(
+            server.attributes as NSDictionary,
+            BAUserAttribute.serverJsonRepresentation(forAttributes: datasource.attributes()) as NSDictionary
+        )
+        XCTAssertEqual(server.tags, datasource.tagCollections())
+    }
+}
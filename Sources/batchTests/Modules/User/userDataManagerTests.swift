@@ -24,4 +24,44 @@ class UserDataManagerTests: XCTestCase {
 
         datasource.verify()
     }
+
+    func testSubmissionsAreCoalesced() {
+        let datasource = MockUserDatasource()
+
+        let overlay = BAInjection.overlayProtocol(BAUserDatasourceProtocol.self, returnedInstance: datasource)
+        defer { removeOverlay(overlay) }
+
+        // Both editors' changes should be applied in a single transaction
+        datasource.expect()
+            .call(
+                datasource.acquireTransactionLock(withChangeset: Arg.any()),
+                count: 1
+            )
+        datasource.expect()
+            .call(
+                datasource.setBoolAttribute(Arg.eq(true), forKey: Arg.eq("first"))
+            )
+        datasource.expect()
+            .call(
+                datasource.setBoolAttribute(Arg.eq(false), forKey: Arg.eq("second"))
+            )
+
+        let firstCompletion = expectation(description: "First submit completed")
+        let secondCompletion = expectation(description: "Second submit completed")
+
+        BAUserDataManager.sharedQueue().async {
+            BAUserDataManager.addOperationQueueAndSubmit(
+                [{ datasource.setBoolAttribute(true, forKey: "first") }],
+                withCompletion: { firstCompletion.fulfill() }
+            )
+            BAUserDataManager.addOperationQueueAndSubmit(
+                [{ datasource.setBoolAttribute(false, forKey: "second") }],
+                withCompletion: { secondCompletion.fulfill() }
+            )
+        }
+
+        wait(for: [firstCompletion, secondCompletion], timeout: 5)
+
+        datasource.verify()
+    }
 }
@@ -7,6 +7,7 @@
 
 #import <XCTest/XCTest.h>
 #import "BACoreCenter.h"
+#import "BATAttributedTextBuilder.h"
 #import "BATHtmlParser.h"
 #import "BatchCore.h"
 
@@ -129,4 +130,82 @@
     XCTAssertEqualObjects(parser.text, @" A b c d e fg");
 }
 
+- (void)testEntities {
+    NSString *string = @"a &amp; b &lt;c&gt; &#65;&#x42; <span style=\"color:&quot;red&quot;\">d</span>";
+
+    BATHtmlParser *parser = [[BATHtmlParser alloc] initWithString:string];
+    NSError *error = [parser parse];
+
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(parser.text, @"a & b <c> AB d");
+    XCTAssertEqualObjects(parser.transforms[0].attributes[@"color"], @"\"red\"");
+
+    XCTAssertNotNil([[[BATHtmlParser alloc] initWithString:@"a &unknown; b"] parse]);
+    XCTAssertNotNil([[[BATHtmlParser alloc] initWithString:@"a & b"] parse]);
+}
+
+- (void)testLineBreaksAndComments {
+    NSString *string = @"<b>a<br/>b</b><!-- comment <i> -->c<br></br>d";
+
+    BATHtmlParser *parser = [[BATHtmlParser alloc] initWithString:string];
+    NSError *error = [parser parse];
+
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(parser.text, @"a\nbc\nd");
+    XCTAssertEqual(parser.transforms.count, 1);
+    XCTAssertEqual([[parser.transforms firstObject] range].length, 3);
+}
+
+- (void)testMalformedMarkup {
+    NSArray<NSString *> *strings =
+        @[ @"<b>unclosed", @"a < b", @"<b attr>a</b>", @"<span style=\"color:red>a</span>", @"a</b>", @"<!-- a" ];
+    for (NSString *string in strings) {
+        BATHtmlParser *parser = [[BATHtmlParser alloc] initWithString:string];
+        XCTAssertNotNil([parser parse], @"'%@' should not parse", string);
+        XCTAssertEqual(parser.transforms.count, 0);
+    }
+}
+
+- (void)testAttributedStrings {
+    BATHtmlParser *parser = [[BATHtmlParser alloc] initWithString:@"<u>R<i>Vera</i></u>"];
+    XCTAssertNil([parser parse]);
+
+    UIFont *font = [UIFont systemFontOfSize:12];
+    BATAttributedTextStyle *style = [[BATAttributedTextStyle alloc] initWithFont:font];
+    NSAttributedString *attributedString = [BATAttributedTextBuilder attributedStringForText:parser.text
+                                                                                  transforms:parser.transforms
+                                                                                       style:style];
+
+    XCTAssertEqualObjects(attributedString.string, @"RVera");
+    XCTAssertEqualObjects([attributedString attribute:NSFontAttributeName atIndex:0 effectiveRange:nil], font);
+    XCTAssertNotNil([attributedString attribute:NSUnderlineStyleAttributeName atIndex:0 effectiveRange:nil]);
+    UIFont *italicFont = [attributedString attribute:NSFontAttributeName atIndex:1 effectiveRange:nil];
+    XCTAssertTrue(italicFont.fontDescriptor.symbolicTraits & UIFontDescriptorTraitItalic);
+
+    // Same text and style: the built string is reused
+    BATAttributedTextStyle *sameStyle = [[BATAttributedTextStyle alloc] initWithFont:font];
+    XCTAssertEqual(attributedString, [BATAttributedTextBuilder attributedStringForText:parser.text
+                                                                            transforms:parser.transforms
+                                                                                 style:sameStyle]);
+
+    sameStyle.letterSpacing = 2;
+    XCTAssertNotEqual(attributedString, [BATAttributedTextBuilder attributedStringForText:parser.text
+                                                                               transforms:parser.transforms
+                                                                                    style:sameStyle]);
+}
+
+- (void)testParsePerformance {
+    NSMutableString *string = [NSMutableString new];
+    for (int i = 0; i < 200; i++) {
+        [string appendString:@"Lorem <b>ipsum</b> dolor &amp; <span style=\"color:#FF0000\">sit <i>amet</i></span>"
+                             @"<br/>\n  consectetur &nbsp; <u>adipiscing</u> elit. "];
+    }
+
+    [self measureBlock:^{
+      for (int i = 0; i < 20; i++) {
+          XCTAssertNil([[[BATHtmlParser alloc] initWithString:string] parse]);
+      }
+    }];
+}
+
 @end